@@ -30,18 +30,43 @@
 #include <dcs/debug.hpp>
 #include <dcs/des/engine_traits.hpp>
 #include <dcs/des/entity.hpp>
+#include <dcs/des/cloud/control_tick_scheduler.hpp>
 #include <dcs/des/cloud/multi_tier_application.hpp>
+#include <dcs/des/cloud/physical_resource_category.hpp>
 #include <dcs/des/cloud/registry.hpp>
+#include <dcs/des/cloud/virtual_machine.hpp>
 #include <dcs/functional/bind.hpp>
 #include <dcs/macro.hpp>
 #include <dcs/memory.hpp>
-#include <string>
+#include <vector>
 
 
 namespace dcs { namespace des { namespace cloud {
 
+/**
+ * \brief Base class for application controllers.
+ *
+ * A controller whose control step only depends on its own application (see
+ * \c do_concurrent_control) can have it computed concurrently with the ones
+ * of the other controllers with the same sampling time.
+ * In this case, the wanted resource shares it sets through
+ * \c wanted_resource_share (and the physical machine controls it triggers
+ * through \c control_physical_machine) are deferred and applied in its own
+ * control event handler, that is in the same order as sequential runs.
+ *
+ * Only the order in which effects are applied is preserved, not the inputs of
+ * the control steps.
+ * In a sequential run, a controller reads the resource shares of its VMs after
+ * the earlier controllers of the same tick have redistributed the shares of
+ * the physical machines they share.
+ * A concurrently computed step reads the shares at the beginning of the tick,
+ * instead.
+ * Hence, when applications share physical machines, runs with more than one
+ * control thread are not expected to reproduce single-threaded ones.
+ */
 template <typename TraitsT>
-class base_application_controller: public ::dcs::des::entity
+class base_application_controller: public ::dcs::des::entity,
+									public base_concurrent_control_step<TraitsT>
 {
 	private: typedef base_application_controller<TraitsT> self_type;
 	public: typedef TraitsT traits_type;
@@ -52,18 +77,33 @@ class base_application_controller: public ::dcs::des::entity
 	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::engine_context_type des_engine_context_type;
 	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::event_type des_event_type;
 	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::event_source_type des_event_source_type;
-	public: typedef ::dcs::shared_ptr<des_event_source_type> des_event_source_pointer;
 	private: typedef registry<traits_type> registry_type;
+	private: typedef virtual_machine<traits_type> virtual_machine_type;
+	private: typedef ::dcs::shared_ptr<virtual_machine_type> virtual_machine_pointer;
+	private: typedef typename traits_type::physical_machine_identifier_type physical_machine_identifier_type;
+	private: struct deferred_share
+	{
+		deferred_share(virtual_machine_pointer const& ptr_vm_, physical_resource_category category_, real_type share_)
+		: ptr_vm(ptr_vm_),
+		  category(category_),
+		  share(share_)
+		{
+		}
 
-
-	private: static const ::std::string control_event_source_name;
+		virtual_machine_pointer ptr_vm;
+		physical_resource_category category;
+		real_type share;
+	};
+	private: typedef ::std::vector<deferred_share> deferred_share_container;
+	private: typedef ::std::vector<physical_machine_identifier_type> physical_machine_identifier_container;
 
 
 	/// Default constructor.
 	protected: base_application_controller()
 	: ptr_app_(),
 	  ts_(0),
-	  ptr_control_evt_src_(new des_event_source_type(control_event_source_name))
+	  deferred_(false),
+	  computed_(false)
 	{
 		init();
 	}
@@ -73,7 +113,8 @@ class base_application_controller: public ::dcs::des::entity
 	protected: explicit base_application_controller(real_type ts)
 	: ptr_app_(),
 	  ts_(ts),
-	  ptr_control_evt_src_(new des_event_source_type(control_event_source_name))
+	  deferred_(false),
+	  computed_(false)
 	{
 		init();
 	}
@@ -83,7 +124,8 @@ class base_application_controller: public ::dcs::des::entity
 	protected: base_application_controller(application_pointer const& ptr_app, real_type ts)
 	: ptr_app_(ptr_app),
 	  ts_(ts),
-	  ptr_control_evt_src_(new des_event_source_type(control_event_source_name))
+	  deferred_(false),
+	  computed_(false)
 	{
 		init();
 	}
@@ -93,7 +135,8 @@ class base_application_controller: public ::dcs::des::entity
 	public: base_application_controller(base_application_controller const& that)
 	: ptr_app_(that.ptr_app_),
 	  ts_(that.ts_),
-	  ptr_control_evt_src_(new des_event_source_type(*that.ptr_control_evt_src_))
+	  deferred_(false),
+	  computed_(false)
 	{
 		init();
 	}
@@ -108,7 +151,6 @@ class base_application_controller: public ::dcs::des::entity
 
 			ptr_app_ = rhs.ptr_app_;
 			ts_ = rhs.ts_;
-			ptr_control_evt_src_ = ::dcs::make_shared<des_event_source_type>(*(rhs.ptr_control_evt_src_));
 
 			init();
 		}
@@ -150,21 +192,20 @@ class base_application_controller: public ::dcs::des::entity
 	}
 
 
-	public: des_event_source_type& control_event_source()
-	{
-		return *ptr_control_evt_src_;
-	}
-
-
+	/// The control event source, shared by all the controllers with the same sampling time.
 	public: des_event_source_type const& control_event_source() const
 	{
-		return *ptr_control_evt_src_;
+		return registry_type::instance().control_tick_scheduler().control_event_source(ts_);
 	}
 
 
 	public: void sampling_time(real_type ts)
 	{
+		this->disconnect_from_event_sources();
+
 		ts_ = ts;
+
+		this->connect_to_event_sources();
 	}
 
 
@@ -174,6 +215,21 @@ class base_application_controller: public ::dcs::des::entity
 	}
 
 
+	/**
+	 * \brief Take over the control of the application in the middle of a run.
+	 *
+	 * A controller which replaces another one (e.g., in a forked variant of
+	 * the simulation) does not receive the system-initialization event, so
+	 * it is initialized here, within the given event.
+	 * Once enabled (see data_center::application_controller), it is run at
+	 * the next control tick of its sampling time.
+	 */
+	public: void take_over(des_event_type const& evt, des_engine_context_type& ctx)
+	{
+		do_process_sys_init(evt, ctx);
+	}
+
+
 	protected: application_pointer application_ptr() const
 	{
 		return ptr_app_;
@@ -186,6 +242,34 @@ class base_application_controller: public ::dcs::des::entity
 	}
 
 
+	/// Set the wanted share of the given resource category for the given VM.
+	protected: void wanted_resource_share(virtual_machine_pointer const& ptr_vm, physical_resource_category category, real_type share)
+	{
+		if (deferred_)
+		{
+			deferred_shares_.push_back(deferred_share(ptr_vm, category, share));
+		}
+		else
+		{
+			ptr_vm->wanted_resource_share(category, share);
+		}
+	}
+
+
+	/// Trigger the controller of the given physical machine.
+	protected: void control_physical_machine(physical_machine_identifier_type pm_id)
+	{
+		if (deferred_)
+		{
+			deferred_pm_controls_.push_back(pm_id);
+		}
+		else
+		{
+			this->application().data_centre().physical_machine_controller(pm_id).control();
+		}
+	}
+
+
 	private: void init()
 	{
 //		if (this->enabled())
@@ -208,7 +292,10 @@ class base_application_controller: public ::dcs::des::entity
 	{
 		if (ts_ > 0)
 		{
-			ptr_control_evt_src_->connect(
+			registry_type& reg(registry_type::instance());
+
+			reg.control_tick_scheduler().connect(
+				ts_,
 				::dcs::functional::bind(
 					&self_type::process_control,
 					this,
@@ -216,8 +303,7 @@ class base_application_controller: public ::dcs::des::entity
 					::dcs::functional::placeholders::_2
 				)
 			);
-
-			registry_type& reg(registry_type::instance());
+			reg.control_tick_scheduler().connect_concurrent(ts_, this);
 
 			reg.des_engine_ptr()->system_initialization_event_source().connect(
 				::dcs::functional::bind(
@@ -235,20 +321,19 @@ class base_application_controller: public ::dcs::des::entity
 	{
 		if (ts_ > 0)
 		{
-			if (ptr_control_evt_src_)
-			{
-				ptr_control_evt_src_->disconnect(
-					::dcs::functional::bind(
-						&self_type::process_control,
-						this,
-						::dcs::functional::placeholders::_1,
-						::dcs::functional::placeholders::_2
-					)
-				);
-			}
-
 			registry_type& reg(registry_type::instance());
 
+			reg.control_tick_scheduler().disconnect(
+				ts_,
+				::dcs::functional::bind(
+					&self_type::process_control,
+					this,
+					::dcs::functional::placeholders::_1,
+					::dcs::functional::placeholders::_2
+				)
+			);
+			reg.control_tick_scheduler().disconnect_concurrent(ts_, this);
+
 			reg.des_engine_ptr()->system_initialization_event_source().disconnect(
 				::dcs::functional::bind(
 					&self_type::process_sys_init,
@@ -263,18 +348,9 @@ class base_application_controller: public ::dcs::des::entity
 
 	//@{ Event Triggers
 
+	/// Control events are scheduled by the control tick scheduler (see registry).
 	private: void schedule_control()
 	{
-		if (ts_ > 0)
-		{
-			registry_type& reg(registry_type::instance());
-
-			reg.des_engine_ptr()->schedule_event(
-				ptr_control_evt_src_,
-				reg.des_engine_ptr()->simulated_time() + ts_
-			);
-		}
-
 		do_schedule_control();
 	}
 
@@ -296,23 +372,84 @@ class base_application_controller: public ::dcs::des::entity
 
 	private: void process_control(des_event_type const& evt, des_engine_context_type& ctx)
 	{
-		if (this->enabled())
+		// The control tick is shared with the other controllers with the same
+		// sampling time, hence skip it when disabled.
+		if (!this->enabled())
 		{
-			schedule_control();
+			return;
 		}
 
-		do_process_control(evt, ctx);
+		schedule_control();
+
+		// Computes the concurrent steps of this tick, if not done yet
+		registry_type::instance().control_tick_scheduler().run_concurrent_steps(ts_, evt, ctx);
+
+		if (computed_)
+		{
+			computed_ = false;
+
+			apply_deferred_control();
+		}
+		else
+		{
+			do_process_control(evt, ctx);
+		}
 	}
 
 	//@} Event Handlers
 
 
+	private: void apply_deferred_control()
+	{
+		typedef typename deferred_share_container::const_iterator share_iterator;
+		typedef typename physical_machine_identifier_container::const_iterator pm_id_iterator;
+
+		share_iterator share_end_it(deferred_shares_.end());
+		for (share_iterator it = deferred_shares_.begin(); it != share_end_it; ++it)
+		{
+			it->ptr_vm->wanted_resource_share(it->category, it->share);
+		}
+		deferred_shares_.clear();
+
+		pm_id_iterator pm_end_it(deferred_pm_controls_.end());
+		for (pm_id_iterator it = deferred_pm_controls_.begin(); it != pm_end_it; ++it)
+		{
+			this->application().data_centre().physical_machine_controller(*it).control();
+		}
+		deferred_pm_controls_.clear();
+	}
+
+
+	private: bool do_concurrent() const
+	{
+		return this->enabled() && do_concurrent_control();
+	}
+
+
+	private: void do_compute(des_event_type const& evt, des_engine_context_type& ctx)
+	{
+		deferred_ = true;
+		try
+		{
+			do_process_control(evt, ctx);
+		}
+		catch (...)
+		{
+			deferred_ = false;
+			deferred_shares_.clear();
+			deferred_pm_controls_.clear();
+			throw;
+		}
+		deferred_ = false;
+
+		computed_ = true;
+	}
+
+
 	//@{ Interface Member Functions
 
 	protected: virtual void do_enable(bool flag)
 	{
-		ptr_control_evt_src_->enable(flag);
-
 //		if (flag)
 //		{
 //			if (!this->enabled())
@@ -356,6 +493,20 @@ class base_application_controller: public ::dcs::des::entity
 	private: virtual void do_process_control(des_event_type const& evt, des_engine_context_type& ctx) = 0;
 
 
+	/**
+	 * \brief Tell if the control step can be computed concurrently with the
+	 *  ones of the other controllers.
+	 *
+	 * This is the case when the step only touches the state of the controller
+	 * and sets wanted shares and triggers physical machine controllers only
+	 * through \c wanted_resource_share and \c control_physical_machine.
+	 */
+	protected: virtual bool do_concurrent_control() const
+	{
+		return false;
+	}
+
+
 	protected: virtual void do_schedule_control()
 	{
 		// empty
@@ -366,12 +517,14 @@ class base_application_controller: public ::dcs::des::entity
 
 	private: application_pointer ptr_app_;
 	private: real_type ts_;
-	private: des_event_source_pointer ptr_control_evt_src_;
+	/// Tells if wanted shares and physical machine controls are currently deferred
+	private: bool deferred_;
+	/// Tells if the control step of the current tick has been computed concurrently
+	private: bool computed_;
+	private: deferred_share_container deferred_shares_;
+	private: physical_machine_identifier_container deferred_pm_controls_;
 };
 
-template <typename TraitsT>
-const ::std::string base_application_controller<TraitsT>::control_event_source_name("Control Application");
-
 }}} // Namespace dcs::des::cloud
 
 
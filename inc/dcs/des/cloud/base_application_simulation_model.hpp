@@ -26,6 +26,8 @@
 #define DCS_DES_CLOUD_BASE_APPLICATION_SIMULATION_MODEL_HPP
 
 
+#include <algorithm>
+#include <dcs/debug.hpp>
 #include <dcs/des/base_statistic.hpp>
 #include <dcs/des/engine_traits.hpp>
 #include <dcs/des/entity.hpp>
@@ -33,9 +35,11 @@
 #include <dcs/des/cloud/physical_resource_category.hpp>
 #include <dcs/des/cloud/registry.hpp>
 #include <dcs/des/cloud/user_request.hpp>
+#include <dcs/des/cloud/user_request_view.hpp>
 #include <dcs/exception.hpp>
 #include <dcs/macro.hpp>
 #include <dcs/memory.hpp>
+#include <cstddef>
 #include <map>
 #include <stdexcept>
 #include <vector>
@@ -56,6 +60,9 @@ class base_application_simulation_model: public ::dcs::des::entity
 	public: typedef ::dcs::des::base_statistic<real_type,uint_type> output_statistic_type;
 	public: typedef ::dcs::shared_ptr<output_statistic_type> output_statistic_pointer;
 	public: typedef user_request<traits_type> user_request_type;
+	public: typedef user_request_view<traits_type> user_request_view_type;
+	private: typedef typename user_request_view_type::state_pointer request_state_pointer;
+	private: typedef typename user_request_view_type::utilization_profile_type request_utilization_profile_type;
 	public: typedef multi_tier_application<traits_type> application_type;
 	public: typedef application_type* application_pointer;
 	public: typedef virtual_machine<traits_type> virtual_machine_type;
@@ -66,6 +73,9 @@ class base_application_simulation_model: public ::dcs::des::entity
 	private: typedef ::std::map<tier_identifier_type,virtual_machine_pointer> tier_vm_mapping_container;
 
 
+	friend class user_request_view<traits_type>;
+
+
 	/// Default constructor.
 	protected: base_application_simulation_model()
 	: start_time_(0),
@@ -229,6 +239,12 @@ class base_application_simulation_model: public ::dcs::des::entity
 	}
 
 
+	public: ::std::vector<user_request_view_type> tier_in_service_request_views(uint_type tier_id) const
+	{
+		return do_tier_in_service_request_views(tier_id);
+	}
+
+
 	public: output_statistic_type const& num_arrivals() const
 	{
 		return do_num_arrivals();
@@ -349,6 +365,13 @@ class base_application_simulation_model: public ::dcs::des::entity
 	}
 
 
+	/// Returns a lazy view over the request carried by the given event.
+	public: user_request_view_type request_view(des_event_type const& evt) const
+	{
+		return do_request_view(evt);
+	}
+
+
 	public: void start_application()
 	{
 		this->enable(true);
@@ -554,6 +577,174 @@ class base_application_simulation_model: public ::dcs::des::entity
 	private: virtual void do_resource_share(uint_type tier_id, physical_resource_category category, real_type share) = 0;
 
 
+	//@{ Request view accessors (used by user_request_view)
+
+	private: uint_type request_id(request_state_pointer const& ptr_state) const
+	{
+		return do_request_id(ptr_state);
+	}
+
+
+	private: uint_type request_current_tier(request_state_pointer const& ptr_state) const
+	{
+		return do_request_current_tier(ptr_state);
+	}
+
+
+	private: real_type request_arrival_time(request_state_pointer const& ptr_state) const
+	{
+		return do_request_arrival_time(ptr_state);
+	}
+
+
+	private: real_type request_departure_time(request_state_pointer const& ptr_state) const
+	{
+		return do_request_departure_time(ptr_state);
+	}
+
+
+	private: ::std::size_t request_tier_num_visits(request_state_pointer const& ptr_state, uint_type tier_id) const
+	{
+		return do_request_tier_num_visits(ptr_state, tier_id);
+	}
+
+
+	private: real_type request_tier_arrival_time(request_state_pointer const& ptr_state, uint_type tier_id, ::std::size_t visit) const
+	{
+		return do_request_tier_arrival_time(ptr_state, tier_id, visit);
+	}
+
+
+	private: real_type request_tier_departure_time(request_state_pointer const& ptr_state, uint_type tier_id, ::std::size_t visit) const
+	{
+		return do_request_tier_departure_time(ptr_state, tier_id, visit);
+	}
+
+
+	private: real_type request_tier_residence_time(request_state_pointer const& ptr_state, uint_type tier_id) const
+	{
+		return do_request_tier_residence_time(ptr_state, tier_id);
+	}
+
+
+	private: request_utilization_profile_type request_tier_last_utilization_profile(request_state_pointer const& ptr_state, uint_type tier_id, physical_resource_category category) const
+	{
+		return do_request_tier_last_utilization_profile(ptr_state, tier_id, category);
+	}
+
+	//@} Request view accessors
+
+
+	//@{ Default request view implementation
+	//
+	// Models that are unable to provide lazy access to their request state
+	// get views backed by an eagerly built user_request.
+
+	private: virtual user_request_view_type do_request_view(des_event_type const& evt) const
+	{
+		return user_request_view_type(*this, ::dcs::make_shared<user_request_type>(do_request_state(evt)));
+	}
+
+
+	private: virtual ::std::vector<user_request_view_type> do_tier_in_service_request_views(uint_type tier_id) const
+	{
+		typedef ::std::vector<user_request_type> request_container;
+		typedef typename request_container::const_iterator request_iterator;
+
+		request_container reqs(do_tier_in_service_requests(tier_id));
+		::std::vector<user_request_view_type> views;
+		views.reserve(reqs.size());
+		request_iterator end_it(reqs.end());
+		for (request_iterator it = reqs.begin(); it != end_it; ++it)
+		{
+			views.push_back(user_request_view_type(*this, ::dcs::make_shared<user_request_type>(*it)));
+		}
+
+		return views;
+	}
+
+
+	private: virtual uint_type do_request_id(request_state_pointer const& ptr_state) const
+	{
+		return eager_request(ptr_state).id();
+	}
+
+
+	private: virtual uint_type do_request_current_tier(request_state_pointer const& ptr_state) const
+	{
+		return eager_request(ptr_state).current_tier();
+	}
+
+
+	private: virtual real_type do_request_arrival_time(request_state_pointer const& ptr_state) const
+	{
+		return eager_request(ptr_state).arrival_time();
+	}
+
+
+	private: virtual real_type do_request_departure_time(request_state_pointer const& ptr_state) const
+	{
+		return eager_request(ptr_state).departure_time();
+	}
+
+
+	private: virtual ::std::size_t do_request_tier_num_visits(request_state_pointer const& ptr_state, uint_type tier_id) const
+	{
+		return eager_request(ptr_state).tier_arrival_times(tier_id).size();
+	}
+
+
+	private: virtual real_type do_request_tier_arrival_time(request_state_pointer const& ptr_state, uint_type tier_id, ::std::size_t visit) const
+	{
+		return eager_request(ptr_state).tier_arrival_times(tier_id).at(visit);
+	}
+
+
+	private: virtual real_type do_request_tier_departure_time(request_state_pointer const& ptr_state, uint_type tier_id, ::std::size_t visit) const
+	{
+		return eager_request(ptr_state).tier_departure_times(tier_id).at(visit);
+	}
+
+
+	private: virtual real_type do_request_tier_residence_time(request_state_pointer const& ptr_state, uint_type tier_id) const
+	{
+		::std::vector<real_type> arr_times(eager_request(ptr_state).tier_arrival_times(tier_id));
+		::std::vector<real_type> dep_times(eager_request(ptr_state).tier_departure_times(tier_id));
+		::std::size_t n(::std::min(arr_times.size(), dep_times.size()));
+		real_type rt(0);
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			rt += dep_times[i]-arr_times[i];
+		}
+
+		return rt;
+	}
+
+
+	private: virtual request_utilization_profile_type do_request_tier_last_utilization_profile(request_state_pointer const& ptr_state, uint_type tier_id, physical_resource_category category) const
+	{
+		::std::vector<request_utilization_profile_type> profiles(eager_request(ptr_state).tier_utilization_profiles(tier_id, category));
+
+		if (profiles.empty())
+		{
+			return request_utilization_profile_type();
+		}
+
+		return profiles.back();
+	}
+
+
+	private: static user_request_type const& eager_request(request_state_pointer const& ptr_state)
+	{
+		// pre: ptr_state must be a valid pointer
+		DCS_DEBUG_ASSERT( ptr_state );
+
+		return *static_cast<user_request_type const*>(ptr_state.get());
+	}
+
+	//@} Default request view implementation
+
+
 //	private: virtual void do_process_application_start(des_event_type const& evt, des_engine_context& ctx) = 0;
 //
 //
@@ -34,9 +34,12 @@
 #include <dcs/des/cloud/data_center.hpp>
 #include <dcs/des/cloud/physical_resource_category.hpp>
 #include <dcs/des/cloud/registry.hpp>
+#include <dcs/des/cloud/resource_vector.hpp>
 #include <dcs/functional/bind.hpp>
 #include <dcs/macro.hpp>
+#include <dcs/math/traits/float.hpp>
 #include <dcs/memory.hpp>
+#include <cstddef>
 #include <map>
 #include <string>
 #include <vector>
@@ -207,6 +210,20 @@ class base_migration_controller: public ::dcs::des::entity
 	}
 
 
+	/**
+	 * \brief Wait for the work this controller is doing outside the DES
+	 *  thread.
+	 *
+	 * On return, no thread runs on behalf of this controller until its next
+	 * control event, so that, for instance, the process can be safely forked.
+	 * Results not yet applied are kept.
+	 */
+	public: void wait_background_work()
+	{
+		do_wait_background_work();
+	}
+
+
 #ifdef DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
 	public: void notify_vm_creation(virtual_machine_pointer const& ptr_vm)
 	{
@@ -235,6 +252,17 @@ class base_migration_controller: public ::dcs::des::entity
 	}
 
 
+	/**
+	 * \brief Deploy VMs according to the given placement.
+	 *
+	 * The placement must include every VM that has to keep running.
+	 * Only VMs whose machine changes are moved; VMs which stay on their
+	 * machine only get their shares updated (if needed).
+	 * Running VMs not included in the placement are stopped, and powered-on
+	 * machines left without VMs are powered off.
+	 *
+	 * \return The number of migrated VMs.
+	 */
 	protected: uint_type migrate(virtual_machines_placement_type const& placement)
 	{
 		typedef typename traits_type::physical_machine_identifier_type pm_identifier_type;
@@ -249,6 +277,8 @@ class base_migration_controller: public ::dcs::des::entity
 		typedef typename pm_id_map::iterator pm_id_iterator;
 //		typedef typename physical_virtual_machine_map::const_iterator physical_virtual_machine_iterator;
 		typedef typename virtual_machines_placement_type::const_iterator vm_placement_iterator;
+		typedef typename virtual_machines_placement_type::share_const_iterator vm_share_iterator;
+		typedef ::std::vector<vm_placement_iterator> vm_placement_iterator_container;
 		typedef ::std::map<vm_identifier_type,vm_pointer> vm_id_map;
 		typedef typename vm_id_map::iterator vm_id_iterator;
 
@@ -275,7 +305,7 @@ class base_migration_controller: public ::dcs::des::entity
 
 		// Populate the inactive VMs container with all active virtual machines
 		{
-			vm_container active_vms(ptr_dc_->active_virtual_machines());
+			vm_container const& active_vms(ptr_dc_->active_virtual_machines());
 			vm_iterator vm_end_it(active_vms.end());
 			for (vm_iterator vm_it = active_vms.begin(); vm_it != vm_end_it; ++vm_it)
 			{
@@ -285,6 +315,72 @@ class base_migration_controller: public ::dcs::des::entity
 			}
 		}
 
+		// Find out the VMs to be moved and the ones whose shares change
+		vm_placement_iterator_container moved_vms;
+		vm_placement_iterator_container shrunk_vms;
+		vm_placement_iterator_container grown_vms;
+		{
+			virtual_machines_placement_type const& cur_placement(ptr_dc_->current_virtual_machines_placement());
+
+			vm_placement_iterator pm_vm_end_it(placement.end());
+			for (vm_placement_iterator pm_vm_it = placement.begin(); pm_vm_it != pm_vm_end_it; ++pm_vm_it)
+			{
+				pm_identifier_type pm_id(placement.pm_id(pm_vm_it));
+				vm_identifier_type vm_id(placement.vm_id(pm_vm_it));
+
+				inactive_pms.erase(pm_id);
+				inactive_vms.erase(vm_id);
+
+				vm_pointer ptr_vm(ptr_dc_->virtual_machine_ptr(vm_id));
+
+				// check: paranoid check
+				DCS_DEBUG_ASSERT( ptr_vm );
+
+				if (ptr_vm->power_state() != powered_on_power_status || !cur_placement.placed(vm_id, pm_id))
+				{
+					if (ptr_vm->vmm().hosting_machine().id() != pm_id)
+					{
+						++num_migrs;
+					}
+
+					moved_vms.push_back(pm_vm_it);
+					continue;
+				}
+
+				vm_placement_iterator cur_pm_vm_it(cur_placement.find(vm_id));
+				bool shrunk(false);
+				bool grown(false);
+				vm_share_iterator share_end_it(placement.shares_end(pm_vm_it));
+				for (vm_share_iterator share_it = placement.shares_begin(pm_vm_it); share_it != share_end_it; ++share_it)
+				{
+					physical_resource_category category(placement.resource_category(share_it));
+					real_type new_share(placement.resource_share(share_it));
+					real_type old_share(cur_pm_vm_it->second.count(category) > 0 ? cur_pm_vm_it->second.at(category) : real_type(0));
+
+					if (::dcs::math::float_traits<real_type>::approximately_equal(old_share, new_share, 1.0e-5))
+					{
+						continue;
+					}
+					if (new_share < old_share)
+					{
+						shrunk = true;
+					}
+					else
+					{
+						grown = true;
+					}
+				}
+				if (grown)
+				{
+					grown_vms.push_back(pm_vm_it);
+				}
+				else if (shrunk)
+				{
+					shrunk_vms.push_back(pm_vm_it);
+				}
+			}
+		}
+
 		// Migrate VMs
 		{
 			//NOTE: we cannot use directly the method data_center::migrate for
@@ -295,53 +391,60 @@ class base_migration_controller: public ::dcs::des::entity
 			//      VM2 (VM1) on it, without before powering-off VM1 (VM2).
 			//      The situation complicates when there are more than one VMs
 			//      involved in this circular dependencies.
-			//      So to solve we first power-off and displace all VMs, and
-			//      then place them on the new positions.
+			//      So to solve we first power-off and displace all the VMs to
+			//      be moved, and then place them on the new positions.
 			//      The drawback of this is that this does not mimic the true VM
 			//      live-migration since VMs are first powered-off and then
 			//      powered-on (just like a cold migration).
+			//      VMs which stay on their machine are left untouched, but for
+			//      their shares, which are updated before placing the moved
+			//      VMs (shrinking ones first, so that the growing ones fit).
 
-			vm_placement_iterator pm_vm_end_it(placement.end());
+			typedef typename vm_placement_iterator_container::const_iterator vm_placement_iterator_iterator;
+
+			vm_placement_iterator_iterator moved_end_it(moved_vms.end());
 
 			// Displace
-			for (vm_placement_iterator pm_vm_it = placement.begin(); pm_vm_it != pm_vm_end_it; ++pm_vm_it)
+			for (vm_placement_iterator_iterator moved_it = moved_vms.begin(); moved_it != moved_end_it; ++moved_it)
 			{
-				pm_pointer ptr_pm(ptr_dc_->physical_machine_ptr(placement.pm_id(pm_vm_it)));
-				vm_pointer ptr_vm(ptr_dc_->virtual_machine_ptr(placement.vm_id(pm_vm_it)));
+				vm_pointer ptr_vm(ptr_dc_->virtual_machine_ptr(placement.vm_id(*moved_it)));
 
-				// check: paranoid check
-				DCS_DEBUG_ASSERT( ptr_pm );
 				// check: paranoid check
 				DCS_DEBUG_ASSERT( ptr_vm );
 
-				if (ptr_vm->vmm().hosting_machine().id() != ptr_pm->id())
-				{
-					++num_migrs;
-				}
-
 				// Power-off and displace
 				ptr_dc_->displace_virtual_machine(ptr_vm, true);
 			}
 
+			// Update shares
+			vm_placement_iterator_container const* resized_vms[] = {&shrunk_vms, &grown_vms};
+			for (::std::size_t k = 0; k < sizeof(resized_vms)/sizeof(resized_vms[0]); ++k)
+			{
+				vm_placement_iterator_iterator resized_end_it(resized_vms[k]->end());
+				for (vm_placement_iterator_iterator resized_it = resized_vms[k]->begin(); resized_it != resized_end_it; ++resized_it)
+				{
+					vm_pointer ptr_vm(ptr_dc_->virtual_machine_ptr(placement.vm_id(*resized_it)));
+
+					// check: paranoid check
+					DCS_DEBUG_ASSERT( ptr_vm );
+
+					ptr_dc_->update_virtual_machine_shares(ptr_vm, placement.shares_begin(*resized_it), placement.shares_end(*resized_it));
+				}
+			}
+
 			// Place
-			for (vm_placement_iterator pm_vm_it = placement.begin(); pm_vm_it != pm_vm_end_it; ++pm_vm_it)
+			for (vm_placement_iterator_iterator moved_it = moved_vms.begin(); moved_it != moved_end_it; ++moved_it)
 			{
-				pm_pointer ptr_pm(ptr_dc_->physical_machine_ptr(placement.pm_id(pm_vm_it)));
-				vm_pointer ptr_vm(ptr_dc_->virtual_machine_ptr(placement.vm_id(pm_vm_it)));
+				pm_pointer ptr_pm(ptr_dc_->physical_machine_ptr(placement.pm_id(*moved_it)));
+				vm_pointer ptr_vm(ptr_dc_->virtual_machine_ptr(placement.vm_id(*moved_it)));
 
 				// check: paranoid check
 				DCS_DEBUG_ASSERT( ptr_pm );
 				// check: paranoid check
 				DCS_DEBUG_ASSERT( ptr_vm );
 
-				ptr_dc_->place_virtual_machine(ptr_vm, ptr_pm, placement.shares_begin(pm_vm_it), placement.shares_end(pm_vm_it));
+				ptr_dc_->place_virtual_machine(ptr_vm, ptr_pm, placement.shares_begin(*moved_it), placement.shares_end(*moved_it));
 				ptr_pm->vmm().power_on(ptr_vm);
-
-				if (inactive_pms.count(ptr_pm->id()) > 0)
-				{
-					inactive_pms.erase(ptr_pm->id());
-				}
-				inactive_vms.erase(ptr_vm->id());
 			}
 		}
 
@@ -587,6 +690,12 @@ class base_migration_controller: public ::dcs::des::entity
 	}
 
 
+	protected: virtual void do_wait_background_work()
+	{
+		// empty
+	}
+
+
 	protected: virtual void do_enable(bool flag)
 	{
 		ptr_control_evt_src_->enable(flag);
@@ -626,7 +735,7 @@ class base_migration_controller: public ::dcs::des::entity
 #ifdef DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
 	protected: struct vm_share_observer: public share_observer<traits_type>
 	{
-		typedef ::std::map<physical_resource_category,real_type> share_container;
+		typedef resource_vector<real_type> share_container;
 
 		static const real_type smooth_factor;
 
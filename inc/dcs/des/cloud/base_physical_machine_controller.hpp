@@ -35,7 +35,6 @@
 #include <dcs/functional/bind.hpp>
 #include <dcs/macro.hpp>
 #include <dcs/memory.hpp>
-#include <string>
 
 
 namespace dcs { namespace des { namespace cloud {
@@ -53,19 +52,14 @@ class base_physical_machine_controller: public ::dcs::des::entity
 	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::engine_context_type des_engine_context_type;
 	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::event_type des_event_type;
 	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::event_source_type des_event_source_type;
-	public: typedef ::dcs::shared_ptr<des_event_source_type> des_event_source_pointer;
 	private: typedef registry<traits_type> registry_type;
 
 
-	private: static const ::std::string control_event_source_name;
-
-
 	/// A constructor.
 	protected: base_physical_machine_controller()
 	: ptr_mach_(),
-	  ts_(0),
+	  ts_(0)
 //	  passive_(false),
-	  ptr_control_evt_src_(/*new des_event_source_type(control_event_source_name)*/)
 	{
 		init();
 	}
@@ -74,9 +68,8 @@ class base_physical_machine_controller: public ::dcs::des::entity
 	/// A constructor.
 	protected: explicit base_physical_machine_controller(physical_machine_pointer const& ptr_mach, real_type ts)
 	: ptr_mach_(ptr_mach),
-	  ts_(ts),
+	  ts_(ts)
 //	  passive_(false),
-	  ptr_control_evt_src_(/*new des_event_source_type(control_event_source_name)*/)
 	{
 		init();
 	}
@@ -85,9 +78,8 @@ class base_physical_machine_controller: public ::dcs::des::entity
 	/// Copy constructor.
 	public: base_physical_machine_controller(base_physical_machine_controller const& that)
 	: ptr_mach_(that.ptr_mach_),
-	  ts_(that.ts_),
+	  ts_(that.ts_)
 //	  passive_(that.passive_)
-	  ptr_control_evt_src_(that.ptr_control_evt_src_ ? new des_event_source_type(*that.ptr_control_evt_src_) : new des_event_source_type(control_event_source_name))
 	{
 		init();
 	}
@@ -103,14 +95,6 @@ class base_physical_machine_controller: public ::dcs::des::entity
 			ptr_mach_ = rhs.ptr_mach_;
 			ts_ = rhs.ts_;
 //			passive_ = rhs.passive;
-			if (rhs.ptr_control_evt_src_)
-			{
-				ptr_control_evt_src_ = ::dcs::make_shared<des_event_source_type>(*(rhs.ptr_control_evt_src_));
-			}
-			else
-			{
-				ptr_control_evt_src_ = ::dcs::make_shared<des_event_source_type>(control_event_source_name);
-			}
 
 			init();
 		}
@@ -152,9 +136,10 @@ class base_physical_machine_controller: public ::dcs::des::entity
 	}
 
 
+	/// The control event source, shared by all the controllers with the same sampling time.
 	public: des_event_source_type const& control_event_source() const
 	{
-		return *ptr_control_evt_src_;
+		return registry_type::instance().control_tick_scheduler().control_event_source(ts_);
 	}
 
 
@@ -222,12 +207,10 @@ class base_physical_machine_controller: public ::dcs::des::entity
 	{
 		if (ts_ > 0)
 		{
-			if (!ptr_control_evt_src_)
-			{
-				ptr_control_evt_src_ = ::dcs::make_shared<des_event_source_type>();
-			}
+			registry_type& reg(registry_type::instance());
 
-			ptr_control_evt_src_->connect(
+			reg.control_tick_scheduler().connect(
+				ts_,
 				::dcs::functional::bind(
 					&self_type::process_control,
 					this,
@@ -236,8 +219,6 @@ class base_physical_machine_controller: public ::dcs::des::entity
 				)
 			);
 
-			registry_type& reg(registry_type::instance());
-
 			reg.des_engine_ptr()->system_initialization_event_source().connect(
 				::dcs::functional::bind(
 					&self_type::process_sys_init,
@@ -254,20 +235,18 @@ class base_physical_machine_controller: public ::dcs::des::entity
 	{
 		if (ts_ > 0)
 		{
-			if (ptr_control_evt_src_)
-			{
-				ptr_control_evt_src_->disconnect(
-					::dcs::functional::bind(
-						&self_type::process_control,
-						this,
-						::dcs::functional::placeholders::_1,
-						::dcs::functional::placeholders::_2
-					)
-				);
-			}
-
 			registry_type& reg(registry_type::instance());
 
+			reg.control_tick_scheduler().disconnect(
+				ts_,
+				::dcs::functional::bind(
+					&self_type::process_control,
+					this,
+					::dcs::functional::placeholders::_1,
+					::dcs::functional::placeholders::_2
+				)
+			);
+
 			reg.des_engine_ptr()->system_initialization_event_source().disconnect(
 				::dcs::functional::bind(
 					&self_type::process_sys_init,
@@ -282,18 +261,9 @@ class base_physical_machine_controller: public ::dcs::des::entity
 
 	//@{ Event Triggers
 
+	/// Control events are scheduled by the control tick scheduler (see registry).
 	private: void schedule_control()
 	{
-		if (ts_ > 0)
-		{
-			registry_type& reg(registry_type::instance());
-
-			reg.des_engine_ptr()->schedule_event(
-				ptr_control_evt_src_,
-				reg.des_engine_ptr()->simulated_time() + ts_
-			);
-		}
-
 		do_schedule_control();
 	}
 
@@ -319,13 +289,17 @@ class base_physical_machine_controller: public ::dcs::des::entity
 		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( evt );
 		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( ctx );
 
-		DCS_DEBUG_TRACE("(" << this << ") BEGIN Processing CONTROL (Clock: " << ctx.simulated_time() << ")");//XXX
-
-		if (this->enabled())
+		// The control tick is shared with the other controllers with the same
+		// sampling time, hence skip it when disabled.
+		if (!this->enabled())
 		{
-			schedule_control();
+			return;
 		}
 
+		DCS_DEBUG_TRACE("(" << this << ") BEGIN Processing CONTROL (Clock: " << ctx.simulated_time() << ")");//XXX
+
+		schedule_control();
+
 //		do_process_control(evt, ctx);
 		control();
 
@@ -362,8 +336,6 @@ class base_physical_machine_controller: public ::dcs::des::entity
 
 	protected: virtual void do_enable(bool flag)
 	{
-		ptr_control_evt_src_->enable(flag);
-
 		if (flag && !this->enabled())
 		{
 			schedule_control();
@@ -382,12 +354,8 @@ class base_physical_machine_controller: public ::dcs::des::entity
 	private: physical_machine_pointer ptr_mach_;
 	private: real_type ts_;
 //	private: bool passive_;
-	private: des_event_source_pointer ptr_control_evt_src_;
 };
 
-template <typename TraitsT>
-const ::std::string base_physical_machine_controller<TraitsT>::control_event_source_name("Control Machine");
-
 }}} // Namespace dcs::des::cloud
 
 
@@ -0,0 +1,363 @@
+/**
+ * \file dcs/des/cloud/batch_means_statistic.hpp
+ *
+ * \brief Output statistic estimated by the method of batch means.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_BATCH_MEANS_STATISTIC_HPP
+#define DCS_DES_CLOUD_BATCH_MEANS_STATISTIC_HPP
+
+
+#include <boost/math/distributions/students_t.hpp>
+#include <cmath>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/des/base_statistic.hpp>
+#include <dcs/des/statistic_categories.hpp>
+#include <dcs/memory.hpp>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace cloud {
+
+/**
+ * \brief Output statistic estimated by the method of batch means.
+ *
+ * A single long run is split, after a warm-up period, into \c num_batches
+ * consecutive batches of \c batch_duration simulated time units each.
+ * Observations are fed to a per-batch copy of the wrapped statistic; the
+ * point estimate is the mean of the per-batch estimates and the confidence
+ * interval is the Student's t interval over them, as if each batch were an
+ * independent replication.
+ *
+ * Observations collected during the warm-up period are discarded, while the
+ * ones collected after the end of the last batch are assigned to the last
+ * batch.
+ * Statistics observed once per run (e.g., the consumed energy of a machine
+ * or the number of VM migrations) cannot be estimated this way and are not
+ * wrapped by this class.
+ *
+ * \tparam StatisticT The type of the statistic estimated in each batch.
+ * \tparam DesEngineT The type of the DES engine providing the simulated time.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename StatisticT, typename DesEngineT>
+class batch_means_statistic: public ::dcs::des::base_statistic<typename StatisticT::value_type, typename StatisticT::uint_type>
+{
+	private: typedef ::dcs::des::base_statistic<typename StatisticT::value_type, typename StatisticT::uint_type> base_type;
+	public: typedef StatisticT statistic_type;
+	public: typedef DesEngineT des_engine_type;
+	public: typedef ::dcs::shared_ptr<des_engine_type> des_engine_pointer;
+	public: typedef typename base_type::value_type value_type;
+	public: typedef typename base_type::uint_type uint_type;
+	private: typedef ::std::size_t size_type;
+
+
+	public: batch_means_statistic(statistic_type const& stat,
+								  des_engine_pointer const& ptr_engine,
+								  value_type warmup_duration,
+								  value_type batch_duration,
+								  uint_type num_batches,
+								  value_type confidence_level)
+	: stat_(stat),
+	  ptr_eng_(ptr_engine),
+	  warmup_len_(warmup_duration),
+	  batch_len_(batch_duration),
+	  max_num_batches_(num_batches),
+	  conf_level_(confidence_level),
+	  cur_batch_(0),
+	  last_pushed_(false),
+	  num_obs_(0)
+	{
+		// pre: ptr_engine is a valid pointer
+		DCS_ASSERT(
+				ptr_eng_,
+				throw ::std::invalid_argument("[dcs::des::cloud::batch_means_statistic::ctor] Invalid DES engine.")
+			);
+		// pre: warmup_duration >= 0
+		DCS_ASSERT(
+				warmup_len_ >= 0,
+				throw ::std::invalid_argument("[dcs::des::cloud::batch_means_statistic::ctor] Negative warm-up duration.")
+			);
+		// pre: batch_duration > 0
+		DCS_ASSERT(
+				batch_len_ > 0,
+				throw ::std::invalid_argument("[dcs::des::cloud::batch_means_statistic::ctor] Non-positive batch duration.")
+			);
+		// pre: num_batches > 0
+		DCS_ASSERT(
+				max_num_batches_ > 0,
+				throw ::std::invalid_argument("[dcs::des::cloud::batch_means_statistic::ctor] Invalid number of batches.")
+			);
+
+		stat_.reset();
+	}
+
+
+	/// Return the number of completed batches (at the current simulated time).
+	public: uint_type num_batches() const
+	{
+		close_batches(ptr_eng_->simulated_time());
+
+		return batch_estimates_.size();
+	}
+
+
+	/// Return the estimate of the given completed batch.
+	public: value_type batch_estimate(uint_type i) const
+	{
+		close_batches(ptr_eng_->simulated_time());
+
+		// pre: i < num_batches()
+		DCS_ASSERT(
+				i < batch_estimates_.size(),
+				throw ::std::invalid_argument("[dcs::des::cloud::batch_means_statistic::batch_estimate] Batch out of range.")
+			);
+
+		return batch_estimates_[i];
+	}
+
+
+	/// Return the index of the batch including time \a t (\c max_num_batches_ if in the warm-up period).
+	private: uint_type batch_of(value_type t) const
+	{
+		if (t < warmup_len_)
+		{
+			return max_num_batches_;
+		}
+
+		value_type k(::std::floor((t-warmup_len_)/batch_len_));
+
+		return k < static_cast<value_type>(max_num_batches_-1) ? static_cast<uint_type>(k) : (max_num_batches_-1);
+	}
+
+
+	/// Close the batches ended before time \a t.
+	private: void close_batches(value_type t) const
+	{
+		if (t < warmup_len_)
+		{
+			return;
+		}
+
+		value_type end_time(warmup_len_+batch_len_*(cur_batch_+1));
+
+		while (cur_batch_ < max_num_batches_ && t >= end_time)
+		{
+			// Empty batches carry no information
+			last_pushed_ = stat_.num_observations() > 0;
+			if (last_pushed_)
+			{
+				batch_estimates_.push_back(stat_.estimate());
+			}
+			++cur_batch_;
+			end_time += batch_len_;
+			// The last batch is kept, since it may be reopened by late observations
+			if (cur_batch_ < max_num_batches_)
+			{
+				stat_.reset();
+			}
+		}
+	}
+
+
+	private: void do_collect(value_type obs, value_type weight)
+	{
+		value_type t(ptr_eng_->simulated_time());
+
+		uint_type k(batch_of(t));
+
+		if (k == max_num_batches_)
+		{
+			// Warm-up period
+			return;
+		}
+
+		if (k > cur_batch_)
+		{
+			close_batches(t);
+		}
+		else if (cur_batch_ == max_num_batches_)
+		{
+			// Late observation: reopen the last batch
+			if (last_pushed_)
+			{
+				batch_estimates_.pop_back();
+			}
+			--cur_batch_;
+		}
+
+		stat_(obs, weight);
+		++num_obs_;
+	}
+
+
+	private: ::dcs::des::statistic_category do_category() const
+	{
+		return stat_.category();
+	}
+
+
+	private: value_type do_estimate() const
+	{
+		close_batches(ptr_eng_->simulated_time());
+
+		size_type n(batch_estimates_.size());
+
+		if (n == 0)
+		{
+			return ::std::numeric_limits<value_type>::quiet_NaN();
+		}
+
+		value_type sum(0);
+		for (size_type i = 0; i < n; ++i)
+		{
+			sum += batch_estimates_[i];
+		}
+
+		return sum/static_cast<value_type>(n);
+	}
+
+
+	/// The sample variance of the batch estimates.
+	private: value_type do_variance() const
+	{
+		close_batches(ptr_eng_->simulated_time());
+
+		size_type n(batch_estimates_.size());
+
+		if (n < 2)
+		{
+			return ::std::numeric_limits<value_type>::infinity();
+		}
+
+		value_type mean(do_estimate());
+		value_type ss(0);
+		for (size_type i = 0; i < n; ++i)
+		{
+			value_type d(batch_estimates_[i]-mean);
+			ss += d*d;
+		}
+
+		return ss/static_cast<value_type>(n-1);
+	}
+
+
+	private: value_type do_standard_deviation() const
+	{
+		return ::std::sqrt(do_variance());
+	}
+
+
+	private: value_type do_half_width() const
+	{
+		close_batches(ptr_eng_->simulated_time());
+
+		size_type n(batch_estimates_.size());
+
+		if (n < 2)
+		{
+			return ::std::numeric_limits<value_type>::infinity();
+		}
+
+		::boost::math::students_t_distribution<value_type> dist(n-1);
+		value_type t(::boost::math::quantile(::boost::math::complement(dist, (1-conf_level_)/value_type(2))));
+
+		return t*do_standard_deviation()/::std::sqrt(static_cast<value_type>(n));
+	}
+
+
+	private: value_type do_lower() const
+	{
+		return do_estimate()-do_half_width();
+	}
+
+
+	private: value_type do_upper() const
+	{
+		return do_estimate()+do_half_width();
+	}
+
+
+	private: value_type do_relative_precision() const
+	{
+		return do_half_width()/::std::abs(do_estimate());
+	}
+
+
+	private: value_type do_confidence_level() const
+	{
+		return conf_level_;
+	}
+
+
+	private: uint_type do_num_observations() const
+	{
+		return num_obs_;
+	}
+
+
+	private: void do_reset()
+	{
+		stat_.reset();
+		batch_estimates_.clear();
+		cur_batch_ = 0;
+		last_pushed_ = false;
+		num_obs_ = 0;
+	}
+
+
+	private: ::std::string do_name() const
+	{
+		return stat_.name();
+	}
+
+
+	/// The statistic of the current batch.
+	private: mutable statistic_type stat_;
+	/// The DES engine providing the simulated time.
+	private: des_engine_pointer ptr_eng_;
+	/// The duration of the warm-up period.
+	private: value_type warmup_len_;
+	/// The duration of each batch.
+	private: value_type batch_len_;
+	/// The number of batches.
+	private: uint_type max_num_batches_;
+	/// The level of the confidence interval.
+	private: value_type conf_level_;
+	/// The index of the current batch.
+	private: mutable uint_type cur_batch_;
+	/// Tell if the last closed batch has an estimate.
+	private: mutable bool last_pushed_;
+	/// The estimates of the completed batches.
+	private: mutable ::std::vector<value_type> batch_estimates_;
+	/// The number of collected (non warm-up) observations.
+	private: uint_type num_obs_;
+}; // batch_means_statistic
+
+}}} // Namespace dcs::des::cloud
+
+
+#endif // DCS_DES_CLOUD_BATCH_MEANS_STATISTIC_HPP
@@ -29,9 +29,11 @@
 #include <dcs/debug.hpp>
 #include <dcs/des/cloud/base_incremental_placement_strategy.hpp>
 #include <dcs/des/cloud/data_center.hpp>
+#include <dcs/des/cloud/detail/physical_machine_fit_index.hpp>
 #include <dcs/des/cloud/detail/placement_strategy_utility.hpp>
 #include <dcs/des/cloud/performance_measure_category.hpp>
 #include <dcs/des/cloud/physical_resource_category.hpp>
+#include <dcs/des/cloud/resource_vector.hpp>
 #include <dcs/des/cloud/utility.hpp>
 #include <dcs/des/cloud/virtual_machines_placement.hpp>
 #include <map>
@@ -60,8 +62,7 @@ class best_fit_decreasing_incremental_placement_strategy: public base_incrementa
 		typedef typename data_center_type::virtual_machine_pointer vm_pointer;
 		typedef typename data_center_type::virtual_machines_placement_type vms_placement_type;
 		typedef typename pm_type::identifier_type pm_identifier_type;
-		typedef ::std::vector<pm_pointer> pm_container;
-		typedef typename pm_container::const_iterator pm_iterator;
+		typedef typename detail::physical_machine_fit_index<traits_type>::size_type pm_index_size_type;
 		typedef typename vm_container::const_iterator vm_iterator;
 		typedef typename application_type::application_tier_type application_tier_type;
 //		typedef typename application_tier_type::resource_share_type share_type;
@@ -69,9 +70,9 @@ class best_fit_decreasing_incremental_placement_strategy: public base_incrementa
 //		typedef typename share_container::const_iterator share_iterator;
 //		typedef ::std::map<physical_resource_category,real_type> resource_share_map;
         typedef typename application_tier_type::resource_share_container ref_share_container;
-        typedef ::std::map<physical_resource_category,real_type> share_container;
+        typedef resource_vector<real_type> share_container;
         typedef typename share_container::const_iterator share_iterator;
-		typedef ::std::map<physical_resource_category,real_type> resource_utilization_map;
+		typedef resource_vector<real_type> resource_utilization_map;
 		typedef typename application_type::reference_physical_resource_type ref_resource_type;
 		typedef typename application_type::reference_physical_resource_container ref_resource_container;
 		typedef typename ref_resource_container::const_iterator ref_resource_iterator;
@@ -85,42 +86,8 @@ class best_fit_decreasing_incremental_placement_strategy: public base_incrementa
 		//::std::sort(sorted_pms.begin(),
 		//			sorted_pms.end(),
 		//			detail::ptr_physical_machine_less_comparator<pm_type>());
-		pm_container sorted_pms;
-		pm_container pms;
-		pms = dc.physical_machines(powered_on_power_status);
-		if (!pms.empty())
-		{
-			::std::sort(pms.begin(),
-						pms.end(),
-						detail::ptr_physical_machine_greater_by_id_comparator<pm_type>());
-			::std::sort(pms.begin(),
-						pms.end(),
-						detail::ptr_physical_machine_greater_comparator<pm_type>());
-			sorted_pms.insert(sorted_pms.end(), pms.begin(), pms.end());
-		}
-		pms = dc.physical_machines(suspended_power_status);
-		if (!pms.empty())
-		{
-			::std::sort(pms.begin(),
-						pms.end(),
-						detail::ptr_physical_machine_greater_by_id_comparator<pm_type>());
-			::std::sort(pms.begin(),
-						pms.end(),
-						detail::ptr_physical_machine_greater_comparator<pm_type>());
-			sorted_pms.insert(sorted_pms.end(), pms.begin(), pms.end());
-		}
-		pms = dc.physical_machines(powered_off_power_status);
-		if (!pms.empty())
-		{
-			::std::sort(pms.begin(),
-						pms.end(),
-						detail::ptr_physical_machine_greater_by_id_comparator<pm_type>());
-			::std::sort(pms.begin(),
-						pms.end(),
-						detail::ptr_physical_machine_greater_comparator<pm_type>());
-			sorted_pms.insert(sorted_pms.end(), pms.begin(), pms.end());
-		}
-		pms.clear();
+		// Physical machines are indexed by power state and capacity, so that
+		// they need not be sorted here (see physical_machine_fit_index).
 
 		// Sort virtual machines according to their shares
 		vm_container sorted_vms(vms);
@@ -133,10 +100,11 @@ class best_fit_decreasing_incremental_placement_strategy: public base_incrementa
 
 DCS_DEBUG_TRACE("BEGIN Incremental Placement");//XXX
 ::std::cerr << "[best_fit_decreasing_incremental_placement] BEGIN Incremental Placement" << ::std::endl;//XXX
-DCS_DEBUG_TRACE("#Machines: " << sorted_pms.size());//XXX
+DCS_DEBUG_TRACE("#Machines: " << dc.physical_machines_by_capacity().size());//XXX
 DCS_DEBUG_TRACE("#VMs: " << sorted_vms.size());//XXX
 
 		vms_placement_type deployment(dc.current_virtual_machines_placement());
+		detail::physical_machine_fit_index<traits_type> pm_index(dc, deployment, false);
 
 		vm_iterator vm_end_it(sorted_vms.end());
 		for (vm_iterator vm_it = sorted_vms.begin(); vm_it != vm_end_it; ++vm_it)
@@ -163,11 +131,26 @@ DCS_DEBUG_TRACE("#VMs: " << sorted_vms.size());//XXX
 			// until a suitable machine (i.e., a machine with sufficient free
 			// capacity) is found.
 			bool placed(false);
-			pm_iterator pm_end_it(sorted_pms.end());
 			share_iterator ref_share_end_it(ref_shares.end());
-			for (pm_iterator pm_it = sorted_pms.begin(); pm_it != pm_end_it && !placed; ++pm_it)
+
+			// The (absolute) CPU capacity needed by this VM, used to skip
+			// physical machines without enough free capacity.
+			real_type wanted_capacity(0);
+			if (ref_shares.count(cpu_resource_category) > 0)
+			{
+				real_type ref_share(ref_shares.at(cpu_resource_category));
+				if (this->reference_share_penalty() > 0)
+				{
+					ref_share -= ref_share*this->reference_share_penalty();
+				}
+				wanted_capacity = ref_share*app.reference_resource(cpu_resource_category).capacity();
+			}
+
+			for (pm_index_size_type pos = pm_index.find_first(wanted_capacity);
+				 pos < pm_index.size() && !placed;
+				 pos = pm_index.find_first(wanted_capacity, pos+1))
 			{
-				pm_pointer ptr_pm(*pm_it);
+				pm_pointer ptr_pm(pm_index.physical_machine_ptr(pos));
 
 				// paranoid-check: valid pointer
 				DCS_DEBUG_ASSERT( ptr_pm );
@@ -244,6 +227,10 @@ DCS_DEBUG_TRACE("#VMs: " << sorted_vms.size());//XXX
 											  utils.begin(),
 											  utils.end(),
 											  dc);
+				if (placed)
+				{
+					pm_index.update(ptr_pm->id(), deployment);
+				}
 DCS_DEBUG_TRACE("Placed: VM(" << ptr_vm->id() << ") -> PM(" << ptr_pm->id() << ") ==> OK? " <<  std::boolalpha << placed);///XXX
 ::std::cerr << "[best_fit_decreasing_incremental_placement] Placed: VM(" << ptr_vm->id() << ") -> PM(" << ptr_pm->id() << ") with SHARE: " << shares.at(cpu_resource_category) << " ==> OK? " <<  std::boolalpha << placed << ::std::endl;///XXX
 			}
@@ -324,6 +311,10 @@ DCS_DEBUG_TRACE("Placed: VM(" << ptr_vm->id() << ") -> PM(" << ptr_pm->id() << "
 												  *ptr_pm,
 												  max_pm_shares.begin(),
 												  max_pm_shares.end());
+					if (placed)
+					{
+						pm_index.update(ptr_pm->id(), deployment);
+					}
 	DCS_DEBUG_TRACE("Placed: VM(" << ptr_vm->id() << ") -> PM(" << ptr_pm->id() << ") ==> OK? " <<  std::boolalpha << placed);///XXX
 	::std::cerr << "[best_fit_decreasing_incremental_placement] Placed: VM(" << ptr_vm->id() << ") -> PM(" << ptr_pm->id() << ") with SHARE: " << max_pm_shares.at(cpu_resource_category) << " ==> OK? " <<  std::boolalpha << placed << ::std::endl;///XXX
 				}
@@ -32,6 +32,7 @@
 #include <dcs/des/cloud/detail/placement_strategy_utility.hpp>
 #include <dcs/des/cloud/performance_measure_category.hpp>
 #include <dcs/des/cloud/physical_resource_category.hpp>
+#include <dcs/des/cloud/resource_vector.hpp>
 #include <dcs/des/cloud/utility.hpp>
 #include <dcs/des/cloud/virtual_machines_placement.hpp>
 #include <map>
@@ -65,10 +66,10 @@ class best_fit_decreasing_initial_placement_strategy: public base_initial_placem
 //		typedef ::std::pair<physical_resource_category,real_type> share_type;
 //		typedef ::std::vector<share_type> share_container;
 		typedef typename application_tier_type::resource_share_container ref_share_container;
-		typedef ::std::map<physical_resource_category,real_type> share_container;
+		typedef resource_vector<real_type> share_container;
 		typedef typename share_container::const_iterator share_iterator;
 		typedef typename application_type::reference_physical_resource_type ref_resource_type;
-		typedef ::std::map<physical_resource_category,real_type> resource_utilization_map;
+		typedef resource_vector<real_type> resource_utilization_map;
 		typedef typename application_type::reference_physical_resource_container ref_resource_container;
 		typedef typename ref_resource_container::const_iterator ref_resource_iterator;
 
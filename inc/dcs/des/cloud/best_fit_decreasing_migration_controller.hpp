@@ -27,6 +27,7 @@
 
 
 #include <algorithm>
+#include <cstddef>
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
 #include <dcs/des/base_statistic.hpp>
@@ -34,16 +35,23 @@
 #include <dcs/des/mean_estimator.hpp>
 #include <dcs/des/statistic_categories.hpp>
 #include <dcs/des/cloud/base_migration_controller.hpp>
+#include <dcs/des/cloud/detail/cold_machine_drain.hpp>
+#include <dcs/des/cloud/detail/physical_machine_fit_index.hpp>
 #include <dcs/des/cloud/detail/placement_strategy_utility.hpp>
 #include <dcs/des/cloud/logging.hpp>
 #include <dcs/des/cloud/physical_resource_category.hpp>
 #include <dcs/des/cloud/power_status.hpp>
+#include <dcs/des/cloud/resource_vector.hpp>
 #include <dcs/exception.hpp>
 #include <dcs/macro.hpp>
 #include <dcs/memory.hpp>
+#include <functional>
 #include <limits>
 #include <map>
+#include <set>
+#include <sstream>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 
@@ -65,17 +73,65 @@ class best_fit_decreasing_migration_controller: public base_migration_controller
 	private: typedef ::dcs::des::mean_estimator<real_type,uint_type> statistic_impl_type;
 	private: typedef ::dcs::shared_ptr<statistic_type> statistic_pointer;
 	private: typedef typename traits_type::virtual_machine_identifier_type virtual_machine_identifier_type;
-	private: typedef ::std::map<physical_resource_category,real_type> resource_utilization_map;
+	private: typedef resource_vector<real_type> resource_utilization_map;
 	private: typedef ::std::map<virtual_machine_identifier_type,resource_utilization_map> virtual_machine_utilization_map;
+	private: typedef typename base_type::data_center_type data_center_type;
+	private: typedef typename data_center_type::physical_machine_pointer physical_machine_pointer;
+	private: typedef typename data_center_type::virtual_machine_pointer virtual_machine_pointer;
+	private: typedef typename traits_type::physical_machine_identifier_type physical_machine_identifier_type;
+	private: typedef ::std::set<physical_machine_identifier_type> physical_machine_identifier_set;
+	private: typedef resource_vector<real_type> resource_share_map;
+#ifdef DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
+	private: typedef typename base_type::vm_share_observer::share_container share_container;
+#else // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
+	private: typedef resource_share_map share_container;
+#endif // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
+	private: typedef typename base_type::virtual_machines_placement_type virtual_machines_placement_type;
+	private: typedef detail::physical_machine_fit_index<traits_type> physical_machine_index_type;
+	/// Places VMs by best-fit on behalf of detail::drain_physical_machine.
+	private: struct best_fit_placer
+	{
+		best_fit_placer(best_fit_decreasing_migration_controller const* ptr_ctrl_, data_center_type const& dc_)
+		: ptr_ctrl(ptr_ctrl_),
+		  ptr_dc(&dc_)
+		{
+		}
+
+		real_type wanted_capacity(virtual_machine_pointer const& ptr_vm) const
+		{
+			share_container ref_shares;
+			share_container obs_shares;
+			ptr_ctrl->retrieve_shares(ptr_vm, ref_shares, obs_shares);
+
+			return ptr_ctrl->wanted_capacity(ptr_vm, obs_shares);
+		}
+
+		bool try_place(virtual_machine_pointer const& ptr_vm, physical_machine_pointer const& ptr_pm, virtual_machines_placement_type& deployment) const
+		{
+			share_container ref_shares;
+			share_container obs_shares;
+			ptr_ctrl->retrieve_shares(ptr_vm, ref_shares, obs_shares);
+
+			return ptr_ctrl->try_place(ptr_vm, obs_shares, ref_shares, ptr_pm, *ptr_dc, deployment);
+		}
+
+		best_fit_decreasing_migration_controller const* ptr_ctrl;
+		data_center_type const* ptr_dc;
+	};
 
 
 	private: static const ::dcs::des::statistic_category utilization_statistic_category = ::dcs::des::mean_statistic;
 	public: static const real_type default_ewma_smoothing_factor;
+	public: static const real_type default_hot_threshold;
+	public: static const real_type default_cold_threshold;
 
 
 	public: best_fit_decreasing_migration_controller()
 	: base_type(),
 	  ewma_smooth_(default_ewma_smoothing_factor),
+	  incremental_(false),
+	  hot_threshold_(default_hot_threshold),
+	  cold_threshold_(default_cold_threshold),
 	  count_(0),
 	  fail_count_(0),
 	  migr_count_(0),
@@ -94,6 +150,9 @@ class best_fit_decreasing_migration_controller: public base_migration_controller
 													 real_type smooth_factor = default_ewma_smoothing_factor)
 	: base_type(ptr_dc, ts),
 	  ewma_smooth_(smooth_factor),
+	  incremental_(false),
+	  hot_threshold_(default_hot_threshold),
+	  cold_threshold_(default_cold_threshold),
 	  count_(0),
 	  fail_count_(0),
 	  migr_count_(0),
@@ -132,6 +191,57 @@ class best_fit_decreasing_migration_controller: public base_migration_controller
 //	}
 
 
+	/// Tells whether only the VMs of hot and cold machines have to be moved.
+	public: void incremental(bool value)
+	{
+		incremental_ = value;
+	}
+
+
+	public: bool incremental() const
+	{
+		return incremental_;
+	}
+
+
+	/// Sets the fraction of the machine utilization threshold above which a machine is hot.
+	public: void hot_threshold(real_type value)
+	{
+		// pre: value > 0
+		DCS_ASSERT(
+			value > 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::best_fit_decreasing_migration_controller::hot_threshold] Invalid threshold.")
+		);
+
+		hot_threshold_ = value;
+	}
+
+
+	public: real_type hot_threshold() const
+	{
+		return hot_threshold_;
+	}
+
+
+	/// Sets the fraction of the machine utilization threshold below which a machine is cold.
+	public: void cold_threshold(real_type value)
+	{
+		// pre: value >= 0
+		DCS_ASSERT(
+			value >= 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::best_fit_decreasing_migration_controller::cold_threshold] Invalid threshold.")
+		);
+
+		cold_threshold_ = value;
+	}
+
+
+	public: real_type cold_threshold() const
+	{
+		return cold_threshold_;
+	}
+
+
 	//@{ Interface Member Functions
 
 //	protected: void do_controlled_data_center(data_center_pointer const& ptr_data_center)
@@ -195,103 +305,59 @@ class best_fit_decreasing_migration_controller: public base_migration_controller
 		DCS_DEBUG_TRACE("(" << this << ") BEGIN Do Process CONTROL event (Clock: " << ctx.simulated_time() << " - Count: " << count_ << " - Fail-Count: " << fail_count_ << ")");
 ::std::cerr << "[bfd_migration_controller] (" << this << ") BEGIN Do Process CONTROL event (Clock: " << ctx.simulated_time() << " - Count: " << count_ << " - Fail-Count: " << fail_count_ << ")" << ::std::endl;///XXX
 
-		typedef typename base_type::data_center_type data_center_type;
-		typedef typename data_center_type::application_type application_type; 
-		typedef typename data_center_type::physical_machine_type pm_type;
-		typedef typename data_center_type::physical_machine_pointer pm_pointer;
-		typedef typename data_center_type::virtual_machine_type vm_type;
-		typedef typename data_center_type::virtual_machine_pointer vm_pointer;
-		typedef typename pm_type::identifier_type pm_identifier_type;
-		typedef typename vm_type::identifier_type vm_identifier_type;
-		typedef typename application_type::application_tier_type application_tier_type;
-		typedef ::std::vector<pm_pointer> pm_container;
-		typedef ::std::vector<vm_pointer> vm_container;
-		typedef typename pm_container::const_iterator pm_iterator;
-		typedef typename vm_container::const_iterator vm_iterator;
-		typedef ::std::map<physical_resource_category,real_type> resource_share_map;
-		typedef ::std::map<physical_resource_category,real_type> resource_utilization_map;
-		typedef typename base_type::virtual_machines_placement_type virtual_machines_placement_type;
-		typedef typename application_type::reference_physical_resource_type ref_resource_type;
-		typedef typename application_type::reference_physical_resource_container ref_resource_container;
-		typedef typename ref_resource_container::const_iterator ref_resource_iterator;
-//		typedef ::std::pair<physical_resource_category,real_type> share_type;
-//		typedef ::std::vector<share_type> share_container;
-		typedef typename application_tier_type::resource_share_type share_type;
-		typedef typename application_tier_type::resource_share_container ref_share_container;
-#ifdef DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
-		typedef typename base_type::vm_share_observer::share_container share_container;
-#else // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
-		typedef resource_share_map share_container;
-#endif // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
-		typedef typename share_container::const_iterator share_iterator;
-
 		++count_;
 
 		data_center_type& dc(this->controlled_data_center());
 
-		pm_container sorted_pms;
-		pm_container pms;
-		pms = dc.physical_machines(powered_on_power_status);
-		if (!pms.empty())
+		if (incremental_)
 		{
-			::std::sort(pms.begin(),
-						pms.end(),
-						detail::ptr_physical_machine_greater_by_id_comparator<pm_type>());
-			::std::sort(pms.begin(),
-						pms.end(),
-						detail::ptr_physical_machine_greater_comparator<pm_type>());
-			sorted_pms.insert(sorted_pms.end(), pms.begin(), pms.end());
+			process_control_incrementally(dc);
 		}
-		pms = dc.physical_machines(suspended_power_status);
-		if (!pms.empty())
-		{
-			::std::sort(pms.begin(),
-						pms.end(),
-						detail::ptr_physical_machine_greater_by_id_comparator<pm_type>());
-			::std::sort(pms.begin(),
-						pms.end(),
-						detail::ptr_physical_machine_greater_comparator<pm_type>());
-			sorted_pms.insert(sorted_pms.end(), pms.begin(), pms.end());
-		}
-		pms = dc.physical_machines(powered_off_power_status);
-		if (!pms.empty())
+		else
 		{
-			::std::sort(pms.begin(),
-						pms.end(),
-						detail::ptr_physical_machine_greater_by_id_comparator<pm_type>());
-			::std::sort(pms.begin(),
-						pms.end(),
-						detail::ptr_physical_machine_greater_comparator<pm_type>());
-			sorted_pms.insert(sorted_pms.end(), pms.begin(), pms.end());
+			process_control_fully(dc);
 		}
-		pms.clear();
+
+::std::cerr << "[bfd_migration_controller] (" << this << ") END Do Process CONTROL event (Clock: " << ctx.simulated_time() << " - Count: " << count_ << " - Fail-Count: " << fail_count_ << ")" << ::std::endl;///XXX
+		DCS_DEBUG_TRACE("(" << this << ") END Do Process CONTROL event (Clock: " << ctx.simulated_time() << " - Count: " << count_ << " - Fail-Count: " << fail_count_ << ")");
+	}
+
+
+	private: statistic_type const& do_num_migrations() const
+	{
+		return *ptr_num_migr_;
+	}
+
+
+	private: statistic_type const& do_migration_rate() const
+	{
+		return *ptr_migr_rate_;
+	}
+
+	//@} Interface Member Functions
+
+
+	/// Re-packs all running VMs according to the best-fit-decreasing strategy.
+	private: void process_control_fully(data_center_type& dc)
+	{
+		typedef typename data_center_type::virtual_machine_type vm_type;
+		typedef ::std::vector<virtual_machine_pointer> vm_container;
+		typedef typename vm_container::const_iterator vm_iterator;
+
+		// Physical machines are indexed by power state and capacity, so that
+		// they need not be sorted here (see physical_machine_fit_index).
 
 		// Sort virtual machines according to their shares
         vm_container sorted_vms(dc.active_virtual_machines());
         ::std::sort(sorted_vms.begin(),
                     sorted_vms.end(),
                     detail::ptr_virtual_machine_greater_by_id_comparator<vm_type>());
-#ifdef DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
-		::std::map<typename traits_type::virtual_machine_identifier_type, share_container> wanted_shares;
-		typedef typename base_type::vm_observer_container::const_iterator vm_observer_iterator;
-		vm_observer_iterator vm_obs_end_it(this->vm_observer_map().end());
-		for (vm_observer_iterator it = this->vm_observer_map().begin(); it != vm_obs_end_it; ++it)
-		{
-			wanted_shares[it->first] = share_container(it->second->wanted_shares.begin(), it->second->wanted_shares.end());
-		}
-		::std::sort(sorted_vms.begin(),
-					sorted_vms.end(),
-					detail::ptr_virtual_machine_greater_by_share_comparator<vm_type>(wanted_shares.begin(), wanted_shares.end()));
-		wanted_shares.clear();
-#else // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
-        ::std::sort(sorted_vms.begin(),
-                    sorted_vms.end(),
-                    detail::ptr_virtual_machine_greater_comparator<vm_type>());
-#endif // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
+		sort_virtual_machines(sorted_vms);
 
 		uint_type num_vms(0);
 
 		virtual_machines_placement_type deployment;
+		physical_machine_index_type pm_index(dc, deployment, false);
 
 		vm_iterator vm_end_it(sorted_vms.end());
 
@@ -337,9 +403,11 @@ class best_fit_decreasing_migration_controller: public base_migration_controller
 
 		// Apply best-fit-decreasing strategy
 
+		physical_machine_identifier_set excluded_pms;
+
 		for (vm_iterator vm_it = sorted_vms.begin(); vm_it != vm_end_it; ++vm_it)
 		{
-			vm_pointer ptr_vm(*vm_it);
+			virtual_machine_pointer ptr_vm(*vm_it);
 
 			// paranoid-check: valid pointer.
 			DCS_DEBUG_ASSERT( ptr_vm );
@@ -354,210 +422,13 @@ class best_fit_decreasing_migration_controller: public base_migration_controller
 
 			++num_vms;
 
-#if 0 //[ORIGINAL]
-			// Compute and update VM utilization map
-
-			ref_resource_container rress(ptr_vm->guest_system().application().reference_resources());
-			ref_resource_iterator rress_end_it(rress.end());
-			for (ref_resource_iterator rress_it = rress.begin(); rress_it != rress_end_it; ++rress_it)
-			{
-				ref_resource_type res(*rress_it);
-
-				//TODO: CPU resource category not yet handle in app simulation model
-				DCS_ASSERT(
-						res.category() == cpu_resource_category,
-						DCS_EXCEPTION_THROW(
-							::std::runtime_error,
-							"Resource categories other than CPU are not yet implemented."
-						)
-					);
-
-				real_type new_util(0);
-
-				// Retrieve current resource utilization
-				new_util =  ptr_vm->guest_system().application().simulation_model().actual_tier_utilization(
-								ptr_vm->guest_system().id()
-					);
-				// Scale in terms of reference machine
-				new_util = scale_resource_utilization(
-								ptr_vm->vmm().hosting_machine().resource(res.category())->capacity(),
-								res.capacity(),
-								new_util,
-								res.utilization_threshold()
-					);
-
-				if (count_ > 1)
-				{
-					vm_util_map_[ptr_vm->id()][res.category()] = ewma_smooth_*new_util + (1-ewma_smooth_)*vm_util_map_.at(ptr_vm->id()).at(res.category());
-				}
-				else
-				{
-					vm_util_map_[ptr_vm->id()][res.category()] = new_util;
-				}
-			}
-#endif //[/ORIGINAL]
-
-			application_type const& app(ptr_vm->guest_system().application());
-
-			// Retrieve reference resource shares
 			share_container ref_shares;
-			{
-				ref_share_container tmp_shares(ptr_vm->guest_system().resource_shares());
-				ref_shares = share_container(tmp_shares.begin(), tmp_shares.end());
-			}
-
-			// Retrieve the observed share for every resource of the VM guest system
-#ifdef DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
-			// As observed shares uses the wanted shares collected by
-			// monitoring each VM.
-			share_container obs_shares(this->vm_observer_map().at(ptr_vm->id())->wanted_shares);
-#else // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
-			// As observed shares uses the ones defined by the tier
-			// specifications.
-			//share_container ref_shares(ptr_vm->guest_system().resource_shares());
-			share_container& obs_shares(ref_shares);
-#endif // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
+			share_container obs_shares;
+			retrieve_shares(ptr_vm, ref_shares, obs_shares);
 
-			// Compute and update VM utilization map
+			update_utilization(ptr_vm, obs_shares, ref_shares);
 
-			ref_resource_container rress(ptr_vm->guest_system().application().reference_resources());
-			ref_resource_iterator rress_end_it(rress.end());
-			for (ref_resource_iterator rress_it = rress.begin(); rress_it != rress_end_it; ++rress_it)
-			{
-				ref_resource_type res(*rress_it);
-
-				//TODO: CPU resource category not yet handle in app simulation model
-				DCS_ASSERT(
-						res.category() == cpu_resource_category,
-						DCS_EXCEPTION_THROW(
-							::std::runtime_error,
-							"Resource categories other than CPU are not yet implemented."
-						)
-					);
-
-				// paranoid-check: consistency
-				DCS_DEBUG_ASSERT( obs_shares.count(res.category()) > 0 );
-
-				// paranoid-check: consistency
-				DCS_DEBUG_ASSERT( ref_shares.count(res.category()) > 0 );
-
-				real_type obs_util(0);
-
-				// Retrieve current resource utilization
-				obs_util =  ptr_vm->guest_system().application().simulation_model().actual_tier_utilization(
-								ptr_vm->guest_system().id()
-					);
-::std::cerr << "[bfd_migration_controller] Observed Utilization " << obs_util << ::std::endl;//XXX
-
-				real_type obs_share(obs_shares.at(res.category()));
-::std::cerr << "[bfd_migration_controller] Observed Share " << obs_share << ::std::endl;//XXX
-
-				// Scale share in terms of actual machine
-				obs_share = scale_resource_share(res.capacity(),
-												 ptr_vm->vmm().hosting_machine().resource(res.category())->capacity(),
-												 obs_share);
-
-::std::cerr << "[bfd_migration_controller] Scaled (ref -> actual) Observed Share " << obs_share << ::std::endl;//XXX
-::std::cerr << "[bfd_migration_controller] Reference Share " << ref_shares.at(res.category()) << ::std::endl;//XXX
-
-				// Scale utilization in terms of reference machine
-				obs_util = scale_resource_utilization(ptr_vm->vmm().hosting_machine().resource(res.category())->capacity(),
-													  obs_share,
-													  res.capacity(),
-													  ref_shares.at(res.category()),
-													  obs_util,
-													  res.utilization_threshold());
-::std::cerr << "[bfd_migration_controller] Scaled (actual -> reference) Observed Utilization " << obs_util << ::std::endl;//XXX
-
-				if (count_ > 1)
-				{
-					vm_util_map_[ptr_vm->id()][res.category()] = ewma_smooth_*obs_util + (1-ewma_smooth_)*vm_util_map_.at(ptr_vm->id()).at(res.category());
-				}
-				else
-				{
-					vm_util_map_[ptr_vm->id()][res.category()] = obs_util;
-				}
-::std::cerr << "[bfd_migration_controller] Filtered Observed Utilization " << vm_util_map_.at(ptr_vm->id()).at(res.category()) << ::std::endl;//XXX
-			}
-
-			// For each physical machine PM, try to deploy current VM on PM
-			// until a suitable machine (i.e., a machine with sufficient free
-			// capacity) is found.
-			bool placed(false);
-			pm_iterator pm_end_it(sorted_pms.end());
-			share_iterator obs_share_end_it(obs_shares.end());
-			for (pm_iterator pm_it = sorted_pms.begin(); pm_it != pm_end_it && !placed; ++pm_it)
-			{
-				pm_pointer ptr_pm(*pm_it);
-
-				// paranoid-check: valid pointer.
-				DCS_DEBUG_ASSERT( ptr_pm );
-::std::cerr << "[bfd_migration_controller] Physical Machine " << *ptr_pm << ::std::endl;//XXX
-
-				// Reference to actual resource shares
-				resource_share_map shares;
-
-				for (share_iterator obs_share_it = obs_shares.begin(); obs_share_it != obs_share_end_it; ++obs_share_it)
-				{
-					physical_resource_category res_category(obs_share_it->first);
-					real_type share(obs_share_it->second);
-
-					real_type ref_capacity(app.reference_resource(res_category).capacity());
-					//real_type ref_threshold(app.reference_resource(ref_category).utilization_threshold());
-
-					real_type actual_capacity(ptr_pm->resource(res_category)->capacity());
-					//real_type actual_threshold(ptr_pm->resource(ref_category)->utilization_threshold());
-
-::std::cerr << "[bfd_migration_controller] Observed Share " << share << ::std::endl;//XXX
-					share = scale_resource_share(ref_capacity,
-												 //ref_threshold,
-												 actual_capacity,
-												 //actual_threshold,
-												 share);
-::std::cerr << "[bfd_migration_controller] Scaled (ref -> candidate) Observed Share " << share << ::std::endl;//XXX
-
-					shares[res_category] = share;
-				}
-
-				// Reference to actual resource utilizaition
-				resource_utilization_map utils;
-				for (ref_resource_iterator rress_it = rress.begin(); rress_it != rress_end_it; ++rress_it)
-				{
-					ref_resource_type res(*rress_it);
-
-					// paranoid-check: consistency
-					DCS_DEBUG_ASSERT( shares.count(res.category()) > 0 );
-
-					// paranoid-check: consistency
-					DCS_DEBUG_ASSERT( ref_shares.count(res.category()) > 0 );
-
-					real_type util(vm_util_map_.at(ptr_vm->id()).at(res.category()));
-
-::std::cerr << "[bfd_migration_controller] Observed Utilization " << util << ::std::endl;//XXX
-					// Scale utilization in terms of the new physical machine
-					util = scale_resource_utilization(res.capacity(),
-													  ref_shares.at(res.category()),
-													  ptr_pm->resource(res.category())->capacity(),
-													  shares.at(res.category()),
-													  util,
-													  ptr_pm->resource(res.category())->utilization_threshold());
-::std::cerr << "[bfd_migration_controller] Scaled (ref -> candidate) Observed Utilization " << util << ::std::endl;//XXX
-
-					utils[res.category()] = util;
-				}
-
-				// Try to place current VM on current PM
-				placed = deployment.try_place(*ptr_vm,
-											  *ptr_pm,
-											  shares.begin(),
-											  shares.end(),
-											  utils.begin(),
-											  utils.end(),
-											  dc);
-::std::cerr << "[bfd_migration_controller] Evaluating VM: " << *ptr_vm << " - PM: " << *ptr_pm << " - SHARE: " << shares.at(cpu_resource_category) << " - UTIL: " << utils.at(cpu_resource_category) << " ==> " << std::boolalpha << placed << ::std::endl;//XXX
-			}
-
-			if (!placed)
+			if (!place_best_fit(ptr_vm, obs_shares, ref_shares, dc, deployment, pm_index, excluded_pms))
 			{
 				++fail_count_;
 
@@ -583,17 +454,7 @@ class best_fit_decreasing_migration_controller: public base_migration_controller
 		{
 			log_warn(DCS_DES_CLOUD_LOGGING_AT, "No VM is running. Power-off active PMs.");
 
-			pm_container pms(dc.physical_machines(powered_on_power_status));
-			pm_iterator pm_end_it(pms.end());
-			for (pm_iterator pm_it = pms.begin(); pm_it != pm_end_it; ++pm_it)
-			{
-				pm_pointer ptr_pm(*pm_it);
-
-				// paranoid-check: null
-				DCS_DEBUG_ASSERT( ptr_pm );
-
-				ptr_pm->power_off();
-			}
+			power_off_physical_machines(dc);
 		}
 
 /*
@@ -674,28 +535,553 @@ class best_fit_decreasing_migration_controller: public base_migration_controller
 			++fail_count_;
 		}
 */
+	}
 
-::std::cerr << "[bfd_migration_controller] (" << this << ") END Do Process CONTROL event (Clock: " << ctx.simulated_time() << " - Count: " << count_ << " - Fail-Count: " << fail_count_ << ")" << ::std::endl;///XXX
-		DCS_DEBUG_TRACE("(" << this << ") END Do Process CONTROL event (Clock: " << ctx.simulated_time() << " - Count: " << count_ << " - Fail-Count: " << fail_count_ << ")");
+
+	/**
+	 * \brief Moves only the VMs hosted by hot and cold physical machines.
+	 *
+	 * A machine is hot when the utilization of its VMs exceeds the hot
+	 * threshold, and it is cold when it falls below the cold threshold (both
+	 * relative to the utilization threshold of the machine).
+	 * Hot machines are relieved by moving their most loaded VMs away.
+	 * Cold machines are emptied, starting from the least loaded ones, so that
+	 * they can be powered off; a cold machine whose VMs do not all fit on the
+	 * other machines in use is left untouched, since no machine is powered on
+	 * to empty a cold one.
+	 * Moved VMs are re-placed by best-fit-decreasing, while every other VM
+	 * keeps its current placement.
+	 */
+	private: void process_control_incrementally(data_center_type& dc)
+	{
+		typedef typename data_center_type::physical_machine_type pm_type;
+		typedef ::std::vector<virtual_machine_pointer> vm_container;
+		typedef typename vm_container::const_iterator vm_iterator;
+		typedef ::std::pair<real_type,virtual_machine_pointer> vm_load_type;
+		typedef ::std::vector<vm_load_type> vm_load_container;
+		typedef ::std::map<physical_machine_identifier_type,vm_load_container> pm_vm_load_map;
+		typedef typename pm_vm_load_map::iterator pm_vm_load_iterator;
+		typedef ::std::pair<real_type,physical_machine_identifier_type> pm_load_type;
+		typedef ::std::vector<pm_load_type> pm_load_container;
+
+		uint_type num_vms(0);
+
+		virtual_machines_placement_type deployment(dc.current_virtual_machines_placement());
+
+		// Update VMs utilization and compute the load of each physical machine
+
+		pm_vm_load_map pm_vm_loads;
+		vm_container const& vms(dc.active_virtual_machines());
+		vm_iterator vm_end_it(vms.end());
+		for (vm_iterator vm_it = vms.begin(); vm_it != vm_end_it; ++vm_it)
+		{
+			virtual_machine_pointer ptr_vm(*vm_it);
+
+			// paranoid-check: valid pointer.
+			DCS_DEBUG_ASSERT( ptr_vm );
+
+			if (ptr_vm->power_state() != powered_on_power_status)
+			{
+				// Non active VMs should not occupy resources
+				if (deployment.placed(*ptr_vm))
+				{
+					deployment.displace(*ptr_vm);
+				}
+				continue;
+			}
+
+			++num_vms;
+
+			share_container ref_shares;
+			share_container obs_shares;
+			retrieve_shares(ptr_vm, ref_shares, obs_shares);
+
+			update_utilization(ptr_vm, obs_shares, ref_shares);
+
+			// Scale utilization in terms of the hosting machine and of the current share
+			//FIXME: CPU resource category is hard-coded.
+			pm_type const& pm(ptr_vm->vmm().hosting_machine());
+			real_type load(scale_resource_utilization(ptr_vm->guest_system().application().reference_resource(cpu_resource_category).capacity(),
+													  ref_shares.at(cpu_resource_category),
+													  pm.resource(cpu_resource_category)->capacity(),
+													  ptr_vm->resource_share(cpu_resource_category),
+													  vm_util_map_.at(ptr_vm->id()).at(cpu_resource_category),
+													  pm.resource(cpu_resource_category)->utilization_threshold()));
+
+			pm_vm_loads[pm.id()].push_back(::std::make_pair(load, ptr_vm));
+		}
+
+		if (num_vms == 0)
+		{
+			log_warn(DCS_DES_CLOUD_LOGGING_AT, "No VM is running. Power-off active PMs.");
+
+			power_off_physical_machines(dc);
+
+			return;
+		}
+
+		// Find hot and cold machines, and move the most loaded VMs off hot ones
+
+		physical_machine_identifier_set excluded_pms;
+		pm_load_container cold_pms;
+		vm_container moving_vms;
+		pm_vm_load_iterator pm_end_it(pm_vm_loads.end());
+		for (pm_vm_load_iterator pm_it = pm_vm_loads.begin(); pm_it != pm_end_it; ++pm_it)
+		{
+			physical_machine_identifier_type pm_id(pm_it->first);
+			vm_load_container& vm_loads(pm_it->second);
+
+			real_type threshold(dc.physical_machine_ptr(pm_id)->resource(cpu_resource_category)->utilization_threshold());
+			real_type load(0);
+			for (::std::size_t k = 0; k < vm_loads.size(); ++k)
+			{
+				load += vm_loads[k].first;
+			}
+
+			if (load > (hot_threshold_*threshold))
+			{
+				::std::sort(vm_loads.begin(), vm_loads.end(), ::std::greater<vm_load_type>());
+				for (::std::size_t k = 0; k < vm_loads.size() && load > (hot_threshold_*threshold); ++k)
+				{
+					deployment.displace(*(vm_loads[k].second));
+					moving_vms.push_back(vm_loads[k].second);
+					load -= vm_loads[k].first;
+				}
+
+				// Don't move other VMs on it
+				excluded_pms.insert(pm_id);
+			}
+			else if (load < (cold_threshold_*threshold))
+			{
+				cold_pms.push_back(::std::make_pair(load, pm_id));
+			}
+		}
+
+		if (moving_vms.empty() && cold_pms.empty())
+		{
+			// Nothing to move: keep the current placement
+			// For migration rate, use the weighted harmonic mean (see the "Workload Book" by Feitelson)
+			migr_rate_den_ += num_vms;
+
+			return;
+		}
+
+		physical_machine_index_type pm_index(dc, deployment, false);
+		physical_machine_identifier_set target_pms;
+
+		// Re-place VMs moved off hot machines
+
+		sort_virtual_machines(moving_vms);
+		vm_iterator moving_end_it(moving_vms.end());
+		for (vm_iterator vm_it = moving_vms.begin(); vm_it != moving_end_it; ++vm_it)
+		{
+			virtual_machine_pointer ptr_vm(*vm_it);
+
+			share_container ref_shares;
+			share_container obs_shares;
+			retrieve_shares(ptr_vm, ref_shares, obs_shares);
+
+			if (!place_best_fit(ptr_vm, obs_shares, ref_shares, dc, deployment, pm_index, excluded_pms))
+			{
+				++fail_count_;
+
+				::std::ostringstream oss;
+				oss << "Failed to find a placement for VM: " << *ptr_vm << ". Skip migration.";
+				log_warn(DCS_DES_CLOUD_LOGGING_AT, oss.str());
+
+				return;
+			}
+
+			target_pms.insert(deployment.pm_id(deployment.find(*ptr_vm)));
+		}
+
+		// Empty cold machines, starting from the least loaded ones
+
+		::std::sort(cold_pms.begin(), cold_pms.end());
+		for (::std::size_t i = 0; i < cold_pms.size(); ++i)
+		{
+			physical_machine_identifier_type pm_id(cold_pms[i].second);
+
+			if (target_pms.count(pm_id) > 0)
+			{
+				// It is no more cold
+				continue;
+			}
+
+			vm_load_container const& vm_loads(pm_vm_loads.at(pm_id));
+
+			vm_container draining_vms;
+			for (::std::size_t k = 0; k < vm_loads.size(); ++k)
+			{
+				draining_vms.push_back(vm_loads[k].second);
+			}
+			sort_virtual_machines(draining_vms);
+
+			best_fit_placer placer(this, dc);
+			if (detail::drain_physical_machine(pm_id, draining_vms, dc, deployment, pm_index, excluded_pms, placer))
+			{
+				for (::std::size_t k = 0; k < draining_vms.size(); ++k)
+				{
+					target_pms.insert(deployment.pm_id(deployment.find(*(draining_vms[k]))));
+				}
+			}
+		}
+
+		uint_type num_migrs(0);
+		num_migrs = this->migrate(deployment);
+
+		migr_count_ += num_migrs;
+		// For migration rate, use the weighted harmonic mean (see the "Workload Book" by Feitelson)
+		migr_rate_den_ += num_vms;
+		migr_rate_num_ += num_migrs;
 	}
 
 
-	private: statistic_type const& do_num_migrations() const
+	/// Sorts the given VMs by decreasing share.
+	private: void sort_virtual_machines(::std::vector<virtual_machine_pointer>& vms) const
 	{
-		return *ptr_num_migr_;
+		typedef typename data_center_type::virtual_machine_type vm_type;
+
+#ifdef DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
+		::std::map<typename traits_type::virtual_machine_identifier_type, share_container> wanted_shares;
+		typedef typename base_type::vm_observer_container::const_iterator vm_observer_iterator;
+		vm_observer_iterator vm_obs_end_it(this->vm_observer_map().end());
+		for (vm_observer_iterator it = this->vm_observer_map().begin(); it != vm_obs_end_it; ++it)
+		{
+			wanted_shares[it->first] = share_container(it->second->wanted_shares.begin(), it->second->wanted_shares.end());
+		}
+		::std::sort(vms.begin(),
+					vms.end(),
+					detail::ptr_virtual_machine_greater_by_share_comparator<vm_type>(wanted_shares.begin(), wanted_shares.end()));
+#else // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
+        ::std::sort(vms.begin(),
+                    vms.end(),
+                    detail::ptr_virtual_machine_greater_comparator<vm_type>());
+#endif // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
 	}
 
 
-	private: statistic_type const& do_migration_rate() const
+	/// Retrieves the reference and the observed shares of the given VM.
+	private: void retrieve_shares(virtual_machine_pointer const& ptr_vm, share_container& ref_shares, share_container& obs_shares) const
 	{
-		return *ptr_migr_rate_;
+		typedef typename data_center_type::application_type application_type;
+		typedef typename application_type::application_tier_type application_tier_type;
+		typedef typename application_tier_type::resource_share_container ref_share_container;
+
+		// Retrieve reference resource shares
+		{
+			ref_share_container tmp_shares(ptr_vm->guest_system().resource_shares());
+			ref_shares = share_container(tmp_shares.begin(), tmp_shares.end());
+		}
+
+		// Retrieve the observed share for every resource of the VM guest system
+#ifdef DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
+		// As observed shares uses the wanted shares collected by
+		// monitoring each VM.
+		obs_shares = share_container(this->vm_observer_map().at(ptr_vm->id())->wanted_shares);
+#else // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
+		// As observed shares uses the ones defined by the tier
+		// specifications.
+		obs_shares = ref_shares;
+#endif // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
 	}
 
-	//@} Interface Member Functions
+
+	/// Computes and updates the (smoothed) utilization of the given VM, in terms of its reference machine.
+	private: void update_utilization(virtual_machine_pointer const& ptr_vm, share_container const& obs_shares, share_container const& ref_shares)
+	{
+		typedef typename data_center_type::application_type application_type;
+		typedef typename application_type::reference_physical_resource_type ref_resource_type;
+		typedef typename application_type::reference_physical_resource_container ref_resource_container;
+		typedef typename ref_resource_container::const_iterator ref_resource_iterator;
+
+#if 0 //[ORIGINAL]
+		// Compute and update VM utilization map
+
+		ref_resource_container rress(ptr_vm->guest_system().application().reference_resources());
+		ref_resource_iterator rress_end_it(rress.end());
+		for (ref_resource_iterator rress_it = rress.begin(); rress_it != rress_end_it; ++rress_it)
+		{
+			ref_resource_type res(*rress_it);
+
+			//TODO: CPU resource category not yet handle in app simulation model
+			DCS_ASSERT(
+					res.category() == cpu_resource_category,
+					DCS_EXCEPTION_THROW(
+						::std::runtime_error,
+						"Resource categories other than CPU are not yet implemented."
+					)
+				);
+
+			real_type new_util(0);
+
+			// Retrieve current resource utilization
+			new_util =  ptr_vm->guest_system().application().simulation_model().actual_tier_utilization(
+							ptr_vm->guest_system().id()
+				);
+			// Scale in terms of reference machine
+			new_util = scale_resource_utilization(
+							ptr_vm->vmm().hosting_machine().resource(res.category())->capacity(),
+							res.capacity(),
+							new_util,
+							res.utilization_threshold()
+				);
+
+			if (count_ > 1)
+			{
+				vm_util_map_[ptr_vm->id()][res.category()] = ewma_smooth_*new_util + (1-ewma_smooth_)*vm_util_map_.at(ptr_vm->id()).at(res.category());
+			}
+			else
+			{
+				vm_util_map_[ptr_vm->id()][res.category()] = new_util;
+			}
+		}
+#endif //[/ORIGINAL]
+
+		// Compute and update VM utilization map
+
+		ref_resource_container rress(ptr_vm->guest_system().application().reference_resources());
+		ref_resource_iterator rress_end_it(rress.end());
+		for (ref_resource_iterator rress_it = rress.begin(); rress_it != rress_end_it; ++rress_it)
+		{
+			ref_resource_type res(*rress_it);
+
+			//TODO: CPU resource category not yet handle in app simulation model
+			DCS_ASSERT(
+					res.category() == cpu_resource_category,
+					DCS_EXCEPTION_THROW(
+						::std::runtime_error,
+						"Resource categories other than CPU are not yet implemented."
+					)
+				);
+
+			// paranoid-check: consistency
+			DCS_DEBUG_ASSERT( obs_shares.count(res.category()) > 0 );
+
+			// paranoid-check: consistency
+			DCS_DEBUG_ASSERT( ref_shares.count(res.category()) > 0 );
+
+			real_type obs_util(0);
+
+			// Retrieve current resource utilization
+			obs_util =  ptr_vm->guest_system().application().simulation_model().actual_tier_utilization(
+							ptr_vm->guest_system().id()
+				);
+::std::cerr << "[bfd_migration_controller] Observed Utilization " << obs_util << ::std::endl;//XXX
+
+			real_type obs_share(obs_shares.at(res.category()));
+::std::cerr << "[bfd_migration_controller] Observed Share " << obs_share << ::std::endl;//XXX
+
+			// Scale share in terms of actual machine
+			obs_share = scale_resource_share(res.capacity(),
+											 ptr_vm->vmm().hosting_machine().resource(res.category())->capacity(),
+											 obs_share);
+
+::std::cerr << "[bfd_migration_controller] Scaled (ref -> actual) Observed Share " << obs_share << ::std::endl;//XXX
+::std::cerr << "[bfd_migration_controller] Reference Share " << ref_shares.at(res.category()) << ::std::endl;//XXX
+
+			// Scale utilization in terms of reference machine
+			obs_util = scale_resource_utilization(ptr_vm->vmm().hosting_machine().resource(res.category())->capacity(),
+												  obs_share,
+												  res.capacity(),
+												  ref_shares.at(res.category()),
+												  obs_util,
+												  res.utilization_threshold());
+::std::cerr << "[bfd_migration_controller] Scaled (actual -> reference) Observed Utilization " << obs_util << ::std::endl;//XXX
+
+			if (count_ > 1)
+			{
+				vm_util_map_[ptr_vm->id()][res.category()] = ewma_smooth_*obs_util + (1-ewma_smooth_)*vm_util_map_.at(ptr_vm->id()).at(res.category());
+			}
+			else
+			{
+				vm_util_map_[ptr_vm->id()][res.category()] = obs_util;
+			}
+::std::cerr << "[bfd_migration_controller] Filtered Observed Utilization " << vm_util_map_.at(ptr_vm->id()).at(res.category()) << ::std::endl;//XXX
+		}
+	}
+
+
+	/**
+	 * \brief Places the given VM on the physical machine where it fits best,
+	 *  skipping the excluded machines.
+	 *
+	 * \return \c true if the VM has been placed, \c false otherwise.
+	 */
+	private: bool place_best_fit(virtual_machine_pointer const& ptr_vm,
+								 share_container const& obs_shares,
+								 share_container const& ref_shares,
+								 data_center_type const& dc,
+								 virtual_machines_placement_type& deployment,
+								 physical_machine_index_type& pm_index,
+								 physical_machine_identifier_set const& excluded_pms)
+	{
+		typedef typename physical_machine_index_type::size_type pm_index_size_type;
+
+		// For each physical machine PM, try to deploy current VM on PM
+		// until a suitable machine (i.e., a machine with sufficient free
+		// capacity) is found.
+		bool placed(false);
+
+		// The (absolute) CPU capacity needed by this VM, used to skip
+		// physical machines without enough free capacity.
+		real_type capacity(wanted_capacity(ptr_vm, obs_shares));
+
+		for (pm_index_size_type pos = pm_index.find_first(capacity);
+			 pos < pm_index.size() && !placed;
+			 pos = pm_index.find_first(capacity, pos+1))
+		{
+			physical_machine_pointer ptr_pm(pm_index.physical_machine_ptr(pos));
+
+			// paranoid-check: valid pointer.
+			DCS_DEBUG_ASSERT( ptr_pm );
+
+			if (excluded_pms.count(ptr_pm->id()) > 0)
+			{
+				continue;
+			}
+
+			placed = try_place(ptr_vm, obs_shares, ref_shares, ptr_pm, dc, deployment);
+			if (placed)
+			{
+				pm_index.update(ptr_pm->id(), deployment);
+			}
+		}
+
+		return placed;
+	}
+
+
+	/// The (absolute) CPU capacity needed by the given VM.
+	private: real_type wanted_capacity(virtual_machine_pointer const& ptr_vm, share_container const& obs_shares) const
+	{
+		if (obs_shares.count(cpu_resource_category) == 0)
+		{
+			return 0;
+		}
+
+		return obs_shares.at(cpu_resource_category)*ptr_vm->guest_system().application().reference_resource(cpu_resource_category).capacity();
+	}
+
+
+	/**
+	 * \brief Tries to place the given VM on the given physical machine, with
+	 *  its shares and utilization scaled to that machine.
+	 *
+	 * \return \c true if the VM has been placed, \c false otherwise.
+	 */
+	private: bool try_place(virtual_machine_pointer const& ptr_vm,
+							share_container const& obs_shares,
+							share_container const& ref_shares,
+							physical_machine_pointer const& ptr_pm,
+							data_center_type const& dc,
+							virtual_machines_placement_type& deployment) const
+	{
+		typedef typename data_center_type::application_type application_type;
+		typedef typename application_type::reference_physical_resource_type ref_resource_type;
+		typedef typename application_type::reference_physical_resource_container ref_resource_container;
+		typedef typename ref_resource_container::const_iterator ref_resource_iterator;
+		typedef typename share_container::const_iterator share_iterator;
+
+		application_type const& app(ptr_vm->guest_system().application());
+		ref_resource_container rress(app.reference_resources());
+		ref_resource_iterator rress_end_it(rress.end());
+		share_iterator obs_share_end_it(obs_shares.end());
+
+::std::cerr << "[bfd_migration_controller] Physical Machine " << *ptr_pm << ::std::endl;//XXX
+
+		// Reference to actual resource shares
+		resource_share_map shares;
+
+		for (share_iterator obs_share_it = obs_shares.begin(); obs_share_it != obs_share_end_it; ++obs_share_it)
+		{
+			physical_resource_category res_category(obs_share_it->first);
+			real_type share(obs_share_it->second);
+
+			real_type ref_capacity(app.reference_resource(res_category).capacity());
+			//real_type ref_threshold(app.reference_resource(ref_category).utilization_threshold());
+
+			real_type actual_capacity(ptr_pm->resource(res_category)->capacity());
+			//real_type actual_threshold(ptr_pm->resource(ref_category)->utilization_threshold());
+
+::std::cerr << "[bfd_migration_controller] Observed Share " << share << ::std::endl;//XXX
+			share = scale_resource_share(ref_capacity,
+										 //ref_threshold,
+										 actual_capacity,
+										 //actual_threshold,
+										 share);
+::std::cerr << "[bfd_migration_controller] Scaled (ref -> candidate) Observed Share " << share << ::std::endl;//XXX
+
+			shares[res_category] = share;
+		}
+
+		// Reference to actual resource utilizaition
+		resource_utilization_map utils;
+		for (ref_resource_iterator rress_it = rress.begin(); rress_it != rress_end_it; ++rress_it)
+		{
+			ref_resource_type res(*rress_it);
+
+			// paranoid-check: consistency
+			DCS_DEBUG_ASSERT( shares.count(res.category()) > 0 );
+
+			// paranoid-check: consistency
+			DCS_DEBUG_ASSERT( ref_shares.count(res.category()) > 0 );
+
+			real_type util(vm_util_map_.at(ptr_vm->id()).at(res.category()));
+
+::std::cerr << "[bfd_migration_controller] Observed Utilization " << util << ::std::endl;//XXX
+			// Scale utilization in terms of the new physical machine
+			util = scale_resource_utilization(res.capacity(),
+											  ref_shares.at(res.category()),
+											  ptr_pm->resource(res.category())->capacity(),
+											  shares.at(res.category()),
+											  util,
+											  ptr_pm->resource(res.category())->utilization_threshold());
+::std::cerr << "[bfd_migration_controller] Scaled (ref -> candidate) Observed Utilization " << util << ::std::endl;//XXX
+
+			utils[res.category()] = util;
+		}
+
+		// Try to place current VM on current PM
+		bool placed(false);
+		placed = deployment.try_place(*ptr_vm,
+									  *ptr_pm,
+									  shares.begin(),
+									  shares.end(),
+									  utils.begin(),
+									  utils.end(),
+									  dc);
+::std::cerr << "[bfd_migration_controller] Evaluating VM: " << *ptr_vm << " - PM: " << *ptr_pm << " - SHARE: " << shares.at(cpu_resource_category) << " - UTIL: " << utils.at(cpu_resource_category) << " ==> " << std::boolalpha << placed << ::std::endl;//XXX
+
+		return placed;
+	}
+
+
+	/// Powers off all the powered-on physical machines.
+	private: void power_off_physical_machines(data_center_type& dc)
+	{
+		typedef ::std::vector<physical_machine_pointer> pm_container;
+		typedef typename pm_container::const_iterator pm_iterator;
+
+		pm_container pms(dc.physical_machines(powered_on_power_status));
+		pm_iterator pm_end_it(pms.end());
+		for (pm_iterator pm_it = pms.begin(); pm_it != pm_end_it; ++pm_it)
+		{
+			physical_machine_pointer ptr_pm(*pm_it);
+
+			// paranoid-check: null
+			DCS_DEBUG_ASSERT( ptr_pm );
+
+			ptr_pm->power_off();
+		}
+	}
 
 
 
 	private: real_type ewma_smooth_;
+	private: bool incremental_;
+	private: real_type hot_threshold_;
+	private: real_type cold_threshold_;
 	private: uint_type count_;
 	private: uint_type fail_count_;
 	private: uint_type migr_count_;
@@ -710,6 +1096,12 @@ class best_fit_decreasing_migration_controller: public base_migration_controller
 template <typename TraitsT>
 const typename best_fit_decreasing_migration_controller<TraitsT>::real_type best_fit_decreasing_migration_controller<TraitsT>::default_ewma_smoothing_factor(0.70);
 
+template <typename TraitsT>
+const typename best_fit_decreasing_migration_controller<TraitsT>::real_type best_fit_decreasing_migration_controller<TraitsT>::default_hot_threshold(1);
+
+template <typename TraitsT>
+const typename best_fit_decreasing_migration_controller<TraitsT>::real_type best_fit_decreasing_migration_controller<TraitsT>::default_cold_threshold(0.3);
+
 }}} // Namespace dcs::des::cloud
 
 
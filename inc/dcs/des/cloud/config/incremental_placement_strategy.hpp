@@ -35,8 +35,10 @@
 
 
 #include <boost/variant.hpp>
+#include <cstddef>
 #include <dcs/macro.hpp>
 #include <iosfwd>
+#include <vector>
 
 
 namespace dcs { namespace des { namespace cloud { namespace config {
@@ -44,10 +46,15 @@ namespace dcs { namespace des { namespace cloud { namespace config {
 enum incremental_placement_strategy_category
 {
 	best_fit_incremental_placement_strategy,
-	best_fit_decreasing_incremental_placement_strategy
+	best_fit_decreasing_incremental_placement_strategy,
+	portfolio_incremental_placement_strategy
 };
 
 
+template <typename RealT>
+struct incremental_placement_strategy_config;
+
+
 struct best_fit_incremental_placement_strategy_config
 {
 };
@@ -58,17 +65,32 @@ struct best_fit_decreasing_incremental_placement_strategy_config
 };
 
 
+template <typename RealT>
+struct portfolio_incremental_placement_strategy_config
+{
+	typedef RealT real_type;
+
+	::std::vector< incremental_placement_strategy_config<real_type> > strategies; ///< Strategies run concurrently.
+	real_type time_budget; ///< Max wall-clock time (in secs) to wait for the strategies.
+	real_type wn; ///< Weight of the number of active machines.
+	real_type wp; ///< Weight of the expected energy consumption.
+	real_type ws; ///< Weight of the SLA violation risk.
+};
+
+
 template <typename RealT>
 struct incremental_placement_strategy_config
 {
 	typedef RealT real_type;
     typedef best_fit_incremental_placement_strategy_config best_fit_incremental_placement_strategy_config_type;
     typedef best_fit_decreasing_incremental_placement_strategy_config best_fit_decreasing_incremental_placement_strategy_config_type;
+    typedef portfolio_incremental_placement_strategy_config<real_type> portfolio_incremental_placement_strategy_config_type;
 
 
 	incremental_placement_strategy_category category;
     ::boost::variant<best_fit_incremental_placement_strategy_config_type,
-    				 best_fit_decreasing_incremental_placement_strategy_config_type> category_conf;
+    				 best_fit_decreasing_incremental_placement_strategy_config_type,
+    				 portfolio_incremental_placement_strategy_config_type> category_conf;
 	real_type ref_penalty;
 };
 
@@ -84,6 +106,9 @@ template <typename CharT, typename CharTraitsT>
 		case best_fit_decreasing_incremental_placement_strategy:
 			os << "best-fit-decreasing";
 			break;
+		case portfolio_incremental_placement_strategy:
+			os << "portfolio";
+			break;
 	}
 
 	return os;
@@ -112,6 +137,30 @@ template <typename CharT, typename CharTraitsT>
 }
 
 
+template <typename CharT, typename CharTraitsT, typename RealT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, portfolio_incremental_placement_strategy_config<RealT> const& strategy)
+{
+	os << "<(portfolio-incremental-placement)"
+	   << " strategies: [";
+	for (::std::size_t i = 0; i < strategy.strategies.size(); ++i)
+	{
+		if (i > 0)
+		{
+			os << ", ";
+		}
+		os << strategy.strategies[i];
+	}
+	os << "]"
+	   << ", time-budget: " << strategy.time_budget
+	   << ", active-machines-weight: " << strategy.wn
+	   << ", power-weight: " << strategy.wp
+	   << ", sla-weight: " << strategy.ws
+	   << ">";
+
+	return os;
+}
+
+
 template <typename CharT, typename CharTraitsT, typename RealT>
 ::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, incremental_placement_strategy_config<RealT> const& strategy)
 {
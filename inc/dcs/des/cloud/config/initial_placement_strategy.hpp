@@ -35,12 +35,15 @@
 
 
 #include <boost/variant.hpp>
+#include <cstddef>
 #include <dcs/des/cloud/optimal_solver_categories.hpp>
 #include <dcs/des/cloud/optimal_solver_ids.hpp>
 #include <dcs/des/cloud/optimal_solver_input_methods.hpp>
 #include <dcs/des/cloud/optimal_solver_proxies.hpp>
 #include <dcs/macro.hpp>
 #include <iosfwd>
+#include <string>
+#include <vector>
 
 
 namespace dcs { namespace des { namespace cloud { namespace config {
@@ -51,10 +54,15 @@ enum initial_placement_strategy_category
 	best_fit_decreasing_initial_placement_strategy,
 	first_fit_initial_placement_strategy,
 	first_fit_scaleout_initial_placement_strategy,
-	optimal_initial_placement_strategy
+	optimal_initial_placement_strategy,
+	portfolio_initial_placement_strategy
 };
 
 
+template <typename RealT>
+struct initial_placement_strategy_config;
+
+
 struct best_fit_initial_placement_strategy_config
 {
 };
@@ -86,6 +94,23 @@ struct optimal_initial_placement_strategy_config
 	optimal_solver_input_methods input_method;
 	optimal_solver_ids solver_id;
 	optimal_solver_proxies proxy;
+	real_type solver_time_limit; ///< Max time (in secs) to solve a problem (native solvers only).
+	::std::size_t solver_threads; ///< Max number of threads of the solver (native solvers only).
+	bool solver_cache; ///< Reuse the results of already solved problems.
+	::std::string solver_cache_path; ///< Directory where solved problems are stored (empty for in-memory only).
+};
+
+
+template <typename RealT>
+struct portfolio_initial_placement_strategy_config
+{
+	typedef RealT real_type;
+
+	::std::vector< initial_placement_strategy_config<real_type> > strategies; ///< Strategies run concurrently.
+	real_type time_budget; ///< Max wall-clock time (in secs) to wait for the strategies (optimal ones must use the native solver, if finite).
+	real_type wn; ///< Weight of the number of active machines.
+	real_type wp; ///< Weight of the expected energy consumption.
+	real_type ws; ///< Weight of the SLA violation risk.
 };
 
 
@@ -98,6 +123,7 @@ struct initial_placement_strategy_config
     typedef first_fit_initial_placement_strategy_config first_fit_initial_placement_strategy_config_type;
     typedef first_fit_scaleout_initial_placement_strategy_config first_fit_scaleout_initial_placement_strategy_config_type;
     typedef optimal_initial_placement_strategy_config<real_type> optimal_initial_placement_strategy_config_type;
+    typedef portfolio_initial_placement_strategy_config<real_type> portfolio_initial_placement_strategy_config_type;
 
 
 	initial_placement_strategy_category category;
@@ -105,7 +131,8 @@ struct initial_placement_strategy_config
 					 best_fit_decreasing_initial_placement_strategy_config_type,
 					 first_fit_initial_placement_strategy_config_type,
 					 first_fit_scaleout_initial_placement_strategy_config_type,
-					 optimal_initial_placement_strategy_config_type> category_conf;
+					 optimal_initial_placement_strategy_config_type,
+					 portfolio_initial_placement_strategy_config_type> category_conf;
 	real_type ref_penalty;
 };
 
@@ -130,6 +157,9 @@ template <typename CharT, typename CharTraitsT>
 		case optimal_initial_placement_strategy:
 			os << "optimal";
 			break;
+		case portfolio_initial_placement_strategy:
+			os << "portfolio";
+			break;
 	}
 
 	return os;
@@ -190,6 +220,34 @@ template <typename CharT, typename CharTraitsT, typename RealT>
 	   << ", input: " << strategy.input_method
 	   << ", solver: " << strategy.solver_id
 	   << ", proxy: " << strategy.proxy
+	   << ", solver-time-limit: " << strategy.solver_time_limit
+	   << ", solver-threads: " << strategy.solver_threads
+	   << ", solver-cache: " << ::std::boolalpha << strategy.solver_cache
+	   << ", solver-cache-path: " << strategy.solver_cache_path
+	   << ">";
+
+	return os;
+}
+
+
+template <typename CharT, typename CharTraitsT, typename RealT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, portfolio_initial_placement_strategy_config<RealT> const& strategy)
+{
+	os << "<(portfolio-initial-placement)"
+	   << " strategies: [";
+	for (::std::size_t i = 0; i < strategy.strategies.size(); ++i)
+	{
+		if (i > 0)
+		{
+			os << ", ";
+		}
+		os << strategy.strategies[i];
+	}
+	os << "]"
+	   << ", time-budget: " << strategy.time_budget
+	   << ", active-machines-weight: " << strategy.wn
+	   << ", power-weight: " << strategy.wp
+	   << ", sla-weight: " << strategy.ws
 	   << ">";
 
 	return os;
@@ -35,12 +35,14 @@
 
 
 #include <boost/variant.hpp>
+#include <cstddef>
 #include <dcs/des/cloud/optimal_solver_categories.hpp>
 #include <dcs/des/cloud/optimal_solver_ids.hpp>
 #include <dcs/des/cloud/optimal_solver_input_methods.hpp>
 #include <dcs/des/cloud/optimal_solver_proxies.hpp>
 #include <dcs/macro.hpp>
 #include <iosfwd>
+#include <string>
 
 
 namespace dcs { namespace des { namespace cloud { namespace config {
@@ -53,8 +55,14 @@ enum migration_controller_category
 };
 
 
+template <typename RealT>
 struct best_fit_decreasing_migration_controller_config
 {
+	typedef RealT real_type;
+
+	bool incremental; ///< Only move VMs off overloaded (hot) and underloaded (cold) physical machines.
+	real_type hot_threshold; ///< Fraction of the machine utilization threshold above which a machine is hot.
+	real_type cold_threshold; ///< Fraction of the machine utilization threshold below which a machine is cold.
 };
 
 
@@ -75,6 +83,13 @@ struct optimal_migration_controller_config
     optimal_solver_input_methods input_method;
     optimal_solver_ids solver_id;
     optimal_solver_proxies proxy;
+    real_type solver_time_limit; ///< Max time (in secs) to solve a problem (native solvers only).
+    ::std::size_t solver_threads; ///< Max number of threads of the solver (native solvers only).
+    bool solver_cache; ///< Reuse the results of already solved problems.
+    ::std::string solver_cache_path; ///< Directory where solved problems are stored (empty for in-memory only).
+    real_type solver_cache_tolerance; ///< Max difference of VM utilizations to reuse a solved problem.
+    bool async_solver; ///< Solve problems outside the DES thread while the simulation goes on.
+    real_type decision_delay; ///< Simulated time to make a decision when solving asynchronously (0 means at the next control event).
 };
 
 
@@ -82,7 +97,7 @@ template <typename RealT>
 struct migration_controller_config
 {
 	typedef RealT real_type;
-	typedef best_fit_decreasing_migration_controller_config best_fit_decreasing_migration_controller_config_type;
+	typedef best_fit_decreasing_migration_controller_config<real_type> best_fit_decreasing_migration_controller_config_type;
 	typedef dummy_migration_controller_config dummy_migration_controller_config_type;
 	typedef optimal_migration_controller_config<real_type> optimal_migration_controller_config_type;
 
@@ -114,12 +129,14 @@ template <typename CharT, typename CharTraitsT>
 }
 
 
-template <typename CharT, typename CharTraitsT>
-::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, best_fit_decreasing_migration_controller_config const& conf)
+template <typename CharT, typename CharTraitsT, typename RealT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, best_fit_decreasing_migration_controller_config<RealT> const& conf)
 {
-	DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( conf );
-
-	os << "<(best-fit-decreasing-migration-controller)>";
+	os << "<(best-fit-decreasing-migration-controller)"
+	   << " incremental: " << ::std::boolalpha << conf.incremental
+	   << ", hot-threshold: " << conf.hot_threshold
+	   << ", cold-threshold: " << conf.cold_threshold
+	   << ">";
 
 	return os;
 }
@@ -147,6 +164,13 @@ template <typename CharT, typename CharTraitsT, typename RealT>
 	   << ", input: " << conf.input_method
 	   << ", solver: " << conf.solver_id
 	   << ", proxy: " << conf.proxy
+	   << ", solver-time-limit: " << conf.solver_time_limit
+	   << ", solver-threads: " << conf.solver_threads
+	   << ", solver-cache: " << ::std::boolalpha << conf.solver_cache
+	   << ", solver-cache-path: " << conf.solver_cache_path
+	   << ", solver-cache-tolerance: " << conf.solver_cache_tolerance
+	   << ", async-solver: " << ::std::boolalpha << conf.async_solver
+	   << ", decision-delay: " << conf.decision_delay
 	   << ">";
 
 	return os;
@@ -8,38 +8,22 @@
 #include <dcs/des/cloud/config/operation/make_physical_machine_controller.hpp>
 #include <dcs/des/cloud/data_center.hpp>
 #include <dcs/des/cloud/physical_machine.hpp>
+#include <dcs/des/cloud/registry.hpp>
 #include <dcs/memory.hpp>
 #include <stdexcept>
 
 
 namespace dcs { namespace des { namespace cloud { namespace config {
 
+namespace detail { namespace /*<unnamed>*/ {
+
 template <typename TraitsT, typename RealT, typename UIntT>
-::dcs::shared_ptr< ::dcs::des::cloud::data_center<TraitsT> > make_data_center(configuration<RealT,UIntT> const& conf,
-																		 ::dcs::shared_ptr<typename TraitsT::uniform_random_generator_type> const& ptr_rng,
-																		 ::dcs::shared_ptr<typename TraitsT::des_engine_type> const& ptr_des_eng)
+void add_physical_machines(configuration<RealT,UIntT> const& conf, ::dcs::des::cloud::data_center<TraitsT>& dc)
 {
 	typedef TraitsT traits_type;
-	typedef RealT real_type;
-	typedef UIntT uint_type;
-	typedef ::dcs::des::cloud::data_center<traits_type> data_center_type;
-	typedef configuration<real_type,uint_type> configuration_type;
+	typedef configuration<RealT,UIntT> configuration_type;
 	typedef typename configuration_type::data_center_config_type data_center_config_type;
 
-	// pre: random number generator pointer must be a valid pointer
-	DCS_ASSERT(
-		ptr_rng,
-		throw ::std::invalid_argument("[dcs::des::cloud::config::make_data_center] Invalid random number generator.")
-	);
-	// pre: DES engine pointer must be a valid pointer
-	DCS_ASSERT(
-		ptr_des_eng,
-		throw ::std::invalid_argument("[dcs::des::cloud::config::make_data_center] Invalid DES engine.")
-	);
-
-	::dcs::shared_ptr<data_center_type> ptr_dc = ::dcs::make_shared<data_center_type>();
-
-	// Make physical machines
 	{
 		typedef typename data_center_config_type::physical_machine_config_container::const_iterator iterator;
 		iterator end_it = conf.data_center().physical_machines().end();
@@ -54,7 +38,7 @@ template <typename TraitsT, typename RealT, typename UIntT>
 			ptr_mach_controller = make_physical_machine_controller<traits_type>(it->controller);
 			ptr_mach_controller->machine(ptr_mach);
 
-			ptr_dc->add_physical_machine(ptr_mach, ptr_mach_controller);
+			dc.add_physical_machine(ptr_mach, ptr_mach_controller);
 		}
 	}
 
@@ -77,11 +61,79 @@ template <typename TraitsT, typename RealT, typename UIntT>
 //			ptr_dc->add_application(ptr_app, ptr_app_controller);
 //		}
 //	}
+}
+
+}} // Namespace detail::<unnamed>
+
+
+template <typename TraitsT, typename RealT, typename UIntT>
+::dcs::shared_ptr< ::dcs::des::cloud::data_center<TraitsT> > make_data_center(configuration<RealT,UIntT> const& conf,
+																		 ::dcs::shared_ptr<typename TraitsT::uniform_random_generator_type> const& ptr_rng,
+																		 ::dcs::shared_ptr<typename TraitsT::des_engine_type> const& ptr_des_eng)
+{
+	typedef TraitsT traits_type;
+	typedef RealT real_type;
+	typedef UIntT uint_type;
+	typedef ::dcs::des::cloud::data_center<traits_type> data_center_type;
+	typedef configuration<real_type,uint_type> configuration_type;
+	typedef typename configuration_type::data_center_config_type data_center_config_type;
+
+	// pre: random number generator pointer must be a valid pointer
+	DCS_ASSERT(
+		ptr_rng,
+		throw ::std::invalid_argument("[dcs::des::cloud::config::make_data_center] Invalid random number generator.")
+	);
+	// pre: DES engine pointer must be a valid pointer
+	DCS_ASSERT(
+		ptr_des_eng,
+		throw ::std::invalid_argument("[dcs::des::cloud::config::make_data_center] Invalid DES engine.")
+	);
+
+	::dcs::shared_ptr<data_center_type> ptr_dc = ::dcs::make_shared<data_center_type>();
+
+	// Make physical machines
+	detail::add_physical_machines(conf, *ptr_dc);
 
 	return ptr_dc;
 }
 
 
+/**
+ * \brief Make a data center bound to the given simulation context.
+ *
+ * The data center and all of its components are created while \a ptr_reg is
+ * bound to the calling thread, so that they never use the process-wide
+ * default registry.
+ */
+template <typename TraitsT, typename RealT, typename UIntT>
+::dcs::shared_ptr< ::dcs::des::cloud::data_center<TraitsT> > make_data_center(configuration<RealT,UIntT> const& conf,
+																		 ::dcs::shared_ptr< ::dcs::des::cloud::registry<TraitsT> > const& ptr_reg)
+{
+	typedef TraitsT traits_type;
+	typedef ::dcs::des::cloud::data_center<traits_type> data_center_type;
+
+	DCS_ASSERT(
+		ptr_reg,
+		throw ::std::invalid_argument("[dcs::des::cloud::config::make_data_center] Invalid simulation context.")
+	);
+	DCS_ASSERT(
+		ptr_reg->uniform_random_generator_ptr(),
+		throw ::std::invalid_argument("[dcs::des::cloud::config::make_data_center] Invalid random number generator.")
+	);
+	DCS_ASSERT(
+		ptr_reg->des_engine_ptr(),
+		throw ::std::invalid_argument("[dcs::des::cloud::config::make_data_center] Invalid DES engine.")
+	);
+
+	::dcs::des::cloud::scoped_registry<traits_type> reg_scope(*ptr_reg);
+
+	::dcs::shared_ptr<data_center_type> ptr_dc = ::dcs::make_shared<data_center_type>(ptr_reg);
+
+	detail::add_physical_machines(conf, *ptr_dc);
+
+	return ptr_dc;
+}
+
 }}}} // Namespace dcs::des::cloud::config
 
 
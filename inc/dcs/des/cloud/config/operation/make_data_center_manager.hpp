@@ -13,6 +13,7 @@
 #include <dcs/des/cloud/config/operation/make_migration_controller.hpp>
 #include <dcs/des/cloud/data_center.hpp>
 #include <dcs/des/cloud/data_center_manager.hpp>
+#include <dcs/des/cloud/registry.hpp>
 #include <dcs/memory.hpp>
 
 
@@ -34,6 +35,8 @@ template <
 	typedef ::dcs::des::cloud::data_center_manager<traits_type> data_center_manager_type;
 	typedef configuration<real_type,uint_type> configuration_type;
 
+	// Build everything within the simulation context of the data center
+	::dcs::des::cloud::scoped_registry<traits_type> reg_scope(ptr_dc->reg());
 
 	::dcs::shared_ptr<data_center_manager_type> ptr_dc_mngr(new data_center_manager_type());
 
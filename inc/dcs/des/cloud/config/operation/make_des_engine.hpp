@@ -84,6 +84,21 @@ template <typename RealT, typename UIntT>
 				);
 			}
 			break;
+		case batch_means_output_analysis:
+			{
+				typedef batch_means_output_analysis_config<real_type,uint_type> output_analysis_config_type;
+				typedef ::dcs::des::replications::engine<real_type,uint_type> engine_impl_type;
+
+				output_analysis_config_type const& analysis = ::boost::get<output_analysis_config_type>(conf.simulation().output_analysis.category_conf);
+
+				// A single replication long enough to cover the warm-up period
+				// and all the batches
+				ptr_eng = ::dcs::make_shared<engine_impl_type>(
+					analysis.warmup_duration+analysis.num_batches*analysis.batch_duration,
+					uint_type(1)
+				);
+			}
+			break;
 		default:
 			throw ::std::runtime_error("[dcs::des::cloud::config::make_des_engine] Unhandled output analysis category.");
 	}
@@ -3,10 +3,12 @@
 
 
 //#include <boost/variant.hpp>
+#include <cstddef>
 #include <dcs/des/cloud/base_incremental_placement_strategy.hpp>
 #include <dcs/des/cloud/best_fit_decreasing_incremental_placement_strategy.hpp>
 #include <dcs/des/cloud/best_fit_incremental_placement_strategy.hpp>
 #include <dcs/des/cloud/config/incremental_placement_strategy.hpp>
+#include <dcs/des/cloud/portfolio_incremental_placement_strategy.hpp>
 #include <dcs/memory.hpp>
 
 
@@ -49,6 +51,29 @@ template <typename TraitsT, typename RealT>
 				ptr_strategy = ::dcs::make_shared<strategy_impl_type>();
 			}
 			break;
+		case portfolio_incremental_placement_strategy:
+			{
+				typedef typename strategy_config_type::portfolio_incremental_placement_strategy_config_type strategy_config_impl_type;
+				typedef ::dcs::des::cloud::portfolio_incremental_placement_strategy<traits_type> strategy_impl_type;
+				typedef typename strategy_impl_type::cost_model_type cost_model_type;
+
+				strategy_config_impl_type const& strategy_conf_impl = ::boost::get<strategy_config_impl_type>(strategy_conf.category_conf);
+
+				cost_model_type cost_model(strategy_conf_impl.wn,
+										   strategy_conf_impl.wp,
+										   strategy_conf_impl.ws);
+
+				::dcs::shared_ptr<strategy_impl_type> ptr_strategy_impl;
+				ptr_strategy_impl = ::dcs::make_shared<strategy_impl_type>(cost_model,
+																		   strategy_conf_impl.time_budget);
+				for (::std::size_t i = 0; i < strategy_conf_impl.strategies.size(); ++i)
+				{
+					ptr_strategy_impl->add_strategy(make_incremental_placement_strategy<traits_type>(strategy_conf_impl.strategies[i]));
+				}
+
+				ptr_strategy = ptr_strategy_impl;
+			}
+			break;
 	}
 
 	ptr_strategy->reference_share_penalty(strategy_conf.ref_penalty);
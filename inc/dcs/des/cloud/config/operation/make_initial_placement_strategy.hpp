@@ -3,6 +3,8 @@
 
 
 //#include <boost/variant.hpp>
+#include <algorithm>
+#include <cstddef>
 #include <dcs/des/cloud/base_initial_placement_strategy.hpp>
 #include <dcs/des/cloud/best_fit_decreasing_initial_placement_strategy.hpp>
 #include <dcs/des/cloud/best_fit_initial_placement_strategy.hpp>
@@ -10,8 +12,12 @@
 #include <dcs/des/cloud/first_fit_initial_placement_strategy.hpp>
 #include <dcs/des/cloud/first_fit_scaleout_initial_placement_strategy.hpp>
 #include <dcs/des/cloud/optimal_initial_placement_strategy.hpp>
+#include <dcs/des/cloud/optimal_solver_input_methods.hpp>
 #include <dcs/des/cloud/optimal_solver_params.hpp>
+#include <dcs/des/cloud/portfolio_initial_placement_strategy.hpp>
 #include <dcs/memory.hpp>
+#include <limits>
+#include <stdexcept>
 
 
 namespace dcs { namespace des { namespace cloud { namespace config {
@@ -88,12 +94,65 @@ template <typename TraitsT, typename RealT>
 														  strategy_conf_impl.input_method,
 														  strategy_conf_impl.solver_id,
 														  strategy_conf_impl.proxy);
+				params.time_limit(strategy_conf_impl.solver_time_limit);
+				params.num_threads(strategy_conf_impl.solver_threads);
+				params.cache(strategy_conf_impl.solver_cache);
+				params.cache_path(strategy_conf_impl.solver_cache_path);
 
 				ptr_strategy = ::dcs::make_shared<strategy_impl_type>(params,
 																	  strategy_conf_impl.wp,
 																	  strategy_conf_impl.ws);
 			}
 			break;
+		case portfolio_initial_placement_strategy:
+			{
+				typedef typename strategy_config_type::portfolio_initial_placement_strategy_config_type strategy_config_impl_type;
+				typedef typename strategy_config_type::optimal_initial_placement_strategy_config_type optimal_strategy_config_impl_type;
+				typedef ::dcs::des::cloud::portfolio_initial_placement_strategy<traits_type> strategy_impl_type;
+				typedef typename strategy_impl_type::cost_model_type cost_model_type;
+
+				strategy_config_impl_type const& strategy_conf_impl = ::boost::get<strategy_config_impl_type>(strategy_conf.category_conf);
+
+				cost_model_type cost_model(strategy_conf_impl.wn,
+										   strategy_conf_impl.wp,
+										   strategy_conf_impl.ws);
+
+				::dcs::shared_ptr<strategy_impl_type> ptr_strategy_impl;
+				ptr_strategy_impl = ::dcs::make_shared<strategy_impl_type>(cost_model,
+																		   strategy_conf_impl.time_budget);
+				for (::std::size_t i = 0; i < strategy_conf_impl.strategies.size(); ++i)
+				{
+					strategy_config_type member_conf(strategy_conf_impl.strategies[i]);
+
+					// Members must give up within the time budget, since the
+					// portfolio cannot leave them running.
+					// Only the native solver honors a time limit: AMPL/NEOS
+					// solvers would hold the portfolio until they finish.
+					if (member_conf.category == optimal_initial_placement_strategy
+						&& strategy_conf_impl.time_budget != ::std::numeric_limits<RealT>::infinity())
+					{
+						optimal_strategy_config_impl_type& optimal_conf = ::boost::get<optimal_strategy_config_impl_type>(member_conf.category_conf);
+
+						if (optimal_conf.input_method != native_optimal_solver_input_method)
+						{
+							throw ::std::runtime_error("[dcs::des::cloud::config::make_initial_placement_strategy] An optimal strategy in a portfolio with a time budget must use the native solver.");
+						}
+
+						optimal_conf.solver_time_limit = ::std::min(optimal_conf.solver_time_limit, strategy_conf_impl.time_budget);
+					}
+					else if (member_conf.category == portfolio_initial_placement_strategy)
+					{
+						strategy_config_impl_type& portfolio_conf = ::boost::get<strategy_config_impl_type>(member_conf.category_conf);
+
+						portfolio_conf.time_budget = ::std::min(portfolio_conf.time_budget, strategy_conf_impl.time_budget);
+					}
+
+					ptr_strategy_impl->add_strategy(make_initial_placement_strategy<traits_type>(member_conf));
+				}
+
+				ptr_strategy = ptr_strategy_impl;
+			}
+			break;
 	}
 
 	ptr_strategy->reference_share_penalty(strategy_conf.ref_penalty);
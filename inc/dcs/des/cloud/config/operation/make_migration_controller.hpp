@@ -35,10 +35,16 @@ template <typename TraitsT, typename RealT>
 				typedef typename controller_config_type::best_fit_decreasing_migration_controller_config_type controller_config_impl_type;
 				typedef ::dcs::des::cloud::best_fit_decreasing_migration_controller<traits_type> controller_impl_type;
 
-				//controller_config_impl_type const& controller_conf_impl = ::boost::get<controller_config_impl_type>(controller_conf.category_conf);
+				controller_config_impl_type const& controller_conf_impl = ::boost::get<controller_config_impl_type>(controller_conf.category_conf);
 
-				ptr_controller = ::dcs::make_shared<controller_impl_type>(ptr_dc,
-																		  controller_conf.sampling_time);
+				::dcs::shared_ptr<controller_impl_type> ptr_controller_impl;
+				ptr_controller_impl = ::dcs::make_shared<controller_impl_type>(ptr_dc,
+																			   controller_conf.sampling_time);
+				ptr_controller_impl->incremental(controller_conf_impl.incremental);
+				ptr_controller_impl->hot_threshold(controller_conf_impl.hot_threshold);
+				ptr_controller_impl->cold_threshold(controller_conf_impl.cold_threshold);
+
+				ptr_controller = ptr_controller_impl;
 			}
 			break;
 		case optimal_migration_controller:
@@ -52,13 +58,23 @@ template <typename TraitsT, typename RealT>
 														  controller_conf_impl.input_method,
 														  controller_conf_impl.solver_id,
 														  controller_conf_impl.proxy);
-
-				ptr_controller = ::dcs::make_shared<controller_impl_type>(ptr_dc,
-																		  controller_conf.sampling_time,
-																		  params,
-																		  controller_conf_impl.wp,
-																		  controller_conf_impl.wm,
-																		  controller_conf_impl.ws);
+				params.time_limit(controller_conf_impl.solver_time_limit);
+				params.num_threads(controller_conf_impl.solver_threads);
+				params.cache(controller_conf_impl.solver_cache);
+				params.cache_path(controller_conf_impl.solver_cache_path);
+				params.cache_tolerance(controller_conf_impl.solver_cache_tolerance);
+
+				::dcs::shared_ptr<controller_impl_type> ptr_controller_impl;
+				ptr_controller_impl = ::dcs::make_shared<controller_impl_type>(ptr_dc,
+																			   controller_conf.sampling_time,
+																			   params,
+																			   controller_conf_impl.wp,
+																			   controller_conf_impl.wm,
+																			   controller_conf_impl.ws);
+				ptr_controller_impl->async_solver(controller_conf_impl.async_solver);
+				ptr_controller_impl->decision_delay(controller_conf_impl.decision_delay);
+
+				ptr_controller = ptr_controller_impl;
 			}
 			break;
 		case dummy_migration_controller:
@@ -6,6 +6,8 @@
 #include <dcs/des/base_statistic.hpp>
 #include <dcs/des/base_analyzable_statistic.hpp>
 #include <dcs/des/cloud/base_application_simulation_model.hpp>
+#include <dcs/des/cloud/batch_means_statistic.hpp>
+#include <dcs/des/cloud/mser_mean_estimator.hpp>
 #include <dcs/des/cloud/config/statistic.hpp>
 #include <dcs/des/max_estimator.hpp>
 #include <dcs/des/mean_estimator.hpp>
@@ -696,8 +698,33 @@ template <
 				}
 */
 				target_real_type confidence_level(simulation_conf.output_analysis.confidence_level);
-				output_statistic_impl_type stat(confidence_level);
-				ptr_stat = make_independent_replications_output_statistic_impl<traits_type>(stat, simulation_conf, /*ptr_rng,*/ ptr_engine, primary);
+				switch (stat_conf.transient_category)
+				{
+					case none_transient_detector:
+						{
+							output_statistic_impl_type stat(confidence_level);
+							ptr_stat = make_independent_replications_output_statistic_impl<traits_type>(stat, simulation_conf, /*ptr_rng,*/ ptr_engine, primary);
+						}
+						break;
+					case mser_transient_detector:
+						{
+							typedef ::dcs::des::cloud::mser_mean_estimator<target_real_type,target_uint_type> mser_statistic_impl_type;
+							typedef ::dcs::des::cloud::mser_truncated_statistic<target_real_type,target_uint_type> truncated_statistic_type;
+							typedef typename truncated_statistic_type::truncation_summary_type truncation_summary_type;
+							typedef typename statistic_config_type::mser_transient_detector_config_type transient_detector_config_impl_type;
+
+							transient_detector_config_impl_type const& trans_conf_impl(::boost::get<transient_detector_config_impl_type>(stat_conf.transient_category_conf));
+
+							// The summary is shared by all the per-replication copies of the estimator
+							::dcs::shared_ptr<truncation_summary_type> ptr_summary(::dcs::make_shared<truncation_summary_type>());
+							mser_statistic_impl_type stat(confidence_level, trans_conf_impl.batch_size, ptr_summary);
+							ptr_stat = ::dcs::make_shared<truncated_statistic_type>(
+											make_independent_replications_output_statistic_impl<traits_type>(stat, simulation_conf, /*ptr_rng,*/ ptr_engine, primary),
+											ptr_summary
+									);
+						}
+						break;
+				}
 			}
 			break;
 		case min_statistic:
@@ -730,6 +757,116 @@ template <
 	return ptr_stat;
 }
 
+
+template <
+	typename TraitsT,
+	typename StatisticT,
+	typename RealT,
+	typename UIntT
+>
+::dcs::shared_ptr<
+	::dcs::des::base_statistic<
+		typename TraitsT::real_type,
+		typename TraitsT::uint_type
+	>
+> make_batch_means_output_statistic_impl(StatisticT const& stat,
+										 simulation_config<RealT,UIntT> const& simulation_conf,
+										 ::dcs::shared_ptr<typename TraitsT::des_engine_type> const& ptr_engine)
+{
+	typedef RealT real_type;
+	typedef UIntT uint_type;
+	typedef TraitsT traits_type;
+	typedef typename traits_type::real_type target_real_type;
+	typedef typename traits_type::uint_type target_uint_type;
+	typedef typename traits_type::des_engine_type des_engine_type;
+	typedef batch_means_output_analysis_config<real_type,uint_type> output_analysis_config_impl_type;
+	typedef ::dcs::des::cloud::batch_means_statistic<StatisticT,des_engine_type> output_statistic_impl_type;
+
+	output_analysis_config_impl_type const& output_analysis_conf_impl = ::boost::get<output_analysis_config_impl_type>(simulation_conf.output_analysis.category_conf);
+
+	// Primary and secondary statistics are handled in the same way, since
+	// the length of the (only) run is fixed by the DES engine.
+	return ::dcs::make_shared<output_statistic_impl_type>(
+				stat,
+				ptr_engine,
+				static_cast<target_real_type>(output_analysis_conf_impl.warmup_duration),
+				static_cast<target_real_type>(output_analysis_conf_impl.batch_duration),
+				static_cast<target_uint_type>(output_analysis_conf_impl.num_batches),
+				static_cast<target_real_type>(simulation_conf.output_analysis.confidence_level)
+			);
+}
+
+
+template <
+	typename TraitsT,
+	typename RealT,
+	typename UIntT
+>
+::dcs::shared_ptr<
+	::dcs::des::base_statistic<
+		typename TraitsT::real_type,
+		typename TraitsT::uint_type
+	>
+> make_batch_means_output_statistic(statistic_config<RealT> stat_conf,
+									simulation_config<RealT,UIntT> const& simulation_conf,
+									::dcs::shared_ptr<typename TraitsT::des_engine_type> const& ptr_engine)
+{
+	typedef TraitsT traits_type;
+	typedef statistic_config<RealT> statistic_config_type;
+	typedef typename traits_type::uint_type target_uint_type;
+	typedef typename traits_type::real_type target_real_type;
+	typedef ::dcs::des::base_statistic<target_real_type,target_uint_type> output_statistic_type;
+
+	::dcs::shared_ptr<output_statistic_type> ptr_stat;
+
+	target_real_type confidence_level(simulation_conf.output_analysis.confidence_level);
+
+	switch (stat_conf.category)
+	{
+		case max_statistic:
+			{
+				typedef ::dcs::des::max_estimator<target_real_type,target_uint_type> output_statistic_impl_type;
+
+				output_statistic_impl_type stat(confidence_level);
+				ptr_stat = make_batch_means_output_statistic_impl<traits_type>(stat, simulation_conf, ptr_engine);
+			}
+			break;
+		case mean_statistic:
+			{
+				typedef ::dcs::des::mean_estimator<target_real_type,target_uint_type> output_statistic_impl_type;
+
+				// The initial transient is discarded by the warm-up period, so
+				// the transient detector (if any) is not used
+				output_statistic_impl_type stat(confidence_level);
+				ptr_stat = make_batch_means_output_statistic_impl<traits_type>(stat, simulation_conf, ptr_engine);
+			}
+			break;
+		case min_statistic:
+			{
+				typedef ::dcs::des::min_estimator<target_real_type,target_uint_type> output_statistic_impl_type;
+
+				output_statistic_impl_type stat(confidence_level);
+				ptr_stat = make_batch_means_output_statistic_impl<traits_type>(stat, simulation_conf, ptr_engine);
+			}
+			break;
+		case quantile_statistic:
+			{
+				typedef ::dcs::des::quantile_estimator<target_real_type,target_uint_type> output_statistic_impl_type;
+				typedef typename statistic_config_type::quantile_statistic_config_type statistic_config_impl_type;
+
+				statistic_config_impl_type const& stat_conf_impl(::boost::get<statistic_config_impl_type>(stat_conf.category_conf));
+
+				output_statistic_impl_type stat(stat_conf_impl.probability, confidence_level);
+				ptr_stat = make_batch_means_output_statistic_impl<traits_type>(stat, simulation_conf, ptr_engine);
+			}
+			break;
+		default:
+			throw ::std::runtime_error("[dcs::des::cloud::config::detail::make_batch_means_output_statistic] Statistic type not hanlded.");
+	} // switch (stat_category) ...
+
+	return ptr_stat;
+}
+
 }} // Namespace detail::<unnamed>
 
 
@@ -775,6 +912,15 @@ template <
 						);
 				}
 				break;
+			case batch_means_output_analysis:
+				{
+					ptr_stat = detail::make_batch_means_output_statistic<traits_type>(
+								stat_conf,
+								simulation_conf,
+								ptr_engine
+						);
+				}
+				break;
 		}
 	}
 	else
@@ -792,6 +938,15 @@ template <
 						);
 				}
 				break;
+			case batch_means_output_analysis:
+				{
+					ptr_stat = detail::make_batch_means_output_statistic<traits_type>(
+								stat_conf,
+								simulation_conf,
+								ptr_engine
+						);
+				}
+				break;
 		}
 /*
 		switch (to_des_statistic_category(stat_conf.category))
@@ -72,6 +72,9 @@ template <typename CharT, typename CharTraitsT>
 		case mps_optimal_solver_input_method: ///< MPS (http://en.wikipedia.org/wiki/MPS_(format))
 			os << "MPS";
 			break;
+		case native_optimal_solver_input_method: ///< Native (the problem is solved in-process)
+			os << "native";
+			break;
 		case netflo_optimal_solver_input_method: ///< NETFLO (http://www.mcs.anl.gov/otc/Guide/SoftwareGuide/Blurbs/netflo.html)
 			os << "NETFLO";
 			break;
@@ -10,7 +10,8 @@ namespace dcs { namespace des { namespace cloud { namespace config {
 
 enum output_analysis_category
 {
-	independent_replications_output_analysis
+	independent_replications_output_analysis,
+	batch_means_output_analysis
 };
 
 
@@ -87,17 +88,34 @@ struct independent_replications_output_analysis_config
 };
 
 
+/// Batch means over a single long run: after the warm-up period, the run is
+/// split into \c num_batches batches of \c batch_duration time units each.
+template <typename RealT, typename UIntT>
+struct batch_means_output_analysis_config
+{
+	typedef RealT real_type;
+	typedef UIntT uint_type;
+
+	real_type warmup_duration;
+	real_type batch_duration;
+	uint_type num_batches;
+};
+
+
 template <typename RealT, typename UIntT>
 struct simulation_output_analysis_config
 {
 	typedef RealT real_type;
 	typedef UIntT uint_type;
 	typedef independent_replications_output_analysis_config<real_type,uint_type> independent_replications_config_type;
+	typedef batch_means_output_analysis_config<real_type,uint_type> batch_means_config_type;
 
 	real_type confidence_level;
 	real_type relative_precision;
+	uint_type parallelism; ///< Max number of replications to run concurrently.
 	output_analysis_category category;
-	::boost::variant<independent_replications_config_type> category_conf;
+	::boost::variant<independent_replications_config_type,
+					 batch_means_config_type> category_conf;
 };
 
 
@@ -109,6 +127,7 @@ struct simulation_config
 	typedef simulation_output_analysis_config<real_type,uint_type> output_analysis_config_type;
 
 	output_analysis_config_type output_analysis;
+	uint_type control_parallelism; ///< Max number of threads computing the application control steps of a tick (when greater than 1, steps read the VM shares at the beginning of the tick, so results differ from single-threaded runs if applications share machines).
 };
 
 
@@ -120,6 +139,9 @@ template <typename CharT, typename CharTraitsT>
 		case independent_replications_output_analysis:
 			os << "independent-replication";
 			break;
+		case batch_means_output_analysis:
+			os << "batch-means";
+			break;
 	}
 
 	return os;
@@ -185,12 +207,26 @@ template <typename CharT, typename CharTraitsT, typename RealT, typename UIntT>
 }
 
 
+template <typename CharT, typename CharTraitsT, typename RealT, typename UIntT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, batch_means_output_analysis_config<RealT,UIntT> const& conf)
+{
+	os << "<(batch-means-output-analysis)"
+	   << " warmup-duration: " << conf.warmup_duration
+	   << ", batch-duration: " << conf.batch_duration
+	   << ", num-batches: " << conf.num_batches
+	   << ">";
+
+	return os;
+}
+
+
 template <typename CharT, typename CharTraitsT, typename RealT, typename UIntT>
 ::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, simulation_output_analysis_config<RealT,UIntT> const& conf)
 {
 	os << "<(output-analysis)"
 	   << " confidence-level: " << conf.confidence_level
 	   << " relative-precision: " << conf.relative_precision
+	   << ", parallelism: " << conf.parallelism
 	   << ", method: " << conf.category_conf
 	   << ">";
 
@@ -203,6 +239,7 @@ template <typename CharT, typename CharTraitsT, typename RealT, typename UIntT>
 {
 	os << "<(simulation)"
 	   << " output-analysis: " << conf.output_analysis
+	   << ", control-parallelism: " << conf.control_parallelism
 	   << ">";
 
 	return os;
@@ -3,6 +3,7 @@
 
 
 #include <boost/variant.hpp>
+#include <cstddef>
 #include <dcs/des/statistic_categories.hpp>
 #include <dcs/macro.hpp>
 #include <iosfwd>
@@ -20,6 +21,27 @@ enum statistic_category
 };
 
 
+enum transient_detector_category
+{
+	none_transient_detector,
+	mser_transient_detector
+};
+
+
+struct none_transient_detector_config
+{
+	// empty
+};
+
+
+/// Truncation of the initial transient by means of the MSER rule over
+/// batches of \c batch_size observations (i.e., MSER-5 by default).
+struct mser_transient_detector_config
+{
+	::std::size_t batch_size;
+};
+
+
 struct max_statistic_config
 {
 	// empty
@@ -55,12 +77,27 @@ struct statistic_config
 	typedef mean_statistic_config mean_statistic_config_type;
 	typedef min_statistic_config min_statistic_config_type;
 	typedef quantile_statistic_config<real_type> quantile_statistic_config_type;
+	typedef none_transient_detector_config none_transient_detector_config_type;
+	typedef mser_transient_detector_config mser_transient_detector_config_type;
+
+
+	statistic_config()
+	: category(mean_statistic),
+	  category_conf(mean_statistic_config_type()),
+	  transient_category(none_transient_detector),
+	  transient_category_conf(none_transient_detector_config_type())
+	{
+	}
+
 
 	statistic_category category;
 	::boost::variant<max_statistic_config_type,
 					 mean_statistic_config_type,
 					 min_statistic_config_type,
 					 quantile_statistic_config_type> category_conf;
+	transient_detector_category transient_category;
+	::boost::variant<none_transient_detector_config_type,
+					 mser_transient_detector_config_type> transient_category_conf;
 };
 
 
@@ -124,11 +161,32 @@ template <typename CharT, typename CharTraitsT, typename RealT>
 }
 
 
+template <typename CharT, typename CharTraitsT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, none_transient_detector_config const& conf)
+{
+	DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING(conf);
+
+	os << "none";
+
+	return os;
+}
+
+
+template <typename CharT, typename CharTraitsT>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, mser_transient_detector_config const& conf)
+{
+	os << "mser: " << conf.batch_size;
+
+	return os;
+}
+
+
 template <typename CharT, typename CharTraitsT, typename RealT>
 ::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, statistic_config<RealT> const& conf)
 {
 	os << "<(statistic)"
 	   << " " << conf.category_conf
+	   << ", transient: " << conf.transient_category_conf
 	   << ">";
 
 	return os;
@@ -224,6 +224,10 @@ output_analysis_category text_to_output_analysis_category(::std::string const& s
 	{
 		return independent_replications_output_analysis;
 	}
+	if (!istr.compare("batch-means"))
+	{
+		return batch_means_output_analysis;
+	}
 
 	throw ::std::runtime_error("[dcs::des::cloud::config::detail::text_to_output_analysis_category] Unknown simulation output analysis category.");
 }
@@ -246,6 +250,23 @@ statistic_category text_to_statistic_category(::std::string const& str)
 }
 
 
+transient_detector_category text_to_transient_detector_category(::std::string const& str)
+{
+	::std::string istr = ::dcs::string::to_lower_copy(str);
+
+	if (!istr.compare("none"))
+	{
+		return none_transient_detector;
+	}
+	if (!istr.compare("mser"))
+	{
+		return mser_transient_detector;
+	}
+
+	throw ::std::runtime_error("[dcs::des::cloud::config::detail::text_to_transient_detector_category] Unknown transient detector category.");
+}
+
+
 probability_distribution_category text_to_probability_distribution_category(::std::string const& str)
 {
 	::std::string istr = ::dcs::string::to_lower_copy(str);
@@ -424,6 +445,10 @@ initial_placement_strategy_category text_to_initial_placement_strategy_category(
 	{
 		return optimal_initial_placement_strategy;
 	}
+	if (!istr.compare("portfolio"))
+	{
+		return portfolio_initial_placement_strategy;
+	}
 
 	throw ::std::runtime_error("[dcs::des::cloud::config::detail::text_to_initial_placement_strategy_category] Unknown initial VM placement strategy category.");
 }
@@ -441,6 +466,10 @@ incremental_placement_strategy_category text_to_incremental_placement_strategy_c
 	{
 		return best_fit_decreasing_incremental_placement_strategy;
 	}
+	if (!istr.compare("portfolio"))
+	{
+		return portfolio_incremental_placement_strategy;
+	}
 
 	throw ::std::runtime_error("[dcs::des::cloud::config::detail::text_to_incremental_placement_strategy_category] Unknown incremental VM placement strategy category.");
 }
@@ -772,6 +801,10 @@ optimal_solver_input_methods text_to_optimal_solver_input_method(::std::string c
 	{
 		return mps_optimal_solver_input_method;
 	}
+	if (!istr.compare("native"))
+	{
+		return native_optimal_solver_input_method;
+	}
 	if (!istr.compare("netflo"))
 	{
 		return netflo_optimal_solver_input_method;
@@ -1347,6 +1380,58 @@ void operator>>(::YAML::Node const& node, statistic_config<RealT>& conf)
 			}
 			break;
 	}
+
+	// Read Initial Transient Detector
+	if (node.FindValue("transient"))
+	{
+		::YAML::Node const& subnode = node["transient"];
+
+		subnode["type"] >> label;
+		conf.transient_category = detail::text_to_transient_detector_category(label);
+	}
+	else
+	{
+		conf.transient_category = none_transient_detector;
+	}
+	switch (conf.transient_category)
+	{
+		case none_transient_detector:
+			{
+				typedef typename config_type::none_transient_detector_config_type config_impl_type;
+
+				config_impl_type conf_impl;
+
+				conf.transient_category_conf = conf_impl;
+			}
+			break;
+		case mser_transient_detector:
+			{
+				typedef typename config_type::mser_transient_detector_config_type config_impl_type;
+
+				// Truncation is only defined for the mean
+				if (conf.category != mean_statistic)
+				{
+					throw ::std::runtime_error("[dcs::des::cloud::config::>>] MSER transient detection is only available for the mean statistic.");
+				}
+
+				::YAML::Node const& subnode = node["transient"];
+
+				config_impl_type conf_impl;
+
+				if (subnode.FindValue("batch-size"))
+				{
+					subnode["batch-size"] >> conf_impl.batch_size;
+				}
+				else
+				{
+					// Default to MSER-5
+					conf_impl.batch_size = 5;
+				}
+
+				conf.transient_category_conf = conf_impl;
+			}
+			break;
+	}
 }
 
 
@@ -1541,6 +1626,34 @@ void operator>>(::YAML::Node const& node, independent_replications_output_analys
 }
 
 
+template <typename RealT, typename UIntT>
+void operator>>(::YAML::Node const& node, batch_means_output_analysis_config<RealT,UIntT>& analysis)
+{
+	// Read Warm-up Duration
+	if (node.FindValue("warmup-duration"))
+	{
+		node["warmup-duration"] >> analysis.warmup_duration;
+	}
+	else
+	{
+		analysis.warmup_duration = 0;
+	}
+
+	// Read Batch Duration
+	node["batch-duration"] >> analysis.batch_duration;
+
+	// Read Number of Batches
+	if (node.FindValue("num-batches"))
+	{
+		node["num-batches"] >> analysis.num_batches;
+	}
+	else
+	{
+		analysis.num_batches = 30;
+	}
+}
+
+
 template <typename RealT, typename UIntT>
 void operator>>(::YAML::Node const& node, simulation_config<RealT,UIntT>& sim)
 {
@@ -1569,6 +1682,14 @@ void operator>>(::YAML::Node const& node, simulation_config<RealT,UIntT>& sim)
 					output_analysis_conf.category_conf = conf;
 				}
 				break;
+			case batch_means_output_analysis:
+				{
+					batch_means_output_analysis_config<RealT,UIntT> conf;
+					subnode >> conf;
+
+					output_analysis_conf.category_conf = conf;
+				}
+				break;
 		}
 
 		// Read Confidence Level
@@ -1594,8 +1715,30 @@ void operator>>(::YAML::Node const& node, simulation_config<RealT,UIntT>& sim)
 			output_analysis_conf.relative_precision = ::std::numeric_limits<RealT>::infinity();
 		}
 
+		// Read Parallelism
+		if (subnode.FindValue("parallelism"))
+		{
+			subnode["parallelism"] >> output_analysis_conf.parallelism;
+		}
+		else
+		{
+			// Default to sequential execution
+			output_analysis_conf.parallelism = 1;
+		}
+
 		sim.output_analysis = output_analysis_conf;
 	}
+
+	// Read Control Parallelism
+	if (node.FindValue("control-parallelism"))
+	{
+		node["control-parallelism"] >> sim.control_parallelism;
+	}
+	else
+	{
+		// Default to sequential control steps
+		sim.control_parallelism = 1;
+	}
 }
 
 
@@ -3385,8 +3528,16 @@ void operator>>(::YAML::Node const& node, initial_placement_strategy_config<Real
 				strategy_conf_impl.category = detail::text_to_optimal_solver_category(label);
 				node["input"] >> label;
 				strategy_conf_impl.input_method = detail::text_to_optimal_solver_input_method(label);
-				node["solver"] >> label;
-				strategy_conf_impl.solver_id = detail::text_to_optimal_solver_id(label);
+				if (node.FindValue("solver") || strategy_conf_impl.input_method != native_optimal_solver_input_method)
+				{
+					node["solver"] >> label;
+					strategy_conf_impl.solver_id = detail::text_to_optimal_solver_id(label);
+				}
+				else
+				{
+					// The native solver does not use any external solver: the value is only informative
+					strategy_conf_impl.solver_id = couenne_optimal_solver_id;
+				}
 				if (node.FindValue("solver-proxy"))
 				{
 					node["solver-proxy"] >> label;
@@ -3396,6 +3547,95 @@ void operator>>(::YAML::Node const& node, initial_placement_strategy_config<Real
 				{
 					strategy_conf_impl.proxy = none_optimal_solver_proxy;
 				}
+				if (node.FindValue("solver-time-limit"))
+				{
+					node["solver-time-limit"] >> strategy_conf_impl.solver_time_limit;
+				}
+				else
+				{
+					// Default to no limit
+					strategy_conf_impl.solver_time_limit = ::std::numeric_limits<real_type>::infinity();
+				}
+				if (node.FindValue("solver-threads"))
+				{
+					node["solver-threads"] >> strategy_conf_impl.solver_threads;
+				}
+				else
+				{
+					strategy_conf_impl.solver_threads = 1;
+				}
+				if (node.FindValue("solver-cache"))
+				{
+					node["solver-cache"] >> strategy_conf_impl.solver_cache;
+				}
+				else
+				{
+					strategy_conf_impl.solver_cache = false;
+				}
+				if (node.FindValue("solver-cache-path"))
+				{
+					node["solver-cache-path"] >> strategy_conf_impl.solver_cache_path;
+				}
+
+				strategy_conf.category_conf = strategy_conf_impl;
+			}
+			break;
+		case portfolio_initial_placement_strategy:
+			{
+				typedef typename strategy_config_type::portfolio_initial_placement_strategy_config_type strategy_config_impl_type;
+
+				strategy_config_impl_type strategy_conf_impl;
+
+				// Read the strategies of the portfolio
+				{
+					::YAML::Node const& subnode = node["strategies"];
+					::std::size_t n = subnode.size();
+					for (::std::size_t i = 0; i < n; ++i)
+					{
+						strategy_config_type member_conf;
+
+						::YAML::Node const& member_node = subnode[i]["strategy"];
+						member_node >> member_conf;
+
+						strategy_conf_impl.strategies.push_back(member_conf);
+					}
+				}
+				if (node.FindValue("time-budget"))
+				{
+					node["time-budget"] >> strategy_conf_impl.time_budget;
+				}
+				else
+				{
+					// Default to no limit
+					strategy_conf_impl.time_budget = ::std::numeric_limits<real_type>::infinity();
+				}
+				// Read active machines weight
+				if (node.FindValue("active-machines-weight"))
+				{
+					node["active-machines-weight"] >> strategy_conf_impl.wn;
+				}
+				else
+				{
+					strategy_conf_impl.wn = real_type(1);
+				}
+				// Read power consumption weight
+				if (node.FindValue("power-weight"))
+				{
+					node["power-weight"] >> strategy_conf_impl.wp;
+				}
+				else
+				{
+					strategy_conf_impl.wp = real_type(1);
+				}
+				// Read sla violation weight
+				if (node.FindValue("sla-weight"))
+				{
+					node["sla-weight"] >> strategy_conf_impl.ws;
+				}
+				else
+				{
+					strategy_conf_impl.ws = real_type(1);
+				}
 
 				strategy_conf.category_conf = strategy_conf_impl;
 			}
@@ -3416,7 +3656,8 @@ void operator>>(::YAML::Node const& node, initial_placement_strategy_config<Real
 template <typename RealT>
 void operator>>(::YAML::Node const& node, incremental_placement_strategy_config<RealT>& strategy_conf)
 {
-	typedef incremental_placement_strategy_config<RealT> strategy_config_type;
+	typedef RealT real_type;
+	typedef incremental_placement_strategy_config<real_type> strategy_config_type;
 
 	::std::string label;
 
@@ -3444,6 +3685,66 @@ void operator>>(::YAML::Node const& node, incremental_placement_strategy_config<
 				strategy_conf.category_conf = strategy_conf_impl;
 			}
 			break;
+		case portfolio_incremental_placement_strategy:
+			{
+				typedef typename strategy_config_type::portfolio_incremental_placement_strategy_config_type strategy_config_impl_type;
+
+				strategy_config_impl_type strategy_conf_impl;
+
+				// Read the strategies of the portfolio
+				{
+					::YAML::Node const& subnode = node["strategies"];
+					::std::size_t n = subnode.size();
+					for (::std::size_t i = 0; i < n; ++i)
+					{
+						strategy_config_type member_conf;
+
+						::YAML::Node const& member_node = subnode[i]["strategy"];
+						member_node >> member_conf;
+
+						strategy_conf_impl.strategies.push_back(member_conf);
+					}
+				}
+				if (node.FindValue("time-budget"))
+				{
+					node["time-budget"] >> strategy_conf_impl.time_budget;
+				}
+				else
+				{
+					// Default to no limit
+					strategy_conf_impl.time_budget = ::std::numeric_limits<real_type>::infinity();
+				}
+				// Read active machines weight
+				if (node.FindValue("active-machines-weight"))
+				{
+					node["active-machines-weight"] >> strategy_conf_impl.wn;
+				}
+				else
+				{
+					strategy_conf_impl.wn = real_type(1);
+				}
+				// Read power consumption weight
+				if (node.FindValue("power-weight"))
+				{
+					node["power-weight"] >> strategy_conf_impl.wp;
+				}
+				else
+				{
+					strategy_conf_impl.wp = real_type(1);
+				}
+				// Read sla violation weight
+				if (node.FindValue("sla-weight"))
+				{
+					node["sla-weight"] >> strategy_conf_impl.ws;
+				}
+				else
+				{
+					strategy_conf_impl.ws = real_type(1);
+				}
+
+				strategy_conf.category_conf = strategy_conf_impl;
+			}
+			break;
 	}
 
 	if (node.FindValue("ref-penalty"))
@@ -3477,6 +3778,31 @@ void operator>>(::YAML::Node const& node, migration_controller_config<RealT>& co
 
 				controller_config_impl_type controller_conf_impl;
 
+				if (node.FindValue("incremental"))
+				{
+					node["incremental"] >> controller_conf_impl.incremental;
+				}
+				else
+				{
+					controller_conf_impl.incremental = false;
+				}
+				if (node.FindValue("hot-threshold"))
+				{
+					node["hot-threshold"] >> controller_conf_impl.hot_threshold;
+				}
+				else
+				{
+					controller_conf_impl.hot_threshold = real_type(1);
+				}
+				if (node.FindValue("cold-threshold"))
+				{
+					node["cold-threshold"] >> controller_conf_impl.cold_threshold;
+				}
+				else
+				{
+					controller_conf_impl.cold_threshold = real_type(0.3);
+				}
+
 				controller_conf.category_conf = controller_conf_impl;
 			}
 			break;
@@ -3517,8 +3843,16 @@ void operator>>(::YAML::Node const& node, migration_controller_config<RealT>& co
 				controller_conf_impl.category = detail::text_to_optimal_solver_category(label);
 				node["input"] >> label;
 				controller_conf_impl.input_method = detail::text_to_optimal_solver_input_method(label);
-				node["solver"] >> label;
-				controller_conf_impl.solver_id = detail::text_to_optimal_solver_id(label);
+				if (node.FindValue("solver") || controller_conf_impl.input_method != native_optimal_solver_input_method)
+				{
+					node["solver"] >> label;
+					controller_conf_impl.solver_id = detail::text_to_optimal_solver_id(label);
+				}
+				else
+				{
+					// The native solver does not use any external solver: the value is only informative
+					controller_conf_impl.solver_id = couenne_optimal_solver_id;
+				}
 				if (node.FindValue("solver-proxy"))
 				{
 					node["solver-proxy"] >> label;
@@ -3528,6 +3862,61 @@ void operator>>(::YAML::Node const& node, migration_controller_config<RealT>& co
 				{
 					controller_conf_impl.proxy = none_optimal_solver_proxy;
 				}
+				if (node.FindValue("solver-time-limit"))
+				{
+					node["solver-time-limit"] >> controller_conf_impl.solver_time_limit;
+				}
+				else
+				{
+					// Default to no limit
+					controller_conf_impl.solver_time_limit = ::std::numeric_limits<real_type>::infinity();
+				}
+				if (node.FindValue("solver-threads"))
+				{
+					node["solver-threads"] >> controller_conf_impl.solver_threads;
+				}
+				else
+				{
+					controller_conf_impl.solver_threads = 1;
+				}
+				if (node.FindValue("solver-cache"))
+				{
+					node["solver-cache"] >> controller_conf_impl.solver_cache;
+				}
+				else
+				{
+					controller_conf_impl.solver_cache = false;
+				}
+				if (node.FindValue("solver-cache-path"))
+				{
+					node["solver-cache-path"] >> controller_conf_impl.solver_cache_path;
+				}
+				if (node.FindValue("solver-cache-tolerance"))
+				{
+					node["solver-cache-tolerance"] >> controller_conf_impl.solver_cache_tolerance;
+				}
+				else
+				{
+					// Default to exact matches
+					controller_conf_impl.solver_cache_tolerance = 0;
+				}
+				if (node.FindValue("async-solver"))
+				{
+					node["async-solver"] >> controller_conf_impl.async_solver;
+				}
+				else
+				{
+					controller_conf_impl.async_solver = false;
+				}
+				if (node.FindValue("decision-delay"))
+				{
+					node["decision-delay"] >> controller_conf_impl.decision_delay;
+				}
+				else
+				{
+					// Default to the next control event
+					controller_conf_impl.decision_delay = 0;
+				}
 
 				controller_conf.category_conf = controller_conf_impl;
 			}
@@ -31,6 +31,7 @@
 #include <dcs/des/cloud/base_physical_machine_controller.hpp>
 #include <dcs/des/cloud/physical_resource_category.hpp>
 #include <dcs/des/cloud/power_status.hpp>
+#include <dcs/des/cloud/resource_vector.hpp>
 //#include <dcs/des/cloud/registry.hpp>
 #include <dcs/macro.hpp>
 
@@ -67,7 +68,7 @@ class conservative_physical_machine_controller: public base_physical_machine_con
 	private: typedef typename physical_machine_type::vmm_type vmm_type;
 	private: typedef typename vmm_type::virtual_machine_type vm_type;
 	private: typedef typename vm_type::identifier_type vm_identifier_type;
-	private: typedef ::std::map<physical_resource_category,real_type> share_container;
+	private: typedef resource_vector<real_type> share_container;
 	private: typedef ::std::map<vm_identifier_type,share_container> vm_share_container;
 
 
@@ -95,7 +96,7 @@ class conservative_physical_machine_controller: public base_physical_machine_con
 		typedef typename vm_container::const_iterator vm_iterator;
 		typedef typename share_container::const_iterator share_iterator;
 
-		vm_container actual_vms(this->machine().vmm().virtual_machines(powered_on_power_status));
+		vm_container const& actual_vms(this->machine().vmm().virtual_machines(powered_on_power_status));
 
 		vm_iterator vm_end_it(actual_vms.end());
 		for (vm_iterator vm_it = actual_vms.begin(); vm_it != vm_end_it; ++vm_it)
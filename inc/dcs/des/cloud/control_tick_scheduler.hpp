@@ -0,0 +1,603 @@
+/**
+ * \file dcs/des/cloud/control_tick_scheduler.hpp
+ *
+ * \brief Coalesced scheduling of periodic control events.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_CONTROL_TICK_SCHEDULER_HPP
+#define DCS_DES_CLOUD_CONTROL_TICK_SCHEDULER_HPP
+
+
+#include <algorithm>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/utility.hpp>
+#include <cstddef>
+#include <exception>
+#include <dcs/assert.hpp>
+#include <dcs/des/engine_traits.hpp>
+#include <dcs/functional/bind.hpp>
+#include <dcs/macro.hpp>
+#include <dcs/memory.hpp>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace cloud {
+
+template <typename TraitsT>
+class registry;
+
+template <typename TraitsT>
+class scoped_registry;
+
+
+/**
+ * \brief A control step which can be computed concurrently with the other
+ *  steps of the same control tick.
+ *
+ * The computation must only touch the state of the step itself; any effect on
+ * the shared simulation state must be deferred until the step's own control
+ * event handler is run.
+ */
+template <typename TraitsT>
+class base_concurrent_control_step
+{
+	public: typedef TraitsT traits_type;
+	private: typedef typename traits_type::des_engine_type des_engine_type;
+	public: typedef typename ::dcs::des::engine_traits<des_engine_type>::engine_context_type des_engine_context_type;
+	public: typedef typename ::dcs::des::engine_traits<des_engine_type>::event_type des_event_type;
+
+
+	public: virtual ~base_concurrent_control_step()
+	{
+	}
+
+
+	/// Tell if this step has to be computed concurrently in the current tick.
+	public: bool concurrent() const
+	{
+		return do_concurrent();
+	}
+
+
+	/// Compute this step (possibly in a thread other than the DES one).
+	public: void compute(des_event_type const& evt, des_engine_context_type& ctx)
+	{
+		do_compute(evt, ctx);
+	}
+
+
+	private: virtual bool do_concurrent() const = 0;
+
+
+	private: virtual void do_compute(des_event_type const& evt, des_engine_context_type& ctx) = 0;
+};
+
+
+/**
+ * \brief Coalesced scheduling of periodic control events.
+ *
+ * Controllers sharing the same sampling time are connected to the same control
+ * event source, which is scheduled once per period in the DES engine.
+ * Hence, each control tick puts one event for each distinct sampling time in
+ * the event calendar (instead of one for each controller), and all the
+ * controllers of that sampling time are run one after the other, in the order
+ * they have been connected.
+ *
+ * The first tick of each sampling time is scheduled at system initialization
+ * (or at connection time, for sampling times first connected in the middle of
+ * a run), and a sampling time keeps ticking as long as some handler is
+ * connected to it.
+ *
+ * When more than one thread is allowed (see \c num_threads), the concurrent
+ * control steps connected to a sampling time can be computed in parallel,
+ * once per tick, by means of \c run_concurrent_steps.
+ */
+template <typename TraitsT>
+class control_tick_scheduler: ::boost::noncopyable
+{
+	private: typedef control_tick_scheduler<TraitsT> self_type;
+	public: typedef TraitsT traits_type;
+	public: typedef typename traits_type::real_type real_type;
+	public: typedef typename traits_type::des_engine_type des_engine_type;
+	public: typedef ::dcs::shared_ptr<des_engine_type> des_engine_pointer;
+	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::engine_context_type des_engine_context_type;
+	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::event_type des_event_type;
+	public: typedef typename ::dcs::des::engine_traits<des_engine_type>::event_source_type des_event_source_type;
+	public: typedef ::dcs::shared_ptr<des_event_source_type> des_event_source_pointer;
+	public: typedef base_concurrent_control_step<traits_type> concurrent_control_step_type;
+	private: typedef ::std::vector<concurrent_control_step_type*> concurrent_control_step_container;
+	private: typedef registry<traits_type> registry_type;
+	private: struct tick_group
+	{
+		tick_group()
+		: num_handlers(0),
+		  scheduled(false),
+		  steps_done(false)
+		{
+		}
+
+		des_event_source_pointer ptr_evt_src;
+		::std::size_t num_handlers;
+		bool scheduled;
+		concurrent_control_step_container steps;
+		/// Tells if the concurrent steps have already been run in the current tick
+		bool steps_done;
+	};
+	private: typedef ::std::map<real_type,tick_group> tick_group_container;
+	/// Shared state of the threads computing the concurrent steps of a tick.
+	private: struct concurrent_run
+	{
+		concurrent_run(concurrent_control_step_container const& steps_, des_event_type const& evt_, des_engine_context_type& ctx_, registry_type& reg_)
+		: steps(steps_),
+		  evt(evt_),
+		  ctx(ctx_),
+		  reg(reg_),
+		  next(0),
+		  failed(false)
+		{
+		}
+
+		void work()
+		{
+			// Controllers look the simulation context up through the registry
+			scoped_registry<traits_type> reg_scope(reg);
+
+			while (true)
+			{
+				::std::size_t i(0);
+				{
+					::boost::lock_guard< ::boost::mutex > lock(mutex);
+
+					if (failed || next == steps.size())
+					{
+						return;
+					}
+					i = next++;
+				}
+
+				try
+				{
+					steps[i]->compute(evt, ctx);
+				}
+				catch (::std::exception const& e)
+				{
+					fail(e.what());
+				}
+				catch (...)
+				{
+					fail("Unknown error.");
+				}
+			}
+		}
+
+		void fail(::std::string const& msg)
+		{
+			::boost::lock_guard< ::boost::mutex > lock(mutex);
+
+			if (!failed)
+			{
+				failed = true;
+				error = msg;
+			}
+		}
+
+		concurrent_control_step_container const& steps;
+		des_event_type const& evt;
+		des_engine_context_type& ctx;
+		registry_type& reg;
+		::boost::mutex mutex;
+		::std::size_t next;
+		bool failed;
+		::std::string error;
+	};
+
+
+	public: control_tick_scheduler()
+	: initialized_(false),
+	  num_threads_(1)
+	{
+	}
+
+
+	public: ~control_tick_scheduler()
+	{
+		disconnect_from_engine();
+	}
+
+
+	/// Set the DES engine where control ticks are scheduled.
+	public: void des_engine(des_engine_pointer const& ptr_eng)
+	{
+		disconnect_from_engine();
+
+		ptr_eng_ = ptr_eng;
+		initialized_ = false;
+
+		typedef typename tick_group_container::iterator iterator;
+		iterator end_it(groups_.end());
+		for (iterator it = groups_.begin(); it != end_it; ++it)
+		{
+			it->second.scheduled = false;
+		}
+
+		connect_to_engine();
+	}
+
+
+	/**
+	 * \brief Connect the given control event handler to the ticks of the given
+	 *  sampling time.
+	 *
+	 * The handler has the signature of a DES event handler.
+	 * It is called at every tick (regardless of whether its controller is
+	 * enabled), after the next tick has been scheduled.
+	 */
+	public: template <typename HandlerT>
+		void connect(real_type ts, HandlerT handler)
+	{
+		// pre: ts > 0
+		DCS_ASSERT(
+			ts > 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::control_tick_scheduler::connect] Invalid sampling time.")
+		);
+
+		tick_group& group(groups_[ts]);
+
+		if (!group.ptr_evt_src)
+		{
+			group.ptr_evt_src = ::dcs::make_shared<des_event_source_type>(control_event_source_name);
+
+			// Connected first, so that the next tick is scheduled before
+			// running the controllers.
+			group.ptr_evt_src->connect(
+				::dcs::functional::bind(
+					&self_type::process_tick,
+					this,
+					::dcs::functional::placeholders::_1,
+					::dcs::functional::placeholders::_2,
+					ts
+				)
+			);
+		}
+
+		group.ptr_evt_src->connect(handler);
+		++group.num_handlers;
+
+		if (initialized_ && !group.scheduled)
+		{
+			schedule_tick(ts, group);
+		}
+	}
+
+
+	/// Disconnect the given control event handler from the ticks of the given sampling time.
+	public: template <typename HandlerT>
+		void disconnect(real_type ts, HandlerT handler)
+	{
+		typename tick_group_container::iterator it(groups_.find(ts));
+
+		if (it == groups_.end() || it->second.num_handlers == 0)
+		{
+			return;
+		}
+
+		it->second.ptr_evt_src->disconnect(handler);
+		--(it->second.num_handlers);
+	}
+
+
+	/**
+	 * \brief Connect the given concurrent control step to the ticks of the
+	 *  given sampling time.
+	 *
+	 * The step is not owned by the scheduler and must be disconnected before
+	 * being destroyed.
+	 */
+	public: void connect_concurrent(real_type ts, concurrent_control_step_type* ptr_step)
+	{
+		// pre: ts > 0
+		DCS_ASSERT(
+			ts > 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::control_tick_scheduler::connect_concurrent] Invalid sampling time.")
+		);
+		// pre: ptr_step != null
+		DCS_ASSERT(
+			ptr_step,
+			throw ::std::invalid_argument("[dcs::des::cloud::control_tick_scheduler::connect_concurrent] Invalid control step.")
+		);
+
+		groups_[ts].steps.push_back(ptr_step);
+	}
+
+
+	/// Disconnect the given concurrent control step from the ticks of the given sampling time.
+	public: void disconnect_concurrent(real_type ts, concurrent_control_step_type* ptr_step)
+	{
+		typename tick_group_container::iterator it(groups_.find(ts));
+
+		if (it == groups_.end())
+		{
+			return;
+		}
+
+		concurrent_control_step_container& steps(it->second.steps);
+		typename concurrent_control_step_container::iterator step_it(::std::find(steps.begin(), steps.end(), ptr_step));
+		if (step_it != steps.end())
+		{
+			steps.erase(step_it);
+		}
+	}
+
+
+	/**
+	 * \brief Compute the concurrent control steps of the current tick of the
+	 *  given sampling time.
+	 *
+	 * Only the first call within a tick has an effect: the steps which are
+	 * concurrent at that time are shared among at most \c num_threads threads
+	 * (the calling one included), and this call returns once all of them have
+	 * been computed.
+	 * Nothing is run when a single thread is allowed or when there are less
+	 * than two concurrent steps, so that these steps are simply run in their
+	 * control event handler.
+	 */
+	public: void run_concurrent_steps(real_type ts, des_event_type const& evt, des_engine_context_type& ctx)
+	{
+		typename tick_group_container::iterator it(groups_.find(ts));
+
+		if (it == groups_.end() || it->second.steps_done)
+		{
+			return;
+		}
+
+		it->second.steps_done = true;
+
+		if (num_threads_ < 2)
+		{
+			return;
+		}
+
+		concurrent_control_step_container steps;
+		typedef typename concurrent_control_step_container::const_iterator step_iterator;
+		step_iterator end_it(it->second.steps.end());
+		for (step_iterator step_it = it->second.steps.begin(); step_it != end_it; ++step_it)
+		{
+			if ((*step_it)->concurrent())
+			{
+				steps.push_back(*step_it);
+			}
+		}
+
+		if (steps.size() < 2)
+		{
+			return;
+		}
+
+		concurrent_run run(steps, evt, ctx, registry_type::instance());
+
+		::std::size_t nw(::std::min(num_threads_, steps.size())-1);
+		::boost::thread_group workers;
+		for (::std::size_t i = 0; i < nw; ++i)
+		{
+			workers.create_thread(::dcs::functional::bind(&concurrent_run::work, &run));
+		}
+		run.work();
+		workers.join_all();
+
+		if (run.failed)
+		{
+			throw ::std::runtime_error("[dcs::des::cloud::control_tick_scheduler::run_concurrent_steps] Concurrent control step failed: " + run.error);
+		}
+	}
+
+
+	/// Set the maximum number of threads computing the concurrent control steps of a tick.
+	public: void num_threads(::std::size_t n)
+	{
+		// pre: n > 0
+		DCS_ASSERT(
+			n > 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::control_tick_scheduler::num_threads] Invalid number of threads.")
+		);
+
+		num_threads_ = n;
+	}
+
+
+	/// Return the maximum number of threads computing the concurrent control steps of a tick.
+	public: ::std::size_t num_threads() const
+	{
+		return num_threads_;
+	}
+
+
+	/// Return the control event source of the given sampling time.
+	public: des_event_source_type const& control_event_source(real_type ts) const
+	{
+		// pre: ts must have been connected
+		DCS_ASSERT(
+			groups_.count(ts) > 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::control_tick_scheduler::control_event_source] Unknown sampling time.")
+		);
+
+		return *(groups_.find(ts)->second.ptr_evt_src);
+	}
+
+
+	/// Return the number of distinct sampling times which currently have some handler.
+	public: ::std::size_t num_sampling_times() const
+	{
+		typedef typename tick_group_container::const_iterator iterator;
+
+		::std::size_t n(0);
+
+		iterator end_it(groups_.end());
+		for (iterator it = groups_.begin(); it != end_it; ++it)
+		{
+			if (it->second.num_handlers > 0)
+			{
+				++n;
+			}
+		}
+
+		return n;
+	}
+
+
+	private: void connect_to_engine()
+	{
+		if (!ptr_eng_)
+		{
+			return;
+		}
+
+		ptr_eng_->system_initialization_event_source().connect(
+			::dcs::functional::bind(
+				&self_type::process_sys_init,
+				this,
+				::dcs::functional::placeholders::_1,
+				::dcs::functional::placeholders::_2
+			)
+		);
+		ptr_eng_->system_finalization_event_source().connect(
+			::dcs::functional::bind(
+				&self_type::process_sys_finit,
+				this,
+				::dcs::functional::placeholders::_1,
+				::dcs::functional::placeholders::_2
+			)
+		);
+	}
+
+
+	private: void disconnect_from_engine()
+	{
+		if (!ptr_eng_)
+		{
+			return;
+		}
+
+		ptr_eng_->system_initialization_event_source().disconnect(
+			::dcs::functional::bind(
+				&self_type::process_sys_init,
+				this,
+				::dcs::functional::placeholders::_1,
+				::dcs::functional::placeholders::_2
+			)
+		);
+		ptr_eng_->system_finalization_event_source().disconnect(
+			::dcs::functional::bind(
+				&self_type::process_sys_finit,
+				this,
+				::dcs::functional::placeholders::_1,
+				::dcs::functional::placeholders::_2
+			)
+		);
+	}
+
+
+	//@{ Event Triggers
+
+	private: void schedule_tick(real_type ts, tick_group& group)
+	{
+		ptr_eng_->schedule_event(
+			group.ptr_evt_src,
+			ptr_eng_->simulated_time() + ts
+		);
+
+		group.scheduled = true;
+	}
+
+	//@} Event Triggers
+
+
+	//@{ Event Handlers
+
+	private: void process_sys_init(des_event_type const& evt, des_engine_context_type& ctx)
+	{
+		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( evt );
+		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( ctx );
+
+		initialized_ = true;
+
+		typedef typename tick_group_container::iterator iterator;
+		iterator end_it(groups_.end());
+		for (iterator it = groups_.begin(); it != end_it; ++it)
+		{
+			it->second.scheduled = false;
+			it->second.steps_done = false;
+			if (it->second.num_handlers > 0)
+			{
+				schedule_tick(it->first, it->second);
+			}
+		}
+	}
+
+
+	private: void process_sys_finit(des_event_type const& evt, des_engine_context_type& ctx)
+	{
+		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( evt );
+		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( ctx );
+
+		initialized_ = false;
+	}
+
+
+	private: void process_tick(des_event_type const& evt, des_engine_context_type& ctx, real_type ts)
+	{
+		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( evt );
+		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( ctx );
+
+		tick_group& group(groups_[ts]);
+
+		group.scheduled = false;
+		group.steps_done = false;
+		if (group.num_handlers > 0)
+		{
+			schedule_tick(ts, group);
+		}
+	}
+
+	//@} Event Handlers
+
+
+	private: static const ::std::string control_event_source_name;
+
+
+	private: des_engine_pointer ptr_eng_;
+	/// Tells if the system has been initialized in the current replication
+	private: bool initialized_;
+	private: tick_group_container groups_;
+	private: ::std::size_t num_threads_;
+};
+
+template <typename TraitsT>
+const ::std::string control_tick_scheduler<TraitsT>::control_event_source_name("Control Tick");
+
+}}} // Namespace dcs::des::cloud
+
+
+#endif // DCS_DES_CLOUD_CONTROL_TICK_SCHEDULER_HPP
@@ -26,6 +26,7 @@
 #define DCS_DES_CLOUD_DATA_CENTER_HPP
 
 
+#include <algorithm>
 #include <cstddef>
 #include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
@@ -35,6 +36,7 @@
 #include <dcs/des/cloud/logging.hpp>
 #include <dcs/des/cloud/multi_tier_application.hpp>
 #include <dcs/des/cloud/physical_machine.hpp>
+#include <dcs/des/cloud/physical_resource_category.hpp>
 #include <dcs/des/cloud/power_status.hpp>
 #include <dcs/des/cloud/virtual_machine.hpp>
 #include <dcs/des/cloud/virtual_machines_placement.hpp>
@@ -73,38 +75,45 @@ class data_center
 	public: typedef ::dcs::shared_ptr<application_controller_type> application_controller_pointer;
 	public: typedef ::dcs::shared_ptr<physical_machine_controller_type> physical_machine_controller_pointer;
 	public: typedef virtual_machines_placement<traits_type> virtual_machines_placement_type;
-	private: typedef ::std::map<application_identifier_type,application_pointer> application_container;
-	private: typedef ::std::map<application_identifier_type,application_controller_pointer> application_controller_container;
-	private: typedef ::std::map<physical_machine_identifier_type,physical_machine_pointer> physical_machine_container;
-	private: typedef ::std::map<physical_machine_identifier_type,physical_machine_controller_pointer> physical_machine_controller_container;
+	private: typedef ::std::vector<application_pointer> application_container;
+	private: typedef ::std::vector<application_controller_pointer> application_controller_container;
+	private: typedef ::std::vector<physical_machine_pointer> physical_machine_container;
+	private: typedef ::std::vector<physical_machine_controller_pointer> physical_machine_controller_container;
 	public: typedef virtual_machine<traits_type> virtual_machine_type;
 	public: typedef ::dcs::shared_ptr<virtual_machine_type> virtual_machine_pointer;
 #ifdef DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
 	public: typedef data_center_manager<traits_type>* manager_pointer;
 #endif // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
-	private: typedef ::std::map<virtual_machine_identifier_type,virtual_machine_pointer> virtual_machine_container;
-	private: typedef registry<traits_type> registry_type;
+	private: typedef ::std::vector<virtual_machine_pointer> virtual_machine_container;
+	public: typedef registry<traits_type> registry_type;
+	public: typedef ::dcs::shared_ptr<registry_type> registry_pointer;
 	private: typedef typename traits_type::uint_type uint_type;
+	private: typedef typename traits_type::real_type real_type;
 	private: typedef typename application_type::application_tier_type application_tier_type;
 	private: typedef ::dcs::shared_ptr<application_tier_type> application_tier_pointer;
-	private: typedef ::std::set<virtual_machine_identifier_type> deployed_application_vm_container;
-	private: typedef ::std::map<
-						application_identifier_type,
-						deployed_application_vm_container
-					> deployed_application_container;
+	private: typedef ::std::vector<virtual_machine_container> application_vm_container;
+	private: typedef ::std::size_t size_type;
 	private: typedef typename traits_type::des_engine_type des_engine_type;
 	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::event_type des_event_type;
 	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::engine_context_type des_engine_context_type;
 	private: typedef ::std::set<application_identifier_type> application_id_container;
 
 
-	/// Default constructor
+	/// Default constructor (uses the registry bound to the calling thread).
 	public: data_center()
 	{
 		init();
 	}
 
 
+	/// A constructor with an explicit simulation context.
+	public: explicit data_center(registry_pointer const& ptr_reg)
+	: ptr_reg_(ptr_reg)
+	{
+		init();
+	}
+
+
 	/// Copy constructor.
 	private: data_center(data_center const& that)
 	{
@@ -149,9 +158,10 @@ class data_center
 
 		application_identifier_type id;
 
-		id = registry<traits_type>::instance().application_id_generator()();
-		apps_[id] = ptr_app;
-		app_ctrls_[id] = ptr_app_control;
+		id = reg().application_id_generator()();
+		store(apps_, id, ptr_app);
+		store(app_ctrls_, id, ptr_app_control);
+		app_list_.push_back(ptr_app);
 ::std::cerr << "[data_center] Added APPLICATION: " << *ptr_app << " (" << ptr_app << ")" << ::std::endl;///XXX
 		ptr_app->id(id);
 ::std::cerr << "[data_center] Change ID to APPLICATION: " << *ptr_app << " (" << ptr_app << ")" << ::std::endl;///XXX
@@ -160,6 +170,10 @@ class data_center
 		{
 			deploy_application(id);
 		}
+		else
+		{
+			update_active_lists();
+		}
 
 		ptr_app->data_centre(this);
 
@@ -171,14 +185,17 @@ class data_center
 	{
 		// pre: app_id must be a valid application identifier.
 		DCS_ASSERT(
-			apps_.count(app_id) > 0,
+			stored(apps_, app_id),
 			throw ::std::invalid_argument("[dcs::des::cloud::remove_application] Invalid application identifier.")
 		);
 
 		undeploy_application(app_id);
 
-		apps_.erase(app_id);
-		app_ctrls_.erase(app_id);
+		app_list_.erase(::std::find(app_list_.begin(), app_list_.end(), apps_[app_id]));
+		apps_[app_id].reset();
+		app_ctrls_[app_id].reset();
+
+		update_active_lists();
 	}
 
 
@@ -198,13 +215,20 @@ class data_center
 
 		physical_machine_identifier_type id;
 
-		id = registry<traits_type>::instance().physical_machine_id_generator()();
-		pms_[id] = ptr_mach;
-		pm_ctrls_[id] = ptr_mach_control;
+		id = reg().physical_machine_id_generator()();
+		store(pms_, id, ptr_mach);
+		store(pm_ctrls_, id, ptr_mach_control);
+		pm_list_.push_back(ptr_mach);
 ::std::cerr << "[data_center] Added PHYSICAL-MACHINE: " << *ptr_mach << " (" << ptr_mach << ")" << ::std::endl;///XXX
 		ptr_mach->id(id);
 ::std::cerr << "[data_center] Change ID to PHYSICAL-MACHINE: " << *ptr_mach << " (" << ptr_mach << ")" << ::std::endl;///XXX
 
+		pms_by_capacity_.insert(::std::upper_bound(pms_by_capacity_.begin(),
+												   pms_by_capacity_.end(),
+												   ptr_mach,
+												   &self_type::physical_machine_capacity_less),
+								ptr_mach);
+
 		return id;
 	}
 
@@ -213,12 +237,14 @@ class data_center
 	{
 		// pre: mach_id must be a valid physical machine identifier.
 		DCS_ASSERT(
-			pms_.count(mach_id) > 0,
+			stored(pms_, mach_id),
 			throw ::std::invalid_argument("[dcs::des::cloud::remove_physical_machine] Invalid physical machine identifier.")
 		);
 
-		pms_.erase(mach_id);
-		pm_ctrls_.erase(mach_id);
+		pms_by_capacity_.erase(::std::find(pms_by_capacity_.begin(), pms_by_capacity_.end(), pms_[mach_id]));
+		pm_list_.erase(::std::find(pm_list_.begin(), pm_list_.end(), pms_[mach_id]));
+		pms_[mach_id].reset();
+		pm_ctrls_[mach_id].reset();
 	}
 
 
@@ -240,11 +266,11 @@ class data_center
 	{
 		// pre: mach_id must be a valid physical machine identifier.
 		DCS_ASSERT(
-			pms_.count(id) > 0,
+			stored(pms_, id),
 			throw ::std::invalid_argument("[dcs::des::cloud::physical_machine_ptr] Invalid physical machine identifier.")
 		);
 
-		return pms_.at(id);
+		return pms_[id];
 	}
 
 
@@ -252,7 +278,7 @@ class data_center
 	{
 		// pre: mach_id must be a valid physical machine identifier.
 		DCS_ASSERT(
-			pms_.count(id) > 0,
+			stored(pms_, id),
 			throw ::std::invalid_argument("[dcs::des::cloud::physical_machine_ptr] Invalid physical machine identifier.")
 		);
 
@@ -260,47 +286,79 @@ class data_center
 	}
 
 
-	public: ::std::vector<physical_machine_pointer> physical_machines() const
+	/// Returns all the physical machines sorted by identifier.
+	public: ::std::vector<physical_machine_pointer> const& physical_machines() const
 	{
-		typedef ::std::vector<physical_machine_pointer> result_container;
-		typedef typename physical_machine_container::const_iterator pm_iterator;
+		return pm_list_;
+	}
 
-		result_container pms;
-		pm_iterator end_it(pms_.end());
-		for (pm_iterator it = pms_.begin(); it != end_it; ++it)
-		{
-			// check: paranoid check
-			DCS_DEBUG_ASSERT( it->second );
 
-			pms.push_back(it->second);
-		}
+	/**
+	 * \brief Returns all the physical machines sorted by increasing capacity.
+	 *
+	 * The capacity of a machine is the one of its CPU resource weighted by the
+	 * utilization threshold; ties are broken by machine identifier.
+	 * The order is kept up-to-date as machines are added and removed, so
+	 * placement strategies need not sort machines at every decision.
+	 */
+	public: ::std::vector<physical_machine_pointer> const& physical_machines_by_capacity() const
+	{
+		return pms_by_capacity_;
+	}
+
+
+	public: ::std::vector<physical_machine_pointer> physical_machines(power_status status) const
+	{
+		::std::vector<physical_machine_pointer> pms;
+
+		physical_machines(status, pms);
 
 		return pms;
 	}
 
 
-	public: ::std::vector<physical_machine_pointer> physical_machines(power_status status) const
+	/**
+	 * \brief Fills \a pms with the physical machines in the given power status,
+	 *  sorted by identifier.
+	 *
+	 * Power status changes are notified through the event calendar, so the
+	 * machines are filtered at every call rather than kept in per-status
+	 * lists.
+	 * Reusing the same \a pms across calls avoids both allocations and, for
+	 * machines which keep their position, reference-count updates.
+	 */
+	public: void physical_machines(power_status status, ::std::vector<physical_machine_pointer>& pms) const
 	{
-		typedef ::std::vector<physical_machine_pointer> result_container;
 		typedef typename physical_machine_container::const_iterator pm_iterator;
 
-		result_container pms;
+		size_type n(0);
 
-		pm_iterator end_it(pms_.end());
-		for (pm_iterator it = pms_.begin(); it != end_it; ++it)
+		pm_iterator end_it(pm_list_.end());
+		for (pm_iterator it = pm_list_.begin(); it != end_it; ++it)
 		{
-			physical_machine_pointer ptr_pm(it->second);
+			physical_machine_pointer const& ptr_pm(*it);
 
 			// check: paranoid check
 			DCS_DEBUG_ASSERT( ptr_pm );
 
 			if (ptr_pm->power_state() == status)
 			{
-				pms.push_back(ptr_pm);
+				if (n < pms.size())
+				{
+					if (pms[n] != ptr_pm)
+					{
+						pms[n] = ptr_pm;
+					}
+				}
+				else
+				{
+					pms.push_back(ptr_pm);
+				}
+				++n;
 			}
 		}
 
-		return pms;
+		pms.resize(n);
 	}
 
 
@@ -312,10 +370,10 @@ class data_center
 
 		result_container pms;
 
-		pm_iterator end_it(pms_.end());
-		for (pm_iterator it = pms_.begin(); it != end_it; ++it)
+		pm_iterator end_it(pm_list_.end());
+		for (pm_iterator it = pm_list_.begin(); it != end_it; ++it)
 		{
-			physical_machine_pointer ptr_pm(it->second);
+			physical_machine_pointer const& ptr_pm(*it);
 
 			// check: paranoid check
 			DCS_DEBUG_ASSERT( ptr_pm );
@@ -334,11 +392,11 @@ class data_center
 	{
 		// pre: id must be a valid physical machine identifier.
 		DCS_ASSERT(
-			pm_ctrls_.count(id) > 0,
+			stored(pm_ctrls_, id),
 			throw ::std::invalid_argument("[dcs::des::cloud::physical_machine_controller] Invalid physical machine identifier.")
 		);
 
-		return *(pm_ctrls_.at(id));
+		return *(pm_ctrls_[id]);
 	}
 
 
@@ -346,7 +404,7 @@ class data_center
 	{
 		// pre: id must be a valid physical machine identifier.
 		DCS_ASSERT(
-			pm_ctrls_.count(id) > 0,
+			stored(pm_ctrls_, id),
 			throw ::std::invalid_argument("[dcs::des::cloud::physical_machine_controller] Invalid physical machine identifier.")
 		);
 
@@ -357,11 +415,11 @@ class data_center
 	{
 		// pre: id must be a valid physical machine identifier.
 		DCS_ASSERT(
-			pm_ctrls_.count(id) > 0,
+			stored(pm_ctrls_, id),
 			throw ::std::invalid_argument("[dcs::des::cloud::physical_machine_controller_ptr] Invalid physical machine identifier.")
 		);
 
-		return pm_ctrls_.at(id);
+		return pm_ctrls_[id];
 	}
 
 
@@ -369,7 +427,7 @@ class data_center
 	{
 		// pre: id must be a valid physical machine identifier.
 		DCS_ASSERT(
-			pm_ctrls_.count(id) > 0,
+			stored(pm_ctrls_, id),
 			throw ::std::invalid_argument("[dcs::des::cloud::physical_machine_controller_ptr] Invalid physical machine identifier.")
 		);
 
@@ -381,11 +439,11 @@ class data_center
 	{
 		// pre: id must be a valid application identifier.
 		DCS_ASSERT(
-			app_ctrls_.count(id) > 0,
+			stored(app_ctrls_, id),
 			throw ::std::invalid_argument("[dcs::des::cloud::application_controller] Invalid application identifier.")
 		);
 
-		return *(app_ctrls_.at(id));
+		return *(app_ctrls_[id]);
 	}
 
 
@@ -393,7 +451,7 @@ class data_center
 	{
 		// pre: id must be a valid application identifier.
 		DCS_ASSERT(
-			app_ctrls_.count(id) > 0,
+			stored(app_ctrls_, id),
 			throw ::std::invalid_argument("[dcs::des::cloud::application_controller] Invalid application identifier.")
 		);
 
@@ -401,23 +459,45 @@ class data_center
 	}
 
 
-	public: application_controller_pointer application_controller_ptr(application_identifier_type id) const
+	/**
+	 * \brief Replace the controller of the given application.
+	 *
+	 * The old controller is disabled, while the new one inherits its enabled
+	 * state (and, if enabled, gets its first control event scheduled).
+	 *
+	 * \return The old controller.
+	 */
+	public: application_controller_pointer application_controller(application_identifier_type id, application_controller_pointer const& ptr_app_control)
 	{
 		// pre: id must be a valid application identifier.
 		DCS_ASSERT(
-			app_ctrls_.count(id) > 0,
-			throw ::std::invalid_argument("[dcs::des::cloud::application_controller_ptr] Invalid application identifier.")
+			stored(app_ctrls_, id),
+			throw ::std::invalid_argument("[dcs::des::cloud::application_controller] Invalid application identifier.")
+		);
+		// pre: ptr_app_control must be a valid application controller pointer.
+		DCS_ASSERT(
+			ptr_app_control,
+			throw ::std::invalid_argument("[dcs::des::cloud::application_controller] Invalid application controller.")
 		);
 
-		return app_ctrls_.at(id);
+		application_controller_pointer ptr_old_app_control(app_ctrls_[id]);
+
+		bool enabled(ptr_old_app_control->enabled());
+		ptr_old_app_control->enable(false);
+		// Disable first, so that the new controller goes through its enable transition
+		ptr_app_control->enable(false);
+		ptr_app_control->enable(enabled);
+		app_ctrls_[id] = ptr_app_control;
+
+		return ptr_old_app_control;
 	}
 
 
-	public: application_controller_pointer application_controller_ptr(application_identifier_type id)
+	public: application_controller_pointer application_controller_ptr(application_identifier_type id) const
 	{
 		// pre: id must be a valid application identifier.
 		DCS_ASSERT(
-			app_ctrls_.count(id) > 0,
+			stored(app_ctrls_, id),
 			throw ::std::invalid_argument("[dcs::des::cloud::application_controller_ptr] Invalid application identifier.")
 		);
 
@@ -425,52 +505,29 @@ class data_center
 	}
 
 
-	public: ::std::vector<application_pointer> applications() const
+	public: application_controller_pointer application_controller_ptr(application_identifier_type id)
 	{
-		typedef ::std::vector<application_pointer> result_container;
-		typedef typename application_container::const_iterator app_iterator;
-
-		result_container apps;
-
-		app_iterator end_it(apps_.end());
-		for (app_iterator it = apps_.begin(); it != end_it; ++it)
-		{
-			application_pointer ptr_app(it->second);
-
-			// check: paranoid check
-			DCS_DEBUG_ASSERT( ptr_app );
-
-			apps.push_back(ptr_app);
-		}
+		// pre: id must be a valid application identifier.
+		DCS_ASSERT(
+			stored(app_ctrls_, id),
+			throw ::std::invalid_argument("[dcs::des::cloud::application_controller_ptr] Invalid application identifier.")
+		);
 
-		return apps;
+		return app_ctrls_[id];
 	}
 
 
-	public: ::std::vector<application_pointer> active_applications() const
+	/// Returns all the applications sorted by identifier.
+	public: ::std::vector<application_pointer> const& applications() const
 	{
-		typedef ::std::vector<application_pointer> result_container;
-		typedef typename application_container::const_iterator app_iterator;
-
-		result_container apps;
-
-		app_iterator end_it(apps_.end());
-		for (app_iterator it = apps_.begin(); it != end_it; ++it)
-		{
-			application_pointer ptr_app(it->second);
-
-			// check: paranoid check
-			DCS_DEBUG_ASSERT( ptr_app );
-
-			if (this->inhibited_application(ptr_app->id()))
-			{
-				continue;
-			}
+		return app_list_;
+	}
 
-			apps.push_back(ptr_app);
-		}
 
-		return apps;
+	/// Returns the non-inhibited applications sorted by identifier.
+	public: ::std::vector<application_pointer> const& active_applications() const
+	{
+		return active_app_list_;
 	}
 
 
@@ -479,19 +536,19 @@ class data_center
 		// pre: app_id must be a valid ID and the related application pointer
 		//      must be valid as well.
 		DCS_ASSERT(
-				apps_.count(app_id) > 0
-				&&
-				apps_.at(app_id),
+				stored(apps_, app_id),
 				throw ::std::invalid_argument("[dcs::des::cloud::data_center::deploy_application] Invalid application identifier.")
 			);
 
-::std::cerr << "[data_center] BEGIN Deploy application: " << apps_.at(app_id) << ::std::endl;//XXX
+::std::cerr << "[data_center] BEGIN Deploy application: " << apps_[app_id] << ::std::endl;//XXX
 		if (deployed(app_id))
 		{
 			return;
 		}
 
-		uint_type ntiers = apps_.at(app_id)->num_tiers();
+		uint_type ntiers = apps_[app_id]->num_tiers();
+		store(deployed_apps_, app_id, true);
+		store(app_vms_, app_id, virtual_machine_container());
 		for (uint_type t = 0; t < ntiers; ++t)
 		{
 			application_tier_pointer ptr_tier(apps_[app_id]->tier(t));
@@ -504,17 +561,20 @@ class data_center
 
 			virtual_machine_identifier_type id;
 
-			id = registry<traits_type>::instance().virtual_machine_id_generator()();
+			id = reg().virtual_machine_id_generator()();
 
-			vms_[id] = ptr_vm;
+			store(vms_, id, ptr_vm);
+			vm_list_.push_back(ptr_vm);
 ::std::cerr << "[data_center] Added VIRTUAL-MACHINE: " << *ptr_vm << " (" << ptr_vm << ")" << ::std::endl;///XXX
 			ptr_vm->id(id);
 ::std::cerr << "[data_center] Change ID to VIRTUAL-MACHINE: " << *ptr_vm << " (" << ptr_vm << ")" << ::std::endl;///XXX
-			deployed_apps_[app_id].insert(id);
+			app_vms_[app_id].push_back(ptr_vm);
 			apps_[app_id]->simulation_model().tier_virtual_machine(ptr_vm);
 			//ptr_tier->virtual_machine(ptr_vm);
 		}
-::std::cerr << "[data_center] END Deploy application: " << apps_.at(app_id) << ::std::endl;//XXX
+
+		update_active_lists();
+::std::cerr << "[data_center] END Deploy application: " << apps_[app_id] << ::std::endl;//XXX
 	}
 
 
@@ -523,47 +583,45 @@ class data_center
 		// pre: app_id must be a valid ID and the related application pointer
 		//      must be valid as well.
 		DCS_ASSERT(
-				apps_.count(app_id) > 0
-				&&
-				apps_.at(app_id),
+				stored(apps_, app_id),
 				throw ::std::invalid_argument("[dcs::des::cloud::data_center::undeploy_application] Invalid application identifier.")
 			);
 
-		typedef typename deployed_application_container::const_iterator app_iterator;
-
-::std::cerr << "[data_center] BEGIN Undeploy application: " << apps_.at(app_id) << ::std::endl;//XXX
-		app_iterator app_it = deployed_apps_.find(app_id);
-
+::std::cerr << "[data_center] BEGIN Undeploy application: " << apps_[app_id] << ::std::endl;//XXX
 		// pre: app_id must identify an already deployed application
 		DCS_ASSERT(
-			app_it != deployed_apps_.end(),
+			deployed(app_id),
 			throw ::std::invalid_argument("[dcs::des::cloud::data_center::undeploy_application] Cannot undeploy a non-deployed application.")
 		);
 
 		// destroy all associated VMs
-		typedef typename deployed_application_vm_container::const_iterator vm_iterator;
-		vm_iterator vm_end_it(app_it->second.end());
-		for (vm_iterator vm_it = app_it->second.begin(); vm_it != vm_end_it; ++vm_it)
+		typedef typename virtual_machine_container::const_iterator vm_iterator;
+		vm_iterator vm_end_it(app_vms_[app_id].end());
+		for (vm_iterator vm_it = app_vms_[app_id].begin(); vm_it != vm_end_it; ++vm_it)
 		{
-			virtual_machine_identifier_type vm_id(*vm_it);
+			virtual_machine_identifier_type vm_id((*vm_it)->id());
 
 			// check: make sure vm_id is a valid VM identifier.
-			DCS_DEBUG_ASSERT( vms_.count(vm_id) > 0 );
+			DCS_DEBUG_ASSERT( stored(vms_, vm_id) );
 			// check: make sure vm_id refer to a valid VM
-			DCS_DEBUG_ASSERT( vms_.at(vm_id) );
+			DCS_DEBUG_ASSERT( vms_[vm_id] );
 			// check: double check on VM identifier.
-			DCS_DEBUG_ASSERT( vms_.at(vm_id)->id() == vm_id );
+			DCS_DEBUG_ASSERT( vms_[vm_id]->id() == vm_id );
 
 			// Displace this VM
-			displace_virtual_machine(vms_.at(vm_id));
+			displace_virtual_machine(vms_[vm_id]);
 
 			// Remove from the VM list
-			vms_.erase(vm_id);
+			vm_list_.erase(::std::find(vm_list_.begin(), vm_list_.end(), vms_[vm_id]));
+			vms_[vm_id].reset();
 		}
 
 		// Undeploy the application
-		deployed_apps_.erase(app_id);
-::std::cerr << "[data_center] END Undeploy application: " << apps_.at(app_id) << ::std::endl;//XXX
+		app_vms_[app_id].clear();
+		deployed_apps_[app_id] = false;
+
+		update_active_lists();
+::std::cerr << "[data_center] END Undeploy application: " << apps_[app_id] << ::std::endl;//XXX
 	}
 
 
@@ -572,18 +630,11 @@ class data_center
 		// pre: app_id must be a valid ID and the related application pointer
 		//      must be valid as well.
 		DCS_ASSERT(
-				apps_.count(id) > 0
-				&&
-				apps_.at(id),
+				stored(apps_, id),
 				throw ::std::invalid_argument("[dcs::des::cloud::data_center::deployed] Invalid application identifier.")
 			);
 
-		if (deployed_apps_.find(id) != deployed_apps_.end())
-		{
-			return true;
-		}
-
-		return false;
+		return static_cast<size_type>(id) < deployed_apps_.size() && deployed_apps_[id];
 	}
 
 
@@ -605,11 +656,11 @@ class data_center
 	{
 		// pre: id must be a valid VM id
 		DCS_ASSERT(
-				vms_.count(id) > 0,
+				stored(vms_, id),
 				DCS_EXCEPTION_THROW( ::std::invalid_argument, "Invalid virtual machine identifier." )
 			);
 
-		return vms_.at(id);
+		return vms_[id];
 	}
 
 
@@ -617,7 +668,7 @@ class data_center
 	{
 		// pre: id must be a valid VM id
 		DCS_ASSERT(
-				vms_.count(id) > 0,
+				stored(vms_, id),
 				DCS_EXCEPTION_THROW( ::std::invalid_argument, "Invalid virtual machine identifier." )
 			);
 
@@ -625,83 +676,29 @@ class data_center
 	}
 
 
-	public: ::std::vector<virtual_machine_pointer> virtual_machines() const
+	/// Returns all the virtual machines sorted by identifier.
+	public: ::std::vector<virtual_machine_pointer> const& virtual_machines() const
 	{
-		typedef ::std::vector<virtual_machine_pointer> result_container;
-		typedef typename virtual_machine_container::const_iterator vm_iterator;
-
-		result_container vms;
-		vm_iterator end_it(vms_.end());
-		for (vm_iterator it = vms_.begin(); it != end_it; ++it)
-		{
-			virtual_machine_pointer ptr_vm(it->second);
-
-			// check: paranoid check
-			DCS_DEBUG_ASSERT( ptr_vm );
-
-			vms.push_back(ptr_vm);
-		}
-
-		return vms;
+		return vm_list_;
 	}
 
 
-	public: ::std::vector<virtual_machine_pointer> active_virtual_machines() const
+	/// Returns the virtual machines of non-inhibited applications sorted by identifier.
+	public: ::std::vector<virtual_machine_pointer> const& active_virtual_machines() const
 	{
-		typedef ::std::vector<virtual_machine_pointer> result_container;
-		typedef typename virtual_machine_container::const_iterator vm_iterator;
-
-		result_container vms;
-		vm_iterator end_it(vms_.end());
-		for (vm_iterator it = vms_.begin(); it != end_it; ++it)
-		{
-			virtual_machine_pointer ptr_vm(it->second);
-
-			// check: paranoid check
-			DCS_DEBUG_ASSERT( ptr_vm );
-
-			if (this->inhibited_virtual_machine(ptr_vm->id()))
-			{
-				continue;
-			}
-
-			vms.push_back(ptr_vm);
-		}
-
-		return vms;
+		return active_vm_list_;
 	}
 
 
-	public: ::std::vector<virtual_machine_pointer> application_virtual_machines(application_identifier_type id) const
+	/// Returns the virtual machines of the given deployed application, one for each tier.
+	public: ::std::vector<virtual_machine_pointer> const& application_virtual_machines(application_identifier_type id) const
 	{
-		typedef typename deployed_application_container::const_iterator app_iterator;
-		typedef typename deployed_application_vm_container::const_iterator vm_iterator;
-
-		app_iterator app_it(deployed_apps_.find(id));
-		if (app_it == deployed_apps_.end())
+		if (!stored(apps_, id) || !deployed(id))
 		{
 			throw ::std::invalid_argument("[dcs::des::cloud::application_virtual_machines] Invalid application identifier.");
 		}
 
-		::std::vector<virtual_machine_pointer> vms;
-
-		vm_iterator vm_end_it(app_it->second.end());
-		for (vm_iterator vm_it = app_it->second.begin(); vm_it != vm_end_it; ++vm_it)
-		{
-			virtual_machine_identifier_type vm_id(*vm_it);
-
-			// check: make sure vm_id is a valid VM identifier.
-			DCS_DEBUG_ASSERT( vms_.count(vm_id) > 0 );
-			// check: make sure vm_id refer to a valid VM
-			DCS_DEBUG_ASSERT( vms_.at(vm_id) );
-			// check: double check on VM identifier.
-			DCS_DEBUG_ASSERT( vms_.at(vm_id)->id() == vm_id );
-
-
-			vms.push_back(vms_.at(vm_id));
-		}
-
-		return vms;
+		return app_vms_[id];
 	}
 
 
@@ -781,6 +778,39 @@ class data_center
 	}
 
 
+	/// Changes the resource shares of a placed VM, leaving it on its current machine.
+	public: template <typename ForwardIterT>
+		void update_virtual_machine_shares(virtual_machine_pointer const& ptr_vm,
+										   ForwardIterT first_share,
+										   ForwardIterT last_share)
+	{
+		// pre: ptr_vm must be a valid pointer
+		DCS_ASSERT(
+				ptr_vm,
+				DCS_EXCEPTION_THROW( ::std::invalid_argument, "Invalid VM pointer." )
+			);
+		// pre: the VM must be placed
+		DCS_ASSERT(
+				placement_.placed(*ptr_vm),
+				DCS_EXCEPTION_THROW( ::std::invalid_argument, "VM not placed." )
+			);
+
+		physical_machine_identifier_type pm_id(placement_.pm_id(placement_.find(*ptr_vm)));
+
+		// paranoid-check: existence
+		DCS_DEBUG_ASSERT( stored(pms_, pm_id) );
+
+		placement_.replace(*ptr_vm, *pms_[pm_id], first_share, last_share);
+
+		while (first_share != last_share)
+		{
+			ptr_vm->wanted_resource_share(first_share->first, first_share->second);
+			ptr_vm->resource_share(first_share->first, first_share->second);
+			++first_share;
+		}
+	}
+
+
 	public: void displace_virtual_machine(virtual_machine_pointer const& ptr_vm, bool power_off = true)
 	{
 		/// pre: ptr_vm must be a valid pointer
@@ -802,7 +832,7 @@ class data_center
 				physical_machine_identifier_type pm_id(placement_.pm_id(it));
 
 				// paranoid-check: existence
-				DCS_DEBUG_ASSERT( pms_.count(pm_id) > 0 );
+				DCS_DEBUG_ASSERT( stored(pms_, pm_id) );
 
 				physical_machine_pointer ptr_pm(pms_[pm_id]);
 
@@ -834,12 +864,12 @@ class data_center
 				physical_machine_identifier_type pm_id(placement_.pm_id(it));
 
 				// paranoid-check: existence
-				DCS_DEBUG_ASSERT( pms_.count(pm_id) > 0 );
+				DCS_DEBUG_ASSERT( stored(pms_, pm_id) );
 				// paranoid-check: existence
-				DCS_DEBUG_ASSERT( vms_.count(vm_id) > 0 );
+				DCS_DEBUG_ASSERT( stored(vms_, vm_id) );
 
-				physical_machine_pointer ptr_pm(pms_.at(pm_id));
-				virtual_machine_pointer ptr_vm(vms_.at(vm_id));
+				physical_machine_pointer ptr_pm(pms_[pm_id]);
+				virtual_machine_pointer ptr_vm(vms_[vm_id]);
 
 				// paranoid-check: null
 				DCS_DEBUG_ASSERT( ptr_pm );
@@ -871,16 +901,19 @@ class data_center
 
 	public: uint_type start_applications()
 	{
-		typedef typename deployed_application_container::const_iterator app_iterator;
-		//typedef typename ::std::vector<virtual_machine_identifier_type>::const_iterator vm_iterator;
-		typedef typename deployed_application_vm_container::const_iterator vm_iterator;
+		typedef typename application_container::const_iterator app_iterator;
 
 		uint_type started_apps(0);
 
-		app_iterator app_end_it(deployed_apps_.end());
-		for (app_iterator app_it(deployed_apps_.begin()); app_it != app_end_it; ++app_it)
+		app_iterator app_end_it(app_list_.end());
+		for (app_iterator app_it(app_list_.begin()); app_it != app_end_it; ++app_it)
 		{
-			application_identifier_type app_id(app_it->first);
+			application_identifier_type app_id((*app_it)->id());
+
+			if (!deployed(app_id))
+			{
+				continue;
+			}
 
 			bool started;
 
@@ -900,28 +933,27 @@ class data_center
 	{
 		// pre: id must be a valid application identifier
 		DCS_ASSERT(
-				apps_.count(app_id) > 0,
+				stored(apps_, app_id),
 				DCS_EXCEPTION_THROW( ::std::invalid_argument, "Invalid application identifier" )
 			);
 		DCS_ASSERT(
-				deployed_apps_.count(app_id) > 0,
+				deployed(app_id),
 				DCS_EXCEPTION_THROW( ::std::invalid_argument, "Invalid application identifier" )
 			);
 
-::std::cerr << "[data_center] BEGIN Start application: " << *(apps_.at(app_id)) << ::std::endl;//XXX
+::std::cerr << "[data_center] BEGIN Start application: " << *(apps_[app_id]) << ::std::endl;//XXX
 		bool startable(true);
 
 		if (!this->inhibited_application(app_id))
 		{
-			typedef typename deployed_application_container::const_iterator app_iterator;
-			typedef typename deployed_application_vm_container::const_iterator vm_iterator;
+			typedef typename virtual_machine_container::const_iterator vm_iterator;
 
-			app_iterator app_it(deployed_apps_.find(app_id));
+			virtual_machine_container const& app_vms(app_vms_[app_id]);
 
-			vm_iterator vm_end_it(app_it->second.end());
-			for (vm_iterator vm_it = app_it->second.begin(); startable && vm_it != vm_end_it; ++vm_it)
+			vm_iterator vm_end_it(app_vms.end());
+			for (vm_iterator vm_it = app_vms.begin(); startable && vm_it != vm_end_it; ++vm_it)
 			{
-				startable = placement_.placed(*vm_it);
+				startable = placement_.placed((*vm_it)->id());
 			}
 
 			if (startable)
@@ -929,12 +961,11 @@ class data_center
 	//			this->inhibit_application(app_id, false);
 
 				typedef typename virtual_machines_placement_type::const_iterator vm_placement_iterator;
-				::std::vector<virtual_machine_pointer> app_vms;
-				for (vm_iterator vm_it = app_it->second.begin(); vm_it != vm_end_it; ++vm_it)
+				for (vm_iterator vm_it = app_vms.begin(); vm_it != vm_end_it; ++vm_it)
 				{
-					vm_placement_iterator vm_place_it(placement_.find(*vm_it));
+					vm_placement_iterator vm_place_it(placement_.find((*vm_it)->id()));
 					physical_machine_pointer ptr_pm(pms_[placement_.pm_id(vm_place_it)]);
-					virtual_machine_pointer ptr_vm(vms_.at(placement_.vm_id(vm_place_it)));
+					virtual_machine_pointer ptr_vm(*vm_it);
 
 					// paranoid-check: null
 					DCS_DEBUG_ASSERT( ptr_pm );
@@ -944,14 +975,13 @@ class data_center
 					ptr_pm->vmm().power_on(ptr_vm);
 //					virtual_machine_pointer ptr_vm(vms_[*vm_it]);
 //					ptr_vm->power_on();
-					app_vms.push_back(ptr_vm);
 				}
 				this->application_ptr(app_id)->start(app_vms.begin(), app_vms.end());
 			}
 			else
 			{
 				::std::ostringstream oss;
-				oss << "Application " << app_id << " '" << *(apps_.at(app_id)) << "' cannot be started: at least one VM has not been placed.";
+				oss << "Application " << app_id << " '" << *(apps_[app_id]) << "' cannot be started: at least one VM has not been placed.";
 
 				log_warn(DCS_DES_CLOUD_LOGGING_AT, oss.str());
 			}
@@ -961,27 +991,31 @@ class data_center
 			startable = false;
 
 			::std::ostringstream oss;
-			oss << "Application " << app_id << " '" << *(apps_.at(app_id)) << "' cannot be started because it has been inhibited.";
+			oss << "Application " << app_id << " '" << *(apps_[app_id]) << "' cannot be started because it has been inhibited.";
 
 			log_warn(DCS_DES_CLOUD_LOGGING_AT, oss.str());
 		}
 
-::std::cerr << "[data_center] END Start application: " << *(apps_.at(app_id)) << ::std::endl;//XXX
+::std::cerr << "[data_center] END Start application: " << *(apps_[app_id]) << ::std::endl;//XXX
 		return startable;
 	}
 
 
 	public: uint_type stop_applications()
 	{
-		typedef typename deployed_application_container::const_iterator app_iterator;
-		typedef typename deployed_application_vm_container::const_iterator vm_iterator;
+		typedef typename application_container::const_iterator app_iterator;
 
 		uint_type stopped_apps(0);
 
-		app_iterator app_end_it(deployed_apps_.end());
-		for (app_iterator app_it(deployed_apps_.begin()); app_it != app_end_it; ++app_it)
+		app_iterator app_end_it(app_list_.end());
+		for (app_iterator app_it(app_list_.begin()); app_it != app_end_it; ++app_it)
 		{
-			application_identifier_type app_id(app_it->first);
+			application_identifier_type app_id((*app_it)->id());
+
+			if (!deployed(app_id))
+			{
+				continue;
+			}
 
 			bool stopped;
 
@@ -1001,44 +1035,40 @@ class data_center
 	{
 		// pre: id must be a valid application identifier
 		DCS_ASSERT(
-				apps_.count(app_id) > 0,
+				stored(apps_, app_id),
 				DCS_EXCEPTION_THROW( ::std::invalid_argument, "Invalid application identifier" )
 			);
 		DCS_ASSERT(
-				deployed_apps_.count(app_id) > 0,
+				deployed(app_id),
 				DCS_EXCEPTION_THROW( ::std::invalid_argument, "Invalid application identifier" )
 			);
 
-::std::cerr << "[data_center] BEGIN Stop application: " << *(apps_.at(app_id)) << ::std::endl;//XXX
+::std::cerr << "[data_center] BEGIN Stop application: " << *(apps_[app_id]) << ::std::endl;//XXX
 		bool stoppable(true);
 
 		if (!this->inhibited_application(app_id))
 		{
-			typedef typename deployed_application_container::const_iterator app_iterator;
-			typedef typename deployed_application_vm_container::const_iterator vm_iterator;
+			typedef typename virtual_machine_container::const_iterator vm_iterator;
 
-			app_iterator app_it(deployed_apps_.find(app_id));
+			virtual_machine_container const& app_vms(app_vms_[app_id]);
 
-			vm_iterator vm_end_it(app_it->second.end());
-			for (vm_iterator vm_it = app_it->second.begin(); stoppable && vm_it != vm_end_it; ++vm_it)
+			vm_iterator vm_end_it(app_vms.end());
+			for (vm_iterator vm_it = app_vms.begin(); stoppable && vm_it != vm_end_it; ++vm_it)
 			{
-				stoppable = placement_.placed(*vm_it);
+				stoppable = placement_.placed((*vm_it)->id());
 			}
 
 			if (stoppable)
 			{
 				typedef typename virtual_machines_placement_type::const_iterator vm_placement_iterator;
-				for (vm_iterator vm_it = app_it->second.begin(); vm_it != vm_end_it; ++vm_it)
+				for (vm_iterator vm_it = app_vms.begin(); vm_it != vm_end_it; ++vm_it)
 				{
-					// paranoid-check: existence
-					DCS_DEBUG_ASSERT( vms_.count(*vm_it) > 0 );
-
-					virtual_machine_pointer ptr_vm(vms_.at(*vm_it));
+					virtual_machine_pointer ptr_vm(*vm_it);
 
 					// paranoid-check: null
 					DCS_DEBUG_ASSERT( ptr_vm );
 
-					//vms_.at(*vm_it)->power_off();
+					//vms_[*vm_it]->power_off();
 
 					ptr_vm->vmm().power_off(ptr_vm);
 				}
@@ -1047,7 +1077,7 @@ class data_center
 			else
 			{
 				::std::ostringstream oss;
-				oss << "Application " << app_id << " '" << *(apps_.at(app_id)) << "' cannot be stopped: at least one VM has not been placed.";
+				oss << "Application " << app_id << " '" << *(apps_[app_id]) << "' cannot be stopped: at least one VM has not been placed.";
 
 				log_warn(DCS_DES_CLOUD_LOGGING_AT, oss.str());
 			}
@@ -1057,12 +1087,12 @@ class data_center
 			stoppable = false;
 
 			::std::ostringstream oss;
-			oss << "Application " << app_id << " '" << *(apps_.at(app_id)) << "' cannot be stopped because it has been inhibited.";
+			oss << "Application " << app_id << " '" << *(apps_[app_id]) << "' cannot be stopped because it has been inhibited.";
 
 			log_warn(DCS_DES_CLOUD_LOGGING_AT, oss.str());
 		}
 
-::std::cerr << "[data_center] END Stop application: " << *(apps_.at(app_id)) << ::std::endl;//XXX
+::std::cerr << "[data_center] END Stop application: " << *(apps_[app_id]) << ::std::endl;//XXX
 		return stoppable;
 	}
 
@@ -1079,6 +1109,8 @@ class data_center
 		}
 		apps_[id]->simulation_model().enable(!inhibit);
 		app_ctrls_[id]->enable(!inhibit);
+
+		update_active_lists();
 	}
 
 
@@ -1096,15 +1128,92 @@ class data_center
 #endif // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
 
 
+	/// Return the simulation context this data center belongs to (null if it uses the thread-bound one).
+	public: registry_pointer registry_ptr() const
+	{
+		return ptr_reg_;
+	}
+
+
+	/// Return the simulation context this data center belongs to.
+	public: registry_type& reg() const
+	{
+		if (ptr_reg_)
+		{
+			return *ptr_reg_;
+		}
+
+		return registry_type::instance();
+	}
+
+
 	private: bool inhibited_virtual_machine(virtual_machine_identifier_type id) const
 	{
-		return inhibited_apps_.count(vms_.at(id)->guest_system().application().id()) > 0;
+		return inhibited_apps_.count(vms_[id]->guest_system().application().id()) > 0;
+	}
+
+
+	/// Tells if \a id refers to an entity stored in the id-indexed container \a c.
+	private: template <typename T, typename IdT>
+		static bool stored(::std::vector<T> const& c, IdT id)
+	{
+		return id >= 0 && static_cast<size_type>(id) < c.size() && c[id];
+	}
+
+
+	/// Stores \a x at position \a id of the id-indexed container \a c.
+	private: template <typename T, typename IdT>
+		static void store(::std::vector<T>& c, IdT id, T const& x)
+	{
+		if (static_cast<size_type>(id) >= c.size())
+		{
+			c.resize(id+1);
+		}
+		c[id] = x;
+	}
+
+
+	/// Rebuilds the lists of non-inhibited applications and virtual machines.
+	private: void update_active_lists()
+	{
+		typedef typename application_container::const_iterator app_iterator;
+		typedef typename virtual_machine_container::const_iterator vm_iterator;
+
+		active_app_list_.clear();
+		app_iterator app_end_it(app_list_.end());
+		for (app_iterator app_it = app_list_.begin(); app_it != app_end_it; ++app_it)
+		{
+			if (!this->inhibited_application((*app_it)->id()))
+			{
+				active_app_list_.push_back(*app_it);
+			}
+		}
+
+		active_vm_list_.clear();
+		vm_iterator vm_end_it(vm_list_.end());
+		for (vm_iterator vm_it = vm_list_.begin(); vm_it != vm_end_it; ++vm_it)
+		{
+			if (!this->inhibited_virtual_machine((*vm_it)->id()))
+			{
+				active_vm_list_.push_back(*vm_it);
+			}
+		}
+	}
+
+
+	//FIXME: only the single-resource (CPU) case is handled
+	private: static bool physical_machine_capacity_less(physical_machine_pointer const& ptr_pm1, physical_machine_pointer const& ptr_pm2)
+	{
+		real_type cap1(ptr_pm1->resource(cpu_resource_category)->capacity()*ptr_pm1->resource(cpu_resource_category)->utilization_threshold());
+		real_type cap2(ptr_pm2->resource(cpu_resource_category)->capacity()*ptr_pm2->resource(cpu_resource_category)->utilization_threshold());
+
+		return cap1 < cap2 || (cap1 == cap2 && ptr_pm1->id() < ptr_pm2->id());
 	}
 
 
 	private: void init()
 	{
-		registry<traits_type>& ref_reg(registry<traits_type>::instance());
+		registry_type& ref_reg(reg());
 
 		ref_reg.des_engine_ptr()->system_initialization_event_source().connect(
 			::dcs::functional::bind(
@@ -1119,7 +1228,7 @@ class data_center
 
 	private: void finit()
 	{
-		registry<traits_type>& ref_reg(registry<traits_type>::instance());
+		registry_type& ref_reg(reg());
 
 		ref_reg.des_engine_ptr()->system_initialization_event_source().disconnect(
 			::dcs::functional::bind(
@@ -1149,7 +1258,7 @@ class data_center
 	{
 		// pre: id must be a valid application identifier
 		DCS_ASSERT(
-				apps_.count(id) > 0,
+				stored(apps_, id),
 				DCS_EXCEPTION_THROW( ::std::invalid_argument, "Invalid application identifier" )
 			);
 
@@ -1161,11 +1270,11 @@ class data_center
 	{
 		// pre: id must be a valid application identifier
 		DCS_ASSERT(
-				apps_.count(id) > 0,
+				stored(apps_, id),
 				DCS_EXCEPTION_THROW( ::std::invalid_argument, "Invalid application identifier" )
 			);
 
-		return apps_.at(id);
+		return apps_[id];
 	}
 
 
@@ -1180,11 +1289,11 @@ class data_center
 		// pre: ptr_vm must be a valid pointer
 		DCS_DEBUG_ASSERT( ptr_vm );
 		// pre: ptr_vm must refer to a valid VM
-		DCS_DEBUG_ASSERT( vms_.count(ptr_vm->id()) > 0 );
+		DCS_DEBUG_ASSERT( stored(vms_, ptr_vm->id()) );
 		// pre: ptr_pm must be a valid pointer
 		DCS_DEBUG_ASSERT( ptr_pm );
 		// pre: ptr_pm must refer to a valid PM
-		DCS_DEBUG_ASSERT( pms_.count(ptr_pm->id()) > 0 );
+		DCS_DEBUG_ASSERT( stored(pms_, ptr_pm->id()) );
 
 ::std::cerr << "[data_center] BEGIN VM Placement>> VM: " << *ptr_vm << " - PM: " << *ptr_pm << " - SHARE: " << first_share->second << ::std::endl;//XXX
 		if (ptr_pm->power_state() != powered_on_power_status)
@@ -1227,14 +1336,35 @@ class data_center
 	}
 
 
+	/// Applications indexed by identifier (null for removed ones).
 	private: application_container apps_;
+	/// Application controllers indexed by application identifier.
 	private: application_controller_container app_ctrls_;
+	/// Physical machines indexed by identifier (null for removed ones).
 	private: physical_machine_container pms_;
+	/// Physical machines sorted by increasing capacity.
+	private: ::std::vector<physical_machine_pointer> pms_by_capacity_;
+	/// Physical machine controllers indexed by physical machine identifier.
 	private: physical_machine_controller_container pm_ctrls_;
+	/// Virtual machines indexed by identifier (null for removed ones).
 	private: virtual_machine_container vms_;
+	/// Applications sorted by identifier.
+	private: application_container app_list_;
+	/// Non-inhibited applications sorted by identifier.
+	private: application_container active_app_list_;
+	/// Physical machines sorted by identifier.
+	private: physical_machine_container pm_list_;
+	/// Virtual machines sorted by identifier.
+	private: virtual_machine_container vm_list_;
+	/// Virtual machines of non-inhibited applications sorted by identifier.
+	private: virtual_machine_container active_vm_list_;
 	private: virtual_machines_placement_type placement_;
-	private: deployed_application_container deployed_apps_;
+	/// Virtual machines of each deployed application, indexed by application identifier.
+	private: application_vm_container app_vms_;
+	/// Deployment flag of each application, indexed by application identifier.
+	private: ::std::vector<bool> deployed_apps_;
 	private: application_id_container inhibited_apps_;
+	private: registry_pointer ptr_reg_;
 #ifdef DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
 	private: manager_pointer ptr_mngr_;
 #endif // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
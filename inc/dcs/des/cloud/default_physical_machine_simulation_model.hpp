@@ -34,15 +34,19 @@
 #include <dcs/des/weighted_mean_estimator.hpp>
 #include <dcs/math/traits/float.hpp>
 #include <dcs/des/cloud/base_physical_machine_simulation_model.hpp>
+#include <dcs/des/cloud/detail/utilization_profile_integrator.hpp>
 #include <dcs/des/cloud/logging.hpp>
 #include <dcs/des/cloud/physical_resource_category.hpp>
 #include <dcs/des/cloud/power_status.hpp>
 #include <dcs/des/cloud/registry.hpp>
 #include <dcs/des/cloud/resource_utilization_profile.hpp>
+#include <dcs/des/cloud/trace.hpp>
 #include <dcs/des/cloud/user_request.hpp>
+#include <dcs/des/cloud/user_request_view.hpp>
 #include <dcs/exception.hpp>
 #include <dcs/functional/bind.hpp>
 #include <dcs/macro.hpp>
+#include <cstddef>
 #include <map>
 #include <stdexcept>
 #include <string>
@@ -76,6 +80,7 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 	private: typedef typename base_type::virtual_machine_pointer virtual_machine_pointer;
 	//private: typedef user_request<traits_type> user_request_type;
 	private: typedef resource_utilization_profile<traits_type> utilization_profile_type;
+	private: typedef detail::utilization_profile_integrator<traits_type> utilization_profile_integrator_type;
 	private: typedef typename traits_type::virtual_machine_identifier_type virtual_machine_identifier_type;
 	private: typedef ::std::map< virtual_machine_identifier_type, ::std::vector< ::std::pair<real_type,real_type> > > virtual_machine_hosting_time_map;
 	private: typedef ::std::map< virtual_machine_identifier_type, ::std::map<physical_resource_category,real_type> > virtual_machine_share_time_map;
@@ -88,6 +93,23 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 	private: static const ::std::string vm_suspend_event_source_name;
 	private: static const ::std::string vm_resume_event_source_name;
 	private: static const ::std::string vm_migration_event_source_name;
+	/// Power consumed above the idle level, as a function of utilization.
+	private: struct busy_power
+	{
+		busy_power(physical_machine_type const& pm_)
+		: pm(pm_),
+		  idle(pm_.consumed_energy(0))
+		{
+		}
+
+		real_type operator()(real_type u) const
+		{
+			return pm.consumed_energy(u)-idle;
+		}
+
+		physical_machine_type const& pm;
+		real_type idle;
+	};
 
 
 	public: default_physical_machine_simulation_model()
@@ -96,6 +118,7 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 //	  energy_(0),
 	  uptime_(0),
 	  last_pwron_time_(0),
+	  profile_integrator_(),
 	  ptr_pwron_evt_src_(new des_event_source_type(poweron_event_source_name)),
 	  ptr_pwroff_evt_src_(new des_event_source_type(poweroff_event_source_name)),
 	  ptr_vm_pwron_evt_src_(new des_event_source_type(vm_poweron_event_source_name)),
@@ -318,7 +341,7 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 		typedef typename utilization_profile_type::const_iterator profile_iterator;
 		typedef typename utilization_profile_type::time_interval_type time_interval_type;
 
-		virtual_machine_container active_vms(this->machine().vmm().virtual_machines(powered_on_power_status));
+		virtual_machine_container const& active_vms(this->machine().vmm().virtual_machines(powered_on_power_status));
 		time_interval_type last_uptime(utilization_profile_type::make_time_interval(last_pwron_time_, cur_time));
 		vm_iterator vm_end_it(active_vms.end());
 		for (vm_iterator vm_it = active_vms.begin(); vm_it != vm_end_it; ++vm_it)
@@ -364,7 +387,7 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 		DCS_DEBUG_ASSERT( vm_host_time_map_.count(ptr_vm->id()) > 0 );
 		DCS_DEBUG_ASSERT( vm_host_time_map_.at(ptr_vm->id()).size() > 0 );
 
-		typedef user_request<traits_type> user_request_type;
+		typedef user_request_view<traits_type> user_request_type;
 		typedef ::std::vector<user_request_type> request_container;
 		typedef typename request_container::const_iterator request_iterator;
 		typedef typename utilization_profile_type::const_iterator profile_iterator;
@@ -376,7 +399,7 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 
 //		time_interval_type host_time(utilization_profile_type::make_time_interval(vm_host_time_map.at(ptr_vm->id()).back().first, vm_host_time_map.at(ptr_vm->id()).back().second));
 		time_interval_type host_time(utilization_profile_type::make_time_interval(vm_host_time_map_.at(ptr_vm->id()).back().first, ::std::min(vm_host_time_map_.at(ptr_vm->id()).back().second, cur_time)));
-		request_container reqs(ptr_vm->guest_system().application().simulation_model().tier_in_service_requests(ptr_vm->guest_system().id()));
+		request_container reqs(ptr_vm->guest_system().application().simulation_model().tier_in_service_request_views(ptr_vm->guest_system().id()));
 		request_iterator req_end_it(reqs.end());
 		for (request_iterator req_it = reqs.begin(); req_it != req_end_it; ++req_it)
 		{
@@ -403,11 +426,13 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 */
 		}
 
+		integrate_settled_utilization_profile();
+
 		DCS_DEBUG_TRACE("(" << this << ") END Updating Utilization Profile (Clock: " << registry_type::instance().des_engine().simulated_time() << ")");
 	}
 
 
-	private: void update_utilization_profile(virtual_machine_pointer const& ptr_vm, user_request<traits_type> const& req)
+	private: void update_utilization_profile(virtual_machine_pointer const& ptr_vm, user_request_view<traits_type> const& req)
 	{
 		DCS_DEBUG_TRACE("(" << this << ") BEGIN Updating Utilization Profile (Clock: " << registry_type::instance().des_engine().simulated_time() << ")");
 
@@ -429,13 +454,11 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 		//FIXME: CPU resource category is hard-coded
 		physical_resource_category category(cpu_resource_category);
 
-		::std::vector<utilization_profile_type> profiles;
-		profiles = req.tier_utilization_profiles(ptr_vm->guest_system().id(), category);
-		if (profiles.size() > 0)
+		// Only the profile of the last visit (at this tier) is needed
+		utilization_profile_type last_profile(req.tier_last_utilization_profile(ptr_vm->guest_system().id(), category));
+		if (last_profile.size() > 0)
 		{
-			// The last profiles refers to the last visit (at this tier)
-			//utilization_profile_type const& profile(profiles.back());
-			utilization_profile_type profile(make_profile_from_intersection(profiles.back(), host_time));
+			utilization_profile_type profile(make_profile_from_intersection(last_profile, host_time));
 			profile_iterator profile_end_it(profile.end());
 			for (profile_iterator profile_it = profile.begin(); profile_it != profile_end_it; ++profile_it)
 			{
@@ -447,6 +470,64 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 	}
 
 
+	/**
+	 * \brief Integrates energy and busy time of utilization profile segments
+	 *  that can no longer change, and drops them from the profile.
+	 *
+	 * Utilization is only added for requests in service on hosted VMs, and
+	 * the profile of each of them starts no earlier than its arrival at the
+	 * tier. Thus, segments ending before the earliest such arrival (or
+	 * before the current time if there is none) are settled.
+	 * This keeps the profile bounded by the in-service window instead of
+	 * growing with the whole simulation run.
+	 */
+	private: void integrate_settled_utilization_profile()
+	{
+		typedef typename physical_machine_type::vmm_type vmm_type;
+		typedef typename vmm_type::virtual_machine_container vm_container;
+		typedef typename vm_container::const_iterator vm_iterator;
+		typedef user_request_view<traits_type> user_request_type;
+		typedef ::std::vector<user_request_type> request_container;
+		typedef typename request_container::const_iterator request_iterator;
+
+		//FIXME: CPU resource category is hard-coded
+		physical_resource_category category(cpu_resource_category);
+
+		if (res_profile_map_.count(category) == 0 || !profile_integrator_.flush_due(res_profile_map_.at(category)))
+		{
+			return;
+		}
+
+		// Find the earliest time at which some utilization can still be added
+
+		real_type settle_time(registry_type::instance().des_engine().simulated_time());
+
+		vm_container const& vms(this->machine().vmm().virtual_machines());
+		vm_iterator vm_end_it(vms.end());
+		for (vm_iterator vm_it = vms.begin(); vm_it != vm_end_it; ++vm_it)
+		{
+			virtual_machine_pointer ptr_vm(*vm_it);
+
+			// check: valid VM pointer (paranoid)
+			DCS_DEBUG_ASSERT( ptr_vm );
+
+			uint_type tier_id(ptr_vm->guest_system().id());
+			request_container reqs(ptr_vm->guest_system().application().simulation_model().tier_in_service_request_views(tier_id));
+			request_iterator req_end_it(reqs.end());
+			for (request_iterator req_it = reqs.begin(); req_it != req_end_it; ++req_it)
+			{
+				::std::size_t nv(req_it->tier_num_visits(tier_id));
+				if (nv > 0)
+				{
+					settle_time = ::std::min(settle_time, req_it->tier_arrival_time(tier_id, nv-1));
+				}
+			}
+		}
+
+		profile_integrator_.flush(res_profile_map_[category], settle_time, busy_power(this->machine()));
+	}
+
+
 	private: void update_share_profile(physical_resource_category category)
 	{
 		DCS_DEBUG_TRACE("(" << this << ") BEGIN Updating Share Profile (Clock: " << registry_type::instance().des_engine().simulated_time() << ")");
@@ -468,7 +549,7 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 		{
 			real_type aggr_share(0);
 
-			vm_container vms(this->machine().vmm().virtual_machines(powered_on_power_status));
+			vm_container const& vms(this->machine().vmm().virtual_machines(powered_on_power_status));
 			vm_iterator vm_end_it(vms.end());
 			for (vm_iterator vm_it = vms.begin(); vm_it != vm_end_it; ++vm_it)
 			{
@@ -507,14 +588,14 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 
 		real_type aggr_share(0);
 
-::std::cerr << "[default_physical_machine_simulation] BEGIN Update Share Stats" << ::std::endl;///XXX
-::std::cerr << "[default_physical_machine_simulation] Old Share Stat: " << ptr_share_stat_->estimate() << ::std::endl;///XXX
+		DCS_DES_CLOUD_TRACE(pm_simulation, debug) << "[default_physical_machine_simulation] BEGIN Update Share Stats";
+		DCS_DES_CLOUD_TRACE(pm_simulation, debug) << "[default_physical_machine_simulation] Old Share Stat: " << ptr_share_stat_->estimate();
 		vm_container vms(this->machine().vmm().virtual_machines(powered_on_power_status));
 		vm_iterator vm_end_it(vms.end());
 		for (vm_iterator vm_it = vms.begin(); vm_it != vm_end_it; ++vm_it)
 		{
 			virtual_machine_pointer ptr_vm(*vm_it);
-::std::cerr << "[default_physical_machine_simulation] VM: " << *ptr_vm << " --> " << ptr_vm->resource_share(category) << ::std::endl;///XXX
+			DCS_DES_CLOUD_TRACE(pm_simulation, debug) << "[default_physical_machine_simulation] VM: " << *ptr_vm << " --> " << ptr_vm->resource_share(category);
 
 			// paranoid-check: null
 			DCS_DEBUG_ASSERT( ptr_vm );
@@ -527,7 +608,7 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 		// paranoid-check: consistency
 		DCS_DEBUG_ASSERT( cur_time >= share_stat_upd_time_ );
 
-::std::cerr << "[default_physical_machine_simulation] Aggregate Share: " << aggr_share << " - Weight: " << (cur_time-share_stat_upd_time_) << ::std::endl;///XXX
+		DCS_DES_CLOUD_TRACE(pm_simulation, debug) << "[default_physical_machine_simulation] Aggregate Share: " << aggr_share << " - Weight: " << (cur_time-share_stat_upd_time_);
 		// Safety check to prevent NaNs
 		if (::dcs::math::float_traits<real_type>::definitely_greater(cur_time, share_stat_upd_time_) > 0)
 		{
@@ -536,8 +617,8 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 
 		}
 		share_stat_upd_time_ = cur_time;
-::std::cerr << "[default_physical_machine_simulation] New Share Stat: " << ptr_share_stat_->estimate() << ::std::endl;///XXX
-::std::cerr << "[default_physical_machine_simulation] END Update Share Stats" << ::std::endl;///XXX
+		DCS_DES_CLOUD_TRACE(pm_simulation, debug) << "[default_physical_machine_simulation] New Share Stat: " << ptr_share_stat_->estimate();
+		DCS_DES_CLOUD_TRACE(pm_simulation, debug) << "[default_physical_machine_simulation] END Update Share Stats";
 	}
 
 
@@ -564,20 +645,20 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 		typedef typename vmm_type::virtual_machine_container vm_container;
 		typedef typename vm_container::const_iterator vm_iterator;
 
-::std::cerr << "[default_physical_machine_simulation] BEGIN Update Share Time: " << time << ::std::endl;///XXX
+		DCS_DES_CLOUD_TRACE(pm_simulation, debug) << "[default_physical_machine_simulation] BEGIN Update Share Time: " << time;
 		vm_container vms(this->machine().vmm().virtual_machines(powered_on_power_status));
 		vm_iterator vm_end_it(vms.end());
 		for (vm_iterator vm_it = vms.begin(); vm_it != vm_end_it; ++vm_it)
 		{
 			virtual_machine_pointer ptr_vm(*vm_it);
-::std::cerr << "[default_physical_machine_simulation] VM: " << *ptr_vm << " --> " << ptr_vm->resource_share(cpu_resource_category) << ::std::endl;///XXX
+			DCS_DES_CLOUD_TRACE(pm_simulation, debug) << "[default_physical_machine_simulation] VM: " << *ptr_vm << " --> " << ptr_vm->resource_share(cpu_resource_category);
 
 			// paranoid-check: null
 			DCS_DEBUG_ASSERT( ptr_vm );
 
 			vm_share_time_map_[ptr_vm->id()][cpu_resource_category] = time;
 		}
-::std::cerr << "[default_physical_machine_simulation] END Update Share Time: " << time << ::std::endl;///XXX
+		DCS_DES_CLOUD_TRACE(pm_simulation, debug) << "[default_physical_machine_simulation] END Update Share Time: " << time;
 	}
 */
 
@@ -1185,6 +1266,7 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 
 		res_profile_map_.clear();
 		vm_host_time_map_.clear();
+		profile_integrator_.reset();
 
 //::std::cerr << "(" << this << ") END Processing SYSTEM-INITIALIZATION (Clock: " << ctx.simulated_time() << ")" << ::std::endl;///XXX
 		DCS_DEBUG_TRACE("(" << this << ") END Processing SYSTEM-INITIALIZATION (Clock: " << ctx.simulated_time() << ")");
@@ -1253,31 +1335,20 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 		// - Compute total energy as the sum of the energy consumed during each
 		//   active time interval and machine utilization as the ratio between
 		//   busy and up time.
-		typedef user_request<traits_type> user_request_type;
-		typedef ::std::vector<user_request_type> request_container;
-		typedef typename request_container::const_iterator request_iterator;
-		typedef typename utilization_profile_type::const_iterator profile_iterator;
-		real_type idle_energy(this->machine().consumed_energy(0));
-		real_type energy(0);
-		real_type busy_time(0);
+		//   Segments settled during the simulation have already been
+		//   integrated (see integrate_settled_utilization_profile), so only
+		//   the remaining ones are accounted here.
+		real_type energy(profile_integrator_.busy_energy());
+		real_type busy_time(profile_integrator_.busy_time());
 		if (res_profile_map_.size() > 0)
 		{
 			//FIXME: CPU resource category is hard-coded
 			physical_resource_category category(cpu_resource_category);
-			utilization_profile_type const& profile(res_profile_map_.at(category));
-			profile_iterator profile_end_it(profile.end());
-			for (profile_iterator profile_it = profile.begin(); profile_it != profile_end_it; ++profile_it)
-			{
-				typename utilization_profile_type::profile_item_type const& item(*profile_it);
-
-				//FIXME: replace boost::icl::length with a wrapper function
-				energy += (this->machine().consumed_energy(item.second)-idle_energy)*::boost::icl::length(item.first);
-				busy_time += ::boost::icl::length(item.first);
-			}
+			profile_integrator_.integrate(res_profile_map_.at(category), busy_power(this->machine()), energy, busy_time);
 		}
-		energy += idle_energy*uptime_;
+		energy += this->machine().consumed_energy(0)*uptime_;
 
-::std::cerr << "[default_physical_machine_simulation] PM: " << this->machine() << " - BUSY-TIME: " << busy_time << " - UPTIME: " << uptime_ << " - SIM TIME: " << ctx.simulated_time() << ::std::endl;//XXX
+		DCS_DES_CLOUD_TRACE(pm_simulation, info) << "[default_physical_machine_simulation] PM: " << this->machine() << " - BUSY-TIME: " << busy_time << " - UPTIME: " << uptime_ << " - SIM TIME: " << ctx.simulated_time();
 		// check: machine cannot be busy more than is up (paranoid check)
 		DCS_DEBUG_ASSERT( ::dcs::math::float_traits<real_type>::definitely_less_equal(busy_time, uptime_) );
 
@@ -1340,9 +1411,11 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 
 		update_utilization_profile(
 				ptr_vm,
-				ptr_vm->guest_system().application().simulation_model().request_state(evt)
+				ptr_vm->guest_system().application().simulation_model().request_view(evt)
 			);
 
+		integrate_settled_utilization_profile();
+
 		DCS_DEBUG_TRACE("(" << this << ") END Processing VM-REQUEST-SERVICE (Clock: " << ctx.simulated_time() << ")");
 	}
 
@@ -1354,6 +1427,8 @@ class default_physical_machine_simulation_model: public base_physical_machine_si
 //	private: real_type energy_;
 	private: real_type uptime_;
 	private: real_type last_pwron_time_;
+	/// Energy and busy time of the utilization profile segments settled so far.
+	private: utilization_profile_integrator_type profile_integrator_;
 	private: des_event_source_pointer ptr_pwron_evt_src_;
 	private: des_event_source_pointer ptr_pwroff_evt_src_;
 	private: des_event_source_pointer ptr_vm_pwron_evt_src_;
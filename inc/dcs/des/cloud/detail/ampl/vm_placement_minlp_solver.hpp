@@ -241,12 +241,12 @@ class vm_placement_minlp_solver: public base_vm_placement_optimal_solver<TraitsT
 	}
 
 
-	private: void do_solve(data_center_type const& dc,
-						   real_type wp,
-						   real_type wm,
-						   real_type ws,
-						   virtual_machine_utilization_map const& vm_util_map,
-						   virtual_machine_share_map const& vm_share_map)
+	private: void do_prepare(data_center_type const& dc,
+							 real_type wp,
+							 real_type wm,
+							 real_type ws,
+							 virtual_machine_utilization_map const& vm_util_map,
+							 virtual_machine_share_map const& vm_share_map)
 	{
 		// Reset previous solution
 		this->result().reset();
@@ -255,8 +255,7 @@ class vm_placement_minlp_solver: public base_vm_placement_optimal_solver<TraitsT
 		virtual_machines_placement<traits_type> init_guess(dc.current_virtual_machines_placement());
 
 		// Create a new problem
-		vm_placement_problem<traits_type> problem_descr;
-		problem_descr = make_vm_placement_problem<traits_type>(dc,
+		problem_descr_ = make_vm_placement_problem<traits_type>(dc,
 															   wp,
 															   wm,
 															   ws,
@@ -269,9 +268,9 @@ class vm_placement_minlp_solver: public base_vm_placement_optimal_solver<TraitsT
 		::std::ostringstream oss;
 		oss << "reset;"
 			<< "model;"
-			<< problem_descr.model
+			<< problem_descr_.model
 			<< "data;"
-			<< problem_descr.data
+			<< problem_descr_.data
 			<< "option solver " << to_ampl_solver(this->solver_id()) << ";"
 			<< "option solution_precision 0;"
 			<< "option solver_msg 0;"
@@ -311,9 +310,15 @@ class vm_placement_minlp_solver: public base_vm_placement_optimal_solver<TraitsT
 			<< "end;"
 			<< ::std::endl;
 
-::std::cerr << "Created AMPL problem: " << oss.str() << ::std::endl;//XXX
-		// Solve the new problem
-		detail::minlp_input_producer producer(oss.str());
+		script_ = oss.str();
+::std::cerr << "Created AMPL problem: " << script_ << ::std::endl;//XXX
+	}
+
+
+	private: void do_run()
+	{
+		// Solve the prepared problem
+		detail::minlp_input_producer producer(script_);
 		detail::minlp_output_consumer consumer;
 		run_ampl_command(find_ampl_command(),
 						 ::std::vector< ::std::string >(),
@@ -324,10 +329,14 @@ class vm_placement_minlp_solver: public base_vm_placement_optimal_solver<TraitsT
 		// Build the new solution
 		if (consumer.solver_result() == solved_result)
 		{
-			this->result(::dcs::des::cloud::detail::make_vm_placement_problem_result<traits_type>(problem_descr, consumer));
+			this->result(::dcs::des::cloud::detail::make_vm_placement_problem_result<traits_type>(problem_descr_, consumer));
 			this->result().solved(true);
 		}
 	}
+
+
+	private: vm_placement_problem<traits_type> problem_descr_;
+	private: ::std::string script_;
 }; // vm_placement_minlp_solver
 
 template <typename TraitsT>
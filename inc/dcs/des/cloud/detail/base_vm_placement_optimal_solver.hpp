@@ -107,6 +107,29 @@ class base_vm_placement_optimal_solver
 					   UtilFwdIterT vm_util_last,
 					   ShareFwdIterT vm_share_first,
 					   ShareFwdIterT vm_share_last)
+	{
+		prepare(dc, wp, wm, ws, vm_util_first, vm_util_last, vm_share_first, vm_share_last);
+		run();
+	}
+
+
+	/**
+	 * \brief Make the placement problem for the given data center without
+	 *  solving it.
+	 *
+	 * Every information needed to solve the problem is read from the data
+	 * center here, so that the following call to \c run does not access the
+	 * data center and can be done outside the DES thread.
+	 */
+	public: template <typename UtilFwdIterT, typename ShareFwdIterT>
+			void prepare(data_center_type const& dc,
+						 real_type wp,
+						 real_type wm,
+						 real_type ws,
+						 UtilFwdIterT vm_util_first,
+						 UtilFwdIterT vm_util_last,
+						 ShareFwdIterT vm_share_first,
+						 ShareFwdIterT vm_share_last)
 	{
 		virtual_machine_utilization_map vm_util_map(vm_util_first, vm_util_last);
 
@@ -118,7 +141,14 @@ class base_vm_placement_optimal_solver
 			++vm_share_first;
 		}
 
-		do_solve(dc, wp, wm, ws, vm_util_map, vm_share_map);
+		do_prepare(dc, wp, wm, ws, vm_util_map, vm_share_map);
+	}
+
+
+	/// Solve the last prepared problem.
+	public: void run()
+	{
+		do_run();
 	}
 
 
@@ -146,12 +176,15 @@ class base_vm_placement_optimal_solver
 	private: virtual optimal_solver_proxies do_proxy() const = 0;
 
 
-	private: virtual void do_solve(data_center_type const& dc,
-								   real_type wp,
-								   real_type wm,
-								   real_type ws,
-								   virtual_machine_utilization_map const& vm_util_map,
-								   virtual_machine_share_map const& vm_share_map) = 0;
+	private: virtual void do_prepare(data_center_type const& dc,
+									 real_type wp,
+									 real_type wm,
+									 real_type ws,
+									 virtual_machine_utilization_map const& vm_util_map,
+									 virtual_machine_share_map const& vm_share_map) = 0;
+
+
+	private: virtual void do_run() = 0;
 
 
 	private: optimal_solver_ids sid_;
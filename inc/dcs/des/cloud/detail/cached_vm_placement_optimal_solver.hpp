@@ -0,0 +1,157 @@
+/**
+ * \file dcs/des/cloud/detail/cached_vm_placement_optimal_solver.hpp
+ *
+ * \brief VM placement optimal solver which reuses the results of already
+ *  solved problems.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_DETAIL_CACHED_VM_PLACEMENT_OPTIMAL_SOLVER_HPP
+#define DCS_DES_CLOUD_DETAIL_CACHED_VM_PLACEMENT_OPTIMAL_SOLVER_HPP
+
+
+#include <dcs/assert.hpp>
+#include <dcs/des/cloud/detail/base_vm_placement_optimal_solver.hpp>
+#include <dcs/des/cloud/detail/native/vm_placement_problem.hpp>
+#include <dcs/des/cloud/detail/vm_placement_result_cache.hpp>
+#include <dcs/des/cloud/optimal_solver_categories.hpp>
+#include <dcs/des/cloud/optimal_solver_proxies.hpp>
+#include <dcs/memory.hpp>
+#include <stdexcept>
+
+
+namespace dcs { namespace des { namespace cloud { namespace detail {
+
+/**
+ * \brief Decorate a VM placement optimal solver with a cache of results.
+ *
+ * The wrapped solver is run only when no cached problem matches the current
+ * one.
+ */
+template <typename TraitsT>
+class cached_vm_placement_optimal_solver: public base_vm_placement_optimal_solver<TraitsT>
+{
+	private: typedef base_vm_placement_optimal_solver<TraitsT> base_type;
+	public: typedef TraitsT traits_type;
+	public: typedef base_type solver_type;
+	public: typedef ::dcs::shared_ptr<solver_type> solver_pointer;
+	public: typedef vm_placement_result_cache<traits_type> cache_type;
+	public: typedef ::dcs::shared_ptr<cache_type> cache_pointer;
+	private: typedef typename base_type::real_type real_type;
+	private: typedef typename base_type::data_center_type data_center_type;
+	private: typedef typename base_type::virtual_machine_utilization_map virtual_machine_utilization_map;
+	private: typedef typename base_type::virtual_machine_share_map virtual_machine_share_map;
+	private: typedef typename base_type::problem_result_type problem_result_type;
+
+
+	public: cached_vm_placement_optimal_solver(solver_pointer const& ptr_solver, cache_pointer const& ptr_cache)
+	: base_type(ptr_solver->solver_id(), ptr_solver->input_method()),
+	  ptr_solver_(ptr_solver),
+	  ptr_cache_(ptr_cache),
+	  hit_(false)
+	{
+		// pre: ptr_cache != null
+		DCS_ASSERT(
+			ptr_cache_,
+			throw ::std::invalid_argument("[dcs::des::cloud::detail::cached_vm_placement_optimal_solver::ctor] Invalid cache.")
+		);
+	}
+
+
+	public: cache_type const& cache() const
+	{
+		return *ptr_cache_;
+	}
+
+
+	private: optimal_solver_categories do_category() const
+	{
+		return ptr_solver_->category();
+	}
+
+
+	private: optimal_solver_proxies do_proxy() const
+	{
+		return ptr_solver_->proxy();
+	}
+
+
+	private: void do_prepare(data_center_type const& dc,
+							 real_type wp,
+							 real_type wm,
+							 real_type ws,
+							 virtual_machine_utilization_map const& vm_util_map,
+							 virtual_machine_share_map const& vm_share_map)
+	{
+		problem_ = native::make_vm_placement_problem<traits_type>(dc,
+																  wp,
+																  wm,
+																  ws,
+																  vm_util_map.begin(),
+																  vm_util_map.end());
+
+		problem_result_type const* ptr_res(ptr_cache_->find(problem_));
+		hit_ = ptr_res != 0;
+		if (hit_)
+		{
+			this->result(*ptr_res);
+			return;
+		}
+
+		this->result().reset();
+
+		ptr_solver_->prepare(dc,
+							 wp,
+							 wm,
+							 ws,
+							 vm_util_map.begin(),
+							 vm_util_map.end(),
+							 vm_share_map.begin(),
+							 vm_share_map.end());
+	}
+
+
+	private: void do_run()
+	{
+		if (hit_)
+		{
+			return;
+		}
+
+		ptr_solver_->run();
+
+		this->result(ptr_solver_->result());
+		if (ptr_solver_->result().solved())
+		{
+			ptr_cache_->insert(problem_, ptr_solver_->result());
+		}
+	}
+
+
+	private: solver_pointer ptr_solver_;
+	private: cache_pointer ptr_cache_;
+	private: native::vm_placement_problem<traits_type> problem_;
+	private: bool hit_;
+}; // cached_vm_placement_optimal_solver
+
+}}}} // Namespace dcs::des::cloud::detail
+
+
+#endif // DCS_DES_CLOUD_DETAIL_CACHED_VM_PLACEMENT_OPTIMAL_SOLVER_HPP
@@ -0,0 +1,151 @@
+/**
+ * \file dcs/des/cloud/detail/cold_machine_drain.hpp
+ *
+ * \brief Emptying of an underutilized physical machine.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_DETAIL_COLD_MACHINE_DRAIN_HPP
+#define DCS_DES_CLOUD_DETAIL_COLD_MACHINE_DRAIN_HPP
+
+
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/des/cloud/data_center.hpp>
+#include <dcs/des/cloud/detail/physical_machine_fit_index.hpp>
+#include <dcs/des/cloud/resource_vector.hpp>
+#include <dcs/des/cloud/virtual_machines_placement.hpp>
+#include <set>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace cloud { namespace detail {
+
+/**
+ * \brief Moves all the given VMs off a physical machine onto the other
+ *  machines in use, or leaves the placement untouched.
+ *
+ * Only powered-on machines which already host some VM in \a deployment may
+ * receive the VMs: emptying a machine by powering on another one saves
+ * nothing, and the VMs would come back as soon as the new machine turned
+ * cold.
+ * VMs are moved in the given order, each one to the first candidate machine
+ * (in the order of \a pm_index) accepted by the placer.
+ *
+ * The placer must provide:
+ * - <tt>real_type wanted_capacity(virtual_machine_pointer const& ptr_vm)</tt>,
+ *   the (absolute) CPU capacity needed by the VM;
+ * - <tt>bool try_place(virtual_machine_pointer const& ptr_vm, physical_machine_pointer const& ptr_pm, virtual_machines_placement_type& deployment)</tt>,
+ *   which places the VM on the machine in \a deployment, if possible.
+ *
+ * \return \c true if all the VMs have been moved (and the machine has been
+ *  added to \a excluded_pms), \c false otherwise.
+ */
+template <typename TraitsT, typename PlacerT>
+bool drain_physical_machine(typename TraitsT::physical_machine_identifier_type pm_id,
+							::std::vector<typename data_center<TraitsT>::virtual_machine_pointer> const& vms,
+							data_center<TraitsT> const& dc,
+							virtual_machines_placement<TraitsT>& deployment,
+							physical_machine_fit_index<TraitsT>& pm_index,
+							::std::set<typename TraitsT::physical_machine_identifier_type>& excluded_pms,
+							PlacerT& placer)
+{
+	typedef typename TraitsT::real_type real_type;
+	typedef typename data_center<TraitsT>::physical_machine_pointer physical_machine_pointer;
+	typedef typename data_center<TraitsT>::virtual_machine_pointer virtual_machine_pointer;
+	typedef typename physical_machine_fit_index<TraitsT>::size_type pm_index_size_type;
+	typedef resource_vector<real_type> resource_share_map;
+
+	// Save current shares, in case the machine cannot be emptied
+	::std::vector<resource_share_map> old_shares;
+	for (::std::size_t k = 0; k < vms.size(); ++k)
+	{
+		typename virtual_machines_placement<TraitsT>::const_iterator it(deployment.find(*(vms[k])));
+
+		old_shares.push_back(resource_share_map(deployment.shares_begin(it), deployment.shares_end(it)));
+		deployment.displace(*(vms[k]));
+	}
+	excluded_pms.insert(pm_id);
+	pm_index.update(pm_id, deployment);
+
+	// Powered-on machines come first in the index
+	pm_index_size_type end_pos(pm_index.num_powered_on());
+	::std::size_t num_placed(0);
+	for (; num_placed < vms.size(); ++num_placed)
+	{
+		virtual_machine_pointer const& ptr_vm(vms[num_placed]);
+
+		bool placed(false);
+		real_type wanted_capacity(placer.wanted_capacity(ptr_vm));
+		for (pm_index_size_type pos = pm_index.find_first(wanted_capacity);
+			 pos < end_pos && !placed;
+			 pos = pm_index.find_first(wanted_capacity, pos+1))
+		{
+			physical_machine_pointer ptr_pm(pm_index.physical_machine_ptr(pos));
+
+			// paranoid-check: valid pointer.
+			DCS_DEBUG_ASSERT( ptr_pm );
+
+			if (excluded_pms.count(ptr_pm->id()) > 0 || deployment.vm_size(ptr_pm->id()) == 0)
+			{
+				continue;
+			}
+
+			placed = placer.try_place(ptr_vm, ptr_pm, deployment);
+			if (placed)
+			{
+				pm_index.update(ptr_pm->id(), deployment);
+			}
+		}
+
+		if (!placed)
+		{
+			break;
+		}
+	}
+
+	if (num_placed == vms.size())
+	{
+		return true;
+	}
+
+	// Roll back: leave the machine as it was
+	for (::std::size_t k = 0; k < num_placed; ++k)
+	{
+		typename TraitsT::physical_machine_identifier_type target_pm_id(deployment.pm_id(deployment.find(*(vms[k]))));
+
+		deployment.displace(*(vms[k]));
+		pm_index.update(target_pm_id, deployment);
+	}
+	physical_machine_pointer ptr_pm(dc.physical_machine_ptr(pm_id));
+	for (::std::size_t k = 0; k < vms.size(); ++k)
+	{
+		deployment.place(*(vms[k]), *ptr_pm, old_shares[k].begin(), old_shares[k].end());
+	}
+	excluded_pms.erase(pm_id);
+	pm_index.update(pm_id, deployment);
+
+	return false;
+}
+
+}}}} // Namespace dcs::des::cloud::detail
+
+
+#endif // DCS_DES_CLOUD_DETAIL_COLD_MACHINE_DRAIN_HPP
@@ -378,7 +378,7 @@ template <typename TraitsT, typename UtilFwdIterT, typename ShareFwdIterT>
 			continue;
 		}
 
-		vm_container on_vms = ptr_pm->vmm().virtual_machines(powered_on_power_status);
+		vm_container const& on_vms(ptr_pm->vmm().virtual_machines(powered_on_power_status));
 		active_vms.insert(active_vms.end(), on_vms.begin(), on_vms.end());
 	}
 
@@ -0,0 +1,791 @@
+/**
+ * \file dcs/des/cloud/detail/native/vm_placement_branch_and_bound.hpp
+ *
+ * \brief Depth-first branch-and-bound for the VM placement MINLP.
+ *
+ * Once the VM-to-machine assignment is fixed, the MINLP decomposes into an
+ * independent share problem for every machine:
+ * \f[
+ *  \min \sum_j (a_j s_j - 1)^2 \quad \text{s.t.} \quad lo_j \le s_j \le 1,\; \sum_j s_j \le Smax,
+ * \f]
+ * with \f$a_j=C/Cr_j\f$ and \f$lo_j=Srmin_j/a_j\f$, which is solved exactly by
+ * bisection on the multiplier of the capacity constraint.
+ * Thus the search is only over the assignment.
+ * VMs are branched in decreasing order of demand; the lower bound of a node
+ * uses, for every used machine, the minimum of its power curve over the
+ * still reachable utilization range, the share cost of the VMs already placed,
+ * and the cheapest migration of the VMs still to place.
+ * Empty machines which are indistinguishable are tried only once.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_DETAIL_NATIVE_VM_PLACEMENT_BRANCH_AND_BOUND_HPP
+#define DCS_DES_CLOUD_DETAIL_NATIVE_VM_PLACEMENT_BRANCH_AND_BOUND_HPP
+
+
+#include <algorithm>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <cmath>
+#include <cstddef>
+#include <dcs/des/cloud/detail/native/vm_placement_problem.hpp>
+#include <exception>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace cloud { namespace detail { namespace native {
+
+template <typename TraitsT>
+class vm_placement_branch_and_bound
+{
+	public: typedef TraitsT traits_type;
+	public: typedef typename traits_type::real_type real_type;
+	public: typedef vm_placement_problem<traits_type> problem_type;
+	public: typedef typename problem_type::index_vector_type index_vector_type;
+	public: typedef typename problem_type::real_vector_type real_vector_type;
+	private: typedef ::std::size_t size_type;
+
+
+	/// Aggregate values of a machine for the VMs placed so far.
+	private: struct machine_totals
+	{
+		machine_totals()
+		: util(0),
+		  min_share(0),
+		  share_cost(0),
+		  bound(0)
+		{
+		}
+
+		real_type util;
+		real_type min_share;
+		real_type share_cost;
+		real_type bound;
+	};
+
+
+	private: struct machine_state
+	{
+		machine_totals totals;
+		index_vector_type vms;
+	};
+
+
+	private: struct candidate
+	{
+		size_type pm;
+		real_type delta; ///< Increase of the lower bound
+		machine_totals totals;
+	};
+
+
+	private: struct candidate_less
+	{
+		bool operator()(candidate const& a, candidate const& b) const
+		{
+			if (a.delta != b.delta)
+			{
+				return a.delta < b.delta;
+			}
+			// Prefer the tightest fit
+			return a.totals.util > b.totals.util;
+		}
+	};
+
+
+	private: struct demand_greater
+	{
+		demand_greater(real_vector_type const& demands)
+		: demands_(demands)
+		{
+		}
+
+		bool operator()(size_type a, size_type b) const
+		{
+			return demands_[a] > demands_[b];
+		}
+
+		real_vector_type const& demands_;
+	};
+
+
+	private: struct search_state
+	{
+		::std::vector<machine_state> pms;
+		index_vector_type hosts; ///< Hosting machine of the VMs placed so far, in branching order
+		index_vector_type scratch;
+		real_type fixed_bound;
+		real_type migr_cost;
+		real_type best_cost;
+		size_type num_nodes;
+		bool stop;
+	};
+
+
+	private: struct worker
+	{
+		worker(vm_placement_branch_and_bound* ptr_bnb)
+		: ptr_bnb_(ptr_bnb)
+		{
+		}
+
+		void operator()()
+		{
+			ptr_bnb_->work();
+		}
+
+		vm_placement_branch_and_bound* ptr_bnb_;
+	};
+
+
+	private: static const size_type sync_period = 256;
+
+
+	public: vm_placement_branch_and_bound(problem_type const& problem,
+										  real_type time_limit,
+										  size_type num_threads)
+	: problem_(problem),
+	  ni_(problem.pm_ids.size()),
+	  nj_(problem.vm_ids.size()),
+	  time_limit_(time_limit),
+	  num_threads_(::std::max(num_threads, size_type(1))),
+	  found_(false),
+	  best_cost_(::std::numeric_limits<real_type>::infinity()),
+	  frontier_depth_(0),
+	  next_node_(0),
+	  stop_(false)
+	{
+		init();
+	}
+
+
+	/// Search the optimal placement; return \c true if a feasible one has been found.
+	public: bool solve()
+	{
+		start_time_ = ::boost::posix_time::microsec_clock::universal_time();
+
+		if (nj_ == 0)
+		{
+			found_ = true;
+			best_cost_ = 0;
+			return true;
+		}
+
+		// Known solutions provide the initial incumbent
+		for (size_type g = 0; g < problem_.init_guesses.size(); ++g)
+		{
+			index_vector_type const& guess(problem_.init_guesses[g]);
+			index_vector_type hosts(nj_);
+			for (size_type k = 0; k < nj_; ++k)
+			{
+				hosts[k] = guess[order_[k]];
+			}
+
+			search_state state;
+			reset(state);
+			if (replay(state, hosts))
+			{
+				leaf(state);
+			}
+		}
+
+		frontier_.assign(1, index_vector_type());
+		frontier_depth_ = 0;
+		next_node_ = 0;
+		if (num_threads_ > 1)
+		{
+			expand_frontier(8*num_threads_);
+		}
+
+		size_type nworkers(::std::min(num_threads_, frontier_.size()));
+		::boost::thread_group workers;
+		for (size_type t = 1; t < nworkers; ++t)
+		{
+			workers.create_thread(worker(this));
+		}
+		work();
+		workers.join_all();
+
+		if (!error_.empty())
+		{
+			throw ::std::runtime_error(error_);
+		}
+
+		return found_;
+	}
+
+
+	public: bool solved() const
+	{
+		return found_;
+	}
+
+
+	public: real_type cost() const
+	{
+		return best_cost_;
+	}
+
+
+	/// The index of the hosting machine of each VM.
+	public: index_vector_type const& hosts() const
+	{
+		return best_hosts_;
+	}
+
+
+	/// The optimal share of each VM on its hosting machine.
+	public: real_vector_type shares() const
+	{
+		real_vector_type vm_shares(nj_, 0);
+
+		::std::vector<index_vector_type> pm_vms(ni_);
+		for (size_type j = 0; j < best_hosts_.size(); ++j)
+		{
+			pm_vms[best_hosts_[j]].push_back(j);
+		}
+		for (size_type i = 0; i < ni_; ++i)
+		{
+			if (pm_vms[i].empty())
+			{
+				continue;
+			}
+
+			real_vector_type pm_shares;
+			optimal_shares(i, pm_vms[i], &pm_shares);
+			for (size_type h = 0; h < pm_vms[i].size(); ++h)
+			{
+				vm_shares[pm_vms[i][h]] = pm_shares[h];
+			}
+		}
+
+		return vm_shares;
+	}
+
+
+	private: void init()
+	{
+		// Normalize the objective terms as done by the AMPL model
+		real_type max_power(0);
+		for (size_type i = 0; i < ni_; ++i)
+		{
+			max_power = ::std::max(max_power, problem_.c0[i]+problem_.c1[i]+problem_.c2[i]);
+		}
+		real_type max_mc(0);
+		for (size_type i = 0; i < ni_; ++i)
+		{
+			for (size_type j = 0; j < nj_; ++j)
+			{
+				max_mc = ::std::max(max_mc, problem_.mc(i,j));
+			}
+		}
+		wwp_ = (ni_ > 0 && max_power > 0) ? problem_.wp/(ni_*max_power) : 0;
+		wwm_ = (problem_.wm > 0 && nj_ > 0 && max_mc > 0) ? problem_.wm/(nj_*max_mc) : 0;
+		wws_ = (nj_ > 0) ? problem_.ws/nj_ : 0;
+
+		// Branch on VMs with larger demand first
+		real_vector_type demands(nj_);
+		order_.resize(nj_);
+		for (size_type j = 0; j < nj_; ++j)
+		{
+			demands[j] = problem_.ur[j]*problem_.cr[j];
+			order_[j] = j;
+		}
+		::std::stable_sort(order_.begin(), order_.end(), demand_greater(demands));
+
+		// Cheapest migration of every VM and its suffix sums along the branching order
+		min_mc_.assign(nj_, 0);
+		for (size_type j = 0; j < nj_; ++j)
+		{
+			real_type min_mc(::std::numeric_limits<real_type>::infinity());
+			for (size_type i = 0; i < ni_; ++i)
+			{
+				min_mc = ::std::min(min_mc, problem_.mc(i,j));
+			}
+			min_mc_[j] = (ni_ > 0) ? wwm_*min_mc : 0;
+		}
+		tail_mc_.assign(nj_+1, 0);
+		for (size_type k = nj_; k > 0; --k)
+		{
+			tail_mc_[k-1] = tail_mc_[k]+min_mc_[order_[k-1]];
+		}
+
+		// Group machines that are interchangeable when empty
+		pm_class_.assign(ni_, 0);
+		index_vector_type representatives;
+		for (size_type i = 0; i < ni_; ++i)
+		{
+			size_type cls(representatives.size());
+			for (size_type h = 0; h < representatives.size() && cls == representatives.size(); ++h)
+			{
+				if (same_machine_class(i, representatives[h]))
+				{
+					cls = h;
+				}
+			}
+			if (cls == representatives.size())
+			{
+				representatives.push_back(i);
+			}
+			pm_class_[i] = cls;
+		}
+	}
+
+
+	private: bool same_machine_class(size_type i1, size_type i2) const
+	{
+		if (problem_.c0[i1] != problem_.c0[i2]
+			|| problem_.c1[i1] != problem_.c1[i2]
+			|| problem_.c2[i1] != problem_.c2[i2]
+			|| problem_.r[i1] != problem_.r[i2]
+			|| problem_.smax[i1] != problem_.smax[i2]
+			|| problem_.c[i1] != problem_.c[i2]
+			|| problem_.umax[i1] != problem_.umax[i2])
+		{
+			return false;
+		}
+		for (size_type j = 0; j < nj_; ++j)
+		{
+			if (problem_.mc(i1,j) != problem_.mc(i2,j))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+
+	private: real_type power(size_type i, real_type u) const
+	{
+		return problem_.c0[i]+problem_.c1[i]*u+problem_.c2[i]*::std::pow(eps_+u, problem_.r[i]);
+	}
+
+
+	/// Minimum power of machine \a i over the utilizations it can still reach from \a u.
+	private: real_type min_power(size_type i, real_type u) const
+	{
+		real_type ub(::std::max(u, problem_.umax[i]));
+		real_type p(::std::min(power(i, u), power(i, ub)));
+
+		// The derivative is monotone, so there is at most one stationary point
+		real_type r(problem_.r[i]);
+		if (problem_.c2[i] != 0 && r != 0 && r != 1)
+		{
+			real_type t(-problem_.c1[i]/(problem_.c2[i]*r));
+			if (t > 0)
+			{
+				real_type us(::std::pow(t, 1/(r-1))-eps_);
+				if (us > u && us < ub)
+				{
+					p = ::std::min(p, power(i, us));
+				}
+			}
+		}
+
+		return p;
+	}
+
+
+	private: real_type share_at(size_type i, size_type j, real_type lambda) const
+	{
+		real_type a(problem_.c[i]/problem_.cr[j]);
+		real_type s(1/a-lambda/(2*a*a));
+
+		return ::std::min(::std::max(s, problem_.srmin[j]/a), real_type(1));
+	}
+
+
+	/**
+	 * \brief Solve the share problem of machine \a i hosting the VMs \a vms.
+	 *
+	 * Assume the problem is feasible, that is the sum of the minimum shares
+	 * does not exceed the max share.
+	 * \return The optimal share cost; the shares are stored in \a p_shares, if
+	 *  not null.
+	 */
+	private: real_type optimal_shares(size_type i, index_vector_type const& vms, real_vector_type* p_shares) const
+	{
+		size_type n(vms.size());
+
+		real_type sum(0);
+		for (size_type h = 0; h < n; ++h)
+		{
+			sum += share_at(i, vms[h], 0);
+		}
+
+		real_type lambda(0);
+		if (sum > problem_.smax[i])
+		{
+			// Bisect the multiplier of the capacity constraint
+			real_type lo(0);
+			real_type hi(0);
+			for (size_type h = 0; h < n; ++h)
+			{
+				real_type a(problem_.c[i]/problem_.cr[vms[h]]);
+				hi = ::std::max(hi, 2*a*(1-problem_.srmin[vms[h]]));
+			}
+			for (size_type iter = 0; iter < 100 && (hi-lo) > ::std::numeric_limits<real_type>::epsilon()*hi; ++iter)
+			{
+				real_type mid((lo+hi)/2);
+				sum = 0;
+				for (size_type h = 0; h < n; ++h)
+				{
+					sum += share_at(i, vms[h], mid);
+				}
+				if (sum > problem_.smax[i])
+				{
+					lo = mid;
+				}
+				else
+				{
+					hi = mid;
+				}
+			}
+			lambda = hi;
+		}
+
+		if (p_shares)
+		{
+			p_shares->resize(n);
+		}
+		real_type cost(0);
+		for (size_type h = 0; h < n; ++h)
+		{
+			real_type s(share_at(i, vms[h], lambda));
+			real_type dev(problem_.c[i]/problem_.cr[vms[h]]*s-1);
+			cost += dev*dev;
+			if (p_shares)
+			{
+				(*p_shares)[h] = s;
+			}
+		}
+
+		return cost;
+	}
+
+
+	/// Evaluate the placement of VM \a j on machine \a i.
+	private: bool evaluate(search_state& state, size_type j, size_type i, candidate& cand) const
+	{
+		machine_state const& pm(state.pms[i]);
+
+		real_type a(problem_.c[i]/problem_.cr[j]);
+		real_type lo(problem_.srmin[j]/a);
+
+		cand.pm = i;
+		cand.totals.util = pm.totals.util+problem_.ur[j]/a;
+		cand.totals.min_share = pm.totals.min_share+lo;
+		if (lo > 1
+			|| cand.totals.util > (problem_.umax[i]+tol_)
+			|| cand.totals.min_share > (problem_.smax[i]+tol_))
+		{
+			return false;
+		}
+
+		state.scratch = pm.vms;
+		state.scratch.push_back(j);
+		cand.totals.share_cost = optimal_shares(i, state.scratch, 0);
+		cand.totals.bound = wwp_*min_power(i, cand.totals.util)+wws_*cand.totals.share_cost;
+		cand.delta = cand.totals.bound-pm.totals.bound+wwm_*problem_.mc(i,j)-min_mc_[j];
+
+		return true;
+	}
+
+
+	private: void candidates(search_state& state, size_type j, ::std::vector<candidate>& cands) const
+	{
+		index_vector_type empty_classes;
+		for (size_type i = 0; i < ni_; ++i)
+		{
+			if (state.pms[i].vms.empty())
+			{
+				if (::std::find(empty_classes.begin(), empty_classes.end(), pm_class_[i]) != empty_classes.end())
+				{
+					continue;
+				}
+				empty_classes.push_back(pm_class_[i]);
+			}
+
+			candidate cand;
+			if (evaluate(state, j, i, cand))
+			{
+				cands.push_back(cand);
+			}
+		}
+
+		::std::sort(cands.begin(), cands.end(), candidate_less());
+	}
+
+
+	private: void assign(search_state& state, size_type j, candidate const& cand) const
+	{
+		machine_state& pm(state.pms[cand.pm]);
+		real_type migr(wwm_*problem_.mc(cand.pm,j));
+
+		state.fixed_bound += cand.totals.bound-pm.totals.bound+migr;
+		state.migr_cost += migr;
+		state.hosts.push_back(cand.pm);
+		pm.totals = cand.totals;
+		pm.vms.push_back(j);
+	}
+
+
+	private: void reset(search_state& state) const
+	{
+		state.pms.assign(ni_, machine_state());
+		state.hosts.clear();
+		state.fixed_bound = 0;
+		state.migr_cost = 0;
+		state.best_cost = best_cost_;
+		state.num_nodes = 0;
+		state.stop = false;
+	}
+
+
+	/// Rebuild the state of the node reached by placing VMs as in \a hosts.
+	private: bool replay(search_state& state, index_vector_type const& hosts) const
+	{
+		reset(state);
+		for (size_type k = 0; k < hosts.size(); ++k)
+		{
+			candidate cand;
+			if (!evaluate(state, order_[k], hosts[k], cand))
+			{
+				return false;
+			}
+			assign(state, order_[k], cand);
+		}
+
+		return true;
+	}
+
+
+	private: bool pruned(real_type bound, real_type best_cost) const
+	{
+		return bound >= (best_cost-tol_*::std::max(real_type(1), ::std::abs(best_cost)));
+	}
+
+
+	private: void leaf(search_state& state)
+	{
+		real_type cost(state.migr_cost);
+		for (size_type i = 0; i < ni_; ++i)
+		{
+			machine_state const& pm(state.pms[i]);
+			if (!pm.vms.empty())
+			{
+				cost += wwp_*power(i, pm.totals.util)+wws_*pm.totals.share_cost;
+			}
+		}
+
+		::boost::lock_guard< ::boost::mutex > lock(mutex_);
+		if (cost < best_cost_)
+		{
+			best_cost_ = cost;
+			best_hosts_.resize(nj_);
+			for (size_type k = 0; k < nj_; ++k)
+			{
+				best_hosts_[order_[k]] = state.hosts[k];
+			}
+			found_ = true;
+		}
+		state.best_cost = best_cost_;
+	}
+
+
+	private: void sync(search_state& state)
+	{
+		::boost::lock_guard< ::boost::mutex > lock(mutex_);
+		if (!stop_ && time_limit_ < ::std::numeric_limits<real_type>::infinity())
+		{
+			::boost::posix_time::time_duration elapsed(::boost::posix_time::microsec_clock::universal_time()-start_time_);
+			if (elapsed.total_microseconds() >= time_limit_*1.0e+6)
+			{
+				stop_ = true;
+			}
+		}
+		state.stop = stop_;
+		state.best_cost = best_cost_;
+	}
+
+
+	private: void search(search_state& state, size_type k)
+	{
+		if ((++state.num_nodes % sync_period) == 0)
+		{
+			sync(state);
+		}
+		if (state.stop)
+		{
+			return;
+		}
+
+		if (k == nj_)
+		{
+			leaf(state);
+			return;
+		}
+
+		size_type j(order_[k]);
+		::std::vector<candidate> cands;
+		candidates(state, j, cands);
+		for (size_type h = 0; h < cands.size() && !state.stop; ++h)
+		{
+			candidate const& cand(cands[h]);
+
+			// Candidates are sorted by bound, so the next ones are pruned too
+			if (pruned(state.fixed_bound+tail_mc_[k]+cand.delta, state.best_cost))
+			{
+				break;
+			}
+
+			machine_totals saved(state.pms[cand.pm].totals);
+			real_type saved_fixed_bound(state.fixed_bound);
+			real_type saved_migr_cost(state.migr_cost);
+
+			assign(state, j, cand);
+			search(state, k+1);
+
+			state.pms[cand.pm].totals = saved;
+			state.pms[cand.pm].vms.pop_back();
+			state.hosts.pop_back();
+			state.fixed_bound = saved_fixed_bound;
+			state.migr_cost = saved_migr_cost;
+		}
+	}
+
+
+	/// Expand the root breadth-first to get enough subtrees to share among workers.
+	private: void expand_frontier(size_type min_size)
+	{
+		search_state state;
+		while (frontier_.size() < min_size && frontier_depth_ < nj_)
+		{
+			::std::vector<index_vector_type> next;
+			size_type j(order_[frontier_depth_]);
+			for (size_type n = 0; n < frontier_.size(); ++n)
+			{
+				replay(state, frontier_[n]);
+
+				::std::vector<candidate> cands;
+				candidates(state, j, cands);
+				for (size_type h = 0; h < cands.size(); ++h)
+				{
+					if (pruned(state.fixed_bound+tail_mc_[frontier_depth_]+cands[h].delta, best_cost_))
+					{
+						break;
+					}
+					next.push_back(frontier_[n]);
+					next.back().push_back(cands[h].pm);
+				}
+			}
+			frontier_.swap(next);
+			++frontier_depth_;
+			if (frontier_.empty())
+			{
+				break;
+			}
+		}
+	}
+
+
+	private: void work()
+	{
+		try
+		{
+			search_state state;
+			while (true)
+			{
+				size_type n;
+				{
+					::boost::lock_guard< ::boost::mutex > lock(mutex_);
+					if (stop_ || next_node_ >= frontier_.size())
+					{
+						break;
+					}
+					n = next_node_++;
+				}
+
+				if (!replay(state, frontier_[n]))
+				{
+					continue;
+				}
+				sync(state);
+				if (!state.stop && !pruned(state.fixed_bound+tail_mc_[frontier_depth_], state.best_cost))
+				{
+					search(state, frontier_depth_);
+				}
+			}
+		}
+		catch (::std::exception const& e)
+		{
+			::boost::lock_guard< ::boost::mutex > lock(mutex_);
+			if (error_.empty())
+			{
+				error_ = ::std::string("[dcs::des::cloud::detail::native::vm_placement_branch_and_bound::work] ")+e.what();
+			}
+			stop_ = true;
+		}
+	}
+
+
+	private: static const real_type eps_;
+	private: static const real_type tol_;
+	private: problem_type const& problem_;
+	private: size_type ni_;
+	private: size_type nj_;
+	private: real_type time_limit_;
+	private: size_type num_threads_;
+	private: real_type wwp_;
+	private: real_type wwm_;
+	private: real_type wws_;
+	/// Branching order of VMs
+	private: index_vector_type order_;
+	private: real_vector_type min_mc_;
+	private: real_vector_type tail_mc_;
+	private: index_vector_type pm_class_;
+	private: bool found_;
+	private: real_type best_cost_;
+	private: index_vector_type best_hosts_;
+	private: ::std::vector<index_vector_type> frontier_;
+	private: size_type frontier_depth_;
+	private: size_type next_node_;
+	private: bool stop_;
+	private: ::std::string error_;
+	private: ::boost::posix_time::ptime start_time_;
+	private: ::boost::mutex mutex_;
+}; // vm_placement_branch_and_bound
+
+template <typename TraitsT>
+const typename vm_placement_branch_and_bound<TraitsT>::real_type vm_placement_branch_and_bound<TraitsT>::eps_(1.0e-5);
+
+template <typename TraitsT>
+const typename vm_placement_branch_and_bound<TraitsT>::real_type vm_placement_branch_and_bound<TraitsT>::tol_(1.0e-9);
+
+}}}}} // Namespace dcs::des::cloud::detail::native
+
+
+#endif // DCS_DES_CLOUD_DETAIL_NATIVE_VM_PLACEMENT_BRANCH_AND_BOUND_HPP
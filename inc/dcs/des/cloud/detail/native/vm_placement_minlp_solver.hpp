@@ -0,0 +1,245 @@
+/**
+ * \file dcs/des/cloud/detail/native/vm_placement_minlp_solver.hpp
+ *
+ * \brief Optimal VM placement strategy formulated as a MINLP problem and
+ *  solved in-process.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_DETAIL_NATIVE_VM_PLACEMENT_MINLP_SOLVER_HPP
+#define DCS_DES_CLOUD_DETAIL_NATIVE_VM_PLACEMENT_MINLP_SOLVER_HPP
+
+
+#include <cstddef>
+#include <dcs/des/cloud/best_fit_decreasing_initial_placement_strategy.hpp>
+#include <dcs/des/cloud/data_center.hpp>
+#include <dcs/des/cloud/detail/base_initial_vm_placement_optimal_solver.hpp>
+#include <dcs/des/cloud/detail/base_vm_placement_optimal_solver.hpp>
+#include <dcs/des/cloud/detail/native/vm_placement_branch_and_bound.hpp>
+#include <dcs/des/cloud/detail/native/vm_placement_problem.hpp>
+#include <dcs/des/cloud/detail/vm_placement_problem.hpp>
+#include <dcs/des/cloud/optimal_solver_categories.hpp>
+#include <dcs/des/cloud/optimal_solver_ids.hpp>
+#include <dcs/des/cloud/optimal_solver_input_methods.hpp>
+#include <dcs/des/cloud/optimal_solver_proxies.hpp>
+#include <dcs/des/cloud/physical_resource_category.hpp>
+#include <dcs/des/cloud/virtual_machines_placement.hpp>
+#include <limits>
+#include <utility>
+
+
+namespace dcs { namespace des { namespace cloud { namespace detail { namespace native {
+
+namespace detail { namespace /*<unnamed>*/ {
+
+template <typename TraitsT>
+::dcs::des::cloud::detail::vm_placement_problem_result<TraitsT> make_vm_placement_problem_result(vm_placement_problem<TraitsT> const& problem,
+																								  vm_placement_branch_and_bound<TraitsT> const& bnb)
+{
+	typedef ::dcs::des::cloud::detail::vm_placement_problem_result<TraitsT> result_type;
+	typedef typename result_type::resource_share_container resource_share_container;
+	typedef typename vm_placement_branch_and_bound<TraitsT>::index_vector_type index_vector_type;
+	typedef typename vm_placement_branch_and_bound<TraitsT>::real_vector_type real_vector_type;
+
+	result_type res;
+
+	res.cost(bnb.cost());
+
+	index_vector_type const& hosts(bnb.hosts());
+	real_vector_type shares(bnb.shares());
+	for (::std::size_t j = 0; j < hosts.size(); ++j)
+	{
+		//FIXME: CPU resource category is hard-coded.
+		resource_share_container vm_shares(1, ::std::make_pair(cpu_resource_category, shares[j]));
+		res.placement()[::std::make_pair(problem.pm_ids[hosts[j]], problem.vm_ids[j])] = vm_shares;
+	}
+
+	return res;
+}
+
+}} // Namespace detail::<unnamed>
+
+
+template <typename TraitsT>
+class initial_vm_placement_minlp_solver: public base_initial_vm_placement_optimal_solver<TraitsT>
+{
+	private: typedef base_initial_vm_placement_optimal_solver<TraitsT> base_type;
+	public: typedef TraitsT traits_type;
+	private: typedef typename base_type::real_type real_type;
+	private: typedef typename base_type::data_center_type data_center_type;
+	private: typedef typename base_type::virtual_machine_utilization_map virtual_machine_utilization_map;
+
+
+	public: static const optimal_solver_ids default_solver_id;
+
+
+	public: explicit initial_vm_placement_minlp_solver(optimal_solver_ids solver_id = default_solver_id,
+													   real_type time_limit = ::std::numeric_limits<real_type>::infinity(),
+													   ::std::size_t num_threads = 1)
+	: base_type(solver_id, native_optimal_solver_input_method),
+	  time_limit_(time_limit),
+	  num_threads_(num_threads)
+	{
+	}
+
+
+	private: optimal_solver_categories do_category() const
+	{
+		return minco_optimal_solver_category;
+	}
+
+
+	private: optimal_solver_proxies do_proxy() const
+	{
+		return none_optimal_solver_proxy;
+	}
+
+
+	private: void do_solve(data_center_type const& dc,
+						   real_type wp,
+						   real_type ws,
+						   real_type ref_penalty,
+						   virtual_machine_utilization_map const& vm_util_map)
+	{
+		// Reset previous solution
+		this->result().reset();
+
+		// Create a new problem
+		vm_placement_problem<traits_type> problem;
+		problem = make_initial_vm_placement_problem<traits_type>(dc,
+																 wp,
+																 ws,
+																 ref_penalty,
+																 vm_util_map);
+
+		// As initial guess use a specif heuristic
+		// FIXME: Best-Fit-Decreasing heuristic is hard-coded
+		best_fit_decreasing_initial_placement_strategy<traits_type> heuristic_strategy;
+		heuristic_strategy.reference_share_penalty(ref_penalty);
+		add_initial_guess(problem, heuristic_strategy.placement(dc));
+
+		// Solve the new problem
+		vm_placement_branch_and_bound<traits_type> bnb(problem, time_limit_, num_threads_);
+
+		// Build the new solution
+		if (bnb.solve())
+		{
+			this->result(detail::make_vm_placement_problem_result(problem, bnb));
+			this->result().solved(true);
+		}
+	}
+
+
+	private: real_type time_limit_;
+	private: ::std::size_t num_threads_;
+}; // initial_vm_placement_minlp_solver
+
+template <typename TraitsT>
+const optimal_solver_ids initial_vm_placement_minlp_solver<TraitsT>::default_solver_id(couenne_optimal_solver_id);
+
+
+template <typename TraitsT>
+class vm_placement_minlp_solver: public base_vm_placement_optimal_solver<TraitsT>
+{
+	private: typedef base_vm_placement_optimal_solver<TraitsT> base_type;
+	public: typedef TraitsT traits_type;
+	private: typedef typename base_type::real_type real_type;
+	private: typedef typename base_type::data_center_type data_center_type;
+	private: typedef typename base_type::virtual_machine_utilization_map virtual_machine_utilization_map;
+	private: typedef typename base_type::virtual_machine_share_map virtual_machine_share_map;
+
+
+	public: static const optimal_solver_ids default_solver_id;
+
+
+	public: explicit vm_placement_minlp_solver(optimal_solver_ids solver_id = default_solver_id,
+											   real_type time_limit = ::std::numeric_limits<real_type>::infinity(),
+											   ::std::size_t num_threads = 1)
+	: base_type(solver_id, native_optimal_solver_input_method),
+	  time_limit_(time_limit),
+	  num_threads_(num_threads)
+	{
+	}
+
+
+	private: optimal_solver_categories do_category() const
+	{
+		return minco_optimal_solver_category;
+	}
+
+
+	private: optimal_solver_proxies do_proxy() const
+	{
+		return none_optimal_solver_proxy;
+	}
+
+
+	private: void do_prepare(data_center_type const& dc,
+							 real_type wp,
+							 real_type wm,
+							 real_type ws,
+							 virtual_machine_utilization_map const& vm_util_map,
+							 virtual_machine_share_map const& vm_share_map)
+	{
+		// Reset previous solution
+		this->result().reset();
+
+		// Create a new problem
+		problem_ = make_vm_placement_problem<traits_type>(dc,
+														  wp,
+														  wm,
+														  ws,
+														  vm_util_map.begin(),
+														  vm_util_map.end());
+
+		// As initial guesses use the current VM placement and a specific heuristic
+		// FIXME: Best-Fit-Decreasing heuristic is hard-coded
+		add_initial_guess(problem_, dc.current_virtual_machines_placement());
+		best_fit_decreasing_initial_placement_strategy<traits_type> heuristic_strategy;
+		add_initial_guess(problem_, heuristic_strategy.placement(dc));
+	}
+
+
+	private: void do_run()
+	{
+		// Solve the prepared problem
+		vm_placement_branch_and_bound<traits_type> bnb(problem_, time_limit_, num_threads_);
+
+		// Build the new solution
+		if (bnb.solve())
+		{
+			this->result(detail::make_vm_placement_problem_result(problem_, bnb));
+			this->result().solved(true);
+		}
+	}
+
+
+	private: real_type time_limit_;
+	private: ::std::size_t num_threads_;
+	private: vm_placement_problem<traits_type> problem_;
+}; // vm_placement_minlp_solver
+
+template <typename TraitsT>
+const optimal_solver_ids vm_placement_minlp_solver<TraitsT>::default_solver_id(couenne_optimal_solver_id);
+
+}}}}} // Namespace dcs::des::cloud::detail::native
+
+
+#endif // DCS_DES_CLOUD_DETAIL_NATIVE_VM_PLACEMENT_MINLP_SOLVER_HPP
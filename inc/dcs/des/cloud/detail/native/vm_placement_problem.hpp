@@ -0,0 +1,287 @@
+/**
+ * \file dcs/des/cloud/detail/native/vm_placement_problem.hpp
+ *
+ * \brief VM placement problem data for the in-process (native) solvers.
+ *
+ * The problem is the same MINLP formulated for the AMPL solvers (see
+ * dcs/des/cloud/detail/ampl/vm_placement_problem.hpp), that is:
+ * \f[
+ *  \min wwp \sum_i x_i (c0_i + c1_i U_i + c2_i (\epsilon+U_i)^{r_i})
+ *       + wwm \sum_{i,j} mc_{ij} y_{ij}
+ *       + wws \sum_{i,j} (s_{ij} C_i/Cr_j - 1)^2 y_{ij}
+ * \f]
+ * where \f$U_i = \sum_j y_{ij} ur_j Cr_j / C_i\f$, subject to: every VM is
+ * placed on exactly one powered-on machine, \f$Srmin_j Cr_j/C_i \le s_{ij} \le 1\f$,
+ * \f$\sum_j s_{ij} \le Smax_i\f$ and \f$U_i \le Umax_i\f$.
+ * Here, the data is kept in plain arrays instead of being written as an AMPL
+ * model.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_DETAIL_NATIVE_VM_PLACEMENT_PROBLEM_HPP
+#define DCS_DES_CLOUD_DETAIL_NATIVE_VM_PLACEMENT_PROBLEM_HPP
+
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <cstddef>
+#include <dcs/des/cloud/data_center.hpp>
+#include <dcs/des/cloud/physical_resource_category.hpp>
+#include <dcs/des/cloud/power_status.hpp>
+#include <dcs/des/cloud/virtual_machines_placement.hpp>
+#include <dcs/perfeval/energy.hpp>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace cloud { namespace detail { namespace native {
+
+template <typename TraitsT>
+struct vm_placement_problem
+{
+	typedef TraitsT traits_type;
+	typedef typename traits_type::real_type real_type;
+	typedef ::std::vector<typename traits_type::physical_machine_identifier_type> physical_machine_identifier_container;
+	typedef ::std::vector<typename traits_type::virtual_machine_identifier_type> virtual_machine_identifier_container;
+	typedef ::std::vector<real_type> real_vector_type;
+	typedef ::boost::numeric::ublas::matrix<real_type> real_matrix_type;
+	typedef ::std::vector< ::std::size_t > index_vector_type;
+
+	physical_machine_identifier_container pm_ids;
+	virtual_machine_identifier_container vm_ids;
+	// Power model coefficients, max share, capacity and utilization threshold of machines
+	real_vector_type c0;
+	real_vector_type c1;
+	real_vector_type c2;
+	real_vector_type r;
+	real_vector_type smax;
+	real_vector_type c;
+	real_vector_type umax;
+	// Reference capacity, utilization and min share of VMs
+	real_vector_type cr;
+	real_vector_type ur;
+	real_vector_type srmin;
+	/// Migration costs (machines by VMs)
+	real_matrix_type mc;
+	real_type wp;
+	real_type wm;
+	real_type ws;
+	/// Known feasible solutions (if any), as the index of the hosting machine of each VM
+	::std::vector<index_vector_type> init_guesses;
+};
+
+
+namespace detail { namespace /*<unnamed>*/ {
+
+template <typename TraitsT>
+void add_physical_machine(vm_placement_problem<TraitsT>& problem, typename data_center<TraitsT>::physical_machine_pointer const& ptr_pm, typename TraitsT::real_type smax)
+{
+	typedef typename data_center<TraitsT>::physical_machine_type pm_type;
+	typedef typename pm_type::resource_pointer resource_pointer;
+	typedef typename pm_type::resource_type resource_type;
+	typedef typename resource_type::energy_model_type energy_model_type;
+	typedef typename ::dcs::perfeval::energy::fan2007_model<typename energy_model_type::real_type> fan2007_energy_model_impl_type;
+
+	//FIXME: CPU resource category is hard-coded
+	resource_pointer ptr_resource(ptr_pm->resource(::dcs::des::cloud::cpu_resource_category));
+	energy_model_type const& energy_model(ptr_resource->energy_model());
+	//FIXME: Fan2007 energy model type is hard-coded
+	fan2007_energy_model_impl_type const* ptr_energy_model_impl(dynamic_cast<fan2007_energy_model_impl_type const*>(&energy_model));
+	if (!ptr_energy_model_impl)
+	{
+		throw ::std::runtime_error("[dcs::des::cloud::detail::native::detail::add_physical_machine] Unable to retrieve energy model.");
+	}
+
+	problem.pm_ids.push_back(ptr_pm->id());
+	problem.c0.push_back(ptr_energy_model_impl->coefficient(0));
+	problem.c1.push_back(ptr_energy_model_impl->coefficient(1));
+	problem.c2.push_back(ptr_energy_model_impl->coefficient(2));
+	problem.r.push_back(ptr_energy_model_impl->coefficient(3));
+	problem.smax.push_back(smax);
+	problem.c.push_back(ptr_resource->capacity()*ptr_resource->utilization_threshold());
+	problem.umax.push_back(ptr_resource->utilization_threshold());
+}
+
+
+template <typename TraitsT>
+void add_virtual_machine(vm_placement_problem<TraitsT>& problem, typename data_center<TraitsT>::virtual_machine_pointer const& ptr_vm, typename TraitsT::real_type util)
+{
+	typedef typename data_center<TraitsT>::application_type application_type;
+	typedef typename application_type::reference_physical_resource_type reference_resource_type;
+
+	application_type const& app(ptr_vm->guest_system().application());
+
+	//FIXME: CPU resource category is hard-coded
+	reference_resource_type const& ref_resource(app.reference_resource(::dcs::des::cloud::cpu_resource_category));
+
+	problem.vm_ids.push_back(ptr_vm->id());
+	problem.cr.push_back(ref_resource.capacity()*ref_resource.utilization_threshold());
+	problem.ur.push_back(util);
+	problem.srmin.push_back(0.2); //FIXME: Minimum share is hard-coded
+}
+
+}} // Namespace detail::<unnamed>
+
+
+/**
+ * \brief Add the given placement to the known solutions of the given problem.
+ *
+ * \return \c false if the placement does not place every VM of the problem on
+ *  some machine of the problem (in which case it is not added).
+ */
+template <typename TraitsT>
+bool add_initial_guess(vm_placement_problem<TraitsT>& problem, virtual_machines_placement<TraitsT> const& placement)
+{
+	typedef typename vm_placement_problem<TraitsT>::index_vector_type index_vector_type;
+
+	::std::size_t npm(problem.pm_ids.size());
+	::std::size_t nvm(problem.vm_ids.size());
+
+	index_vector_type hosts(nvm, npm);
+	for (::std::size_t j = 0; j < nvm; ++j)
+	{
+		for (::std::size_t i = 0; i < npm && hosts[j] == npm; ++i)
+		{
+			if (placement.placed(problem.vm_ids[j], problem.pm_ids[i]))
+			{
+				hosts[j] = i;
+			}
+		}
+		if (hosts[j] == npm)
+		{
+			return false;
+		}
+	}
+
+	problem.init_guesses.push_back(hosts);
+
+	return true;
+}
+
+
+/// Make the problem of placing the active VMs of the given data center from scratch.
+template <typename TraitsT>
+vm_placement_problem<TraitsT> make_initial_vm_placement_problem(data_center<TraitsT> const& dc,
+																typename TraitsT::real_type wp,
+																typename TraitsT::real_type ws,
+																typename TraitsT::real_type ref_penalty,
+																::std::map<typename TraitsT::virtual_machine_identifier_type,
+																		   typename TraitsT::real_type> const& vm_util_map)
+{
+	typedef data_center<TraitsT> data_center_type;
+	typedef typename data_center_type::physical_machine_pointer pm_pointer;
+	typedef typename data_center_type::virtual_machine_pointer vm_pointer;
+	typedef typename vm_placement_problem<TraitsT>::real_matrix_type real_matrix_type;
+
+	vm_placement_problem<TraitsT> problem;
+
+	::std::vector<pm_pointer> pms(dc.physical_machines());
+	::std::size_t npm(pms.size());
+	for (::std::size_t i = 0; i < npm; ++i)
+	{
+		detail::add_physical_machine<TraitsT>(problem, pms[i], 1.0-ref_penalty);
+	}
+
+	::std::vector<vm_pointer> vms(dc.active_virtual_machines());
+	::std::size_t nvm(vms.size());
+	for (::std::size_t j = 0; j < nvm; ++j)
+	{
+		detail::add_virtual_machine<TraitsT>(problem, vms[j], vm_util_map.at(vms[j]->id()));
+	}
+
+	// No migration cost
+	problem.mc = real_matrix_type(npm, nvm, 0);
+	problem.wp = wp;
+	problem.wm = 0;
+	problem.ws = ws;
+
+	return problem;
+}
+
+
+/// Make the problem of re-placing the powered-on VMs of the given data center.
+template <typename TraitsT, typename UtilFwdIterT>
+vm_placement_problem<TraitsT> make_vm_placement_problem(data_center<TraitsT> const& dc,
+														typename TraitsT::real_type wp,
+														typename TraitsT::real_type wm,
+														typename TraitsT::real_type ws,
+														UtilFwdIterT vm_util_first,
+														UtilFwdIterT vm_util_last)
+{
+	typedef data_center<TraitsT> data_center_type;
+	typedef typename data_center_type::physical_machine_pointer pm_pointer;
+	typedef typename data_center_type::virtual_machine_pointer vm_pointer;
+	typedef typename TraitsT::virtual_machine_identifier_type vm_identifier_type;
+	typedef typename TraitsT::real_type real_type;
+	typedef typename vm_placement_problem<TraitsT>::real_matrix_type real_matrix_type;
+
+	vm_placement_problem<TraitsT> problem;
+
+	::std::map<vm_identifier_type,real_type> vm_util_map(vm_util_first, vm_util_last);
+
+	::std::vector<pm_pointer> pms(dc.physical_machines());
+	::std::size_t npm(pms.size());
+
+	// Only powered-on VMs hosted by powered-on machines take part in the problem
+	::std::vector<vm_pointer> active_vms;
+	for (::std::size_t i = 0; i < npm; ++i)
+	{
+		pm_pointer ptr_pm(pms[i]);
+
+		detail::add_physical_machine<TraitsT>(problem, ptr_pm, 1);
+
+		if (ptr_pm->power_state() != powered_on_power_status)
+		{
+			continue;
+		}
+
+		::std::vector<vm_pointer> const& on_vms(ptr_pm->vmm().virtual_machines(powered_on_power_status));
+		active_vms.insert(active_vms.end(), on_vms.begin(), on_vms.end());
+	}
+
+	::std::size_t nvm(active_vms.size());
+	for (::std::size_t j = 0; j < nvm; ++j)
+	{
+		detail::add_virtual_machine<TraitsT>(problem, active_vms[j], vm_util_map.at(active_vms[j]->id()));
+	}
+
+	// Moving a VM away from its current machine costs one migration
+	problem.mc = real_matrix_type(npm, nvm, 0);
+	for (::std::size_t i = 0; i < npm; ++i)
+	{
+		for (::std::size_t j = 0; j < nvm; ++j)
+		{
+			if (pms[i]->id() != active_vms[j]->vmm().hosting_machine().id())
+			{
+				problem.mc(i,j) = 1;
+			}
+		}
+	}
+	problem.wp = wp;
+	problem.wm = wm;
+	problem.ws = ws;
+
+	return problem;
+}
+
+}}}}} // Namespace dcs::des::cloud::detail::native
+
+
+#endif // DCS_DES_CLOUD_DETAIL_NATIVE_VM_PLACEMENT_PROBLEM_HPP
@@ -1152,6 +1152,9 @@ static ::std::string to_string(optimal_solver_input_methods method)
 			return "TSP";
 		case zimpl_optimal_solver_input_method:
 			return "ZIMPL";
+		case native_optimal_solver_input_method:
+			// Native problems cannot be submitted to NEOS
+			break;
 	}
 
 	throw ::std::runtime_error("[dcs::des::cloud::detail::neos::to_string] Unknown NEOS input method.");
@@ -368,13 +368,13 @@ class vm_placement_minlp_solver: public base_vm_placement_optimal_solver<TraitsT
 	}
 
 
-    private: void do_solve(data_center_type const& dc,
-						   real_type wp,
-						   real_type wm,
-						   real_type ws,
-						   virtual_machine_utilization_map const& vm_util_map,
-						   virtual_machine_share_map const& vm_share_map)
-    {
+	private: void do_prepare(data_center_type const& dc,
+							 real_type wp,
+							 real_type wm,
+							 real_type ws,
+							 virtual_machine_utilization_map const& vm_util_map,
+							 virtual_machine_share_map const& vm_share_map)
+	{
 		// Reset previous solution
 		this->result().reset();
 
@@ -389,22 +389,59 @@ class vm_placement_minlp_solver: public base_vm_placement_optimal_solver<TraitsT
 
 					// Create a new problem
 					// 1. Create a problem in AMPL format
-					ampl::vm_placement_problem<traits_type> problem_descr;
-					problem_descr = ampl::make_vm_placement_problem<traits_type>(dc,
-																				 wp,
-																				 wm,
-																				 ws,
-																				 vm_util_map.begin(),
-																				 vm_util_map.end(),
-																				 vm_share_map.begin(),
-																				 vm_share_map.end(),
-																				 init_guess);
-::std::cerr << "Created AMPL problem: " << problem_descr.model << "reset data; data;" << problem_descr.data << ::std::endl;//XXX
-					::std::string xml_job;
-					xml_job = make_ampl_job(xml_tmpl_,
-										    problem_descr.model,
-										    problem_descr.data,
-										    detail::ampl_options());
+					ampl_problem_descr_ = ampl::make_vm_placement_problem<traits_type>(dc,
+																					   wp,
+																					   wm,
+																					   ws,
+																					   vm_util_map.begin(),
+																					   vm_util_map.end(),
+																					   vm_share_map.begin(),
+																					   vm_share_map.end(),
+																					   init_guess);
+::std::cerr << "Created AMPL problem: " << ampl_problem_descr_.model << "reset data; data;" << ampl_problem_descr_.data << ::std::endl;//XXX
+					// 2. Wrap it into a NEOS job
+					xml_job_ = make_ampl_job(xml_tmpl_,
+											 ampl_problem_descr_.model,
+											 ampl_problem_descr_.data,
+											 detail::ampl_options());
+				}
+				break;
+			case gams_optimal_solver_input_method:
+				{
+					namespace gams = ::dcs::des::cloud::detail::gams;
+
+					// Create a new problem
+					// 1. Create a problem in GAMS format
+					gams_problem_descr_ = gams::make_vm_placement_problem<traits_type>(dc,
+																					   wp,
+																					   wm,
+																					   ws,
+																					   vm_util_map.begin(),
+																					   vm_util_map.end(),
+																					   vm_share_map.begin(),
+																					   vm_share_map.end(),
+																					   init_guess);
+::std::cerr << "Created GAMS problem: " << gams_problem_descr_.model << ::std::endl;//XXX
+					// 2. Wrap it into a NEOS job
+					xml_job_ = make_gams_job(xml_tmpl_,
+											 gams_problem_descr_.model,
+											 detail::gams_options());
+				}
+				break;
+			default:
+				throw ::std::runtime_error("[dcs::des::cloud::detail::neos::vm_placement_minlp_solver] Input method not supported.");
+		}
+	}
+
+
+	private: void do_run()
+	{
+		switch (this->input_method())
+		{
+			case ampl_optimal_solver_input_method:
+				{
+					namespace ampl = ::dcs::des::cloud::detail::ampl;
+
 					client neos;
 					::std::string res;
 
@@ -415,7 +452,7 @@ class vm_placement_minlp_solver: public base_vm_placement_optimal_solver<TraitsT
 					{
 						try
 						{
-							res = execute_job(neos, xml_job);
+							res = execute_job(neos, xml_job_);
 							ok = true;
 						}
 						catch (::std::exception const& ex)
@@ -443,7 +480,7 @@ class vm_placement_minlp_solver: public base_vm_placement_optimal_solver<TraitsT
 ::std::cerr << "virtual_machine_shares: " << problem_res.virtual_machine_shares() << std::endl;//XXX
 					if (problem_res.solver_result() == ampl::solved_result)
 					{
-						this->result(::dcs::des::cloud::detail::make_vm_placement_problem_result<traits_type>(problem_descr, problem_res));
+						this->result(::dcs::des::cloud::detail::make_vm_placement_problem_result<traits_type>(ampl_problem_descr_, problem_res));
 						this->result().solved(true);
 					}
 				}
@@ -452,23 +489,6 @@ class vm_placement_minlp_solver: public base_vm_placement_optimal_solver<TraitsT
 				{
 					namespace gams = ::dcs::des::cloud::detail::gams;
 
-					// Create a new problem
-					// 1. Create a problem in GAMS format
-					gams::vm_placement_problem<traits_type> problem_descr;
-					problem_descr = gams::make_vm_placement_problem<traits_type>(dc,
-																				 wp,
-																				 wm,
-																				 ws,
-																				 vm_util_map.begin(),
-																				 vm_util_map.end(),
-																				 vm_share_map.begin(),
-																				 vm_share_map.end(),
-																				 init_guess);
-::std::cerr << "Created GAMS problem: " << problem_descr.model << ::std::endl;//XXX
-					::std::string xml_job;
-					xml_job = make_gams_job(xml_tmpl_,
-										    problem_descr.model,
-										    detail::gams_options());
 					client neos;
 					::std::string res;
 
@@ -479,7 +499,7 @@ class vm_placement_minlp_solver: public base_vm_placement_optimal_solver<TraitsT
 					{
 						try
 						{
-							res = execute_job(neos, xml_job);
+							res = execute_job(neos, xml_job_);
 							ok = true;
 						}
 						catch (::std::exception const& ex)
@@ -513,7 +533,7 @@ class vm_placement_minlp_solver: public base_vm_placement_optimal_solver<TraitsT
 ::std::cerr << "virtual_machine_shares: " << problem_res.virtual_machine_shares() << std::endl;//XXX
 					if (problem_res.solver_result() == gams::normal_completion_solver_result)
 					{
-						this->result(::dcs::des::cloud::detail::make_vm_placement_problem_result<traits_type>(problem_descr, problem_res));
+						this->result(::dcs::des::cloud::detail::make_vm_placement_problem_result<traits_type>(gams_problem_descr_, problem_res));
 						this->result().solved(true);
 					}
 				}
@@ -535,6 +555,9 @@ class vm_placement_minlp_solver: public base_vm_placement_optimal_solver<TraitsT
 
 
 	private: ::std::string xml_tmpl_;
+	private: ::std::string xml_job_;
+	private: ::dcs::des::cloud::detail::ampl::vm_placement_problem<traits_type> ampl_problem_descr_;
+	private: ::dcs::des::cloud::detail::gams::vm_placement_problem<traits_type> gams_problem_descr_;
 }; // vm_placement_minlp_solver
 
 template <typename TraitsT>
@@ -0,0 +1,258 @@
+/**
+ * \file dcs/des/cloud/detail/physical_machine_fit_index.hpp
+ *
+ * \brief Index for fast first-fit search of physical machines.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_DETAIL_PHYSICAL_MACHINE_FIT_INDEX_HPP
+#define DCS_DES_CLOUD_DETAIL_PHYSICAL_MACHINE_FIT_INDEX_HPP
+
+
+#include <algorithm>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/des/cloud/data_center.hpp>
+#include <dcs/des/cloud/physical_resource_category.hpp>
+#include <dcs/des/cloud/power_status.hpp>
+#include <dcs/des/cloud/virtual_machines_placement.hpp>
+#include <dcs/math/traits/float.hpp>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace cloud { namespace detail {
+
+/**
+ * \brief Index of physical machines for first-fit search.
+ *
+ * Physical machines are kept in the order in which a first-fit heuristic
+ * must visit them (powered-on first, then suspended, then powered-off; by
+ * capacity within each group).
+ * A max-tree over the free (absolute) CPU capacity of each machine lets the
+ * first machine with enough free capacity be found in O(log #PMs) time.
+ * After a placement, the free capacity of the chosen machine is updated in
+ * O(log #PMs) time as well.
+ *
+ * The free capacity is only a necessary condition for feasibility: callers
+ * must still confirm the candidate (e.g., by means of
+ * \c virtual_machines_placement::try_place) and continue the search after it
+ * on failure.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+//FIXME: only the single-resource (CPU) case is handled
+template <typename TraitsT>
+class physical_machine_fit_index
+{
+	public: typedef TraitsT traits_type;
+	public: typedef typename traits_type::real_type real_type;
+	public: typedef data_center<traits_type> data_center_type;
+	public: typedef typename data_center_type::physical_machine_type physical_machine_type;
+	public: typedef typename data_center_type::physical_machine_pointer physical_machine_pointer;
+	public: typedef typename data_center_type::virtual_machines_placement_type virtual_machines_placement_type;
+	public: typedef typename physical_machine_type::identifier_type physical_machine_identifier_type;
+	public: typedef ::std::size_t size_type;
+	private: typedef ::std::vector<physical_machine_pointer> physical_machine_container;
+
+
+	/**
+	 * \brief Builds the index for the machines of the given data center.
+	 *
+	 * \param dc The data center.
+	 * \param placement The placement from which to compute residual capacity.
+	 * \param increasing_capacity Whether machines in the same power state
+	 *  are visited from the less to the more powerful (\c true) or vice versa
+	 *  (\c false).
+	 */
+	public: physical_machine_fit_index(data_center_type const& dc,
+									   virtual_machines_placement_type const& placement,
+									   bool increasing_capacity)
+	: num_powered_on_(0)
+	{
+		physical_machine_container const& pms(dc.physical_machines_by_capacity());
+
+		// Group by power state; the by-capacity order avoids any sorting.
+		power_status states[] = {powered_on_power_status, suspended_power_status, powered_off_power_status};
+		size_type num_states(sizeof(states)/sizeof(states[0]));
+		size_type n(pms.size());
+		for (size_type s = 0; s < num_states; ++s)
+		{
+			for (size_type i = 0; i < n; ++i)
+			{
+				physical_machine_pointer const& ptr_pm(pms[increasing_capacity ? i : (n-i-1)]);
+
+				// paranoid-check: valid pointer
+				DCS_DEBUG_ASSERT( ptr_pm );
+
+				if (ptr_pm->power_state() == states[s])
+				{
+					pos_map_[ptr_pm->id()] = pms_.size();
+					pms_.push_back(ptr_pm);
+				}
+			}
+			if (states[s] == powered_on_power_status)
+			{
+				num_powered_on_ = pms_.size();
+			}
+		}
+
+		leaf_offset_ = 1;
+		while (leaf_offset_ < pms_.size())
+		{
+			leaf_offset_ *= 2;
+		}
+		tree_.assign(2*leaf_offset_, real_type(0));
+
+		for (size_type i = 0; i < pms_.size(); ++i)
+		{
+			physical_machine_pointer const& ptr_pm(pms_[i]);
+
+			tree_[leaf_offset_+i] = placement.residual_share(ptr_pm->id(), cpu_resource_category)
+									* ptr_pm->resource(cpu_resource_category)->capacity();
+		}
+		for (size_type i = leaf_offset_-1; i > 0; --i)
+		{
+			tree_[i] = ::std::max(tree_[2*i], tree_[2*i+1]);
+		}
+	}
+
+
+	public: size_type size() const
+	{
+		return pms_.size();
+	}
+
+
+	/// Number of powered-on machines, which come first in the visiting order.
+	public: size_type num_powered_on() const
+	{
+		return num_powered_on_;
+	}
+
+
+	public: physical_machine_pointer const& physical_machine_ptr(size_type pos) const
+	{
+		// pre: pos < size()
+		DCS_ASSERT(
+				pos < pms_.size(),
+				throw ::std::invalid_argument("[dcs::des::cloud::detail::physical_machine_fit_index::physical_machine_ptr] Position out of range.")
+			);
+
+		return pms_[pos];
+	}
+
+
+	/**
+	 * \brief Finds the first machine, at position \a first or later, whose
+	 *  free capacity is (approximately) not less than \a capacity.
+	 *
+	 * \return The position of the found machine or \c size() if none.
+	 */
+	public: size_type find_first(real_type capacity, size_type first = 0) const
+	{
+		if (first >= pms_.size())
+		{
+			return pms_.size();
+		}
+
+		size_type pos(find_first(1, 0, leaf_offset_, capacity, first));
+
+		return pos < pms_.size() ? pos : pms_.size();
+	}
+
+
+	/// Sets the free (absolute) capacity of the given machine.
+	public: void free_capacity(physical_machine_identifier_type pm_id, real_type capacity)
+	{
+		// pre: pm_id must be indexed
+		DCS_ASSERT(
+				pos_map_.count(pm_id) > 0,
+				throw ::std::invalid_argument("[dcs::des::cloud::detail::physical_machine_fit_index::free_capacity] Unknown physical machine.")
+			);
+
+		size_type i(leaf_offset_+pos_map_.at(pm_id));
+		tree_[i] = capacity;
+		for (i /= 2; i > 0; i /= 2)
+		{
+			tree_[i] = ::std::max(tree_[2*i], tree_[2*i+1]);
+		}
+	}
+
+
+	/// Refreshes the free capacity of the given machine from a placement.
+	public: void update(physical_machine_identifier_type pm_id, virtual_machines_placement_type const& placement)
+	{
+		// pre: pm_id must be indexed
+		DCS_ASSERT(
+				pos_map_.count(pm_id) > 0,
+				throw ::std::invalid_argument("[dcs::des::cloud::detail::physical_machine_fit_index::update] Unknown physical machine.")
+			);
+
+		physical_machine_pointer const& ptr_pm(pms_[pos_map_.at(pm_id)]);
+
+		free_capacity(pm_id,
+					  placement.residual_share(pm_id, cpu_resource_category)
+					  * ptr_pm->resource(cpu_resource_category)->capacity());
+	}
+
+
+	/// Search the leftmost leaf at position >= first in the subtree rooted at node (spanning [lo,hi)).
+	private: size_type find_first(size_type node, size_type lo, size_type hi, real_type capacity, size_type first) const
+	{
+		if (hi <= first || ::dcs::math::float_traits<real_type>::definitely_less(tree_[node], capacity))
+		{
+			return leaf_offset_;
+		}
+
+		if (hi-lo == 1)
+		{
+			return lo;
+		}
+
+		size_type mid(lo+(hi-lo)/2);
+		size_type pos(find_first(2*node, lo, mid, capacity, first));
+		if (pos != leaf_offset_)
+		{
+			return pos;
+		}
+
+		return find_first(2*node+1, mid, hi, capacity, first);
+	}
+
+
+	/// Machines in visiting order.
+	private: physical_machine_container pms_;
+	/// Number of powered-on machines.
+	private: size_type num_powered_on_;
+	/// Maps a machine identifier to its position in the visiting order.
+	private: ::std::map<physical_machine_identifier_type,size_type> pos_map_;
+	/// Index of the first leaf in the tree.
+	private: size_type leaf_offset_;
+	/// Max-tree of the free capacity (leaves are in visiting order).
+	private: ::std::vector<real_type> tree_;
+}; // physical_machine_fit_index
+
+}}}} // Namespace dcs::des::cloud::detail
+
+
+#endif // DCS_DES_CLOUD_DETAIL_PHYSICAL_MACHINE_FIT_INDEX_HPP
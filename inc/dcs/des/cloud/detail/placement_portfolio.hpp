@@ -0,0 +1,444 @@
+/**
+ * \file dcs/des/cloud/detail/placement_portfolio.hpp
+ *
+ * \brief Concurrent run of a portfolio of VM placement strategies.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_DETAIL_PLACEMENT_PORTFOLIO_HPP
+#define DCS_DES_CLOUD_DETAIL_PLACEMENT_PORTFOLIO_HPP
+
+
+#include <algorithm>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/thread_time.hpp>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/des/cloud/data_center.hpp>
+#include <dcs/des/cloud/logging.hpp>
+#include <dcs/des/cloud/performance_measure_category.hpp>
+#include <dcs/des/cloud/physical_resource_category.hpp>
+#include <dcs/des/cloud/resource_vector.hpp>
+#include <dcs/des/cloud/utility.hpp>
+#include <dcs/des/cloud/virtual_machines_placement.hpp>
+#include <exception>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace cloud { namespace detail {
+
+/**
+ * \brief Cost of a VM placement, used to rank the placements found by the
+ *  strategies of a portfolio.
+ *
+ * The cost is the weighted sum of:
+ * - the number of active machines (i.e., machines hosting at least one VM);
+ * - the energy expected to be consumed by active machines, according to
+ *   their energy model and to the expected utilization of their VMs;
+ * - the SLA violation risk, that is the squared relative shortfall of the
+ *   capacity assigned to each VM with respect to its reference capacity, plus
+ *   the expected utilization exceeding the threshold of each machine.
+ */
+template <typename TraitsT>
+class placement_cost_model
+{
+	public: typedef TraitsT traits_type;
+	public: typedef typename traits_type::real_type real_type;
+	public: typedef data_center<traits_type> data_center_type;
+	public: typedef virtual_machines_placement<traits_type> virtual_machines_placement_type;
+	private: typedef typename traits_type::physical_machine_identifier_type physical_machine_identifier_type;
+	private: typedef resource_vector<real_type> resource_utilization_map;
+	private: typedef ::std::map<physical_machine_identifier_type,resource_utilization_map> physical_machine_utilization_map;
+
+
+	public: static const real_type default_active_machines_weight;
+	public: static const real_type default_power_weight;
+	public: static const real_type default_sla_weight;
+
+
+	public: explicit placement_cost_model(real_type wn = default_active_machines_weight,
+										  real_type wp = default_power_weight,
+										  real_type ws = default_sla_weight)
+	: wn_(wn),
+	  wp_(wp),
+	  ws_(ws)
+	{
+		// pre: wn >= 0
+		DCS_ASSERT(
+			wn >= 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::detail::placement_cost_model::ctor] Invalid active machines weight.")
+		);
+		// pre: wp >= 0
+		DCS_ASSERT(
+			wp >= 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::detail::placement_cost_model::ctor] Invalid power weight.")
+		);
+		// pre: ws >= 0
+		DCS_ASSERT(
+			ws >= 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::detail::placement_cost_model::ctor] Invalid SLA weight.")
+		);
+	}
+
+
+	public: real_type operator()(data_center_type const& dc, virtual_machines_placement_type const& placement) const
+	{
+		typedef typename data_center_type::physical_machine_pointer physical_machine_pointer;
+		typedef typename data_center_type::virtual_machine_pointer virtual_machine_pointer;
+		typedef typename virtual_machines_placement_type::const_iterator placement_iterator;
+		typedef typename virtual_machines_placement_type::share_const_iterator share_iterator;
+		typedef typename physical_machine_utilization_map::const_iterator pm_utilization_iterator;
+		typedef typename resource_utilization_map::const_iterator utilization_iterator;
+
+		real_type sla_risk(0);
+
+		// Compute the expected utilization of each active machine, along with
+		// the capacity shortfall of each VM
+
+		physical_machine_utilization_map pm_utils;
+		placement_iterator end_it(placement.end());
+		for (placement_iterator it = placement.begin(); it != end_it; ++it)
+		{
+			virtual_machine_pointer ptr_vm(dc.virtual_machine_ptr(placement.vm_id(it)));
+			physical_machine_pointer ptr_pm(dc.physical_machine_ptr(placement.pm_id(it)));
+
+			// paranoid-check: valid pointer.
+			DCS_DEBUG_ASSERT( ptr_vm );
+			// paranoid-check: valid pointer.
+			DCS_DEBUG_ASSERT( ptr_pm );
+
+			resource_utilization_map& utils(pm_utils[ptr_pm->id()]);
+
+			share_iterator share_end_it(placement.shares_end(it));
+			for (share_iterator share_it = placement.shares_begin(it); share_it != share_end_it; ++share_it)
+			{
+				physical_resource_category category(placement.resource_category(share_it));
+				real_type share(placement.resource_share(share_it));
+
+				real_type ref_capacity(ptr_vm->guest_system().application().reference_resource(category).capacity());
+				real_type ref_share(ptr_vm->guest_system().resource_share(category));
+				real_type capacity(ptr_pm->resource(category)->capacity());
+
+				utils[category] += scale_resource_utilization(ref_capacity,
+															  ref_share,
+															  capacity,
+															  share,
+															  ptr_vm->guest_system().application().performance_model().tier_measure(ptr_vm->guest_system().id(), utilization_performance_measure),
+															  ptr_pm->resource(category)->utilization_threshold());
+
+				if (ref_share > 0 && ref_capacity > 0)
+				{
+					real_type shortfall(1-(share*capacity)/(ref_share*ref_capacity));
+					if (shortfall > 0)
+					{
+						sla_risk += shortfall*shortfall;
+					}
+				}
+			}
+		}
+
+		// Add the cost of each active machine
+
+		real_type energy(0);
+		pm_utilization_iterator pm_end_it(pm_utils.end());
+		for (pm_utilization_iterator pm_it = pm_utils.begin(); pm_it != pm_end_it; ++pm_it)
+		{
+			physical_machine_pointer ptr_pm(dc.physical_machine_ptr(pm_it->first));
+
+			utilization_iterator util_end_it(pm_it->second.end());
+			for (utilization_iterator util_it = pm_it->second.begin(); util_it != util_end_it; ++util_it)
+			{
+				physical_resource_category category(util_it->first);
+				real_type util(util_it->second);
+				real_type threshold(ptr_pm->resource(category)->utilization_threshold());
+
+				energy += ptr_pm->resource(category)->energy_model().consumed_energy(::std::min(util, real_type(1)));
+				if (util > threshold)
+				{
+					sla_risk += util-threshold;
+				}
+			}
+		}
+
+		return wn_*static_cast<real_type>(pm_utils.size())
+			   + wp_*energy
+			   + ws_*sla_risk;
+	}
+
+
+	private: real_type wn_;
+	private: real_type wp_;
+	private: real_type ws_;
+}; // placement_cost_model
+
+template <typename TraitsT>
+const typename placement_cost_model<TraitsT>::real_type placement_cost_model<TraitsT>::default_active_machines_weight(1);
+
+template <typename TraitsT>
+const typename placement_cost_model<TraitsT>::real_type placement_cost_model<TraitsT>::default_power_weight(1);
+
+template <typename TraitsT>
+const typename placement_cost_model<TraitsT>::real_type placement_cost_model<TraitsT>::default_sla_weight(1);
+
+
+/**
+ * \brief Runs a portfolio of VM placement tasks concurrently and selects the
+ *  best placement found.
+ *
+ * Every task is run on its own thread.
+ * A task is a function object computing a placement; it must only read the
+ * data center, which must not be changed until \c run returns.
+ * For this reason, tasks still running when the time budget expires are
+ * waited for, but their placements are discarded (unless no task completed in
+ * time).
+ * Hence the time budget bounds the latency of \c run only if every task gives
+ * up on its own within the budget (e.g., the native optimal solver with a
+ * time limit); \c config::make_initial_placement_strategy rejects optimal
+ * tasks which cannot be bounded (i.e., AMPL/NEOS solvers).
+ *
+ * Placements are ranked first by the number of the given VMs left unplaced,
+ * then by their cost (see \c placement_cost_model).
+ */
+template <typename TraitsT>
+class placement_portfolio
+{
+	public: typedef TraitsT traits_type;
+	public: typedef typename traits_type::real_type real_type;
+	public: typedef data_center<traits_type> data_center_type;
+	public: typedef virtual_machines_placement<traits_type> virtual_machines_placement_type;
+	public: typedef placement_cost_model<traits_type> cost_model_type;
+	private: typedef typename data_center_type::virtual_machine_pointer virtual_machine_pointer;
+	private: typedef ::std::vector<virtual_machine_pointer> virtual_machine_container;
+	/// Shared state of the threads running the tasks.
+	private: template <typename TaskT>
+		struct concurrent_run
+	{
+		concurrent_run(::std::vector<TaskT> const& tasks_)
+		: tasks(tasks_),
+		  placements(tasks_.size()),
+		  errors(tasks_.size()),
+		  done(tasks_.size(), false),
+		  in_time(tasks_.size(), false),
+		  num_done(0),
+		  expired(false)
+		{
+		}
+
+		void work(::std::size_t i)
+		{
+			virtual_machines_placement_type placement;
+			::std::string error;
+
+			try
+			{
+				placement = tasks[i]();
+			}
+			catch (::std::exception const& e)
+			{
+				error = e.what();
+			}
+			catch (...)
+			{
+				error = "Unknown error.";
+			}
+
+			::boost::lock_guard< ::boost::mutex > lock(mutex);
+
+			placements[i] = placement;
+			errors[i] = error;
+			done[i] = true;
+			in_time[i] = !expired;
+			++num_done;
+			cond.notify_all();
+		}
+
+		::std::vector<TaskT> const& tasks;
+		::std::vector<virtual_machines_placement_type> placements;
+		::std::vector< ::std::string > errors;
+		::std::vector<bool> done;
+		/// Tells if a task completed within the time budget
+		::std::vector<bool> in_time;
+		::std::size_t num_done;
+		bool expired;
+		::boost::mutex mutex;
+		::boost::condition_variable cond;
+	};
+	private: template <typename TaskT>
+		struct worker
+	{
+		worker(concurrent_run<TaskT>* ptr_run_, ::std::size_t i_)
+		: ptr_run(ptr_run_),
+		  i(i_)
+		{
+		}
+
+		void operator()()
+		{
+			ptr_run->work(i);
+		}
+
+		concurrent_run<TaskT>* ptr_run;
+		::std::size_t i;
+	};
+
+
+	public: static const real_type default_time_budget;
+
+
+	public: explicit placement_portfolio(cost_model_type const& cost_model = cost_model_type(),
+										 real_type time_budget = default_time_budget)
+	: cost_model_(cost_model),
+	  time_budget_(time_budget)
+	{
+		// pre: time_budget > 0
+		DCS_ASSERT(
+			time_budget > 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::detail::placement_portfolio::ctor] Invalid time budget.")
+		);
+	}
+
+
+	/**
+	 * \brief Runs the given tasks and returns the best placement of the given
+	 *  VMs.
+	 *
+	 * \exception std::runtime_error No task has been able to compute a
+	 *  placement.
+	 */
+	public: template <typename TaskT, typename ForwardIterT>
+		virtual_machines_placement_type run(::std::vector<TaskT> const& tasks,
+											data_center_type const& dc,
+											ForwardIterT first_vm,
+											ForwardIterT last_vm) const
+	{
+		virtual_machine_container vms(first_vm, last_vm);
+
+		concurrent_run<TaskT> state(tasks);
+
+		::boost::thread_group workers;
+		for (::std::size_t i = 0; i < tasks.size(); ++i)
+		{
+			workers.create_thread(worker<TaskT>(&state, i));
+		}
+
+		{
+			::boost::unique_lock< ::boost::mutex > lock(state.mutex);
+
+			if (time_budget_ == ::std::numeric_limits<real_type>::infinity())
+			{
+				while (state.num_done < tasks.size())
+				{
+					state.cond.wait(lock);
+				}
+			}
+			else
+			{
+				::boost::system_time deadline(::boost::get_system_time()
+											  + ::boost::posix_time::microseconds(static_cast<long>(time_budget_*1.0e+6)));
+				while (state.num_done < tasks.size() && state.cond.timed_wait(lock, deadline))
+				{
+				}
+			}
+			state.expired = true;
+		}
+
+		// Tasks read the data center, which can change as soon as we return
+		workers.join_all();
+
+		bool any_in_time(false);
+		for (::std::size_t i = 0; i < tasks.size(); ++i)
+		{
+			if (state.in_time[i] && state.errors[i].empty())
+			{
+				any_in_time = true;
+			}
+		}
+
+		::std::size_t best(tasks.size());
+		::std::size_t best_unplaced(0);
+		real_type best_cost(0);
+		for (::std::size_t i = 0; i < tasks.size(); ++i)
+		{
+			if (!state.errors[i].empty())
+			{
+				::std::ostringstream oss;
+				oss << "Placement strategy #" << i << " of the portfolio failed: " << state.errors[i];
+				log_warn(DCS_DES_CLOUD_LOGGING_AT, oss.str());
+				continue;
+			}
+			if (any_in_time && !state.in_time[i])
+			{
+				::std::ostringstream oss;
+				oss << "Placement strategy #" << i << " of the portfolio exceeded the time budget. Discard its placement.";
+				log_warn(DCS_DES_CLOUD_LOGGING_AT, oss.str());
+				continue;
+			}
+
+			::std::size_t unplaced(0);
+			for (::std::size_t j = 0; j < vms.size(); ++j)
+			{
+				if (!state.placements[i].placed(*(vms[j])))
+				{
+					++unplaced;
+				}
+			}
+			real_type cost(cost_model_(dc, state.placements[i]));
+DCS_DEBUG_TRACE("Portfolio strategy #" << i << " - Unplaced VMs: " << unplaced << " - Cost: " << cost);//XXX
+
+			if (best == tasks.size()
+				|| unplaced < best_unplaced
+				|| (unplaced == best_unplaced && cost < best_cost))
+			{
+				best = i;
+				best_unplaced = unplaced;
+				best_cost = cost;
+			}
+		}
+
+		if (best == tasks.size())
+		{
+			throw ::std::runtime_error("[dcs::des::cloud::detail::placement_portfolio::run] No strategy has been able to compute a placement.");
+		}
+
+		return state.placements[best];
+	}
+
+
+	private: cost_model_type cost_model_;
+	private: real_type time_budget_;
+}; // placement_portfolio
+
+template <typename TraitsT>
+const typename placement_portfolio<TraitsT>::real_type placement_portfolio<TraitsT>::default_time_budget(::std::numeric_limits<typename TraitsT::real_type>::infinity());
+
+}}}} // Namespace dcs::des::cloud::detail
+
+
+#endif // DCS_DES_CLOUD_DETAIL_PLACEMENT_PORTFOLIO_HPP
@@ -0,0 +1,398 @@
+/**
+ * \file dcs/des/cloud/detail/sysid_worker/client.hpp
+ *
+ * \brief Client side of a long-lived system identification worker.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_DETAIL_SYSID_WORKER_CLIENT_HPP
+#define DCS_DES_CLOUD_DETAIL_SYSID_WORKER_CLIENT_HPP
+
+
+#include <boost/utility.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/des/cloud/detail/sysid_worker/protocol.hpp>
+#include <ctime>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace cloud { namespace detail { namespace sysid_worker {
+
+/// Name of the environment variable holding the command line of the worker.
+inline
+char const* command_env_var()
+{
+	return "DCS_DES_CLOUD_SYSID_WORKER";
+}
+
+
+/**
+ * \brief Return the command line used to start a worker.
+ *
+ * The command line stored in the \c DCS_DES_CLOUD_SYSID_WORKER environment
+ * variable is used when set (e.g.,
+ * <tt>octave-cli -q --eval dcs_des_cloud_sysid_worker</tt> or
+ * <tt>des_cloud_sysid_worker</tt>); otherwise \a default_cmd is returned.
+ */
+inline
+::std::vector< ::std::string > worker_command(::std::vector< ::std::string > const& default_cmd)
+{
+	char const* env(::getenv(command_env_var()));
+
+	if (!env || !*env)
+	{
+		return default_cmd;
+	}
+
+	::std::vector< ::std::string > cmd;
+	::std::istringstream iss(env);
+	::std::string arg;
+	while (iss >> arg)
+	{
+		cmd.push_back(arg);
+	}
+
+	return cmd;
+}
+
+
+/**
+ * \brief Keep \c SIGPIPE from being delivered to the calling thread during
+ *  the lifetime of this object.
+ *
+ * A write to a dead worker must show up as an \c EPIPE error rather than kill
+ * the simulator, but the signal disposition of the whole process must not be
+ * changed behind the back of the application.
+ * Hence the signal is blocked in the calling thread only, and a \c SIGPIPE
+ * raised meanwhile is discarded before restoring the previous signal mask.
+ */
+class sigpipe_guard: ::boost::noncopyable
+{
+	public: sigpipe_guard()
+	: was_pending_(false)
+	{
+		sigemptyset(&sigpipe_set_);
+		sigaddset(&sigpipe_set_, SIGPIPE);
+
+		// A SIGPIPE already pending (and blocked) is not ours to discard
+		sigset_t pending;
+		was_pending_ = ::sigpending(&pending) == 0 && sigismember(&pending, SIGPIPE);
+
+		::pthread_sigmask(SIG_BLOCK, &sigpipe_set_, &old_set_);
+	}
+
+
+	public: ~sigpipe_guard()
+	{
+		int err(errno);
+
+		if (!was_pending_)
+		{
+			sigset_t pending;
+			if (::sigpending(&pending) == 0 && sigismember(&pending, SIGPIPE))
+			{
+				::timespec timeout = {0, 0};
+				while (::sigtimedwait(&sigpipe_set_, 0, &timeout) == -1 && errno == EINTR)
+				{
+					;
+				}
+			}
+		}
+
+		::pthread_sigmask(SIG_SETMASK, &old_set_, 0);
+
+		errno = err;
+	}
+
+
+	private: sigset_t sigpipe_set_;
+	private: sigset_t old_set_;
+	private: bool was_pending_;
+};
+
+
+/**
+ * \brief Client of a system identification worker process.
+ *
+ * The worker is spawned once at construction and is kept alive until the
+ * client is destroyed, so that every request costs a round-trip over a pair
+ * of pipes rather than a process start-up.
+ * See \c protocol.hpp for the wire format.
+ *
+ * A client inherited by a forked process never talks to the worker of its
+ * parent (whose pipes it shares): it starts its own worker at the first
+ * request.
+ * This is possible since workers are stateless (the estimator state travels
+ * with each request).
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+class client: ::boost::noncopyable
+{
+	/// File descriptor on which the worker writes its replies.
+	public: static const int reply_fd = 3;
+
+
+	public: explicit client(::std::vector< ::std::string > const& cmd)
+	: cmd_(cmd),
+	  owner_pid_(-1),
+	  pid_(-1),
+	  req_fd_(-1),
+	  rep_fd_(-1)
+	{
+		spawn(cmd_);
+	}
+
+
+	public: ~client()
+	{
+		try
+		{
+			shutdown();
+		}
+		catch (...)
+		{
+			// Never throw from a destructor
+		}
+	}
+
+
+	/// Send a request and wait for its reply.
+	public: message call(message const& req)
+	{
+		// pre: worker must be running
+		DCS_ASSERT(
+				pid_ != -1,
+				throw ::std::logic_error("[dcs::des::cloud::detail::sysid_worker::client::call] Worker not running.")
+			);
+
+		if (inherited())
+		{
+			abandon();
+			spawn(cmd_);
+		}
+
+		{
+			sigpipe_guard guard;
+
+			write_message(req_fd_, req);
+		}
+
+		message rep;
+		if (!read_message(rep_fd_, rep))
+		{
+			throw ::std::runtime_error("[dcs::des::cloud::detail::sysid_worker::client::call] Worker terminated unexpectedly.");
+		}
+		if (rep.op == error_opcode)
+		{
+			throw ::std::runtime_error("[dcs::des::cloud::detail::sysid_worker::client::call] Worker error: " + error_text(rep));
+		}
+		if (rep.op != req.op)
+		{
+			throw ::std::runtime_error("[dcs::des::cloud::detail::sysid_worker::client::call] Unexpected reply from worker.");
+		}
+
+		return rep;
+	}
+
+
+	/// Ask the worker to quit and wait for its termination.
+	public: void shutdown()
+	{
+		if (pid_ == -1)
+		{
+			return;
+		}
+
+		if (inherited())
+		{
+			// The worker belongs to the parent process: leave it alone
+			abandon();
+			return;
+		}
+
+		try
+		{
+			sigpipe_guard guard;
+
+			write_message(req_fd_, message(quit_opcode));
+		}
+		catch (...)
+		{
+			// The worker may be already gone: just reap it
+		}
+		::close(req_fd_);
+		::close(rep_fd_);
+		req_fd_ = rep_fd_ = -1;
+
+		int status;
+		while (::waitpid(pid_, &status, 0) == -1 && errno == EINTR)
+		{
+			;
+		}
+		pid_ = -1;
+	}
+
+
+	/// Tell if the worker was started by another (i.e., the parent) process.
+	private: bool inherited() const
+	{
+		return owner_pid_ != ::getpid();
+	}
+
+
+	/// Drop the inherited worker, without touching it.
+	private: void abandon()
+	{
+		::close(req_fd_);
+		::close(rep_fd_);
+		req_fd_ = rep_fd_ = -1;
+		pid_ = -1;
+	}
+
+
+	private: void spawn(::std::vector< ::std::string > const& cmd)
+	{
+		if (cmd.empty())
+		{
+			throw ::std::invalid_argument("[dcs::des::cloud::detail::sysid_worker::client::spawn] Empty worker command.");
+		}
+
+		int req_pipe[2];
+		int rep_pipe[2];
+
+		if (::pipe(req_pipe) == -1)
+		{
+			throw_errno("pipe(2)");
+		}
+		if (::pipe(rep_pipe) == -1)
+		{
+			int err(errno);
+			::close(req_pipe[0]);
+			::close(req_pipe[1]);
+			errno = err;
+			throw_errno("pipe(2)");
+		}
+
+		// Between fork() and execvp() only async-signal-safe functions
+		// must be called, hence the argument vector is prepared here.
+		::std::vector<char*> argv;
+		for (::std::size_t i = 0; i < cmd.size(); ++i)
+		{
+			argv.push_back(const_cast<char*>(cmd[i].c_str()));
+		}
+		argv.push_back(0);
+
+		::pid_t pid(::fork());
+
+		if (pid == -1)
+		{
+			int err(errno);
+			::close(req_pipe[0]);
+			::close(req_pipe[1]);
+			::close(rep_pipe[0]);
+			::close(rep_pipe[1]);
+			errno = err;
+			throw_errno("fork(2)");
+		}
+
+		if (pid == 0)
+		{
+			// The child: requests come from stdin, replies go to fd 3.
+
+			// Move the reply end out of the way before overwriting fd 3
+			int rep_wr(::fcntl(rep_pipe[1], F_DUPFD, reply_fd+1));
+			if (rep_wr == -1
+				|| ::dup2(req_pipe[0], STDIN_FILENO) == -1
+				|| ::dup2(rep_wr, reply_fd) == -1)
+			{
+				::_exit(127);
+			}
+
+			// Close any other inherited descriptor
+			long maxfd(::sysconf(_SC_OPEN_MAX));
+			if (maxfd < 0)
+			{
+				maxfd = 1024;
+			}
+			for (int fd = reply_fd+1; fd < maxfd; ++fd)
+			{
+				::close(fd);
+			}
+
+			::execvp(argv[0], &argv[0]);
+
+			::write(STDERR_FILENO, "execvp() failed\n", 16);
+			::_exit(127);
+		}
+
+		// The parent
+		::close(req_pipe[0]);
+		::close(rep_pipe[1]);
+		::fcntl(req_pipe[1], F_SETFD, FD_CLOEXEC);
+		::fcntl(rep_pipe[0], F_SETFD, FD_CLOEXEC);
+
+		owner_pid_ = ::getpid();
+		pid_ = pid;
+		req_fd_ = req_pipe[1];
+		rep_fd_ = rep_pipe[0];
+
+		DCS_DEBUG_TRACE("Started system identification worker '" << cmd[0] << "' (pid: " << pid_ << ")");
+	}
+
+
+	private: static void throw_errno(char const* what)
+	{
+		::std::ostringstream oss;
+		oss << "[dcs::des::cloud::detail::sysid_worker::client::spawn] " << what << " failed: " << ::std::strerror(errno);
+		throw ::std::runtime_error(oss.str());
+	}
+
+
+	/// The command line of the worker.
+	private: ::std::vector< ::std::string > cmd_;
+	/// The process which started the worker.
+	private: ::pid_t owner_pid_;
+	/// The worker process.
+	private: ::pid_t pid_;
+	/// The write end of the request pipe.
+	private: int req_fd_;
+	/// The read end of the reply pipe.
+	private: int rep_fd_;
+};
+
+}}}}} // Namespace dcs::des::cloud::detail::sysid_worker
+
+
+#endif // DCS_DES_CLOUD_DETAIL_SYSID_WORKER_CLIENT_HPP
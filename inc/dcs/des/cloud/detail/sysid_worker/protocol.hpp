@@ -0,0 +1,376 @@
+/**
+ * \file dcs/des/cloud/detail/sysid_worker/protocol.hpp
+ *
+ * \brief Framed binary protocol spoken with system identification workers.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_DETAIL_SYSID_WORKER_PROTOCOL_HPP
+#define DCS_DES_CLOUD_DETAIL_SYSID_WORKER_PROTOCOL_HPP
+
+
+#include <boost/cstdint.hpp>
+#include <boost/numeric/ublas/expression_types.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublasx/operation/num_columns.hpp>
+#include <boost/numeric/ublasx/operation/num_rows.hpp>
+#include <boost/numeric/ublasx/operation/size.hpp>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+
+/**
+ * A worker is a long-lived process that reads request frames from its
+ * standard input and writes reply frames on file descriptor 3 (so that any
+ * banner or diagnostic printed on its standard output, as MATLAB does, cannot
+ * corrupt the stream).
+ *
+ * Every frame is made of:
+ * - the magic number \c 0x57534344 (i.e., "DCSW" in little-endian order),
+ * - the operation code,
+ * - the number \e n of matrices,
+ * - \e n matrices, each made of the number of rows \e r, the number of
+ *   columns \e c and \e r*c values stored column by column.
+ * .
+ * Integers are 32-bit unsigned and values are 64-bit IEEE floating-point
+ * numbers, both in the byte order of the host (the worker always runs on the
+ * same host of the simulator).
+ *
+ * Requests and replies of each operation are:
+ * - \c rarx_opcode: request <tt>(z, nn, ff[, th, P, phi])</tt> and reply
+ *   <tt>(th, yh, P, phi)</tt>, with the meaning of the MATLAB \c rarx function
+ *   with the \c 'ff' adaptation mechanism;
+ * - \c rpem_opcode: request <tt>(z, nn, ff[, th, P, phi, psi])</tt> and reply
+ *   <tt>(th, yh, P, phi, psi)</tt>, with the meaning of the MATLAB \c rpem
+ *   function with the \c 'ff' adaptation mechanism;
+ * - \c quit_opcode: no argument and no reply; the worker exits.
+ * .
+ * A failed request is replied with \c error_opcode and a single row vector
+ * holding the characters of the error message.
+ */
+
+
+namespace dcs { namespace des { namespace cloud { namespace detail { namespace sysid_worker {
+
+typedef ::boost::uint32_t word_type;
+typedef double value_type;
+typedef ::boost::numeric::ublas::matrix<value_type, ::boost::numeric::ublas::column_major> matrix_type;
+
+
+const word_type magic = 0x57534344;
+
+
+enum opcode
+{
+	quit_opcode = 0,
+	rarx_opcode = 1,
+	rpem_opcode = 2,
+	error_opcode = 255
+};
+
+
+struct message
+{
+	message()
+	: op(quit_opcode)
+	{
+	}
+
+
+	explicit message(word_type op_)
+	: op(op_)
+	{
+	}
+
+
+	word_type op;
+	::std::vector<matrix_type> args;
+};
+
+
+inline
+void write_bytes(int fd, void const* data, ::std::size_t n)
+{
+	char const* p(static_cast<char const*>(data));
+
+	while (n > 0)
+	{
+		::ssize_t k(::write(fd, p, n));
+
+		if (k < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			::std::ostringstream oss;
+			oss << "[dcs::des::cloud::detail::sysid_worker::write_bytes] write(2) failed: " << ::std::strerror(errno);
+			throw ::std::runtime_error(oss.str());
+		}
+
+		p += k;
+		n -= k;
+	}
+}
+
+
+/// Read exactly \a n bytes; return \c false if end-of-file is met before the first byte.
+inline
+bool read_bytes(int fd, void* data, ::std::size_t n)
+{
+	char* p(static_cast<char*>(data));
+	::std::size_t nread(0);
+
+	while (nread < n)
+	{
+		::ssize_t k(::read(fd, p+nread, n-nread));
+
+		if (k < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			::std::ostringstream oss;
+			oss << "[dcs::des::cloud::detail::sysid_worker::read_bytes] read(2) failed: " << ::std::strerror(errno);
+			throw ::std::runtime_error(oss.str());
+		}
+		if (k == 0)
+		{
+			if (nread == 0)
+			{
+				return false;
+			}
+
+			throw ::std::runtime_error("[dcs::des::cloud::detail::sysid_worker::read_bytes] Truncated frame.");
+		}
+
+		nread += k;
+	}
+
+	return true;
+}
+
+
+inline
+void write_message(int fd, message const& msg)
+{
+	// Serialize the whole frame first, so that it is sent with as few system
+	// calls as possible.
+	::std::vector<char> buf;
+	::std::size_t sz(3*sizeof(word_type));
+	::std::size_t nargs(msg.args.size());
+	for (::std::size_t i = 0; i < nargs; ++i)
+	{
+		sz += 2*sizeof(word_type)+msg.args[i].size1()*msg.args[i].size2()*sizeof(value_type);
+	}
+	buf.resize(sz);
+
+	char* p(&buf[0]);
+	word_type hdr[3] = {magic, msg.op, static_cast<word_type>(nargs)};
+	::std::memcpy(p, hdr, sizeof(hdr));
+	p += sizeof(hdr);
+	for (::std::size_t i = 0; i < nargs; ++i)
+	{
+		matrix_type const& A(msg.args[i]);
+		word_type dims[2] = {static_cast<word_type>(A.size1()), static_cast<word_type>(A.size2())};
+		::std::size_t n(A.size1()*A.size2());
+
+		::std::memcpy(p, dims, sizeof(dims));
+		p += sizeof(dims);
+		if (n > 0)
+		{
+			::std::memcpy(p, &A.data()[0], n*sizeof(value_type));
+			p += n*sizeof(value_type);
+		}
+	}
+
+	write_bytes(fd, &buf[0], buf.size());
+}
+
+
+/// Read a frame; return \c false on end-of-file.
+inline
+bool read_message(int fd, message& msg)
+{
+	word_type hdr[3];
+
+	if (!read_bytes(fd, hdr, sizeof(hdr)))
+	{
+		return false;
+	}
+
+	if (hdr[0] != magic)
+	{
+		throw ::std::runtime_error("[dcs::des::cloud::detail::sysid_worker::read_message] Bad frame magic number.");
+	}
+
+	msg.op = hdr[1];
+	msg.args.resize(hdr[2]);
+	for (::std::size_t i = 0; i < hdr[2]; ++i)
+	{
+		word_type dims[2];
+
+		if (!read_bytes(fd, dims, sizeof(dims)))
+		{
+			throw ::std::runtime_error("[dcs::des::cloud::detail::sysid_worker::read_message] Truncated frame.");
+		}
+
+		matrix_type& A(msg.args[i]);
+		A.resize(dims[0], dims[1], false);
+
+		::std::size_t n(static_cast< ::std::size_t >(dims[0])*dims[1]);
+		if (n > 0 && !read_bytes(fd, &A.data()[0], n*sizeof(value_type)))
+		{
+			throw ::std::runtime_error("[dcs::des::cloud::detail::sysid_worker::read_message] Truncated frame.");
+		}
+	}
+
+	return true;
+}
+
+
+/// Make a column (or row) matrix from a vector expression.
+template <typename VectorExprT>
+matrix_type make_matrix(::boost::numeric::ublas::vector_expression<VectorExprT> const& v, bool column = true)
+{
+	::std::size_t n(::boost::numeric::ublasx::size(v));
+	matrix_type A(column ? n : 1, column ? 1 : n);
+
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		A.data()[i] = static_cast<value_type>(v()(i));
+	}
+
+	return A;
+}
+
+
+/// Make a row matrix from a standard vector.
+template <typename ValueT>
+matrix_type make_matrix(::std::vector<ValueT> const& v)
+{
+	matrix_type A(1, v.size());
+
+	for (::std::size_t i = 0; i < v.size(); ++i)
+	{
+		A.data()[i] = static_cast<value_type>(v[i]);
+	}
+
+	return A;
+}
+
+
+template <typename MatrixExprT>
+matrix_type make_matrix(::boost::numeric::ublas::matrix_expression<MatrixExprT> const& A)
+{
+	return matrix_type(A);
+}
+
+
+inline
+matrix_type make_matrix(value_type x)
+{
+	return matrix_type(1, 1, x);
+}
+
+
+/// Copy all the values of a matrix, column by column, into a vector.
+template <typename T>
+void copy_matrix(matrix_type const& A, ::boost::numeric::ublas::vector<T>& v)
+{
+	::std::size_t n(A.size1()*A.size2());
+
+	v.resize(n, false);
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		v(i) = static_cast<T>(A.data()[i]);
+	}
+}
+
+
+template <typename T, typename L, typename A>
+void copy_matrix(matrix_type const& X, ::boost::numeric::ublas::matrix<T,L,A>& Y)
+{
+	Y = X;
+}
+
+
+/// Copy the only value of a 1x1 matrix into a scalar.
+template <typename T>
+void copy_matrix(matrix_type const& A, T& x)
+{
+	if (A.size1()*A.size2() != 1)
+	{
+		throw ::std::runtime_error("[dcs::des::cloud::detail::sysid_worker::copy_matrix] Expected a scalar.");
+	}
+
+	x = static_cast<T>(A.data()[0]);
+}
+
+
+inline
+message make_error_message(::std::string const& what)
+{
+	message msg(error_opcode);
+
+	msg.args.push_back(matrix_type(1, what.size()));
+	for (::std::size_t i = 0; i < what.size(); ++i)
+	{
+		msg.args[0].data()[i] = static_cast<value_type>(static_cast<unsigned char>(what[i]));
+	}
+
+	return msg;
+}
+
+
+inline
+::std::string error_text(message const& msg)
+{
+	::std::string what;
+
+	if (!msg.args.empty())
+	{
+		matrix_type const& A(msg.args[0]);
+		::std::size_t n(A.size1()*A.size2());
+
+		what.reserve(n);
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			what += static_cast<char>(A.data()[i]);
+		}
+	}
+
+	return what;
+}
+
+}}}}} // Namespace dcs::des::cloud::detail::sysid_worker
+
+
+#endif // DCS_DES_CLOUD_DETAIL_SYSID_WORKER_PROTOCOL_HPP
@@ -56,26 +56,15 @@
 #	include <mclcppclass.h>
 #elif defined(DCS_DES_CLOUD_USE_MATLAB_APP)
 #	if _POSIX_C_SOURCE >= 1 || _XOPEN_SOURCE || _POSIX_SOURCE
-#		include <boost/iostreams/device/file_descriptor.hpp>
-#		include <boost/iostreams/stream_buffer.hpp>
-#		include <cctype>
-#		include <cerrno>
-#		include <csignal>
 #		include <cstddef>
-#		include <cstdlib>
-#		include <cstring>
-#		include <fcntl.h>
-#		include <iostream>
-#		include <sstream>
-#		include <sys/resource.h>
-#		include <sys/time.h>
-#		include <sys/types.h>
-#		include <sys/wait.h>
-#		include <unistd.h>
+#		include <dcs/des/cloud/detail/sysid_worker/client.hpp>
+#		include <dcs/des/cloud/detail/sysid_worker/protocol.hpp>
+#		include <string>
 #	else // _POSIX_C_SOURCE
 #		error "Unable to find a POSIX compliant system."
 #	endif // _POSIX_C_SOURCE
 #endif // DCS_DES_CLOUD_USE_MATLAB_*
+#include <limits>
 #include <stdexcept>
 #include <vector>
 
@@ -211,6 +200,20 @@ class base_system_identification_strategy
 	}
 
 
+	/// Store matrix A_k into \a A_k, reusing its storage.
+	public: void A(size_type k, matrix_type& A_k) const
+	{
+		do_A(k, A_k);
+	}
+
+
+	/// Store matrix B_k into \a B_k, reusing its storage.
+	public: void B(size_type k, matrix_type& B_k) const
+	{
+		do_B(k, B_k);
+	}
+
+
 	public: size_type count() const
 	{
 		return count_;
@@ -251,6 +254,18 @@ class base_system_identification_strategy
 	private: virtual matrix_type do_B(size_type k) const = 0;
 
 
+	private: virtual void do_A(size_type k, matrix_type& A_k) const
+	{
+		A_k = do_A(k);
+	}
+
+
+	private: virtual void do_B(size_type k, matrix_type& B_k) const
+	{
+		B_k = do_B(k);
+	}
+
+
 	/// The memory for the control output.
 	private: size_type n_a_;
 	/// The memory for the control input.
@@ -361,6 +376,156 @@ class rls_system_identification_strategy: public base_system_identification_stra
 }; // rls_system_identification_strategy
 
 
+/**
+ * \brief Incremental bounds on the reciprocal condition number of an RLS
+ *  covariance matrix.
+ *
+ * Every RLS variant updates the covariance matrix as
+ * \f$P_k^{-1} = \lambda_k P_{k-1}^{-1} + c_k \phi_k \phi_k^T\f$, with
+ * \f$\lambda_k \le 1\f$ and \f$c_k \le 1\f$ (variants adding a regularization
+ * term to \f$P_k\f$ can only make \f$P_k^{-1}\f$ smaller), so that the largest
+ * eigenvalue of \f$P_k^{-1}\f$ is bounded by
+ * \f$\mu_k = \mu_{k-1} + \|\phi_k\|^2\f$.
+ * Since \f$P_k\f$ is symmetric positive definite, this gives:
+ * \f[
+ *   \frac{1}{\sqrt{n} \|P_k\|_1 \mu_k} \le \operatorname{rcond}_1(P_k) \le \frac{\min_i P_k(i,i)}{\max_i P_k(i,i)}
+ * \f]
+ * Both bounds cost \f$O(n^2)\f$ and no allocation, hence the LU-based \c rcond
+ * estimator is only run when the threshold lies between them; its result is
+ * then used to re-seed \f$\mu_k\f$.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename RealT>
+class rls_covariance_rcond_tracker
+{
+	public: typedef RealT real_type;
+
+
+	public: rls_covariance_rcond_tracker()
+	: mu_(0),
+	  valid_(false)
+	{
+	}
+
+
+	/// Forget the bound (e.g., after the covariance matrix has been reset).
+	public: void reset()
+	{
+		valid_ = false;
+	}
+
+
+	/**
+	 * \brief Account for an RLS step.
+	 *
+	 * \param phi_sq_old The squared norm of the regression vector before the step.
+	 * \param phi_sq_new The squared norm of the regression vector after the step.
+	 *
+	 * Both norms are taken since, depending on the algorithm, the regression
+	 * vector used by the step is the one before or after the update.
+	 */
+	public: void update(real_type phi_sq_old, real_type phi_sq_new)
+	{
+		if (valid_)
+		{
+			mu_ += phi_sq_old+phi_sq_new;
+		}
+	}
+
+
+	/// Tell if \f$\log_{10}(\operatorname{rcond}(P)) > \text{log\_rc}\f$.
+	public: template <typename MatrixT>
+		bool log_rcond_greater(MatrixT const& P, real_type log_rc)
+	{
+		typedef typename MatrixT::size_type size_type;
+
+		const size_type n(P.size1());
+
+		// Column sums of absolute values, extreme diagonal entries and
+		// deviation from symmetry
+		real_type norm1(0);
+		real_type dmin(0);
+		real_type dmax(0);
+		real_type asym(0);
+		for (size_type c = 0; c < n; ++c)
+		{
+			real_type sum(0);
+			for (size_type r = 0; r < n; ++r)
+			{
+				sum += ::std::abs(P(r,c));
+				if (r < c)
+				{
+					asym = ::std::max(asym, ::std::abs(P(r,c)-P(c,r)));
+				}
+			}
+			if (sum > norm1)
+			{
+				norm1 = sum;
+			}
+			if (c == 0 || P(c,c) < dmin)
+			{
+				dmin = P(c,c);
+			}
+			if (c == 0 || P(c,c) > dmax)
+			{
+				dmax = P(c,c);
+			}
+		}
+
+		// The bounds only hold for symmetric positive definite matrices, which
+		// round-off can make P drift away from: in that case, or when a bound is
+		// too close to the threshold to be trusted, fall back to the estimator.
+		if (n > 0 && norm1 > 0 && dmin > 0 && asym <= symmetry_tolerance()*norm1)
+		{
+			if (valid_ && mu_ > 0
+				&& -::std::log10(::std::sqrt(static_cast<real_type>(n))*norm1*mu_) > (log_rc+safety_margin()))
+			{
+				return true;
+			}
+			if (::std::log10(dmin/dmax) <= (log_rc-safety_margin()))
+			{
+				return false;
+			}
+		}
+
+		real_type rc(::boost::numeric::ublasx::rcond(P));
+
+		if (rc > 0 && norm1 > 0)
+		{
+			mu_ = static_cast<real_type>(1)/(rc*norm1);
+			valid_ = true;
+		}
+		else
+		{
+			valid_ = false;
+		}
+
+		return ::std::log10(rc) > log_rc;
+	}
+
+
+	/// Largest deviation from symmetry, relative to the 1-norm, for the bounds to be used.
+	private: static real_type symmetry_tolerance()
+	{
+		return ::std::sqrt(::std::numeric_limits<real_type>::epsilon());
+	}
+
+
+	/// Distance (in decades) a bound must keep from the threshold to be trusted.
+	private: static real_type safety_margin()
+	{
+		return 1;
+	}
+
+
+	/// Upper bound on the largest eigenvalue of the inverse covariance matrix.
+	private: real_type mu_;
+	/// Tell if \c mu_ is meaningful.
+	private: bool valid_;
+}; // rls_covariance_rcond_tracker
+
+
 #if defined(DCS_DES_CLOUD_USE_MATLAB_MCR)
 
 /**
@@ -989,7 +1154,11 @@ class rls_ff_miso_matlab_app_proxy
 			initialized_[i] = false;
 		}
 
-		matlab_cmd_ = find_matlab_command();
+		// Start the worker once: it stays alive across estimation steps
+		if (!ptr_worker_)
+		{
+			ptr_worker_ = ::dcs::make_shared<sysid_worker::client>(sysid_worker::worker_command(default_worker_command()));
+		}
 	}
 
 
@@ -1029,38 +1198,34 @@ class rls_ff_miso_matlab_app_proxy
 			// Partially per-iteration input params
 			z(0) = y()(i);
 
-			// Prepare MATLAB command
-			::std::vector< ::std::string > args;
-			args.push_back("-nodisplay");
-			args.push_back("-nojvm");
-//			args.push_back("-r");
-			::std::ostringstream oss;
-			oss << "-r \"[th,yh,P,phi]=rarx("
-				<< matlab_form(z, false)
-				<< "," << matlab_form(nn, false)
-				<< ",'ff'," << ff_;
+			// Prepare the request
+			sysid_worker::message req(sysid_worker::rarx_opcode);
+			req.args.push_back(sysid_worker::make_matrix(z, false));
+			req.args.push_back(sysid_worker::make_matrix(nn));
+			req.args.push_back(sysid_worker::make_matrix(static_cast<sysid_worker::value_type>(ff_)));
 			if (initialized_[i])
 			{
-				oss << "," << matlab_form(theta_hats_[i], true) //<< "'" // We must pass the transpose of theta_hat
-					<< "," << matlab_form(Ps_[i])
-					<< "," << matlab_form(phis_[i], true);
+				req.args.push_back(sysid_worker::make_matrix(theta_hats_[i]));
+				req.args.push_back(sysid_worker::make_matrix(Ps_[i]));
+				req.args.push_back(sysid_worker::make_matrix(phis_[i]));
 			}
 			else
 			{
 				initialized_[i] = true;
 			}
-			oss << "); format long;"
-				<< " disp('--- [dcs::des::cloud] ---');"
-				<< " disp(['th=', mat2str(th), ]);"
-				<< " disp(['yh=', num2str(yh), ]);"
-				<< " disp(['P=', mat2str(P), ]);"
-				<< " disp(['phi=', mat2str(phi), ]);"
-				<< " disp('--- [/des/cloud] ---');"
-				<< " quit force\"";
-			args.push_back(oss.str());
-
-			// Run MATLAB and retrieve its results
-			run_matlab(matlab_cmd_, args, theta_hats_[i], y_hat(i), Ps_[i], phis_[i]);
+
+			// Send the request to the worker and retrieve its results
+			sysid_worker::message rep(ptr_worker_->call(req));
+
+			DCS_ASSERT(
+					rep.args.size() == 4,
+					throw ::std::runtime_error("[dcs::des::cloud::detail::rls_ff_miso_matlab_app_proxy::estimate] Wrong number of results from the system identification worker.")
+				);
+
+			sysid_worker::copy_matrix(rep.args[0], theta_hats_[i]);
+			sysid_worker::copy_matrix(rep.args[1], y_hat(i));
+			sysid_worker::copy_matrix(rep.args[2], Ps_[i]);
+			sysid_worker::copy_matrix(rep.args[3], phis_[i]);
 
 DCS_DEBUG_TRACE("New theta_hat["<< i << "](k): " << theta_hats_[i]);//XXX
 DCS_DEBUG_TRACE("New P["<< i << "](k): " << Ps_[i]);//XXX
@@ -1132,92 +1297,6 @@ DCS_DEBUG_TRACE("New e["<< i << "](k): " << (y()(i)-y_hat(i)));//XXX
 	}
 
 
-	private: template <typename ValueT>
-		static ::std::string matlab_form(::std::vector<ValueT> const& v, bool column = true)
-	{
-		size_type n(v.size());
-		::std::ostringstream oss;
-		oss << "[";
-		for (size_type i = 0; i < n; ++i)
-		{
-			if (i > 0)
-			{
-				if (column)
-				{
-					oss << ";";
-				}
-				else
-				{
-					oss << " ";
-				}
-			}
-			oss << v[i];
-		}
-		oss << "]";
-
-		return oss.str();
-	}
-
-
-	private: template <typename VectorExprT>
-		static ::std::string matlab_form(::boost::numeric::ublas::vector_expression<VectorExprT> const& v, bool column = true)
-	{
-		namespace ublasx = ::boost::numeric::ublasx;
-
-		size_type n(ublasx::size(v));
-		::std::ostringstream oss;
-		oss << "[";
-		for (size_type i = 0; i < n; ++i)
-		{
-			if (i > 0)
-			{
-				if (column)
-				{
-					oss << ";";
-				}
-				else
-				{
-					oss << " ";
-				}
-			}
-			oss << v()(i);
-		}
-		oss << "]";
-
-		return oss.str();
-	}
-
-
-	private: template <typename MatrixExprT>
-		static ::std::string matlab_form(::boost::numeric::ublas::matrix_expression<MatrixExprT> const& A)
-	{
-		namespace ublasx = ::boost::numeric::ublasx;
-
-		size_type nr(ublasx::num_rows(A));
-		size_type nc(ublasx::num_columns(A));
-		::std::ostringstream oss;
-		oss << "[";
-		for (size_type r = 0; r < nr; ++r)
-		{
-			if (r > 0)
-			{
-				oss << ";";
-			}
-			for (size_type c = 0; c < nc; ++c)
-			{
-				if (c > 0)
-				{
-					oss << " ";
-				}
-				oss << A()(r,c);
-			}
-		}
-		oss << "]";
-
-		return oss.str();
-	}
-
-
 	private: static ::std::string find_matlab_command()
 	{
 		const ::std::string cmd_name("matlab");
@@ -1291,622 +1370,114 @@ DCS_DEBUG_TRACE("New e["<< i << "](k): " << (y()(i)-y_hat(i)));//XXX
 	}
 
 
-	private: template <typename ArgsT>
-		static void run_matlab(::std::string const& cmd, ArgsT const& args, vector_type& th, real_type& yh, matrix_type& P, vector_type& phi)
+	/// Return the default command line of the system identification worker.
+	private: static ::std::vector< ::std::string > default_worker_command()
 	{
-		int pipefd[2];
-
-		// Create a pipe to let to communicate with MATLAB.
-		// Specifically, we want to read the output from MATLAB.
-		// So, the parent process read from the pipe, while the child process
-		// write on it.
-		if (::pipe(pipefd) == -1)
-		{
-			char const* err_str = ::strerror(errno);
-			::std::ostringstream oss;
-			oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::run_matlab] pipe(2) failed: "
-				<< ::std::string(err_str);
-			throw ::std::runtime_error(oss.str());
-		}
+		::std::vector< ::std::string > cmd;
 
-		// Install signal handlers
-		struct ::sigaction sig_act;
-		struct ::sigaction old_sigterm_act;
-		struct ::sigaction old_sigint_act;
-		//::memset(&sig_act, 0, sizeof(sig_act));
-		::sigemptyset(&sig_act.sa_mask);
-		sig_act.sa_flags = 0;
-		sig_act.sa_handler = self_type::process_signals;
-		::sigaction(SIGTERM, &sig_act, &old_sigterm_act);
-		::sigaction(SIGINT, &sig_act, &old_sigint_act);
+		cmd.push_back(find_matlab_command());
+		cmd.push_back("-nodisplay");
+		cmd.push_back("-nojvm");
+		cmd.push_back("-r");
+		cmd.push_back("dcs_des_cloud_sysid_worker");
 
-		// Spawn a new process
+		return cmd;
+	}
 
-		// Between fork() and execve() only async-signal-safe functions
-		// must be called if multithreaded applications should be supported.
-		// That's why the following code is executed before fork() is called.
 
-		::pid_t pid = ::fork();
+	/// The memory for the control output.
+	private: size_type n_a_;
+	/// The memory for the control input.
+	private: size_type n_b_;
+	/// Input delay (dead time).
+	private: size_type d_;
+	/// The size of the control output vector.
+	private: size_type n_y_;
+	/// The size of the augmented control input vector.
+	private: size_type n_u_;
+	/// Forgetting factor.
+	private: real_type ff_;
+	/// Matrix of system parameters estimated by RLS: [A_1 ... A_{n_a} B_1 ... B_{n_b}].
+	private: ::std::vector<vector_type> theta_hats_;
+	/// The covariance matrix.
+	private: ::std::vector<matrix_type> Ps_;
+	/// The regression vector.
+	private: ::std::vector<vector_type> phis_;
+	/// Initialization flags.
+	private: ::std::vector<bool> initialized_;
+	/// The system identification worker (shared among copies of this proxy).
+	private: ::dcs::shared_ptr<sysid_worker::client> ptr_worker_;
+}; // rls_ff_miso_matlab_app_proxy
 
-		// check: pid == -1 --> error
-		if (pid == -1)
-		{
-			char const* err_str = ::strerror(errno);
-			::std::ostringstream oss;
-			oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::run_matlab] fork(2) failed: "
-				<< ::std::string(err_str);
-			throw ::std::runtime_error(oss.str());
-		}
 
-		if (pid == 0)
-		{
-			// The child
+# elif defined(DCS_DES_CLOUD_USE_MATLAB_APP_RPEM)
 
-			// Cancel signal handler set for parent
-			sig_act.sa_handler = SIG_DFL;
-			::sigaction(SIGTERM, &sig_act, 0);
-			::sigaction(SIGINT, &sig_act, 0);
 
-			// Get the maximum number of files this process is allowed to open
-#if defined(F_MAXFD)
-    		int maxdescs = ::fcntl(-1, F_MAXFD, 0);
-    		if (maxdescs == -1)
-			{
-#if defined(_SC_OPEN_MAX)
-        		maxdescs = ::sysconf(_SC_OPEN_MAX);
-#else
-				::rlimit limit;
-				if (::getrlimit(RLIMIT_NOFILE, &limit) < 0)
-				{
-					char const* err_str = ::strerror(errno);
-					::std::ostringstream oss;
-					oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::run_matlab] getrlimit(2) failed: "
-						<< ::std::string(err_str);
-					throw ::std::runtime_error(oss.str());
-				}
-				maxdescs = limit.rlim_cur;
-#endif // _SC_OPEN_MAX
-			}
-#else // F_MAXFD
-#if defined(_SC_OPEN_MAX)
-    		int maxdescs = ::sysconf(_SC_OPEN_MAX);
-#else // _SC_OPEN_MAX
-			::rlimit limit;
-			if (::getrlimit(RLIMIT_NOFILE, &limit) < 0)
-			{
-				char const* err_str = ::strerror(errno);
-				::std::ostringstream oss;
-				oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::run_matlab] getrlimit(2) failed: "
-					<< ::std::string(err_str);
-				throw ::std::runtime_error(oss.str());
-			}
-			maxdescs = limit.rlim_cur;
-#endif // _SC_OPEN_MAX
-#endif // F_MAXFD
-			if (maxdescs == -1)
-			{
-				maxdescs = 1024;
-			}
+/**
+ * \brief Proxy to identify a MIMO system model by applying the recursive
+ *  Prediction-Error Minimization (PEM) with forgetting factor algorithm to
+ *  several MISO system models.
+ *
+ * MATLAB implementation version.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename TraitsT>
+class rpem_ff_miso_matlab_app_proxy
+{
+	private: typedef rpem_ff_miso_matlab_app_proxy self_type;
+	public: typedef TraitsT traits_type;
+	public: typedef typename traits_type::real_type real_type;
+	public: typedef ::boost::numeric::ublas::matrix<real_type> matrix_type;
+	public: typedef ::boost::numeric::ublas::vector<real_type> vector_type;
+	public: typedef ::std::size_t size_type;
 
-			::std::vector<bool> close_fd(maxdescs, true);
 
-			// Associate the child's stdout to the pipe write fd.
-			close_fd[STDOUT_FILENO] = false;
-			if (pipefd[1] != STDOUT_FILENO)
-			{
-				if (::dup2(pipefd[1], STDOUT_FILENO) != STDOUT_FILENO)
-				{
-					char const* err_str = ::strerror(errno);
-					::std::ostringstream oss;
-					oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::run_matlab] dup2(2) failed: "
-						<< ::std::string(err_str);
-					throw ::std::runtime_error(oss.str());
-				}
-			}
-			else
-			{
-				close_fd[pipefd[1]] = false;
-			}
-//			::close(STDOUT_FILENO);
-//			::dup(pipefd[1]);
-
-			// Check if the command already has path information
-			::std::string cmd_path;
-			::std::string cmd_name;
-			typename ::std::string::size_type pos;
-			pos = cmd.find_last_of('/');
-			if (pos != ::std::string::npos)
-			{
-				cmd_path = cmd.substr(0, pos);
-				cmd_name = cmd.substr(pos+1);
-			}
+	public: rpem_ff_miso_matlab_app_proxy()
+	: n_a_(0),
+	  n_b_(0),
+	  n_c_(0),
+	  d_(0),
+	  n_y_(0),
+	  n_u_(0),
+	  ff_(0)
+	{
+//		init_matlab();
+	}
 
-			//FIXME: use scoped_ptr in place of "new"
 
-			::std::size_t nargs = args.size()+1;
-			char** argv = new char*[nargs + 2];
-			argv[0] = new char[cmd_name.size()+1];
-			::std::strncpy(argv[0], cmd_name.c_str(), cmd_name.size()+1); // by convention, the first argument is always the command name
-			typename ArgsT::size_type i(1);
-			typename ArgsT::const_iterator end_it(args.end());
-			for (typename ArgsT::const_iterator it = args.begin(); it != end_it; ++it)
-			{
-				argv[i] = new char[it->size()+1];
-				::std::strncpy(argv[i], it->c_str(), it->size()+1);
-				++i;
-			}
-			argv[nargs] = 0;
+	public: rpem_ff_miso_matlab_app_proxy(size_type n_a, size_type n_b, size_type n_c, size_type d, size_type n_y, size_type n_u, real_type ff)
+	: n_a_(n_a),
+	  n_b_(n_b),
+	  n_c_(n_c),
+	  d_(d),
+	  n_y_(n_y),
+	  n_u_(n_u),
+	  ff_(ff),
+	  theta_hats_(n_y_),
+	  Ps_(n_y_),
+	  phis_(n_y_),
+	  psis_(n_y_)
+	{
+	}
 
-			//char** envp(0);
 
-			// Close unused file descriptors
-#ifdef DCS_DEBUG
-			// Keep standard error open for debug
-			close_fd[STDERR_FILENO] = false;
-#endif // DCS_DEBUG
-			for (int fd = 0; fd < maxdescs; ++fd)
-			{
-				if (close_fd[fd])
-				{
-					::close(fd);
-				}
-			}
+	public: size_type noise_order() const
+	{
+		return n_c_;
+	}
 
-//[XXX]
-#ifdef DCS_DEBUG
-::std::cerr << "Executing MATLAB: " << cmd;//XXX
-for (::std::size_t i=0; i < args.size(); ++i)//XXX
-{//XXX
-::std::cerr << " " << args[i] << ::std::flush;//XXX
-}//XXX
-::std::cerr << ::std::endl;//XXX
-#endif // DCS_DEBUG
-//[/XXX]
-//DCS_DEBUG_TRACE("Executing: " << cmd << " " << args[0] << " " << args[1] << " " << args[2] << " - " << args[3]);
 
-			//::execve(cmd.c_str(), argv, envp);
-			::execvp(cmd.c_str(), argv);
+	public: size_type input_order() const
+	{
+		return n_b_;
+	}
 
-			// Actually we should delete argv and envp data. As we must not
-			// call any non-async-signal-safe functions though we simply exit.
-			::write(STDERR_FILENO, "execvp() failed\n", 17);
-			//_exit(EXIT_FAILURE);
-			_exit(127);
-		}
 
-		// The parent
-
-//		// Associate the parent's stdin to the pipe read fd.
-		::close(pipefd[1]);
-//		::close(STDIN_FILENO);
-//		::dup(pipefd[0]);
-		if (pipefd[0] != STDIN_FILENO)
-		{
-			if (::dup2(pipefd[0], STDIN_FILENO) != STDIN_FILENO)
-			{
-				char const* err_str = ::strerror(errno);
-				::std::ostringstream oss;
-				oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::run_matlab] dup2(2) failed: "
-					<< ::std::string(err_str);
-				throw ::std::runtime_error(oss.str());
-			}
-			::close(pipefd[0]);
-		}
-
-		typedef ::boost::iostreams::file_descriptor_source fd_device_type;
-		typedef ::boost::iostreams::stream_buffer<fd_device_type> fd_streambuf_type;
-		//fd_device_type fd_src(pipefd[0], ::boost::iostreams::close_handle);
-		fd_device_type fd_src(STDIN_FILENO, ::boost::iostreams::close_handle);
-		fd_streambuf_type fd_buf(fd_src);
-		::std::istream is(&fd_buf);
-
-		// Read from the stdin
-DCS_DEBUG_TRACE("BEGIN parsing MATLAB output");//XXX
-		bool parse_line(false);
-		while (is.good())
-		{
-			::std::string line;
-			::std::getline(is, line);
-DCS_DEBUG_TRACE("Read from MATLAB --> " << line);//XXX
-
-			if (parse_line)
-			{
-				if (line.find("[/des/cloud]") != ::std::string::npos)
-				{
-					// The end of parsable lines
-					parse_line = false;
-				}
-				else
-				{
-					typename ::std::string::size_type pos;
-					if ((pos = line.find("th=")) != ::std::string::npos)
-					{
-						parse_matlab_data(line.substr(pos+3), th);
-DCS_DEBUG_TRACE("Parsed as th=" << th);//XXX
-					}
-					else if ((pos = line.find("yh=")) != ::std::string::npos)
-					{
-						parse_matlab_data(line.substr(pos+3), yh);
-DCS_DEBUG_TRACE("Parsed as yh=" << yh);//XXX
-					}
-					else if ((pos = line.find("P=")) != ::std::string::npos)
-					{
-						parse_matlab_data(line.substr(pos+2), P);
-DCS_DEBUG_TRACE("Parsed as P=" << P);//XXX
-					}
-					else if ((pos = line.find("phi=")) != ::std::string::npos)
-					{
-						parse_matlab_data(line.substr(pos+4), phi);
-DCS_DEBUG_TRACE("Parsed as phi=" << phi);//XXX
-
-						// Actually the RARX function of the current System
-						// Identification Toolbox (MATLAB 2010b) returns a
-						// \phi vector with one additional and useless entry
-						// placed at the end of the vector.
-						// Remove it.
-
-						//TODO: check for current MATLAB version and issue a
-						//      warning if the versio is newer than 2010b.
-
-						phi = ::boost::numeric::ublas::subrange(phi, 0, ::boost::numeric::ublasx::size(phi)-1);
-					}
-				}
-			}
-			else
-			{
-				if (line.find("[dcs::des::cloud]") != ::std::string::npos)
-				{
-					// The beginning of parsable lines
-					parse_line = true;
-				}
-			}
-		}
-DCS_DEBUG_TRACE("END parsing MATLAB output");//XXX
-DCS_DEBUG_TRACE("IS state: " << is.good() << " - " << is.eof() << " - " << is.fail() << " - " << is.bad());//XXX
-
-		// Wait the child termination (in order to prevent zombies)
-		int status;
-//		::pid_t wait_pid;
-//		wait_pid = ::wait(&status);
-//		if (wait_pid != pid)
-//		{
-//			throw ::std::runtime_error("[dcs::des::cloud::detail::rls_miso_matlab_app_proxy::run_matlab] Unexpected child process.");
-//		}
-		if (::waitpid(pid, &status, 0) == -1)
-		{
-			char const* err_str = ::strerror(errno);
-			::std::ostringstream oss;
-			oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::run_matlab] waitpid(2) failed: "
-				<< ::std::string(err_str);
-			throw ::std::runtime_error(oss.str());
-		}
-DCS_DEBUG_TRACE("MATLAB exited");//XXX
-		if (WIFEXITED(status))
-		{
-DCS_DEBUG_TRACE("MATLAB exited with a call to 'exit(" << WEXITSTATUS(status) << ")'");//XXX
-			if (WEXITSTATUS(status))
-			{
-				// status != 0 --> error in the execution
-				::std::clog << "[Warning] MATLAB command exited with status " << WEXITSTATUS(status) << ::std::endl;
-			}
-		}
-		else if (WIFSIGNALED(status))
-		{
-DCS_DEBUG_TRACE("MATLAB exited with a call to 'kill(" << WTERMSIG(status) << ")'");//XXX
-		   ::std::clog << "[Warning] MATLAB command received signal " << WTERMSIG(status) << ::std::endl;
-		}
-		else
-		{
-DCS_DEBUG_TRACE("MATLAB exited with an unexpected way");//XXX
-		}
-
-		// Restore signal handler
-		::sigaction(SIGTERM, &old_sigterm_act, 0);
-		::sigaction(SIGINT, &old_sigint_act, 0);
-	}
-
-
-	private: template <typename T>
-		static void parse_matlab_data(::std::string const& text, T& x)
-	{
-		::std::istringstream iss(text);
-		while (iss.good())
-		{
-			char ch(iss.peek());
-
-			if (::std::isspace(ch))
-			{
-				// Skip space
-				iss.get();
-			}
-			else if (::std::isdigit(ch) || ch == '+' || ch == '-' || ch == '.')
-			{
-				// Found the beginning of a number
-
-				iss >> x;
-			}
-			else
-			{
-				throw ::std::runtime_error("[dcs::des::cloud::detail::rls_miso_matlab_app_proxy] Unable to parse a MATLAB number");
-			}
-		}
-	}
-
-
-	private: template <typename T>
-		static void parse_matlab_data(::std::string const& text, ::boost::numeric::ublas::vector<T>& v)
-	{
-		typename ::boost::numeric::ublas::vector<T>::size_type n(0);
-
-		::std::istringstream iss(text);
-		bool inside(false);
-		bool done(false);
-		while (iss.good() && !done)
-		{
-			char ch(iss.peek());
-			bool ko(false);
-
-			if (inside)
-			{
-				if (::std::isspace(ch) || ch == ';')
-				{
-					// Found an element separator
-					iss.get();
-//					while (iss.good() && (ch = iss.peek()) && ::std::isspace(ch))
-//					{
-//						iss.get();
-//					}
-				}
-				else if (ch == ']')
-				{
-					// Found the end of the vector
-//					iss.get();
-//					inside = false;
-					done = true;
-				}
-				else if (::std::isdigit(ch) || ch == '+' || ch == '-' || ch == '.')
-				{
-					// Found the beginning of a number
-					T x;
-					iss >> x;
-					v.resize(n+1, true);
-					v(n) = x;
-					++n;
-				}
-				else
-				{
-					ko = true;
-				}
-			}
-			else
-			{
-				if (ch == '[')
-				{
-					iss.get();
-					v.resize(0, false);
-					inside = true;
-				}
-				else if (::std::isspace(ch))
-				{
-					iss.get();
-				}
-				else
-				{
-					ko = true;
-				}
-			}
-
-			if (ko)
-			{
-				throw ::std::runtime_error("[dcs::des::cloud::detail::rls_miso_matlab_app_proxy] Unable to parse a MATLAB vector.");
-			}
-		}
-	}
-
-
-	private: template <typename T>
-		static void parse_matlab_data(::std::string const& text, ::boost::numeric::ublas::matrix<T>& A)
-	{
-		typename ::boost::numeric::ublas::matrix<T>::size_type r(0);
-		typename ::boost::numeric::ublas::matrix<T>::size_type c(0);
-		typename ::boost::numeric::ublas::matrix<T>::size_type nc(0);
-
-		::std::istringstream iss(text);
-		bool inside(false);
-		bool done(false);
-		while (iss.good() && !done)
-		{
-			char ch(iss.peek());
-			bool ko(false);
-
-			if (inside)
-			{
-				if (::std::isspace(ch))
-				{
-					// Found a column separator
-					iss.get();
-//					while (iss.good() && (ch = iss.peek()) && ::std::isspace(ch))
-//					{
-//						iss.get();
-//					}
-				}
- 				else if (ch == ';')
-				{
-					// Found a row separator
-					iss.get();
-					++r;
-					c = 0;
-				}
-				else if (ch == ']')
-				{
-					// Found the end of the matrix
-//					iss.get();
-//					inside = false;
-					done = true;
-				}
-				else if (::std::isdigit(ch) || ch == '+' || ch == '-' || ch == '.')
-				{
-					// Found the beginning of a number
-					T x;
-					iss >> x;
-					if (nc <= c)
-					{
-						nc = c+1;
-					}
-					A.resize(r+1, nc, true);
-					A(r,c) = x;
-					++c;
-				}
-				else
-				{
-					ko = true;
-				}
-			}
-			else
-			{
-				// Note: outside of a matrix, only two types of character are
-				// allowed: spaces and '['
-
-				if (ch == '[')
-				{
-					iss.get();
-					A.resize(0, 0, false);
-					inside = true;
-				}
-				else if (::std::isspace(ch))
-				{
-					iss.get();
-				}
-				else
-				{
-					ko = true;
-				}
-			}
-
-			if (ko)
-			{
-				throw ::std::runtime_error("[dcs::des::cloud::detail::rls_miso_matlab_app_proxy] Unable to parse a MATLAB matrix.");
-			}
-		}
-	}
-
-
-	private: static void process_signals(int signum)
-	{
-		::std::cerr << "Caught signal " << signum << ::std::endl;
-
-		if (signum != SIGTERM && signum != SIGINT)
-		{
-			::std::clog << "[Warning] Caught the unhandled signal " << signum << ::std::endl;
-		}
-
-		// Terminate all child processes.
-		// Specifically, kill every process in the process group of the calling
-		// process
-		if (::kill(0, SIGKILL) == -1)
-		{
-			char const* err_str = ::strerror(errno);
-			::std::ostringstream oss;
-			oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::process_signals] kill(2) failed: "
-				<< ::std::string(err_str);
-			throw ::std::runtime_error(oss.str());
-		}
-		::std::abort();
-	}
-
-
-	/// The memory for the control output.
-	private: size_type n_a_;
-	/// The memory for the control input.
-	private: size_type n_b_;
-	/// Input delay (dead time).
-	private: size_type d_;
-	/// The size of the control output vector.
-	private: size_type n_y_;
-	/// The size of the augmented control input vector.
-	private: size_type n_u_;
-	/// Forgetting factor.
-	private: real_type ff_;
-	/// Matrix of system parameters estimated by RLS: [A_1 ... A_{n_a} B_1 ... B_{n_b}].
-	private: ::std::vector<vector_type> theta_hats_;
-	/// The covariance matrix.
-	private: ::std::vector<matrix_type> Ps_;
-	/// The regression vector.
-	private: ::std::vector<vector_type> phis_;
-	/// Initialization flags.
-	private: ::std::vector<bool> initialized_;
-	private: ::std::string matlab_cmd_;
-}; // rls_ff_miso_matlab_app_proxy
-
-
-# elif defined(DCS_DES_CLOUD_USE_MATLAB_APP_RPEM)
-
-
-/**
- * \brief Proxy to identify a MIMO system model by applying the recursive
- *  Prediction-Error Minimization (PEM) with forgetting factor algorithm to
- *  several MISO system models.
- *
- * MATLAB implementation version.
- *
- * \author Marco Guazzone (marco.guazzone@gmail.com)
- */
-template <typename TraitsT>
-class rpem_ff_miso_matlab_app_proxy
-{
-	private: typedef rpem_ff_miso_matlab_app_proxy self_type;
-	public: typedef TraitsT traits_type;
-	public: typedef typename traits_type::real_type real_type;
-	public: typedef ::boost::numeric::ublas::matrix<real_type> matrix_type;
-	public: typedef ::boost::numeric::ublas::vector<real_type> vector_type;
-	public: typedef ::std::size_t size_type;
-
-
-	public: rpem_ff_miso_matlab_app_proxy()
-	: n_a_(0),
-	  n_b_(0),
-	  n_c_(0),
-	  d_(0),
-	  n_y_(0),
-	  n_u_(0),
-	  ff_(0)
-	{
-//		init_matlab();
-	}
-
-
-	public: rpem_ff_miso_matlab_app_proxy(size_type n_a, size_type n_b, size_type n_c, size_type d, size_type n_y, size_type n_u, real_type ff)
-	: n_a_(n_a),
-	  n_b_(n_b),
-	  n_c_(n_c),
-	  d_(d),
-	  n_y_(n_y),
-	  n_u_(n_u),
-	  ff_(ff),
-	  theta_hats_(n_y_),
-	  Ps_(n_y_),
-	  phis_(n_y_),
-	  psis_(n_y_)
-	{
-	}
-
-
-	public: size_type noise_order() const
-	{
-		return n_c_;
-	}
-
-
-	public: size_type input_order() const
-	{
-		return n_b_;
-	}
-
-
-	public: size_type output_order() const
-	{
-		return n_a_;
-	}
+	public: size_type output_order() const
+	{
+		return n_a_;
+	}
 
 
 	public: size_type input_delay() const
@@ -2019,7 +1590,11 @@ class rpem_ff_miso_matlab_app_proxy
 			initialized_[i] = false;
 		}
 
-		matlab_cmd_ = find_matlab_command();
+		// Start the worker once: it stays alive across estimation steps
+		if (!ptr_worker_)
+		{
+			ptr_worker_ = ::dcs::make_shared<sysid_worker::client>(sysid_worker::worker_command(default_worker_command()));
+		}
 	}
 
 
@@ -2064,40 +1639,36 @@ class rpem_ff_miso_matlab_app_proxy
 			// Partially per-iteration input params
 			z(0) = y()(i);
 
-			// Prepare MATLAB command
-			::std::vector< ::std::string > args;
-			args.push_back("-nodisplay");
-			args.push_back("-nojvm");
-//			args.push_back("-r");
-			::std::ostringstream oss;
-			oss << "-r \"[th,yh,P,phi,psi]=rpem("
-				<< matlab_form(z, false)
-				<< "," << matlab_form(nn, false)
-				<< ",'ff'," << ff_;
+			// Prepare the request
+			sysid_worker::message req(sysid_worker::rpem_opcode);
+			req.args.push_back(sysid_worker::make_matrix(z, false));
+			req.args.push_back(sysid_worker::make_matrix(nn));
+			req.args.push_back(sysid_worker::make_matrix(static_cast<sysid_worker::value_type>(ff_)));
 			if (initialized_[i])
 			{
-				oss << "," << matlab_form(theta_hats_[i], true) //<< "'" // We must pass the transpose of theta_hat
-					<< "," << matlab_form(Ps_[i])
-					<< "," << matlab_form(phis_[i], true)
-					<< "," << matlab_form(psis_[i], true);
+				req.args.push_back(sysid_worker::make_matrix(theta_hats_[i]));
+				req.args.push_back(sysid_worker::make_matrix(Ps_[i]));
+				req.args.push_back(sysid_worker::make_matrix(phis_[i]));
+				req.args.push_back(sysid_worker::make_matrix(psis_[i]));
 			}
 			else
 			{
 				initialized_[i] = true;
 			}
-			oss << "); format long;"
-				<< " disp('--- [dcs::des::cloud] ---');"
-				<< " disp(['th=', mat2str(th), ]);"
-				<< " disp(['yh=', num2str(yh), ]);"
-				<< " disp(['P=', mat2str(P), ]);"
-				<< " disp(['phi=', mat2str(phi), ]);"
-				<< " disp(['psi=', mat2str(psi), ]);"
-				<< " disp('--- [/des/cloud] ---');"
-				<< " quit force\"";
-			args.push_back(oss.str());
-
-			// Run MATLAB and retrieve its results
-			run_matlab(matlab_cmd_, args, theta_hats_[i], y_hat(i), Ps_[i], phis_[i], psis_[i]);
+
+			// Send the request to the worker and retrieve its results
+			sysid_worker::message rep(ptr_worker_->call(req));
+
+			DCS_ASSERT(
+					rep.args.size() == 5,
+					throw ::std::runtime_error("[dcs::des::cloud::detail::rpem_ff_miso_matlab_app_proxy::estimate] Wrong number of results from the system identification worker.")
+				);
+
+			sysid_worker::copy_matrix(rep.args[0], theta_hats_[i]);
+			sysid_worker::copy_matrix(rep.args[1], y_hat(i));
+			sysid_worker::copy_matrix(rep.args[2], Ps_[i]);
+			sysid_worker::copy_matrix(rep.args[3], phis_[i]);
+			sysid_worker::copy_matrix(rep.args[4], psis_[i]);
 
 DCS_DEBUG_TRACE("New theta_hat["<< i << "](k): " << theta_hats_[i]);//XXX
 DCS_DEBUG_TRACE("New P["<< i << "](k): " << Ps_[i]);//XXX
@@ -2150,737 +1721,148 @@ DCS_DEBUG_TRACE("New e["<< i << "](k): " << (y()(i)-y_hat(i)));//XXX
 		// Remember, for each output i=1,...,n_y:
 		//   \hat{\theta}_i = [a_{ii}^{1};
 		//                     ...;
-		//                     a_{ii}^{n_a};
-		//                     b_{i1}^{1};
-		//                     ...;
-		//                     b_{i1}^{n_b};
-		//                     ...;
-		//                     b_{in_u}^{1};
-		//                     ...;
-		//                     b_{in_u}^{n_b}]
-		// So in \hat{\theta}_i the ith row of matrix B_k stays at:
-		//   B_k(i,:) <- (\hat{\theta}_i(((n_a+k):n_b:n_u))^T
-		matrix_type B_k(n_y_, n_u_);
-		for (size_type i = 0; i < n_y_; ++i)
-		{
-			ublas::row(B_k, i) = ublas::subslice(theta_hats_[i], n_a_+k-1, n_b_, n_u_);
-		}
-
-		return B_k;
-	}
-
-
-	/// Return matrix C_k from \hat{\Theta}.
-	public: matrix_type C(size_type k) const
-	{
-		namespace ublas = ::boost::numeric::ublas;
-
-		DCS_DEBUG_ASSERT( k >= 1 && k <= n_c_ );
-
-		// Remember, for each output i=1,...,n_y:
-		//   \hat{\theta}_i = [a_{ii}^{1};
-		//                     ...;
-		//                     a_{ii}^{n_a};
-		//                     b_{i1}^{1};
-		//                     ...;
-		//                     b_{i1}^{n_b};
-		//                     ...;
-		//                     b_{in_u}^{1};
-		//                     ...;
-		//                     b_{in_u}^{n_b};
-		//                     c_{i1}^{1};
-		//                     ...;
-		//                     c_{i1}^{n_c};
-		//                     ...;
-		//                     c_{in_y}^{1};
-		//                     ...;
-		//                     c_{in_y}^{n_c}]
-		// So in \hat{\theta}_i the ith row of matrix C_k stays at:
-		//   C_k(i,:) <- (\hat{\theta}_i(((n_a+k):n_b:n_u))^T
-		matrix_type C_k(n_y_, n_y_);
-		for (size_type i = 0; i < n_y_; ++i)
-		{
-			ublas::row(C_k, i) = ublas::subslice(theta_hats_[i], n_a_+n_b_*n_u_+k-1, n_c_, n_y_);
-		}
-
-		return C_k;
-	}
-
-
-	private: template <typename ValueT>
-		static ::std::string matlab_form(::std::vector<ValueT> const& v, bool column = true)
-	{
-		size_type n(v.size());
-		::std::ostringstream oss;
-		oss << "[";
-		for (size_type i = 0; i < n; ++i)
-		{
-			if (i > 0)
-			{
-				if (column)
-				{
-					oss << ";";
-				}
-				else
-				{
-					oss << " ";
-				}
-			}
-			oss << v[i];
-		}
-		oss << "]";
-
-		return oss.str();
-	}
-
-
-	private: template <typename VectorExprT>
-		static ::std::string matlab_form(::boost::numeric::ublas::vector_expression<VectorExprT> const& v, bool column = true)
-	{
-		namespace ublasx = ::boost::numeric::ublasx;
-
-		size_type n(ublasx::size(v));
-		::std::ostringstream oss;
-		oss << "[";
-		for (size_type i = 0; i < n; ++i)
-		{
-			if (i > 0)
-			{
-				if (column)
-				{
-					oss << ";";
-				}
-				else
-				{
-					oss << " ";
-				}
-			}
-			oss << v()(i);
-		}
-		oss << "]";
-
-		return oss.str();
-	}
-
-
-	private: template <typename MatrixExprT>
-		static ::std::string matlab_form(::boost::numeric::ublas::matrix_expression<MatrixExprT> const& A)
-	{
-		namespace ublasx = ::boost::numeric::ublasx;
-
-		size_type nr(ublasx::num_rows(A));
-		size_type nc(ublasx::num_columns(A));
-		::std::ostringstream oss;
-		oss << "[";
-		for (size_type r = 0; r < nr; ++r)
-		{
-			if (r > 0)
-			{
-				oss << ";";
-			}
-			for (size_type c = 0; c < nc; ++c)
-			{
-				if (c > 0)
-				{
-					oss << " ";
-				}
-				oss << A()(r,c);
-			}
-		}
-		oss << "]";
-
-		return oss.str();
-	}
-
-
-	private: static ::std::string find_matlab_command()
-	{
-		const ::std::string cmd_name("matlab");
-
-/*XXX: this search is now useless since we use "execvp" in place of "execv".
-		// Get paths from environment
-		char* env_paths(::getenv("PATH"));
-		char* cwd(0);
-		if (!env_paths)
-		{
-			::std::size_t cwd_sz(20);
-			char* buf(0);
-			do
-			{
-				if (buf)
-				{
-					delete[] buf;
-				}
-				buf = new char[cwd_sz];
-				cwd = ::getcwd(buf, cwd_sz);
-			}
-			while (!cwd && errno == ERANGE);
-
-			if (cwd)
-			{
-				env_paths = cwd;
-			}
-			else
-			{
-				// Ooops! Unable to get path info.
-				throw ::std::runtime_error("[dcs::des::cloud::detail::rls_miso_matlab_app_proxy] Unable to get path information.");
-			}
-		}
-
-		::std::string cmd_path;
-		::std::string paths(env_paths);
-		typename ::std::string::size_type pos1(0);
-		typename ::std::string::size_type pos2(0);
-		bool found(false);
-		do
-		{
-			pos2 = paths.find(':', pos1);
-			::std::string dir = (pos2 != ::std::string::npos)
-								? paths.substr(pos1, pos2-pos1)
-								: paths.substr(pos1);
-			cmd_path = ::std::string(dir + "/" + cmd_name);
-			if (::access(cmd_path.c_str(), X_OK))
-			{
-				pos1 = pos2 + 1;
-			}
-			else
-			{
-				found = true;
-			}
-		}
-		while (pos2 != ::std::string::npos && !found);
-
-		if (!found)
-		{
-			throw ::std::runtime_error("[dcs::des::cloud::detail::rls_miso_matlab_app::find_matlab_command] MATLAB not found.");
-		}
-
-		if (cwd)
-		{
-			delete[] cwd;
-		}
-
-		return cmd_path;
-*/
-		return cmd_name;
-	}
-
-
-	private: template <typename ArgsT>
-		static void run_matlab(::std::string const& cmd, ArgsT const& args, vector_type& th, real_type& yh, matrix_type& P, vector_type& phi, vector_type& psi)
-	{
-		int pipefd[2];
-
-		// Create a pipe to let to communicate with MATLAB.
-		// Specifically, we want to read the output from MATLAB.
-		// So, the parent process read from the pipe, while the child process
-		// write on it.
-		if (::pipe(pipefd) == -1)
-		{
-			char const* err_str = ::strerror(errno);
-			::std::ostringstream oss;
-			oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::run_matlab] pipe(2) failed: "
-				<< ::std::string(err_str);
-			throw ::std::runtime_error(oss.str());
-		}
-
-		// Install signal handlers
-		struct ::sigaction sig_act;
-		struct ::sigaction old_sigterm_act;
-		struct ::sigaction old_sigint_act;
-		//::memset(&sig_act, 0, sizeof(sig_act));
-		::sigemptyset(&sig_act.sa_mask);
-		sig_act.sa_flags = 0;
-		sig_act.sa_handler = self_type::process_signals;
-		::sigaction(SIGTERM, &sig_act, &old_sigterm_act);
-		::sigaction(SIGINT, &sig_act, &old_sigint_act);
-
-		// Spawn a new process
-
-		// Between fork() and execve() only async-signal-safe functions
-		// must be called if multithreaded applications should be supported.
-		// That's why the following code is executed before fork() is called.
-
-		::pid_t pid = ::fork();
-
-		// check: pid == -1 --> error
-		if (pid == -1)
-		{
-			char const* err_str = ::strerror(errno);
-			::std::ostringstream oss;
-			oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::run_matlab] fork(2) failed: "
-				<< ::std::string(err_str);
-			throw ::std::runtime_error(oss.str());
-		}
-
-		if (pid == 0)
-		{
-			// The child
-
-			// Cancel signal handler set for parent
-			sig_act.sa_handler = SIG_DFL;
-			::sigaction(SIGTERM, &sig_act, 0);
-			::sigaction(SIGINT, &sig_act, 0);
-
-			// Get the maximum number of files this process is allowed to open
-#if defined(F_MAXFD)
-    		int maxdescs = ::fcntl(-1, F_MAXFD, 0);
-    		if (maxdescs == -1)
-			{
-#if defined(_SC_OPEN_MAX)
-        		maxdescs = ::sysconf(_SC_OPEN_MAX);
-#else
-				::rlimit limit;
-				if (::getrlimit(RLIMIT_NOFILE, &limit) < 0)
-				{
-					char const* err_str = ::strerror(errno);
-					::std::ostringstream oss;
-					oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::run_matlab] getrlimit(2) failed: "
-						<< ::std::string(err_str);
-					throw ::std::runtime_error(oss.str());
-				}
-				maxdescs = limit.rlim_cur;
-#endif // _SC_OPEN_MAX
-			}
-#else // F_MAXFD
-#if defined(_SC_OPEN_MAX)
-    		int maxdescs = ::sysconf(_SC_OPEN_MAX);
-#else // _SC_OPEN_MAX
-			::rlimit limit;
-			if (::getrlimit(RLIMIT_NOFILE, &limit) < 0)
-			{
-				char const* err_str = ::strerror(errno);
-				::std::ostringstream oss;
-				oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::run_matlab] getrlimit(2) failed: "
-					<< ::std::string(err_str);
-				throw ::std::runtime_error(oss.str());
-			}
-			maxdescs = limit.rlim_cur;
-#endif // _SC_OPEN_MAX
-#endif // F_MAXFD
-			if (maxdescs == -1)
-			{
-				maxdescs = 1024;
-			}
-
-			::std::vector<bool> close_fd(maxdescs, true);
-
-			// Associate the child's stdout to the pipe write fd.
-			close_fd[STDOUT_FILENO] = false;
-			if (pipefd[1] != STDOUT_FILENO)
-			{
-				if (::dup2(pipefd[1], STDOUT_FILENO) != STDOUT_FILENO)
-				{
-					char const* err_str = ::strerror(errno);
-					::std::ostringstream oss;
-					oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::run_matlab] dup2(2) failed: "
-						<< ::std::string(err_str);
-					throw ::std::runtime_error(oss.str());
-				}
-			}
-			else
-			{
-				close_fd[pipefd[1]] = false;
-			}
-//			::close(STDOUT_FILENO);
-//			::dup(pipefd[1]);
-
-			// Check if the command already has path information
-			::std::string cmd_path;
-			::std::string cmd_name;
-			typename ::std::string::size_type pos;
-			pos = cmd.find_last_of('/');
-			if (pos != ::std::string::npos)
-			{
-				cmd_path = cmd.substr(0, pos);
-				cmd_name = cmd.substr(pos+1);
-			}
-
-			//FIXME: use scoped_ptr in place of "new"
-
-			::std::size_t nargs = args.size()+1;
-			char** argv = new char*[nargs + 2];
-			argv[0] = new char[cmd_name.size()+1];
-			::std::strncpy(argv[0], cmd_name.c_str(), cmd_name.size()+1); // by convention, the first argument is always the command name
-			typename ArgsT::size_type i(1);
-			typename ArgsT::const_iterator end_it(args.end());
-			for (typename ArgsT::const_iterator it = args.begin(); it != end_it; ++it)
-			{
-				argv[i] = new char[it->size()+1];
-				::std::strncpy(argv[i], it->c_str(), it->size()+1);
-				++i;
-			}
-			argv[nargs] = 0;
-
-			//char** envp(0);
-
-			// Close unused file descriptors
-#ifdef DCS_DEBUG
-			// Keep standard error open for debug
-			close_fd[STDERR_FILENO] = false;
-#endif // DCS_DEBUG
-			for (int fd = 0; fd < maxdescs; ++fd)
-			{
-				if (close_fd[fd])
-				{
-					::close(fd);
-				}
-			}
-
-//[XXX]
-#ifdef DCS_DEBUG
-::std::cerr << "Executing MATLAB: " << cmd;//XXX
-for (::std::size_t i=0; i < args.size(); ++i)//XXX
-{//XXX
-::std::cerr << " " << args[i] << ::std::flush;//XXX
-}//XXX
-::std::cerr << ::std::endl;//XXX
-#endif // DCS_DEBUG
-//[/XXX]
-//DCS_DEBUG_TRACE("Executing: " << cmd << " " << args[0] << " " << args[1] << " " << args[2] << " - " << args[3]);
-
-			//::execve(cmd.c_str(), argv, envp);
-			::execvp(cmd.c_str(), argv);
-
-			// Actually we should delete argv and envp data. As we must not
-			// call any non-async-signal-safe functions though we simply exit.
-			::write(STDERR_FILENO, "execvp() failed\n", 17);
-			//_exit(EXIT_FAILURE);
-			_exit(127);
-		}
-
-		// The parent
-
-//		// Associate the parent's stdin to the pipe read fd.
-		::close(pipefd[1]);
-//		::close(STDIN_FILENO);
-//		::dup(pipefd[0]);
-		if (pipefd[0] != STDIN_FILENO)
-		{
-			if (::dup2(pipefd[0], STDIN_FILENO) != STDIN_FILENO)
-			{
-				char const* err_str = ::strerror(errno);
-				::std::ostringstream oss;
-				oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::run_matlab] dup2(2) failed: "
-					<< ::std::string(err_str);
-				throw ::std::runtime_error(oss.str());
-			}
-			::close(pipefd[0]);
-		}
-
-		typedef ::boost::iostreams::file_descriptor_source fd_device_type;
-		typedef ::boost::iostreams::stream_buffer<fd_device_type> fd_streambuf_type;
-		//fd_device_type fd_src(pipefd[0], ::boost::iostreams::close_handle);
-		fd_device_type fd_src(STDIN_FILENO, ::boost::iostreams::close_handle);
-		fd_streambuf_type fd_buf(fd_src);
-		::std::istream is(&fd_buf);
-
-		// Read from the stdin
-DCS_DEBUG_TRACE("BEGIN parsing MATLAB output");//XXX
-		bool parse_line(false);
-		while (is.good())
-		{
-			::std::string line;
-			::std::getline(is, line);
-DCS_DEBUG_TRACE("Read from MATLAB --> " << line);//XXX
-
-			if (parse_line)
-			{
-				if (line.find("[/des/cloud]") != ::std::string::npos)
-				{
-					// The end of parsable lines
-					parse_line = false;
-				}
-				else
-				{
-					typename ::std::string::size_type pos;
-					if ((pos = line.find("th=")) != ::std::string::npos)
-					{
-						parse_matlab_data(line.substr(pos+3), th);
-DCS_DEBUG_TRACE("Parsed as th=" << th);//XXX
-					}
-					else if ((pos = line.find("yh=")) != ::std::string::npos)
-					{
-						parse_matlab_data(line.substr(pos+3), yh);
-DCS_DEBUG_TRACE("Parsed as yh=" << yh);//XXX
-					}
-					else if ((pos = line.find("P=")) != ::std::string::npos)
-					{
-						parse_matlab_data(line.substr(pos+2), P);
-DCS_DEBUG_TRACE("Parsed as P=" << P);//XXX
-					}
-					else if ((pos = line.find("phi=")) != ::std::string::npos)
-					{
-						parse_matlab_data(line.substr(pos+4), phi);
-DCS_DEBUG_TRACE("Parsed as phi=" << phi);//XXX
-					}
-					else if ((pos = line.find("psi=")) != ::std::string::npos)
-					{
-						parse_matlab_data(line.substr(pos+4), psi);
-DCS_DEBUG_TRACE("Parsed as psi=" << psi);//XXX
-					}
-				}
-			}
-			else
-			{
-				if (line.find("[dcs::des::cloud]") != ::std::string::npos)
-				{
-					// The beginning of parsable lines
-					parse_line = true;
-				}
-			}
-		}
-DCS_DEBUG_TRACE("END parsing MATLAB output");//XXX
-DCS_DEBUG_TRACE("IS state: " << is.good() << " - " << is.eof() << " - " << is.fail() << " - " << is.bad());//XXX
-
-		// Wait the child termination (in order to prevent zombies)
-		int status;
-//		::pid_t wait_pid;
-//		wait_pid = ::wait(&status);
-//		if (wait_pid != pid)
-//		{
-//			throw ::std::runtime_error("[dcs::des::cloud::detail::rls_miso_matlab_app_proxy::run_matlab] Unexpected child process.");
-//		}
-		if (::waitpid(pid, &status, 0) == -1)
-		{
-			char const* err_str = ::strerror(errno);
-			::std::ostringstream oss;
-			oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::run_matlab] waitpid(2) failed: "
-				<< ::std::string(err_str);
-			throw ::std::runtime_error(oss.str());
-		}
-DCS_DEBUG_TRACE("MATLAB exited");//XXX
-		if (WIFEXITED(status))
-		{
-DCS_DEBUG_TRACE("MATLAB exited with a call to 'exit(" << WEXITSTATUS(status) << ")'");//XXX
-			if (WEXITSTATUS(status))
-			{
-				// status != 0 --> error in the execution
-				::std::clog << "[Warning] MATLAB command exited with status " << WEXITSTATUS(status) << ::std::endl;
-			}
-		}
-		else if (WIFSIGNALED(status))
-		{
-DCS_DEBUG_TRACE("MATLAB exited with a call to 'kill(" << WTERMSIG(status) << ")'");//XXX
-		   ::std::clog << "[Warning] MATLAB command received signal " << WTERMSIG(status) << ::std::endl;
-		}
-		else
+		//                     a_{ii}^{n_a};
+		//                     b_{i1}^{1};
+		//                     ...;
+		//                     b_{i1}^{n_b};
+		//                     ...;
+		//                     b_{in_u}^{1};
+		//                     ...;
+		//                     b_{in_u}^{n_b}]
+		// So in \hat{\theta}_i the ith row of matrix B_k stays at:
+		//   B_k(i,:) <- (\hat{\theta}_i(((n_a+k):n_b:n_u))^T
+		matrix_type B_k(n_y_, n_u_);
+		for (size_type i = 0; i < n_y_; ++i)
 		{
-DCS_DEBUG_TRACE("MATLAB exited with an unexpected way");//XXX
+			ublas::row(B_k, i) = ublas::subslice(theta_hats_[i], n_a_+k-1, n_b_, n_u_);
 		}
 
-		// Restore signal handler
-		::sigaction(SIGTERM, &old_sigterm_act, 0);
-		::sigaction(SIGINT, &old_sigint_act, 0);
+		return B_k;
 	}
 
 
-	private: template <typename T>
-		static void parse_matlab_data(::std::string const& text, T& x)
+	/// Return matrix C_k from \hat{\Theta}.
+	public: matrix_type C(size_type k) const
 	{
-		::std::istringstream iss(text);
-		while (iss.good())
-		{
-			char ch(iss.peek());
+		namespace ublas = ::boost::numeric::ublas;
 
-			if (::std::isspace(ch))
-			{
-				// Skip space
-				iss.get();
-			}
-			else if (::std::isdigit(ch) || ch == '+' || ch == '-' || ch == '.')
-			{
-				// Found the beginning of a number
+		DCS_DEBUG_ASSERT( k >= 1 && k <= n_c_ );
 
-				iss >> x;
-			}
-			else
-			{
-				throw ::std::runtime_error("[dcs::des::cloud::detail::rls_miso_matlab_app_proxy] Unable to parse a MATLAB number");
-			}
+		// Remember, for each output i=1,...,n_y:
+		//   \hat{\theta}_i = [a_{ii}^{1};
+		//                     ...;
+		//                     a_{ii}^{n_a};
+		//                     b_{i1}^{1};
+		//                     ...;
+		//                     b_{i1}^{n_b};
+		//                     ...;
+		//                     b_{in_u}^{1};
+		//                     ...;
+		//                     b_{in_u}^{n_b};
+		//                     c_{i1}^{1};
+		//                     ...;
+		//                     c_{i1}^{n_c};
+		//                     ...;
+		//                     c_{in_y}^{1};
+		//                     ...;
+		//                     c_{in_y}^{n_c}]
+		// So in \hat{\theta}_i the ith row of matrix C_k stays at:
+		//   C_k(i,:) <- (\hat{\theta}_i(((n_a+k):n_b:n_u))^T
+		matrix_type C_k(n_y_, n_y_);
+		for (size_type i = 0; i < n_y_; ++i)
+		{
+			ublas::row(C_k, i) = ublas::subslice(theta_hats_[i], n_a_+n_b_*n_u_+k-1, n_c_, n_y_);
 		}
+
+		return C_k;
 	}
 
 
-	private: template <typename T>
-		static void parse_matlab_data(::std::string const& text, ::boost::numeric::ublas::vector<T>& v)
+	private: static ::std::string find_matlab_command()
 	{
-		typename ::boost::numeric::ublas::vector<T>::size_type n(0);
+		const ::std::string cmd_name("matlab");
 
-		::std::istringstream iss(text);
-		bool inside(false);
-		bool done(false);
-		while (iss.good() && !done)
+/*XXX: this search is now useless since we use "execvp" in place of "execv".
+		// Get paths from environment
+		char* env_paths(::getenv("PATH"));
+		char* cwd(0);
+		if (!env_paths)
 		{
-			char ch(iss.peek());
-			bool ko(false);
-
-			if (inside)
+			::std::size_t cwd_sz(20);
+			char* buf(0);
+			do
 			{
-				if (::std::isspace(ch) || ch == ';')
-				{
-					// Found an element separator
-					iss.get();
-//					while (iss.good() && (ch = iss.peek()) && ::std::isspace(ch))
-//					{
-//						iss.get();
-//					}
-				}
-				else if (ch == ']')
-				{
-					// Found the end of the vector
-//					iss.get();
-//					inside = false;
-					done = true;
-				}
-				else if (::std::isdigit(ch) || ch == '+' || ch == '-' || ch == '.')
-				{
-					// Found the beginning of a number
-					T x;
-					iss >> x;
-					v.resize(n+1, true);
-					v(n) = x;
-					++n;
-				}
-				else
+				if (buf)
 				{
-					ko = true;
+					delete[] buf;
 				}
+				buf = new char[cwd_sz];
+				cwd = ::getcwd(buf, cwd_sz);
 			}
-			else
+			while (!cwd && errno == ERANGE);
+
+			if (cwd)
 			{
-				if (ch == '[')
-				{
-					iss.get();
-					v.resize(0, false);
-					inside = true;
-				}
-				else if (::std::isspace(ch))
-				{
-					iss.get();
-				}
-				else
-				{
-					ko = true;
-				}
+				env_paths = cwd;
 			}
-
-			if (ko)
+			else
 			{
-				throw ::std::runtime_error("[dcs::des::cloud::detail::rls_miso_matlab_app_proxy] Unable to parse a MATLAB vector.");
+				// Ooops! Unable to get path info.
+				throw ::std::runtime_error("[dcs::des::cloud::detail::rls_miso_matlab_app_proxy] Unable to get path information.");
 			}
 		}
-	}
-
 
-	private: template <typename T>
-		static void parse_matlab_data(::std::string const& text, ::boost::numeric::ublas::matrix<T>& A)
-	{
-		typename ::boost::numeric::ublas::matrix<T>::size_type r(0);
-		typename ::boost::numeric::ublas::matrix<T>::size_type c(0);
-		typename ::boost::numeric::ublas::matrix<T>::size_type nc(0);
-
-		::std::istringstream iss(text);
-		bool inside(false);
-		bool done(false);
-		while (iss.good() && !done)
+		::std::string cmd_path;
+		::std::string paths(env_paths);
+		typename ::std::string::size_type pos1(0);
+		typename ::std::string::size_type pos2(0);
+		bool found(false);
+		do
 		{
-			char ch(iss.peek());
-			bool ko(false);
-
-			if (inside)
+			pos2 = paths.find(':', pos1);
+			::std::string dir = (pos2 != ::std::string::npos)
+								? paths.substr(pos1, pos2-pos1)
+								: paths.substr(pos1);
+			cmd_path = ::std::string(dir + "/" + cmd_name);
+			if (::access(cmd_path.c_str(), X_OK))
 			{
-				if (::std::isspace(ch))
-				{
-					// Found a column separator
-					iss.get();
-//					while (iss.good() && (ch = iss.peek()) && ::std::isspace(ch))
-//					{
-//						iss.get();
-//					}
-				}
- 				else if (ch == ';')
-				{
-					// Found a row separator
-					iss.get();
-					++r;
-					c = 0;
-				}
-				else if (ch == ']')
-				{
-					// Found the end of the matrix
-//					iss.get();
-//					inside = false;
-					done = true;
-				}
-				else if (::std::isdigit(ch) || ch == '+' || ch == '-' || ch == '.')
-				{
-					// Found the beginning of a number
-					T x;
-					iss >> x;
-					if (nc <= c)
-					{
-						nc = c+1;
-					}
-					A.resize(r+1, nc, true);
-					A(r,c) = x;
-					++c;
-				}
-				else
-				{
-					ko = true;
-				}
+				pos1 = pos2 + 1;
 			}
 			else
 			{
-				// Note: outside of a matrix, only two types of character are
-				// allowed: spaces and '['
-
-				if (ch == '[')
-				{
-					iss.get();
-					A.resize(0, 0, false);
-					inside = true;
-				}
-				else if (::std::isspace(ch))
-				{
-					iss.get();
-				}
-				else
-				{
-					ko = true;
-				}
+				found = true;
 			}
+		}
+		while (pos2 != ::std::string::npos && !found);
 
-			if (ko)
-			{
-				throw ::std::runtime_error("[dcs::des::cloud::detail::rls_miso_matlab_app_proxy] Unable to parse a MATLAB matrix.");
-			}
+		if (!found)
+		{
+			throw ::std::runtime_error("[dcs::des::cloud::detail::rls_miso_matlab_app::find_matlab_command] MATLAB not found.");
+		}
+
+		if (cwd)
+		{
+			delete[] cwd;
 		}
+
+		return cmd_path;
+*/
+		return cmd_name;
 	}
 
 
-	private: static void process_signals(int signum)
+	/// Return the default command line of the system identification worker.
+	private: static ::std::vector< ::std::string > default_worker_command()
 	{
-		::std::cerr << "Caught signal " << signum << ::std::endl;
+		::std::vector< ::std::string > cmd;
 
-		if (signum != SIGTERM && signum != SIGINT)
-		{
-			::std::clog << "[Warning] Caught the unhandled signal " << signum << ::std::endl;
-		}
+		cmd.push_back(find_matlab_command());
+		cmd.push_back("-nodisplay");
+		cmd.push_back("-nojvm");
+		cmd.push_back("-r");
+		cmd.push_back("dcs_des_cloud_sysid_worker");
 
-		// Terminate all child processes.
-		// Specifically, kill every process in the process group of the calling
-		// process
-		if (::kill(0, SIGKILL) == -1)
-		{
-			char const* err_str = ::strerror(errno);
-			::std::ostringstream oss;
-			oss << "[dcs::des::cloud::detail::rls_miso_matlab_app_rpoxy::process_signals] kill(2) failed: "
-				<< ::std::string(err_str);
-			throw ::std::runtime_error(oss.str());
-		}
-		::std::abort();
+		return cmd;
 	}
 
 
@@ -2908,7 +1890,8 @@ DCS_DEBUG_TRACE("MATLAB exited with an unexpected way");//XXX
 	private: ::std::vector<vector_type> psis_;
 	/// Initialization flags.
 	private: ::std::vector<bool> initialized_;
-	private: ::std::string matlab_cmd_;
+	/// The system identification worker (shared among copies of this proxy).
+	private: ::dcs::shared_ptr<sysid_worker::client> ptr_worker_;
 }; // rpem_ff_miso_matlab_app_proxy
 
 
@@ -3030,6 +2013,7 @@ class rls_ff_mimo_proxy: public rls_system_identification_strategy<TraitsT>
 										P_,
 										phi_);
 
+		rcond_tracker_.reset();
 	}
 
 
@@ -3064,7 +2048,7 @@ class rls_ff_mimo_proxy: public rls_system_identification_strategy<TraitsT>
 			real_type check_val = ::std::log10(static_cast<real_type>(2)*::std::numeric_limits<real_type>::epsilon())
 								  + this->condition_number_covariance_heuristic_trusted_digits();
 
-			if (::std::log10(::boost::numeric::ublasx::rcond(P_)) > check_val)
+			if (rcond_tracker_.log_rcond_greater(P_, check_val))
 			{
 				reset = true;
 			}
@@ -3081,6 +2065,7 @@ class rls_ff_mimo_proxy: public rls_system_identification_strategy<TraitsT>
 //DCS_DEBUG_TRACE("Theta_hat(k): " << Theta_hat_);//XXX
 //DCS_DEBUG_TRACE("P(k): " << P_);//XXX
 //DCS_DEBUG_TRACE("phi(k): " << phi_);//XXX
+		const real_type phi_sq_old(::boost::numeric::ublas::inner_prod(phi_, phi_));
 		vector_type y_hat;
 		y_hat = ::dcs::sysid::rls_ff_arx_mimo(y,
 											  u,
@@ -3091,6 +2076,7 @@ class rls_ff_mimo_proxy: public rls_system_identification_strategy<TraitsT>
 											  Theta_hat_,
 											  P_,
 											  phi_);
+		rcond_tracker_.update(phi_sq_old, ::boost::numeric::ublas::inner_prod(phi_, phi_));
 //DCS_DEBUG_TRACE("New Theta_hat(k): " << Theta_hat_);//XXX
 //DCS_DEBUG_TRACE("New P(k): " << P_);//XXX
 //DCS_DEBUG_TRACE("New phi(k): " << phi_);//XXX
@@ -3130,6 +2116,18 @@ class rls_ff_mimo_proxy: public rls_system_identification_strategy<TraitsT>
 	}
 
 
+	/// Store matrix A_k from \hat{\Theta} into \a A_k.
+	private: void do_A(size_type k, matrix_type& A_k) const
+	{
+		namespace ublas = ::boost::numeric::ublas;
+
+		DCS_DEBUG_ASSERT( k >= 1 && k <= this->output_order() );
+
+		A_k.resize(this->num_outputs(), this->num_outputs(), false);
+		ublas::noalias(A_k) = ublas::trans(ublas::subslice(Theta_hat_, k-1, this->output_order(), this->num_outputs(), 0, 1, this->num_outputs()));
+	}
+
+
 	/// Return matrix B_k from \hat{\Theta}.
 	private: matrix_type do_B(size_type k) const
 	{
@@ -3161,6 +2159,18 @@ class rls_ff_mimo_proxy: public rls_system_identification_strategy<TraitsT>
 	}
 
 
+	/// Store matrix B_k from \hat{\Theta} into \a B_k.
+	private: void do_B(size_type k, matrix_type& B_k) const
+	{
+		namespace ublas = ::boost::numeric::ublas;
+
+		DCS_DEBUG_ASSERT( k >= 1 && k <= this->input_order() );
+
+		B_k.resize(this->num_outputs(), this->num_inputs(), false);
+		ublas::noalias(B_k) = ublas::trans(ublas::subslice(Theta_hat_, this->output_order()*this->num_outputs()+k-1, this->input_order(), this->num_inputs(), 0, 1, this->num_outputs()));
+	}
+
+
 	/// Forgetting factor.
 	private: real_type ff_;
 	/// Matrix of system parameters estimated by RLS: [A_1 ... A_{n_a} B_1 ... B_{n_b}].
@@ -3169,6 +2179,8 @@ class rls_ff_mimo_proxy: public rls_system_identification_strategy<TraitsT>
 	private: matrix_type P_;
 	/// The regression vector.
 	private: vector_type phi_;
+	/// Bounds on the conditioning of the covariance matrix.
+	private: rls_covariance_rcond_tracker<real_type> rcond_tracker_;
 }; // rls_ff_mimo_proxy
 
 
@@ -3302,11 +2314,15 @@ class rls_ff_miso_proxy: public rls_system_identification_strategy<TraitsT>
 											Ps_[i],
 											phis_[i]);
 		}
+
+		rcond_trackers_.assign(ny, rls_covariance_rcond_tracker<real_type>());
 	}
 
 
 	private: vector_type do_estimate(vector_type const& y, vector_type const& u)
 	{
+		namespace ublas = ::boost::numeric::ublas;
+
 		const size_type na(this->output_order());
 		const size_type nb(this->input_order());
 		const size_type d(this->input_delay());
@@ -3346,7 +2362,7 @@ class rls_ff_miso_proxy: public rls_system_identification_strategy<TraitsT>
 
 			for (size_type i = 0; i < ny && !reset; ++i)
 			{
-				if (::std::log10(::boost::numeric::ublasx::rcond(Ps_[i])) > check_val)
+				if (rcond_trackers_[i].log_rcond_greater(Ps_[i], check_val))
 				{
 					reset = true;
 				}
@@ -3373,6 +2389,7 @@ DCS_DEBUG_TRACE("phi["<< i << "](k): " << phis_[i]);//XXX
 //::std::cerr << "theta_hat["<< i << "](k): " << theta_hats_[i] << ::std::endl;//XXX
 //::std::cerr << "P["<< i << "](k): " << Ps_[i] << ::std::endl;//XXX
 //::std::cerr << "phi["<< i << "](k): " << phis_[i] << ::std::endl;//XXX
+			const real_type phi_sq_old(ublas::inner_prod(phis_[i], phis_[i]));
 			y_hat(i) = ::dcs::sysid::rls_ff_arx_miso(y(i),
 													 u,
 													 ff_,
@@ -3382,6 +2399,7 @@ DCS_DEBUG_TRACE("phi["<< i << "](k): " << phis_[i]);//XXX
 													 theta_hats_[i],
 													 Ps_[i],
 													 phis_[i]);
+			rcond_trackers_[i].update(phi_sq_old, ublas::inner_prod(phis_[i], phis_[i]));
 DCS_DEBUG_TRACE("New theta_hat["<< i << "](k): " << theta_hats_[i]);//XXX
 DCS_DEBUG_TRACE("New P["<< i << "](k): " << Ps_[i]);//XXX
 DCS_DEBUG_TRACE("New rcond(P["<< i << "](k)): " << ::boost::numeric::ublasx::rcond(Ps_[i]));//XXX
@@ -3405,8 +2423,17 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 	/// Return matrix A_k from \hat{\Theta}.
 	private: matrix_type do_A(size_type k) const
 	{
-		namespace ublas = ::boost::numeric::ublas;
+		matrix_type A_k;
 
+		do_A(k, A_k);
+
+		return A_k;
+	}
+
+
+	/// Store matrix A_k from \hat{\Theta} into \a A_k.
+	private: void do_A(size_type k, matrix_type& A_k) const
+	{
 		DCS_DEBUG_ASSERT( k >= 1 && k <= this->output_order() );
 
 		const size_type ny(this->num_outputs());
@@ -3424,21 +2451,29 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 		//                     b_{in_u}^{n_b}]
 		// So in \hat{\theta}_i the ith diagonal element of matrix A_k stays at:
 		//   A_k(i,i) <- \hat{\theta}_i(k)
-		matrix_type A_k(ny, ny, real_type/*zero*/());
+		A_k.resize(ny, ny, false);
+		A_k.clear();
 		for (size_type i = 0; i < ny; ++i)
 		{
 			A_k(i,i) = theta_hats_[i](k-1);
 		}
-
-		return A_k;
 	}
 
 
 	/// Return matrix B_k from \hat{\Theta}.
 	private: matrix_type do_B(size_type k) const
 	{
-		namespace ublas = ::boost::numeric::ublas;
+		matrix_type B_k;
+
+		do_B(k, B_k);
+
+		return B_k;
+	}
+
 
+	/// Store matrix B_k from \hat{\Theta} into \a B_k.
+	private: void do_B(size_type k, matrix_type& B_k) const
+	{
 		DCS_DEBUG_ASSERT( k >= 1 && k <= this->input_order() );
 
 		const size_type na(this->output_order());
@@ -3459,13 +2494,14 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 		//                     b_{in_u}^{n_b}]
 		// So in \hat{\theta}_i the ith row of matrix B_k stays at:
 		//   B_k(i,:) <- (\hat{\theta}_i(((n_a+k):n_b:n_u))^T
-		matrix_type B_k(ny, nu);
+		B_k.resize(ny, nu, false);
 		for (size_type i = 0; i < ny; ++i)
 		{
-			ublas::row(B_k, i) = ublas::subslice(theta_hats_[i], na+k-1, nb, nu);
+			for (size_type j = 0; j < nu; ++j)
+			{
+				B_k(i,j) = theta_hats_[i](na+k-1+j*nb);
+			}
 		}
-
-		return B_k;
 	}
 
 
@@ -3477,6 +2513,8 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 	private: ::std::vector<matrix_type> Ps_;
 	/// The regression vector.
 	private: ::std::vector<vector_type> phis_;
+	/// Bounds on the conditioning of the covariance matrices.
+	private: ::std::vector< rls_covariance_rcond_tracker<real_type> > rcond_trackers_;
 }; // rls_ff_miso_proxy
 
 
@@ -3636,11 +2674,15 @@ class rls_park1991_miso_proxy: public rls_system_identification_strategy<TraitsT
 											Ps_[i],
 											phis_[i]);
 		}
+
+		rcond_trackers_.assign(ny, rls_covariance_rcond_tracker<real_type>());
 	}
 
 
 	private: vector_type do_estimate(vector_type const& y, vector_type const& u)
 	{
+		namespace ublas = ::boost::numeric::ublas;
+
 		const size_type na(this->output_order());
 		const size_type nb(this->input_order());
 		const size_type d(this->input_delay());
@@ -3680,7 +2722,7 @@ class rls_park1991_miso_proxy: public rls_system_identification_strategy<TraitsT
 
 			for (size_type i = 0; i < ny && !reset; ++i)
 			{
-				if (::std::log10(::boost::numeric::ublasx::rcond(Ps_[i])) > check_val)
+				if (rcond_trackers_[i].log_rcond_greater(Ps_[i], check_val))
 				{
 					reset = true;
 				}
@@ -3707,6 +2749,7 @@ DCS_DEBUG_TRACE("phi["<< i << "](k): " << phis_[i]);//XXX
 //::std::cerr << "theta_hat["<< i << "](k): " << theta_hats_[i] << ::std::endl;//XXX
 //::std::cerr << "P["<< i << "](k): " << Ps_[i] << ::std::endl;//XXX
 //::std::cerr << "phi["<< i << "](k): " << phis_[i] << ::std::endl;//XXX
+			const real_type phi_sq_old(ublas::inner_prod(phis_[i], phis_[i]));
 			y_hat(i) = ::dcs::sysid::rls_park1991_arx_miso(y(i),
 													 u,
 													 ff_,
@@ -3717,6 +2760,7 @@ DCS_DEBUG_TRACE("phi["<< i << "](k): " << phis_[i]);//XXX
 													 theta_hats_[i],
 													 Ps_[i],
 													 phis_[i]);
+			rcond_trackers_[i].update(phi_sq_old, ublas::inner_prod(phis_[i], phis_[i]));
 DCS_DEBUG_TRACE("New theta_hat["<< i << "](k): " << theta_hats_[i]);//XXX
 DCS_DEBUG_TRACE("New P["<< i << "](k): " << Ps_[i]);//XXX
 DCS_DEBUG_TRACE("New rcond(P["<< i << "](k)): " << ::boost::numeric::ublasx::rcond(Ps_[i]));//XXX
@@ -3740,8 +2784,17 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 	/// Return matrix A_k from \hat{\Theta}.
 	private: matrix_type do_A(size_type k) const
 	{
-		namespace ublas = ::boost::numeric::ublas;
+		matrix_type A_k;
+
+		do_A(k, A_k);
 
+		return A_k;
+	}
+
+
+	/// Store matrix A_k from \hat{\Theta} into \a A_k.
+	private: void do_A(size_type k, matrix_type& A_k) const
+	{
 		DCS_DEBUG_ASSERT( k >= 1 && k <= this->output_order() );
 
 		const size_type ny(this->num_outputs());
@@ -3759,21 +2812,29 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 		//                     b_{in_u}^{n_b}]
 		// So in \hat{\theta}_i the ith diagonal element of matrix A_k stays at:
 		//   A_k(i,i) <- \hat{\theta}_i(k)
-		matrix_type A_k(ny, ny, real_type/*zero*/());
+		A_k.resize(ny, ny, false);
+		A_k.clear();
 		for (size_type i = 0; i < ny; ++i)
 		{
 			A_k(i,i) = theta_hats_[i](k-1);
 		}
-
-		return A_k;
 	}
 
 
 	/// Return matrix B_k from \hat{\Theta}.
 	private: matrix_type do_B(size_type k) const
 	{
-		namespace ublas = ::boost::numeric::ublas;
+		matrix_type B_k;
 
+		do_B(k, B_k);
+
+		return B_k;
+	}
+
+
+	/// Store matrix B_k from \hat{\Theta} into \a B_k.
+	private: void do_B(size_type k, matrix_type& B_k) const
+	{
 		DCS_DEBUG_ASSERT( k >= 1 && k <= this->input_order() );
 
 		const size_type na(this->output_order());
@@ -3794,13 +2855,14 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 		//                     b_{in_u}^{n_b}]
 		// So in \hat{\theta}_i the ith row of matrix B_k stays at:
 		//   B_k(i,:) <- (\hat{\theta}_i(((n_a+k):n_b:n_u))^T
-		matrix_type B_k(ny, nu);
+		B_k.resize(ny, nu, false);
 		for (size_type i = 0; i < ny; ++i)
 		{
-			ublas::row(B_k, i) = ublas::subslice(theta_hats_[i], na+k-1, nb, nu);
+			for (size_type j = 0; j < nu; ++j)
+			{
+				B_k(i,j) = theta_hats_[i](na+k-1+j*nb);
+			}
 		}
-
-		return B_k;
 	}
 
 
@@ -3814,6 +2876,8 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 	private: ::std::vector<matrix_type> Ps_;
 	/// The regression vector.
 	private: ::std::vector<vector_type> phis_;
+	/// Bounds on the conditioning of the covariance matrices.
+	private: ::std::vector< rls_covariance_rcond_tracker<real_type> > rcond_trackers_;
 }; // rls_park1991_miso_proxy
 
 
@@ -3947,11 +3011,15 @@ class rls_kulhavy1984_miso_proxy: public rls_system_identification_strategy<Trai
 											Ps_[i],
 											phis_[i]);
 		}
+
+		rcond_trackers_.assign(ny, rls_covariance_rcond_tracker<real_type>());
 	}
 
 
 	private: vector_type do_estimate(vector_type const& y, vector_type const& u)
 	{
+		namespace ublas = ::boost::numeric::ublas;
+
 		const size_type na(this->output_order());
 		const size_type nb(this->input_order());
 		const size_type d(this->input_delay());
@@ -3991,7 +3059,7 @@ class rls_kulhavy1984_miso_proxy: public rls_system_identification_strategy<Trai
 
 			for (size_type i = 0; i < ny && !reset; ++i)
 			{
-				if (::std::log10(::boost::numeric::ublasx::rcond(Ps_[i])) > check_val)
+				if (rcond_trackers_[i].log_rcond_greater(Ps_[i], check_val))
 				{
 					reset = true;
 				}
@@ -4012,6 +3080,7 @@ DCS_DEBUG_TRACE("u(k): " << u);//XXX
 DCS_DEBUG_TRACE("theta_hat["<< i << "](k): " << theta_hats_[i]);//XXX
 DCS_DEBUG_TRACE("P["<< i << "](k): " << Ps_[i]);//XXX
 DCS_DEBUG_TRACE("phi["<< i << "](k): " << phis_[i]);//XXX
+			const real_type phi_sq_old(ublas::inner_prod(phis_[i], phis_[i]));
 			y_hat(i) = ::dcs::sysid::rls_kulhavy1984_arx_miso(y(i),
 													 u,
 													 ff_,
@@ -4021,6 +3090,7 @@ DCS_DEBUG_TRACE("phi["<< i << "](k): " << phis_[i]);//XXX
 													 theta_hats_[i],
 													 Ps_[i],
 													 phis_[i]);
+			rcond_trackers_[i].update(phi_sq_old, ublas::inner_prod(phis_[i], phis_[i]));
 DCS_DEBUG_TRACE("New theta_hat["<< i << "](k): " << theta_hats_[i]);//XXX
 DCS_DEBUG_TRACE("New P["<< i << "](k): " << Ps_[i]);//XXX
 DCS_DEBUG_TRACE("New rcond(P["<< i << "](k)): " << ::boost::numeric::ublasx::rcond(Ps_[i]));//XXX
@@ -4037,8 +3107,17 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 	/// Return matrix A_k from \hat{\Theta}.
 	private: matrix_type do_A(size_type k) const
 	{
-		namespace ublas = ::boost::numeric::ublas;
+		matrix_type A_k;
+
+		do_A(k, A_k);
+
+		return A_k;
+	}
 
+
+	/// Store matrix A_k from \hat{\Theta} into \a A_k.
+	private: void do_A(size_type k, matrix_type& A_k) const
+	{
 		DCS_DEBUG_ASSERT( k >= 1 && k <= this->output_order() );
 
 		const size_type ny(this->num_outputs());
@@ -4056,21 +3135,29 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 		//                     b_{in_u}^{n_b}]
 		// So in \hat{\theta}_i the ith diagonal element of matrix A_k stays at:
 		//   A_k(i,i) <- \hat{\theta}_i(k)
-		matrix_type A_k(ny, ny, real_type/*zero*/());
+		A_k.resize(ny, ny, false);
+		A_k.clear();
 		for (size_type i = 0; i < ny; ++i)
 		{
 			A_k(i,i) = theta_hats_[i](k-1);
 		}
-
-		return A_k;
 	}
 
 
 	/// Return matrix B_k from \hat{\Theta}.
 	private: matrix_type do_B(size_type k) const
 	{
-		namespace ublas = ::boost::numeric::ublas;
+		matrix_type B_k;
+
+		do_B(k, B_k);
 
+		return B_k;
+	}
+
+
+	/// Store matrix B_k from \hat{\Theta} into \a B_k.
+	private: void do_B(size_type k, matrix_type& B_k) const
+	{
 		DCS_DEBUG_ASSERT( k >= 1 && k <= this->input_order() );
 
 		const size_type na(this->output_order());
@@ -4091,13 +3178,14 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 		//                     b_{in_u}^{n_b}]
 		// So in \hat{\theta}_i the ith row of matrix B_k stays at:
 		//   B_k(i,:) <- (\hat{\theta}_i(((n_a+k):n_b:n_u))^T
-		matrix_type B_k(ny, nu);
+		B_k.resize(ny, nu, false);
 		for (size_type i = 0; i < ny; ++i)
 		{
-			ublas::row(B_k, i) = ublas::subslice(theta_hats_[i], na+k-1, nb, nu);
+			for (size_type j = 0; j < nu; ++j)
+			{
+				B_k(i,j) = theta_hats_[i](na+k-1+j*nb);
+			}
 		}
-
-		return B_k;
 	}
 
 
@@ -4109,6 +3197,8 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 	private: ::std::vector<matrix_type> Ps_;
 	/// The regression vector.
 	private: ::std::vector<vector_type> phis_;
+	/// Bounds on the conditioning of the covariance matrices.
+	private: ::std::vector< rls_covariance_rcond_tracker<real_type> > rcond_trackers_;
 }; // rls_kulhavy1984_miso_proxy
 
 
@@ -4251,11 +3341,15 @@ class rls_bittanti1990_miso_proxy: public rls_system_identification_strategy<Tra
 											Ps_[i],
 											phis_[i]);
 		}
+
+		rcond_trackers_.assign(ny, rls_covariance_rcond_tracker<real_type>());
 	}
 
 
 	private: vector_type do_estimate(vector_type const& y, vector_type const& u)
 	{
+		namespace ublas = ::boost::numeric::ublas;
+
 		const size_type na(this->output_order());
 		const size_type nb(this->input_order());
 		const size_type d(this->input_delay());
@@ -4295,7 +3389,7 @@ class rls_bittanti1990_miso_proxy: public rls_system_identification_strategy<Tra
 
 			for (size_type i = 0; i < ny && !reset; ++i)
 			{
-				if (::std::log10(::boost::numeric::ublasx::rcond(Ps_[i])) > check_val)
+				if (rcond_trackers_[i].log_rcond_greater(Ps_[i], check_val))
 				{
 					reset = true;
 				}
@@ -4316,6 +3410,7 @@ DCS_DEBUG_TRACE("u(k): " << u);//XXX
 DCS_DEBUG_TRACE("theta_hat["<< i << "](k): " << theta_hats_[i]);//XXX
 DCS_DEBUG_TRACE("P["<< i << "](k): " << Ps_[i]);//XXX
 DCS_DEBUG_TRACE("phi["<< i << "](k): " << phis_[i]);//XXX
+			const real_type phi_sq_old(ublas::inner_prod(phis_[i], phis_[i]));
 			y_hat(i) = ::dcs::sysid::rls_bittanti1990_arx_miso(y(i),
 															   u,
 															   ff_,
@@ -4326,6 +3421,7 @@ DCS_DEBUG_TRACE("phi["<< i << "](k): " << phis_[i]);//XXX
 															   Ps_[i],
 															   phis_[i],
 															   delta_);
+			rcond_trackers_[i].update(phi_sq_old, ublas::inner_prod(phis_[i], phis_[i]));
 DCS_DEBUG_TRACE("New theta_hat["<< i << "](k): " << theta_hats_[i]);//XXX
 DCS_DEBUG_TRACE("New P["<< i << "](k): " << Ps_[i]);//XXX
 DCS_DEBUG_TRACE("New rcond(P["<< i << "](k)): " << ::boost::numeric::ublasx::rcond(Ps_[i]));//XXX
@@ -4342,8 +3438,17 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 	/// Return matrix A_k from \hat{\Theta}.
 	private: matrix_type do_A(size_type k) const
 	{
-		namespace ublas = ::boost::numeric::ublas;
+		matrix_type A_k;
+
+		do_A(k, A_k);
+
+		return A_k;
+	}
+
 
+	/// Store matrix A_k from \hat{\Theta} into \a A_k.
+	private: void do_A(size_type k, matrix_type& A_k) const
+	{
 		DCS_DEBUG_ASSERT( k >= 1 && k <= this->output_order() );
 
 		const size_type ny(this->num_outputs());
@@ -4361,21 +3466,29 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 		//                     b_{in_u}^{n_b}]
 		// So in \hat{\theta}_i the ith diagonal element of matrix A_k stays at:
 		//   A_k(i,i) <- \hat{\theta}_i(k)
-		matrix_type A_k(ny, ny, real_type/*zero*/());
+		A_k.resize(ny, ny, false);
+		A_k.clear();
 		for (size_type i = 0; i < ny; ++i)
 		{
 			A_k(i,i) = theta_hats_[i](k-1);
 		}
-
-		return A_k;
 	}
 
 
 	/// Return matrix B_k from \hat{\Theta}.
 	private: matrix_type do_B(size_type k) const
 	{
-		namespace ublas = ::boost::numeric::ublas;
+		matrix_type B_k;
+
+		do_B(k, B_k);
+
+		return B_k;
+	}
 
+
+	/// Store matrix B_k from \hat{\Theta} into \a B_k.
+	private: void do_B(size_type k, matrix_type& B_k) const
+	{
 		DCS_DEBUG_ASSERT( k >= 1 && k <= this->input_order() );
 
 		const size_type na(this->output_order());
@@ -4396,13 +3509,14 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 		//                     b_{in_u}^{n_b}]
 		// So in \hat{\theta}_i the ith row of matrix B_k stays at:
 		//   B_k(i,:) <- (\hat{\theta}_i(((n_a+k):n_b:n_u))^T
-		matrix_type B_k(ny, nu);
+		B_k.resize(ny, nu, false);
 		for (size_type i = 0; i < ny; ++i)
 		{
-			ublas::row(B_k, i) = ublas::subslice(theta_hats_[i], na+k-1, nb, nu);
+			for (size_type j = 0; j < nu; ++j)
+			{
+				B_k(i,j) = theta_hats_[i](na+k-1+j*nb);
+			}
 		}
-
-		return B_k;
 	}
 
 
@@ -4416,6 +3530,8 @@ DCS_DEBUG_TRACE("END estimation");//XXX
 	private: ::std::vector<matrix_type> Ps_;
 	/// The regression vector.
 	private: ::std::vector<vector_type> phis_;
+	/// Bounds on the conditioning of the covariance matrices.
+	private: ::std::vector< rls_covariance_rcond_tracker<real_type> > rcond_trackers_;
 }; // rls_bittanti1990_miso_proxy
 
 
@@ -0,0 +1,190 @@
+/**
+ * \file dcs/des/cloud/detail/utilization_profile_integrator.hpp
+ *
+ * \brief Incremental integration of energy and busy time over a utilization
+ *  profile.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_DETAIL_UTILIZATION_PROFILE_INTEGRATOR_HPP
+#define DCS_DES_CLOUD_DETAIL_UTILIZATION_PROFILE_INTEGRATOR_HPP
+
+
+#include <algorithm>
+#include <boost/icl/concept/interval.hpp>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/des/cloud/resource_utilization_profile.hpp>
+#include <stdexcept>
+
+
+namespace dcs { namespace des { namespace cloud { namespace detail {
+
+/**
+ * \brief Integrates energy and busy time of the segments of a utilization
+ *  profile which can no longer change, and drops them from the profile.
+ *
+ * Settled segments are integrated only once the profile has reached a given
+ * number of segments; after each flush, such threshold is set to twice the
+ * number of segments left (and never below the initial one), so that the cost
+ * of finding the settle time and of scanning the profile is amortized over
+ * the segments added meanwhile.
+ *
+ * The power function passed to \c flush and \c integrate must return the
+ * power consumed above the idle level at the given utilization.
+ */
+template <typename TraitsT>
+class utilization_profile_integrator
+{
+	public: typedef TraitsT traits_type;
+	public: typedef typename traits_type::real_type real_type;
+	public: typedef resource_utilization_profile<traits_type> profile_type;
+	public: typedef typename profile_type::size_type size_type;
+
+
+	/// Default minimum number of segments that triggers a flush.
+	public: static const size_type default_min_flush_size;
+
+
+	public: explicit utilization_profile_integrator(size_type min_flush_size = default_min_flush_size)
+	: min_flush_size_(min_flush_size),
+	  flush_size_(min_flush_size),
+	  busy_energy_(0),
+	  busy_time_(0)
+	{
+		// pre: min_flush_size > 0
+		DCS_ASSERT(
+			min_flush_size > 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::detail::utilization_profile_integrator::ctor] Invalid minimum flush size.")
+		);
+	}
+
+
+	/// Tells if the given profile has grown enough to be flushed.
+	public: bool flush_due(profile_type const& profile) const
+	{
+		return profile.num_segments() >= flush_size_;
+	}
+
+
+	/// Integrates and removes the segments of \a profile ending no later than \a settle_time.
+	public: template <typename PowerFuncT>
+		void flush(profile_type& profile, real_type settle_time, PowerFuncT power)
+	{
+		typedef typename profile_type::const_iterator profile_iterator;
+
+		real_type settled_begin(0);
+		real_type settled_end(0);
+		bool found(false);
+		profile_iterator profile_end_it(profile.end());
+		for (profile_iterator profile_it = profile.begin(); profile_it != profile_end_it; ++profile_it)
+		{
+			typename profile_type::profile_item_type const& item(*profile_it);
+
+			if (::boost::icl::upper(item.first) > settle_time)
+			{
+				break;
+			}
+
+			if (!found)
+			{
+				settled_begin = ::boost::icl::lower(item.first);
+				found = true;
+			}
+			settled_end = ::boost::icl::upper(item.first);
+
+			//FIXME: replace boost::icl::length with a wrapper function
+			busy_energy_ += power(item.second)*::boost::icl::length(item.first);
+			busy_time_ += ::boost::icl::length(item.first);
+		}
+
+		if (found)
+		{
+			profile.erase(profile_type::make_time_interval(settled_begin, settled_end));
+		}
+
+		// Amortize: wait for the profile to double before trying again
+		flush_size_ = ::std::max(min_flush_size_, 2*profile.num_segments());
+	}
+
+
+	/// Computes the energy and busy time of the settled segments plus the ones still in \a profile.
+	public: template <typename PowerFuncT>
+		void integrate(profile_type const& profile, PowerFuncT power, real_type& energy, real_type& busy_time) const
+	{
+		typedef typename profile_type::const_iterator profile_iterator;
+
+		energy = busy_energy_;
+		busy_time = busy_time_;
+
+		profile_iterator profile_end_it(profile.end());
+		for (profile_iterator profile_it = profile.begin(); profile_it != profile_end_it; ++profile_it)
+		{
+			typename profile_type::profile_item_type const& item(*profile_it);
+
+			//FIXME: replace boost::icl::length with a wrapper function
+			energy += power(item.second)*::boost::icl::length(item.first);
+			busy_time += ::boost::icl::length(item.first);
+		}
+	}
+
+
+	/// Number of segments that triggers the next flush.
+	public: size_type flush_size() const
+	{
+		return flush_size_;
+	}
+
+
+	/// Energy consumed above the idle level during the settled segments.
+	public: real_type busy_energy() const
+	{
+		return busy_energy_;
+	}
+
+
+	/// Length of the settled segments.
+	public: real_type busy_time() const
+	{
+		return busy_time_;
+	}
+
+
+	public: void reset()
+	{
+		flush_size_ = min_flush_size_;
+		busy_energy_ = busy_time_
+					 = real_type/*zero*/();
+	}
+
+
+	private: size_type min_flush_size_;
+	private: size_type flush_size_;
+	private: real_type busy_energy_;
+	private: real_type busy_time_;
+};
+
+template <typename TraitsT>
+const typename utilization_profile_integrator<TraitsT>::size_type utilization_profile_integrator<TraitsT>::default_min_flush_size(1024);
+
+}}}} // Namespace dcs::des::cloud::detail
+
+
+#endif // DCS_DES_CLOUD_DETAIL_UTILIZATION_PROFILE_INTEGRATOR_HPP
@@ -28,7 +28,10 @@
 
 #include <dcs/des/cloud/detail/ampl/vm_placement_minlp_solver.hpp>
 #include <dcs/des/cloud/detail/base_vm_placement_optimal_solver.hpp>
+#include <dcs/des/cloud/detail/cached_vm_placement_optimal_solver.hpp>
+#include <dcs/des/cloud/detail/native/vm_placement_minlp_solver.hpp>
 #include <dcs/des/cloud/detail/neos/vm_placement_minlp_solver.hpp>
+#include <dcs/des/cloud/detail/vm_placement_result_cache.hpp>
 #include <dcs/des/cloud/optimal_solver_categories.hpp>
 #include <dcs/des/cloud/optimal_solver_params.hpp>
 #include <dcs/des/cloud/optimal_solver_proxies.hpp>
@@ -61,6 +64,13 @@ template <typename TraitsT>
 												params.solver_id()
 											);
 							break;
+						case native_optimal_solver_input_method:
+							ptr_solver = ::dcs::make_shared< native::vm_placement_minlp_solver<TraitsT> >(
+												params.solver_id(),
+												params.time_limit(),
+												params.num_threads()
+											);
+							break;
 //TODO
 //						case gams_optimal_solver_input_method:
 //							ptr_solver = ::dcs::make_shared< gams::vm_placement_minlp_solver<TraitsT> >(
@@ -79,6 +89,17 @@ template <typename TraitsT>
 			throw ::std::runtime_error("[dcs::des::cloud::detail::make_vm_placement_optimal_solver] Solver category not handled.");
 	}
 
+	if (params.cache())
+	{
+		ptr_solver = ::dcs::make_shared< cached_vm_placement_optimal_solver<TraitsT> >(
+							ptr_solver,
+							::dcs::make_shared< vm_placement_result_cache<TraitsT> >(
+									params.cache_path(),
+									params.cache_tolerance()
+								)
+						);
+	}
+
 	return ptr_solver;
 }
 
@@ -0,0 +1,401 @@
+/**
+ * \file dcs/des/cloud/detail/vm_placement_result_cache.hpp
+ *
+ * \brief Cache of the results of solved VM placement problems.
+ *
+ * Problems are identified by a hash of their data.
+ * VM utilizations are left out of the hash and are compared one by one, so
+ * that a result can be reused for a problem whose utilizations differ at most
+ * by a given tolerance.
+ * Results can also be stored on disk (one file per hash), so that they can be
+ * shared among different processes (e.g., concurrent replications) and runs.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_DETAIL_VM_PLACEMENT_RESULT_CACHE_HPP
+#define DCS_DES_CLOUD_DETAIL_VM_PLACEMENT_RESULT_CACHE_HPP
+
+
+#include <algorithm>
+#include <boost/cstdint.hpp>
+#include <cmath>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/des/cloud/detail/native/vm_placement_problem.hpp>
+#include <dcs/des/cloud/detail/vm_placement_problem.hpp>
+#include <dcs/des/cloud/physical_resource_category.hpp>
+#include <fstream>
+#include <iomanip>
+#include <ios>
+#include <limits>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace cloud { namespace detail {
+
+template <typename TraitsT>
+class vm_placement_result_cache
+{
+	public: typedef TraitsT traits_type;
+	public: typedef typename traits_type::real_type real_type;
+	public: typedef native::vm_placement_problem<traits_type> problem_type;
+	public: typedef vm_placement_problem_result<traits_type> problem_result_type;
+	private: typedef typename problem_result_type::physical_machine_identifier_type physical_machine_identifier_type;
+	private: typedef typename problem_result_type::virtual_machine_identifier_type virtual_machine_identifier_type;
+	private: typedef typename problem_result_type::resource_share_container resource_share_container;
+	private: typedef ::boost::uint64_t hash_type;
+	private: typedef ::std::pair<hash_type,hash_type> key_type;
+	private: typedef ::std::vector<real_type> real_vector_type;
+	private: struct entry
+	{
+		real_vector_type utils;
+		problem_result_type result;
+	};
+	private: typedef ::std::map< key_type, ::std::vector<entry> > entry_map;
+
+
+	public: explicit vm_placement_result_cache(::std::string const& path = ::std::string(), real_type tolerance = 0)
+	: path_(path),
+	  tol_(tolerance),
+	  num_hits_(0),
+	  num_misses_(0)
+	{
+		// pre: tolerance >= 0
+		DCS_ASSERT(
+			tolerance >= 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::detail::vm_placement_result_cache::ctor] Invalid tolerance.")
+		);
+	}
+
+
+	/**
+	 * \brief Look for the result of the given problem.
+	 *
+	 * \return A pointer to the result of the closest cached problem, or a null
+	 *  pointer if no cached problem matches the given one.
+	 */
+	public: problem_result_type const* find(problem_type const& problem)
+	{
+		key_type key(make_key(problem));
+
+		load(key);
+
+		typename entry_map::const_iterator it(entries_.find(key));
+		problem_result_type const* ptr_res(0);
+		if (it != entries_.end())
+		{
+			real_type best_dist(::std::numeric_limits<real_type>::infinity());
+			for (::std::size_t e = 0; e < it->second.size(); ++e)
+			{
+				real_type dist(distance(it->second[e].utils, problem.ur));
+				if (dist <= tol_ && dist < best_dist)
+				{
+					best_dist = dist;
+					ptr_res = &it->second[e].result;
+				}
+			}
+		}
+
+		if (ptr_res)
+		{
+			++num_hits_;
+		}
+		else
+		{
+			++num_misses_;
+		}
+
+		return ptr_res;
+	}
+
+
+	/// Store the result of the given problem.
+	public: void insert(problem_type const& problem, problem_result_type const& result)
+	{
+		key_type key(make_key(problem));
+
+		load(key);
+
+		entry e;
+		e.utils = problem.ur;
+		e.result = result;
+		entries_[key].push_back(e);
+
+		if (!path_.empty())
+		{
+			// Write the whole entry at once, so that concurrent writers do not interleave
+			::std::ofstream ofs(file_name(key).c_str(), ::std::ios_base::out | ::std::ios_base::app);
+			if (ofs)
+			{
+				ofs << write_entry(e) << ::std::flush;
+			}
+		}
+	}
+
+
+	public: ::std::size_t num_hits() const
+	{
+		return num_hits_;
+	}
+
+
+	public: ::std::size_t num_misses() const
+	{
+		return num_misses_;
+	}
+
+
+	private: static real_type distance(real_vector_type const& u1, real_vector_type const& u2)
+	{
+		if (u1.size() != u2.size())
+		{
+			return ::std::numeric_limits<real_type>::infinity();
+		}
+
+		real_type dist(0);
+		for (::std::size_t j = 0; j < u1.size(); ++j)
+		{
+			dist = ::std::max(dist, ::std::abs(u1[j]-u2[j]));
+		}
+
+		return dist;
+	}
+
+
+	private: static hash_type make_uint64(unsigned long high, unsigned long low)
+	{
+		return (static_cast<hash_type>(high) << 32) | static_cast<hash_type>(low);
+	}
+
+
+	/// FNV-1a hash of the given text, starting from the given basis.
+	private: static hash_type hash(::std::string const& text, hash_type basis)
+	{
+		hash_type h(basis);
+		for (::std::size_t k = 0; k < text.size(); ++k)
+		{
+			h ^= static_cast<unsigned char>(text[k]);
+			h *= make_uint64(0x00000100UL, 0x000001b3UL); // FNV prime
+		}
+
+		return h;
+	}
+
+
+	private: static void write_values(::std::ostream& os, real_vector_type const& values)
+	{
+		os << values.size();
+		for (::std::size_t k = 0; k < values.size(); ++k)
+		{
+			os << ' ' << values[k];
+		}
+		os << ';';
+	}
+
+
+	/// Hash every problem data but VM utilizations.
+	private: static key_type make_key(problem_type const& problem)
+	{
+		::std::ostringstream oss;
+		oss << ::std::setprecision(::std::numeric_limits<real_type>::digits10+2);
+
+		oss << problem.pm_ids.size();
+		for (::std::size_t i = 0; i < problem.pm_ids.size(); ++i)
+		{
+			oss << ' ' << problem.pm_ids[i];
+		}
+		oss << ';' << problem.vm_ids.size();
+		for (::std::size_t j = 0; j < problem.vm_ids.size(); ++j)
+		{
+			oss << ' ' << problem.vm_ids[j];
+		}
+		oss << ';';
+		write_values(oss, problem.c0);
+		write_values(oss, problem.c1);
+		write_values(oss, problem.c2);
+		write_values(oss, problem.r);
+		write_values(oss, problem.smax);
+		write_values(oss, problem.c);
+		write_values(oss, problem.umax);
+		write_values(oss, problem.cr);
+		write_values(oss, problem.srmin);
+		for (::std::size_t i = 0; i < problem.mc.size1(); ++i)
+		{
+			for (::std::size_t j = 0; j < problem.mc.size2(); ++j)
+			{
+				oss << ' ' << problem.mc(i,j);
+			}
+		}
+		oss << ';' << problem.wp << ' ' << problem.wm << ' ' << problem.ws;
+
+		::std::string text(oss.str());
+
+		// Use the standard FNV offset basis and the one with swapped halves
+		return key_type(hash(text, make_uint64(0xcbf29ce4UL, 0x84222325UL)),
+						hash(text, make_uint64(0x84222325UL, 0xcbf29ce4UL)));
+	}
+
+
+	private: ::std::string file_name(key_type const& key) const
+	{
+		::std::ostringstream oss;
+		oss << path_ << "/" << ::std::hex << ::std::setfill('0')
+			<< ::std::setw(16) << key.first
+			<< ::std::setw(16) << key.second
+			<< ".cache";
+
+		return oss.str();
+	}
+
+
+	/// Format: <#utils> <utils...> <cost> <#pairs> {<pm> <vm> <#shares> {<category> <share>}...}... .
+	private: static ::std::string write_entry(entry const& e)
+	{
+		::std::ostringstream oss;
+		oss << ::std::setprecision(::std::numeric_limits<real_type>::digits10+2);
+
+		oss << e.utils.size();
+		for (::std::size_t j = 0; j < e.utils.size(); ++j)
+		{
+			oss << ' ' << e.utils[j];
+		}
+		oss << ' ' << e.result.cost()
+			<< ' ' << e.result.placement().size();
+		typedef typename problem_result_type::physical_virtual_machine_map::const_iterator placement_iterator;
+		placement_iterator end_it(e.result.placement().end());
+		for (placement_iterator it = e.result.placement().begin(); it != end_it; ++it)
+		{
+			oss << ' ' << it->first.first
+				<< ' ' << it->first.second
+				<< ' ' << it->second.size();
+			for (::std::size_t k = 0; k < it->second.size(); ++k)
+			{
+				oss << ' ' << static_cast<int>(it->second[k].first)
+					<< ' ' << it->second[k].second;
+			}
+		}
+		oss << " ." << ::std::endl;
+
+		return oss.str();
+	}
+
+
+	private: static bool read_entry(::std::string const& line, entry& e)
+	{
+		::std::istringstream iss(line);
+
+		::std::size_t n(0);
+		if (!(iss >> n))
+		{
+			return false;
+		}
+		e.utils.resize(n);
+		for (::std::size_t j = 0; j < n; ++j)
+		{
+			if (!(iss >> e.utils[j]))
+			{
+				return false;
+			}
+		}
+
+		real_type cost;
+		::std::size_t npairs(0);
+		if (!(iss >> cost >> npairs))
+		{
+			return false;
+		}
+		e.result.reset();
+		e.result.cost(cost);
+		for (::std::size_t p = 0; p < npairs; ++p)
+		{
+			physical_machine_identifier_type pm_id;
+			virtual_machine_identifier_type vm_id;
+			::std::size_t nshares(0);
+			if (!(iss >> pm_id >> vm_id >> nshares))
+			{
+				return false;
+			}
+			resource_share_container shares;
+			for (::std::size_t k = 0; k < nshares; ++k)
+			{
+				int category;
+				real_type share;
+				if (!(iss >> category >> share))
+				{
+					return false;
+				}
+				shares.push_back(::std::make_pair(static_cast<physical_resource_category>(category), share));
+			}
+			e.result.placement()[::std::make_pair(pm_id, vm_id)] = shares;
+		}
+
+		// The end marker tells the entry has been completely written
+		::std::string end_mark;
+		if (!(iss >> end_mark) || end_mark != ".")
+		{
+			return false;
+		}
+		e.result.solved(true);
+
+		return true;
+	}
+
+
+	/// Load the stored results of the given problem, the first time it is looked up.
+	private: void load(key_type const& key)
+	{
+		if (path_.empty() || loaded_.count(key))
+		{
+			return;
+		}
+		loaded_.insert(key);
+
+		::std::ifstream ifs(file_name(key).c_str());
+		::std::string line;
+		while (::std::getline(ifs, line))
+		{
+			// Skip partially written entries
+			entry e;
+			if (read_entry(line, e))
+			{
+				entries_[key].push_back(e);
+			}
+		}
+	}
+
+
+	private: ::std::string path_;
+	private: real_type tol_;
+	private: entry_map entries_;
+	private: ::std::set<key_type> loaded_;
+	private: ::std::size_t num_hits_;
+	private: ::std::size_t num_misses_;
+}; // vm_placement_result_cache
+
+}}}} // Namespace dcs::des::cloud::detail
+
+
+#endif // DCS_DES_CLOUD_DETAIL_VM_PLACEMENT_RESULT_CACHE_HPP
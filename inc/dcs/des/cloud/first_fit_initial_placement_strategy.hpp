@@ -31,6 +31,7 @@
 #include <dcs/des/cloud/data_center.hpp>
 #include <dcs/des/cloud/performance_measure_category.hpp>
 #include <dcs/des/cloud/physical_resource_category.hpp>
+#include <dcs/des/cloud/resource_vector.hpp>
 #include <dcs/des/cloud/utility.hpp>
 #include <dcs/des/cloud/virtual_machines_placement.hpp>
 #include <map>
@@ -67,9 +68,9 @@ class first_fit_initial_placement_strategy: public base_initial_placement_strate
 //		typedef ::std::map<physical_resource_category,real_type> resource_share_map;
 		typedef typename application_type::application_tier_type application_tier_type;
 		typedef typename application_tier_type::resource_share_container ref_share_container;
-		typedef ::std::map<physical_resource_category,real_type> share_container;
+		typedef resource_vector<real_type> share_container;
 		typedef typename share_container::const_iterator share_iterator;
-		typedef ::std::map<physical_resource_category,real_type> resource_utilization_map;
+		typedef resource_vector<real_type> resource_utilization_map;
 		typedef typename application_type::reference_physical_resource_type ref_resource_type;
 		typedef typename application_type::reference_physical_resource_container ref_resource_container;
 		typedef typename ref_resource_container::const_iterator ref_resource_iterator;
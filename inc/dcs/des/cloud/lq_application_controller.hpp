@@ -69,9 +69,11 @@
 #include <boost/numeric/ublas/traits.hpp>
 #include <boost/numeric/ublasx/operation/all.hpp>
 #include <boost/numeric/ublasx/operation/isfinite.hpp>
+#include <boost/numeric/ublasx/operation/lu.hpp>
 #include <boost/numeric/ublasx/operation/num_columns.hpp>
 #include <boost/numeric/ublasx/operation/num_rows.hpp>
 #include <boost/numeric/ublasx/operation/size.hpp>
+#include <cmath>
 #include <cstddef>
 #include <dcs/control/analysis/controllability.hpp>
 #include <dcs/control/analysis/detectability.hpp>
@@ -97,6 +99,7 @@
 #include <dcs/des/cloud/physical_resource_category.hpp>
 #include <dcs/des/cloud/registry.hpp>
 #include <dcs/des/cloud/system_identification_strategy_params.hpp>
+#include <dcs/des/cloud/trace.hpp>
 #include <dcs/des/cloud/utility.hpp>
 #include <dcs/exception.hpp>
 #include <dcs/functional/bind.hpp>
@@ -167,6 +170,9 @@ void make_ss(SysIdentStrategyT const& sys_ident_strategy,
 //	const size_type n(::std::max(n_x,n_u));
 	const size_type n_y(1);
 
+	// Scratch block for A_k and B_k, reused across the calls below
+	typename SysIdentStrategyT::matrix_type X_k;
+
 	// Create the state matrix A
 	// A=[ 0        I          0         ...  0    0        I          0         ...  0  ;
 	//     0        0          I         ...  0    0        0          I         ...  0  ;
@@ -214,7 +220,8 @@ void make_ss(SysIdentStrategyT const& sys_ident_strategy,
 			size_type c2((rls_n_b-i)*rls_n_u);
 			size_type c1(c2-rls_n_u);
 
-			ublas::subrange(A(), broffs, n_x, c1, c2) = sys_ident_strategy.B(i+1);
+			sys_ident_strategy.B(i+1, X_k);
+			ublas::subrange(A(), broffs, n_x, c1, c2).assign(X_k);
 		}
 
 		// Fill A with A_1, ..., A_{n_a}
@@ -228,7 +235,8 @@ void make_ss(SysIdentStrategyT const& sys_ident_strategy,
 			size_type c1(c2-rls_n_y);
 
 			////ublas::subrange(A(), broffs, n_x, c1, c2) = sys_ident_strategy.A(i+1);
-			ublas::subrange(A(), broffs, n_x, c1, c2) = -sys_ident_strategy.A(i+1);
+			sys_ident_strategy.A(i+1, X_k);
+			ublas::subrange(A(), broffs, n_x, c1, c2).assign(-X_k);
 			//ublas::subrange(A(), broffs, n_x, c1, c2) = sys_ident_strategy.A(i+1);
 		}
 	}
@@ -257,7 +265,8 @@ void make_ss(SysIdentStrategyT const& sys_ident_strategy,
 		ublas::subrange(B(), 0, n_u, 0, n_u) = ublas::identity_matrix<value_type>(n_u,n_u);
 		ublas::subrange(B(), n_u, broffs, 0, n_u) = ublas::zero_matrix<value_type>(broffs-n_u,n_u);
 		// The bottom part of B with B_1
-		ublas::subrange(B(), broffs, n_x, 0, n_u) = sys_ident_strategy.B(1);
+		sys_ident_strategy.B(1, X_k);
+		ublas::subrange(B(), broffs, n_x, 0, n_u).assign(X_k);
 	}
 	else
 	{
@@ -335,6 +344,9 @@ void make_ss(SysIdentStrategyT const& sys_ident_strategy,
 //	const size_type n(::std::max(n_x,n_u));
 	const size_type n_y(1);
 
+	// Scratch block for A_k and B_k, reused across the calls below
+	typename SysIdentStrategyT::matrix_type X_k;
+
 	DCS_ASSERT(
 			rls_n_y <= 1 && rls_n_u <= 1,
 			DCS_EXCEPTION_THROW(
@@ -382,7 +394,8 @@ void make_ss(SysIdentStrategyT const& sys_ident_strategy,
 				size_type c1(c2-rls_n_y);
 
 				////ublas::subrange(A(), broffs, n_x, c1, c2) = sys_ident_strategy.A(i+1);
-				ublas::subrange(A(), broffs, n_x, c1, c2) = -sys_ident_strategy.A(i+1);
+				sys_ident_strategy.A(i+1, X_k);
+				ublas::subrange(A(), broffs, n_x, c1, c2).assign(-X_k);
 				//ublas::subrange(A(), broffs, n_x, c1, c2) = sys_ident_strategy.A(i+1);
 			}
 		}
@@ -435,7 +448,8 @@ void make_ss(SysIdentStrategyT const& sys_ident_strategy,
 			size_type c2((rls_n_b-i)*rls_n_u);
 			size_type c1(c2-rls_n_u);
 
-			ublas::subrange(C(), 0, n_y, c1, c2) = sys_ident_strategy.B(i+1);
+			sys_ident_strategy.B(i+1, X_k);
+			ublas::subrange(C(), 0, n_y, c1, c2).assign(X_k);
 		}
 	}
 	else
@@ -499,6 +513,9 @@ void make_ss(SysIdentStrategyT const& sys_ident_strategy,
 //	const size_type n(::std::max(n_x,n_u));
 	const size_type n_y(1);
 
+	// Scratch block for A_k and B_k, reused across the calls below
+	typename SysIdentStrategyT::matrix_type X_k;
+
 	// Create the state matrix A
 	// A=[ 0        I          0         ...  0  ;
 	//     0        0          I         ...  0  ;
@@ -529,7 +546,8 @@ void make_ss(SysIdentStrategyT const& sys_ident_strategy,
 			size_type c1(c2-rls_n_y);
 
 			////ublas::subrange(A(), broffs, n_x, c1, c2) = sys_ident_strategy.A(i+1);
-			ublas::subrange(A(), broffs, n_x, c1, c2) = -sys_ident_strategy.A(i+1);
+			sys_ident_strategy.A(i+1, X_k);
+			ublas::subrange(A(), broffs, n_x, c1, c2).assign(-X_k);
 			//ublas::subrange(A(), broffs, n_x, c1, c2) = sys_ident_strategy.A(i+1);
 		}
 	}
@@ -568,7 +586,8 @@ void make_ss(SysIdentStrategyT const& sys_ident_strategy,
 			size_type c2((rls_n_b-i)*rls_n_u);
 			size_type c1(c2-rls_n_u);
 
-			ublas::subrange(B(), broffs, n_x, c1, c2) = sys_ident_strategy.B(i+1);
+			sys_ident_strategy.B(i+1, X_k);
+			ublas::subrange(B(), broffs, n_x, c1, c2).assign(X_k);
 		}
 	}
 	else
@@ -607,6 +626,166 @@ void make_ss(SysIdentStrategyT const& sys_ident_strategy,
 #endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_ALT_SS
 
 
+/**
+ * \brief Cache of the last LQ design.
+ *
+ * Remembers the system matrices the LQ gain was last computed for, together
+ * with the matrix mapping the reference output to the equilibrium control
+ * input, so that the DARE and the Rosenbrock's system matrix solution can be
+ * skipped as long as the identified system stays within a relative tolerance
+ * of the cached one.
+ */
+template <typename RealT>
+class lq_design_cache
+{
+	public: typedef RealT real_type;
+	public: typedef ::boost::numeric::ublas::matrix<real_type> matrix_type;
+	public: typedef ::std::size_t size_type;
+
+
+	public: static const real_type default_tolerance;
+
+
+	public: explicit lq_design_cache(real_type tol = default_tolerance)
+	: tol_(tol),
+	  valid_(false)
+	{
+	}
+
+
+	public: void tolerance(real_type tol)
+	{
+		tol_ = tol;
+		valid_ = false;
+	}
+
+
+	public: real_type tolerance() const
+	{
+		return tol_;
+	}
+
+
+	public: void reset()
+	{
+		valid_ = false;
+	}
+
+
+	/// Tell if the given system matches the one the cached design refers to.
+	public: bool matches(matrix_type const& A, matrix_type const& B, matrix_type const& C, matrix_type const& D) const
+	{
+		return valid_
+			   && close(A, A_)
+			   && close(B, B_)
+			   && close(C, C_)
+			   && close(D, D_);
+	}
+
+
+	/**
+	 * \brief Compute and store the equilibrium compensation for the given
+	 *  system.
+	 *
+	 * The equilibrium point \f$(x_d,u_d)\f$ is the minimum-norm solution of
+	 * \f$P [x_d; u_d] = [0; r]\f$, where
+	 * \f$P = [I-A\ B; -C\ D]\f$ is the Rosenbrock's system matrix.
+	 * The gain \f$K_r\f$ such that \f$u_d = K_r r\f$ is obtained by solving
+	 * \f$P P^T W = [0; I]\f$ by LU factorization, thus avoiding the explicit
+	 * inverse of \f$P P^T\f$.
+	 *
+	 * \return \c false if \f$P P^T\f$ is singular; in this case the cache is
+	 *  invalidated.
+	 */
+	public: bool store(matrix_type const& A, matrix_type const& B, matrix_type const& C, matrix_type const& D)
+	{
+		namespace ublas = ::boost::numeric::ublas;
+		namespace ublasx = ::boost::numeric::ublasx;
+
+		valid_ = false;
+
+		const size_type nx(ublasx::num_columns(A));
+		const size_type nu(ublasx::num_columns(B));
+		const size_type ny(ublasx::num_rows(C));
+		const size_type ncp(nx+nu);
+		const size_type nrp(nx+ny);
+
+		matrix_type P(nrp, ncp, 0);
+		ublas::subrange(P, 0, nx, 0, nx) = ublas::identity_matrix<real_type>(nx, nx) - A;
+		ublas::subrange(P, 0, nx, nx, ncp) = B;
+		ublas::subrange(P, nx, nrp, 0, nx) = -C;
+		ublas::subrange(P, nx, nrp, nx, ncp) = D;
+
+		matrix_type PP(ublas::prod(P, ublas::trans(P)));
+		matrix_type W(nrp, ny, 0);
+		ublas::subrange(W, nx, nrp, 0, ny) = ublas::identity_matrix<real_type>(ny, ny);
+		if (ublasx::lu_solve_inplace(PP, W))
+		{
+			return false;
+		}
+
+		Kr_.resize(nu, ny, false);
+		ublas::noalias(Kr_) = ublas::prod(ublas::trans(ublas::subrange(P, 0, nrp, nx, ncp)), W);
+
+		A_ = A;
+		B_ = B;
+		C_ = C;
+		D_ = D;
+		valid_ = true;
+
+		return true;
+	}
+
+
+	/// The gain mapping the reference output to the equilibrium control input.
+	public: matrix_type const& reference_gain() const
+	{
+		return Kr_;
+	}
+
+
+	private: bool close(matrix_type const& X, matrix_type const& Y) const
+	{
+		const size_type nr(X.size1());
+		const size_type nc(X.size2());
+
+		if (nr != Y.size1() || nc != Y.size2())
+		{
+			return false;
+		}
+
+		real_type max_diff(0);
+		real_type max_abs(1);
+		for (size_type r = 0; r < nr; ++r)
+		{
+			for (size_type c = 0; c < nc; ++c)
+			{
+				max_diff = ::std::max(max_diff, ::std::abs(X(r,c)-Y(r,c)));
+				max_abs = ::std::max(max_abs, ::std::abs(Y(r,c)));
+			}
+		}
+
+		return max_diff <= tol_*max_abs;
+	}
+
+
+	/// Relative tolerance on the system matrices.
+	private: real_type tol_;
+	/// Flag indicating if the cached design can be used.
+	private: bool valid_;
+	private: matrix_type A_;
+	private: matrix_type B_;
+	private: matrix_type C_;
+	private: matrix_type D_;
+	/// The gain mapping the reference output to the equilibrium control input.
+	private: matrix_type Kr_;
+}; // lq_design_cache
+
+
+template <typename RealT>
+const RealT lq_design_cache<RealT>::default_tolerance = 1.0e-6;
+
+
 template <typename TraitsT>
 class lq_application_controller: public base_application_controller<TraitsT>
 {
@@ -630,6 +809,7 @@ class lq_application_controller: public base_application_controller<TraitsT>
 	private: typedef typename base_type::application_type application_type;
 	private: typedef typename application_type::simulation_model_type application_simulation_model_type;
 	private: typedef typename application_simulation_model_type::user_request_type user_request_type;
+	private: typedef typename application_simulation_model_type::user_request_view_type user_request_view_type;
 	private: typedef typename application_simulation_model_type::virtual_machine_type virtual_machine_type;
 	private: typedef ::dcs::shared_ptr<virtual_machine_type> virtual_machine_pointer;
 	private: typedef typename application_type::application_tier_type application_tier_type;
@@ -935,7 +1115,7 @@ class lq_application_controller: public base_application_controller<TraitsT>
 
 			// Apply the EWMA filter to previously observed measurements
 			//real_type ewma_old_s(ewma_s_.at(category));
-::std::cerr << "APP " << this->application().id() << " - STAT: " << ptr_stat->estimate() << " - OLD EWMA: " << ewma_s_.at(category) << " - Smooth: " << ewma_smooth_ << " - Count: " << count_ << " ==> " << ewma_smooth_*ptr_stat->estimate() + (1-ewma_smooth_)*ewma_s_.at(category) << ::std::endl;//XXX
+			DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP " << this->application().id() << " - STAT: " << ptr_stat->estimate() << " - OLD EWMA: " << ewma_s_.at(category) << " - Smooth: " << ewma_smooth_ << " - Count: " << count_ << " ==> " << ewma_smooth_*ptr_stat->estimate() + (1-ewma_smooth_)*ewma_s_.at(category);
 			if (ptr_stat->num_observations() > 0)
 			{
 				if (count_ > 1)
@@ -948,7 +1128,7 @@ class lq_application_controller: public base_application_controller<TraitsT>
 				}
 			}
 
-::std::cerr << "APP " << this->application().id() << " - STAT: " << ptr_stat->estimate() << " - EWMA: " << ewma_s_.at(category) << ::std::endl;//XXX
+			DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP " << this->application().id() << " - STAT: " << ptr_stat->estimate() << " - EWMA: " << ewma_s_.at(category);
 			// Reset stat and set as the first observation a memory of the past
 			ptr_stat->reset();
 			(*ptr_stat)(ewma_s_.at(category));
@@ -1013,7 +1193,7 @@ class lq_application_controller: public base_application_controller<TraitsT>
 
 			// Apply the EWMA filter to previously observed measurements
 			//real_type ewma_old_s(ewma_s_.at(category));
-::std::cerr << "APP " << this->application().id() << " - STAT: " << ptr_stat->estimate() << " - OLD EWMA: " << ewma_s_.at(category) << " - Smooth: " << ewma_smooth_ << " - Count: " << count_ << " ==> " << ewma_smooth_*ptr_stat->estimate() + (1-ewma_smooth_)*ewma_s_.at(category) << ::std::endl;//XXX
+			DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP " << this->application().id() << " - STAT: " << ptr_stat->estimate() << " - OLD EWMA: " << ewma_s_.at(category) << " - Smooth: " << ewma_smooth_ << " - Count: " << count_ << " ==> " << ewma_smooth_*ptr_stat->estimate() + (1-ewma_smooth_)*ewma_s_.at(category);
 			if (ptr_stat->num_observations() > 0)
 			{
 				if (count_ > 1)
@@ -1030,7 +1210,7 @@ class lq_application_controller: public base_application_controller<TraitsT>
 				(*ptr_stat)(ewma_s_.at(category));
 			}
 
-::std::cerr << "APP " << this->application().id() << " - STAT: " << ptr_stat->estimate() << " - EWMA: " << ewma_s_.at(category) << ::std::endl;//XXX
+			DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP " << this->application().id() << " - STAT: " << ptr_stat->estimate() << " - EWMA: " << ewma_s_.at(category);
 #if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT)
 			eq_out_measure_ = ewma_s_.at(category);
 #endif
@@ -1249,7 +1429,7 @@ class lq_application_controller: public base_application_controller<TraitsT>
 
 		// Collect tiers and system output measures
 
-		user_request_type req = app.simulation_model().request_state(evt);
+		user_request_view_type req(app.simulation_model().request_view(evt));
 
 //		real_type app_rt(0);
 
@@ -1275,19 +1455,12 @@ class lq_application_controller: public base_application_controller<TraitsT>
 							//      response time.
 
 							// Compute the residence time for this tier
-							::std::vector<real_type> arr_times(req.tier_arrival_times(tier_id));
-							::std::vector<real_type> dep_times(req.tier_departure_times(tier_id));
-							size_type nt(arr_times.size());
-							if (nt > 0)
+							if (req.tier_num_visits(tier_id) > 0)
 							{
-								real_type rt(0);
-								for (size_type t = 0; t < nt; ++t)
-								{
-									rt += dep_times[t]-arr_times[t];
-								}
+								real_type rt(req.tier_residence_time(tier_id));
 //								rt *= scale_factor;
 								(*ptr_stat)(rt);
-::std::cerr << "APP " << app.id() << " - TIER: " << tier_id << " - OBSERVATION: " << rt << " (Clock: " << ctx.simulated_time() << ")" << ::std::endl;//XXX
+								DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP " << app.id() << " - TIER: " << tier_id << " - OBSERVATION: " << rt << " (Clock: " << ctx.simulated_time() << ")";
 //								app_rt += rt;
 							}
 						}
@@ -1318,7 +1491,7 @@ class lq_application_controller: public base_application_controller<TraitsT>
 					{
 						real_type rt(req.departure_time()-req.arrival_time());
 						(*ptr_stat)(rt);
-::std::cerr << "APP " << app.id() << " - OBSERVATION: " << rt << " (Clock: " << ctx.simulated_time() << ")" << ::std::endl;//XXX
+						DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP " << app.id() << " - OBSERVATION: " << rt << " (Clock: " << ctx.simulated_time() << ")";
 //						(*ptr_stat)(app_rt);
 					}
 					break;
@@ -1413,7 +1586,7 @@ class lq_application_controller: public base_application_controller<TraitsT>
 		DCS_DEBUG_TRACE("(" << this << ") BEGIN Do Process CONTROL event (Clock: " << ctx.simulated_time() << " - Count: " << count_ << "/" << ident_fail_count_ << "/" << ctrl_fail_count_ << ")");
 //if ((count_ % 1000) == 0)//XXX
 //{//XXX
-::std::cerr << "APP: " << this->application().id() << " - BEGIN Process CONTROL event -- Actual Output: " << measures_.at(response_time_performance_measure)->estimate() << " (Clock: " << ctx.simulated_time() << " - Counts: " << count_ << "/" << ident_fail_count_ << "/" << ctrl_fail_count_ << ")" << ::std::endl;//XXX
+		DCS_DES_CLOUD_TRACE(app_controller, info) << "APP: " << this->application().id() << " - BEGIN Process CONTROL event -- Actual Output: " << measures_.at(response_time_performance_measure)->estimate() << " (Clock: " << ctx.simulated_time() << " - Counts: " << count_ << "/" << ident_fail_count_ << "/" << ctrl_fail_count_ << ")";
 //}//XXX
 
 		if (!ready_)
@@ -1422,7 +1595,7 @@ class lq_application_controller: public base_application_controller<TraitsT>
 			return;
 		}
 #if 0
-::std::cerr << "BEGIN MANUAL CONTROL" << ::std::endl;//XXX
+DCS_DES_CLOUD_TRACE(app_controller, debug) << "BEGIN MANUAL CONTROL";
 {
 	typedef typename traits_type::physical_machine_identifier_type pm_identifier_type;
 	typedef ::std::set<pm_identifier_type> pm_id_container;
@@ -1470,7 +1643,7 @@ class lq_application_controller: public base_application_controller<TraitsT>
 		this->application().data_centre().physical_machine_controller(pm_id).control();
 	}
 }
-::std::cerr << "END MANUAL CONTROL" << ::std::endl;//XXX
+DCS_DES_CLOUD_TRACE(app_controller, debug) << "END MANUAL CONTROL";
 return;
 #endif // 0
 
@@ -1516,8 +1689,8 @@ return;
 		//  u(k) = [s(k-n_b+1) ... s(k)]^T
 		//       = [u_{n_s:n_u}(k-1) s(k)]^T
 		// Check if a measure rotation is needed (always but the first time)
-::std::cerr << "Old x=" << x_ << ::std::endl;//XXX
-::std::cerr << "Old u=" << u_ << ::std::endl;//XXX
+		DCS_DES_CLOUD_TRACE(app_controller, debug) << "Old x=" << x_;
+		DCS_DES_CLOUD_TRACE(app_controller, debug) << "Old u=" << u_;
 		if (count_ > 1)
 		{
 			// throw away old observations from x and make space for new ones.
@@ -1525,25 +1698,16 @@ return;
 			if (n_x_ > 0)
 			{
 #if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_ALT_SS)
-::std::cerr << "HERE.1 -- n_b=" << n_b_ << ::std::endl;//XXX
 				if (n_b_ > 1)
 				{
-::std::cerr << "HERE.2" << ::std::endl;//XXX
 					if (n_b_ > 2)
 					{
-::std::cerr << "HERE.3" << ::std::endl;//XXX
 						ublas::subrange(x_, 0, (n_b_-2)*n_s_) = ublas::subrange(x_, n_s_, (n_b_-1)*n_s_);
-::std::cerr << "HERE.4" << ::std::endl;//XXX
 					}
-::std::cerr << "HERE.5" << ::std::endl;//XXX
 					ublas::subrange(x_, (n_b_-2)*n_s_, (n_b_-1)*n_s_) = u_;
-::std::cerr << "HERE.6" << ::std::endl;//XXX
 				}
-::std::cerr << "HERE.7" << ::std::endl;//XXX
 				ublas::subrange(x_, n_s_*(n_b_-1), n_x_-n_p_) = ublas::subrange(x_, (n_b_-1)*n_s_+n_p_, n_x_);
-::std::cerr << "HERE.8" << ::std::endl;//XXX
 				ublas::subrange(x_, n_x_-n_p_, n_x_) = ublas::scalar_vector<real_type>(n_p_, ::std::numeric_limits<real_type>::quiet_NaN());
-::std::cerr << "HERE.9" << ::std::endl;//XXX
 				//ublas::subrange(x_, n_p_, n_x_) = ublas::subrange(x_, 0, n_x_-n_p_);
 #else // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_ALT_SS
 				//ublas::subrange(x_, 0, (n_a_-1)*n_p_) = ublas::subrange(x_, n_p_, n_x_);
@@ -1565,8 +1729,8 @@ return;
 #endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_ALT_SS
 			}
 		}
-::std::cerr << "New x=" << x_ << ::std::endl;//XXX
-::std::cerr << "New u=" << u_ << ::std::endl;//XXX
+		DCS_DES_CLOUD_TRACE(app_controller, debug) << "New x=" << x_;
+		DCS_DES_CLOUD_TRACE(app_controller, debug) << "New u=" << u_;
 
 
 		// Collect data for creating control input and state
@@ -1677,7 +1841,7 @@ eq_out_measure_ = ewma_s_.at(category);//EXP-20120130
 				//skip = true;
 			}
 DCS_DEBUG_TRACE("APP " << app.id() << " - CONTROL OBSERVATION: ref: " << app_perf_model.application_measure(category) << " - equilibrium: " << eq_measure << " - actual: " << actual_measure);//XXX
-::std::cerr << "APP " << app.id() << " - CONTROL OBSERVATION: ref: " << app_perf_model.application_measure(category) << " - equilibrium: " << eq_measure << " - actual: " << actual_measure << ::std::endl;//XXX
+			DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP " << app.id() << " - CONTROL OBSERVATION: ref: " << app_perf_model.application_measure(category) << " - equilibrium: " << eq_measure << " - actual: " << actual_measure;
 
 			if (triggers_.actual_value_sla_ko())
 			{
@@ -1808,7 +1972,7 @@ tier_eq_out_measures_[tier_id] = ewma_tier_s_.at(tier_id).at(category);//EXP-201
 										//skip = true;
 									}
 DCS_DEBUG_TRACE("APP " << app.id() << " - TIER " << tier_id << " CONTROL OBSERVATION: ref: " << app_perf_model.tier_measure(tier_id, category) << " - equilibrium: " << eq_measure << " - actual: " << actual_measure);//XXX
-::std::cerr << "APP " << app.id() << " - TIER " << tier_id << " CONTROL OBSERVATION: ref: " << app_perf_model.tier_measure(tier_id, category) << " - equilibrium: " << eq_measure << " - actual: " << actual_measure << ::std::endl;//XXX
+									DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP " << app.id() << " - TIER " << tier_id << " CONTROL OBSERVATION: ref: " << app_perf_model.tier_measure(tier_id, category) << " - equilibrium: " << eq_measure << " - actual: " << actual_measure;
 #if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_OUTPUT_DEVIATION)
 # if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_NORMALIZED_OUTPUT)
 //#  if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT)
@@ -1853,7 +2017,7 @@ DCS_DEBUG_TRACE("APP " << app.id() << " - TIER " << tier_id << " CONTROL OBSERVA
 									x_(x_offset_+tier_id) = p(tier_id)
 														  = actual_measure;
 #endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_OUTPUT_DEVIATION
-::std::cerr << "Updated x=" << x_ << ::std::endl;//XXX
+									DCS_DES_CLOUD_TRACE(app_controller, debug) << "Updated x=" << x_;
 
 #ifdef DCS_DES_CLOUD_EXP_OUTPUT_RLS_DATA
 									// Dump actual tier residence time
@@ -1950,7 +2114,7 @@ DCS_DEBUG_TRACE("APP " << app.id() << " - TIER " << tier_id << " CONTROL OBSERVA
 				eq_share = ptr_vm->guest_system().resource_share(res_category);
 # endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT
 				DCS_DEBUG_TRACE("APP " << app.id() << " - TIER " << tier_id << " SHARE: ref: " << ptr_vm->guest_system().resource_share(res_category) << " - equilibrium: " << eq_share << " - actual: " << ptr_vm->resource_share(res_category) << " - actual-scaled: " << actual_share);//XXX
-::std::cerr << "APP " << app.id() << " - TIER " << tier_id << " SHARE: ref: " << ptr_vm->guest_system().resource_share(res_category) << " - equilibrium: " << eq_share << " - actual: " << ptr_vm->resource_share(res_category) << " - actual-scaled: " << actual_share << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP " << app.id() << " - TIER " << tier_id << " SHARE: ref: " << ptr_vm->guest_system().resource_share(res_category) << " - equilibrium: " << eq_share << " - actual: " << ptr_vm->resource_share(res_category) << " - actual-scaled: " << actual_share;
 # if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_NORMALIZED_INPUT)
 //#  if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT)
 //				s(tier_id) = actual_share/eq_share - 1;
@@ -2026,30 +2190,30 @@ DCS_DEBUG_TRACE("p_hat=" << p_hat);//XXX
 DCS_DEBUG_TRACE("Theta_hat=" << ptr_ident_strategy_->Theta_hat());//XXX
 DCS_DEBUG_TRACE("P=" << ptr_ident_strategy_->P());//XXX
 DCS_DEBUG_TRACE("phi=" << ptr_ident_strategy_->phi());//XXX
-::std::cerr << "APP: " << app.id() << " - RLS estimation:" << ::std::endl;//XXX
-::std::cerr << "p=" << p << ::std::endl;//XXX
-::std::cerr << "s=" << s << ::std::endl;//XXX
-::std::cerr << "p_hat=" << p_hat << ::std::endl;//XXX
-::std::cerr << "Theta_hat=" << ptr_ident_strategy_->Theta_hat() << ::std::endl;//XXX
-::std::cerr << "P=" << ptr_ident_strategy_->P() << ::std::endl;//XXX
-::std::cerr << "phi=" << ptr_ident_strategy_->phi() << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - RLS estimation:";
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "p=" << p;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "s=" << s;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "p_hat=" << p_hat;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "Theta_hat=" << ptr_ident_strategy_->Theta_hat();
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "P=" << ptr_ident_strategy_->P();
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "phi=" << ptr_ident_strategy_->phi();
 #if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_OUTPUT_DEVIATION)
 # if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_NORMALIZED_OUTPUT)
 #  if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT)
 //::std::cerr << "==> Estimated RLS output =" << ((p_hat(0)+1)*eq_out_measure_) << ::std::endl;//XXX
-::std::cerr << "==> Estimated RLS output =" << ((ublas::inner_prod(ptr_ident_strategy_->phi(), ublas::column(ptr_ident_strategy_->Theta_hat(),0))+1)*eq_out_measure_) << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "==> Estimated RLS output =" << ((ublas::inner_prod(ptr_ident_strategy_->phi(), ublas::column(ptr_ident_strategy_->Theta_hat(),0))+1)*eq_out_measure_);
 #  else // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT
-::std::cerr << "==> Estimated RLS output =" << ((ublas::inner_prod(ptr_ident_strategy_->phi(), ublas::column(ptr_ident_strategy_->Theta_hat(),0))+1)*app_perf_model.application_measure(response_time_performance_measure)) << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "==> Estimated RLS output =" << ((ublas::inner_prod(ptr_ident_strategy_->phi(), ublas::column(ptr_ident_strategy_->Theta_hat(),0))+1)*app_perf_model.application_measure(response_time_performance_measure));
 #  endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT
 # else // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_NORMALIZED_OUTPUT
 #  if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT)
-::std::cerr << "==> Estimated RLS output =" << (ublas::inner_prod(ptr_ident_strategy_->phi(), ublas::column(ptr_ident_strategy_->Theta_hat(),0))+eq_out_measure_) << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "==> Estimated RLS output =" << (ublas::inner_prod(ptr_ident_strategy_->phi(), ublas::column(ptr_ident_strategy_->Theta_hat(),0))+eq_out_measure_);
 #  else // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT
-::std::cerr << "==> Estimated RLS output =" << (ublas::inner_prod(ptr_ident_strategy_->phi(), ublas::column(ptr_ident_strategy_->Theta_hat(),0))+app_perf_model.application_measure(response_time_performance_measure)) << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "==> Estimated RLS output =" << (ublas::inner_prod(ptr_ident_strategy_->phi(), ublas::column(ptr_ident_strategy_->Theta_hat(),0))+app_perf_model.application_measure(response_time_performance_measure));
 #  endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT
 # endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_NORMALIZED_OUTPUT
 #else // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_OUTPUT_DEVIATION
-::std::cerr << "==> Estimated RLS output =" << ublas::inner_prod(ptr_ident_strategy_->phi(), ublas::column(ptr_ident_strategy_->Theta_hat(),0)) << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "==> Estimated RLS output =" << ublas::inner_prod(ptr_ident_strategy_->phi(), ublas::column(ptr_ident_strategy_->Theta_hat(),0));
 #endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_OUTPUT_DEVIATION
 
 				if (!ublasx::all(ublasx::isfinite(ptr_ident_strategy_->Theta_hat())))
@@ -2152,36 +2316,36 @@ DCS_DEBUG_TRACE("D=" << D);//XXX
 DCS_DEBUG_TRACE("y= " << y);//XXX
 DCS_DEBUG_TRACE("x= " << x_);//XXX
 DCS_DEBUG_TRACE("u= " << u_);//XXX
-::std::cerr << "APP: " << app.id() << " - Solving LQ with" << ::std::endl;//XXX
-::std::cerr << "A=" << A << ::std::endl;//XXX
-::std::cerr << "B=" << B << ::std::endl;//XXX
-::std::cerr << "C=" << C << ::std::endl;//XXX
-::std::cerr << "D=" << D << ::std::endl;//XXX
-::std::cerr << "y= " << y << ::std::endl;//XXX
-::std::cerr << "x= " << x_ << ::std::endl;//XXX
-::std::cerr << "u= " << u_ << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Solving LQ with";
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "A=" << A;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "B=" << B;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "C=" << C;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "D=" << D;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "y= " << y;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "x= " << x_;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "u= " << u_;
 #if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_OUTPUT_DEVIATION)
 # if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_NORMALIZED_OUTPUT)
 #  if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT)
 //DCS_DEBUG_TRACE("APP: " << app.id() << " - Estimated SS application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0)*eq_out_measure_));//XXX
-::std::cerr << "APP: " << app.id() << " - Estimated SS application response time: " << (eq_out_measure_*(1+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0))) << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Estimated SS application response time: " << (eq_out_measure_*(1+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0)));
 #  else // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT
 //DCS_DEBUG_TRACE("APP: " << app.id() << " - Estimated SS application response time: " << (app_perf_model.application_measure(response_time_performance_measure)*(1+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0))));//XXX
-::std::cerr << "APP: " << app.id() << " - Estimated SS application response time: " << (app_perf_model.application_measure(response_time_performance_measure)*(1+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0))) << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Estimated SS application response time: " << (app_perf_model.application_measure(response_time_performance_measure)*(1+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0)));
 #  endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT
 # else // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_NORMALIZED_OUTPUT
 //DCS_DEBUG_TRACE("APP: " << app.id() << " - Estimated SS application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0)));//XXX
 //::std::cerr << "APP: " << app.id() << " - Estimated SS application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0)) << ::std::endl;//XXX
 #  if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT)
-::std::cerr << "APP: " << app.id() << " - Estimated SS application response time: " << (eq_out_measure_+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0)) << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Estimated SS application response time: " << (eq_out_measure_+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0));
 #  else // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT
-::std::cerr << "APP: " << app.id() << " - Estimated SS application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0)) << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Estimated SS application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0));
 #  endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT
 # endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_NORMALIZED_OUTPUT
 #else // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_OUTPUT_DEVIATION
 //DCS_DEBUG_TRACE("APP: " << app.id() << " - Estimated SS application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0)));//XXX
 //::std::cerr << "APP: " << app.id() << " - Estimated SS application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0)) << ::std::endl;//XXX
-::std::cerr << "APP: " << app.id() << " - Estimated SS application response time: " << ((ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0)) << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Estimated SS application response time: " << ((ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,u_))+ublas::prod(D,u_))(0));
 #endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_OUTPUT_DEVIATION
 				vector_type opt_u;
 				try
@@ -2202,19 +2366,19 @@ DCS_DEBUG_TRACE("u= " << u_);//XXX
 				{
 DCS_DEBUG_TRACE("APP: " << app.id() << " - Solved!");//XXX
 DCS_DEBUG_TRACE("APP: " << app.id() << " - Optimal Control u*=> " << opt_u);//XXX
-::std:: cerr << "APP: " << app.id() << " - Optimal Control u*=> " << opt_u << ::std::endl;//XXX
+DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Optimal Control u*=> " << opt_u;
 #if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_OUTPUT_DEVIATION)
 # if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_NORMALIZED_OUTPUT)
 #  if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT)
 DCS_DEBUG_TRACE("APP: " << app.id() << " - Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0)*eq_out_measure_));//XXX
-::std::cerr << "APP: " << app.id() << " - Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0)*eq_out_measure_) << ::std::endl;//XXX
+DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0)*eq_out_measure_);
 #  else // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT
 DCS_DEBUG_TRACE("APP: " << app.id() << " - Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)*(1+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0))));//XXX
-::std::cerr << "APP: " << app.id() << " - Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)*(1+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0))) << ::std::endl;//XXX
+DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)*(1+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0)));
 #  endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT
 # else // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_NORMALIZED_OUTPUT
 DCS_DEBUG_TRACE("APP: " << app.id() << " - Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0)));//XXX
-::std::cerr << "APP: " << app.id() << " - Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0)) << ::std::endl;//XXX
+DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0));
 //::std::cerr << "APP: " << app.id() << " - Expected application response time #2: " << (eq_out_measure_+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0)) << ::std::endl;//XXX
 # endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_NORMALIZED_OUTPUT
 #else // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_OUTPUT_DEVIATION
@@ -2228,7 +2392,7 @@ DCS_DEBUG_TRACE("APP: " << app.id() << " - Expected application response time: "
 //DCS_DEBUG_TRACE("APP: " << app.id() << " - Expected application response time: " << (ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0));//XXX
 ////::std::cerr << "APP: " << app.id() << " - Expected application response time: " << (ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0) << ::std::endl;//XXX
 DCS_DEBUG_TRACE("APP: " << app.id() << " - Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0)));//XXX
-::std::cerr << "APP: " << app.id() << " - Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0)) << ::std::endl;//XXX
+					DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0));
 #endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_OUTPUT_DEVIATION
 //::std::cerr << "APP: " << app.id() << " - Expected application response time: " << (eq_out_measure_+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0)) << ::std::endl;//[EXP-20120203]
 
@@ -2329,7 +2493,7 @@ DCS_DEBUG_TRACE("Applying optimal control");//XXX
 							real_type new_share(opt_u(u_offset_+tier_id));
 #endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_INPUT_DEVIATION
 DCS_DEBUG_TRACE("APP : " << app.id() << " - Tier " << tier_id << " --> New Unscaled share: " << new_share);//XXX
-::std::cerr << "APP: " << app.id() << " - Tier " << tier_id << " --> New Unscaled share: " << new_share << ::std::endl;//XXX
+							DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Tier " << tier_id << " --> New Unscaled share: " << new_share;
 							new_share = ::dcs::des::cloud::scale_resource_share(
 											// Reference resource capacity and threshold
 											app.reference_resource(res_category).capacity(),
@@ -2477,8 +2641,8 @@ DCS_DEBUG_TRACE("APP : " << app.id() << " - Tier " << tier_id << " --> New Unsca
 						real_type pred_measure = (ublas::prod(C, ublas::prod(A,x_) + ublas::prod(B,adj_opt_u)) + ublas::prod(D,adj_opt_u))(0);
 						real_type cur_measure = y(0);
 #endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_OUTPUT_DEVIATION
-::std::cerr << "APP: " << app.id() << " - Adjusted Optimal Control u*=> " << adj_opt_u << ::std::endl;//XXX
-::std::cerr << "APP: " << app.id() << " - Expected application response time after adjustment: " << pred_measure << " - Current: " << cur_measure << ::std::endl;//XXX
+						DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Adjusted Optimal Control u*=> " << adj_opt_u;
+						DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Expected application response time after adjustment: " << pred_measure << " - Current: " << cur_measure;
 
 						::std::vector<performance_measure_category> cats(1);
 						cats[0] = response_time_performance_measure;
@@ -2548,8 +2712,8 @@ DCS_DEBUG_TRACE("APP : " << app.id() << " - Tier " << tier_id << " --> New Unsca
 									);
 
 								DCS_DEBUG_TRACE("APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " - Category: " << res_category << " - Actual Output: " << tier_measures_[tier_id].at(response_time_performance_measure)->estimate() << " (Reference-Point: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share);
-::std::cerr << "APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " Actual Output: " << tier_measures_[tier_id].at(response_time_performance_measure)->estimate() << " (Reference-Point: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share << ::std::endl;//XXX
-								ptr_vm->wanted_resource_share(res_category, new_share);
+								DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " Actual Output: " << tier_measures_[tier_id].at(response_time_performance_measure)->estimate() << " (Reference-Point: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share;
+								this->wanted_resource_share(ptr_vm, res_category, new_share);
 							}
 						}
 						else
@@ -2620,7 +2784,7 @@ DCS_DEBUG_TRACE("APP : " << app.id() << " - Tier " << tier_id << " --> New Unsca
 							real_type new_share(opt_u(u_offset_+tier_id));
 #endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_INPUT_DEVIATION
 DCS_DEBUG_TRACE("APP : " << app.id() << " - Tier " << tier_id << " --> New Unscaled share: " << new_share);//XXX
-::std::cerr << "APP : " << app.id() << " - Tier " << tier_id << " --> New Unscaled share: " << new_share << ::std::endl;//XXX
+							DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP : " << app.id() << " - Tier " << tier_id << " --> New Unscaled share: " << new_share;
 //							new_share = ::dcs::des::cloud::scale_resource_share(
 //											// Reference resource capacity and threshold
 //											app.reference_resource(res_category).capacity(),
@@ -2693,13 +2857,13 @@ DCS_DEBUG_TRACE("APP : " << app.id() << " - Tier " << tier_id << " --> New Unsca
 
 #if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT)
 							DCS_DEBUG_TRACE("APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " Actual Output: " << tier_measures_[tier_id].at(response_time_performance_measure)->estimate() << " (Equilibrium-Point: " << tier_eq_out_measures_[tier_id] << " - Reference-Point: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share << " (Equilibrium-Point: " << ::dcs::des::cloud::scale_resource_share(app.reference_resource(res_category).capacity(), pm.resource(res_category)->capacity(), tier_eq_in_measures_[tier_id]) << " - Reference-Point: " << ptr_vm->guest_system().resource_share(res_category) << ")");
-::std::cerr << "APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " Actual Output: " << tier_measures_[tier_id].at(response_time_performance_measure)->estimate() << " (Equilibrium-Point: " << tier_eq_out_measures_[tier_id] << " - Reference-Point: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share << " (Equilibrium-Point: " << ::dcs::des::cloud::scale_resource_share(app.reference_resource(res_category).capacity(), pm.resource(res_category)->capacity(), tier_eq_in_measures_[tier_id]) << " - Reference-Point: " << ptr_vm->guest_system().resource_share(res_category) << ")" << ::std::endl;//XXX
+							DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " Actual Output: " << tier_measures_[tier_id].at(response_time_performance_measure)->estimate() << " (Equilibrium-Point: " << tier_eq_out_measures_[tier_id] << " - Reference-Point: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share << " (Equilibrium-Point: " << ::dcs::des::cloud::scale_resource_share(app.reference_resource(res_category).capacity(), pm.resource(res_category)->capacity(), tier_eq_in_measures_[tier_id]) << " - Reference-Point: " << ptr_vm->guest_system().resource_share(res_category) << ")";
 #else // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT
 							DCS_DEBUG_TRACE("APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " - Category: " << res_category << " - Actual Output: " << tier_measures_[tier_id].at(response_time_performance_measure)->estimate() << " (Reference-Point: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share);
-::std::cerr << "APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " Actual Output: " << tier_measures_[tier_id].at(response_time_performance_measure)->estimate() << " (Reference-Point: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share << ::std::endl;//XXX
+							DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " Actual Output: " << tier_measures_[tier_id].at(response_time_performance_measure)->estimate() << " (Reference-Point: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share;
 #endif // DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_DYNAMIC_EQUILIBRIUM_POINT
 
-							ptr_vm->wanted_resource_share(res_category, new_share);
+							this->wanted_resource_share(ptr_vm, res_category, new_share);
 						}
 					}
 
@@ -2717,7 +2881,7 @@ DCS_DEBUG_TRACE("APP : " << app.id() << " - Tier " << tier_id << " --> New Unsca
 							if (!seen_machs.count(pm_id))
 							{
 								seen_machs.insert(pm_id);
-								this->application().data_centre().physical_machine_controller(pm_id).control();
+								this->control_physical_machine(pm_id);
 							}
 						}
 DCS_DEBUG_TRACE("Optimal control applied");//XXX
@@ -2859,7 +3023,7 @@ DCS_DEBUG_TRACE("Optimal control applied");//XXX
 
 //if (((count_-1) % 1000) == 0)//XXX
 //{//XXX
-::std::cerr << "APP: " << this->application().id() << " - END Process CONTROL event -- Actual Output: " << measures_.at(response_time_performance_measure)->estimate() << " (Clock: " << ctx.simulated_time() << " - Counts: " << count_ << "/" << ident_fail_count_ << "/" << ctrl_fail_count_ << ")" << ::std::endl;//XXX
+		DCS_DES_CLOUD_TRACE(app_controller, info) << "APP: " << this->application().id() << " - END Process CONTROL event -- Actual Output: " << measures_.at(response_time_performance_measure)->estimate() << " (Clock: " << ctx.simulated_time() << " - Counts: " << count_ << "/" << ident_fail_count_ << "/" << ctrl_fail_count_ << ")";
 //}//XXX
 
 		DCS_DEBUG_TRACE("(" << this << ") END Do Process CONTROL event (Clock: " << ctx.simulated_time() << " - Count: " << count_ << "/" << ident_fail_count_ << "/" << ctrl_fail_count_ << ")");
@@ -2993,6 +3157,7 @@ class lqi_application_controller: public detail::lq_application_controller<Trait
 //	public: typedef base_system_identification_strategy_params<traits_type> system_identification_strategy_params_type;
 //	public: typedef ::dcs::shared_ptr<system_identification_strategy_params_type> system_identification_strategy_params_pointer;
 	private: typedef ::dcs::control::dlqi_controller<real_type> lq_controller_type;
+	private: typedef detail::lq_design_cache<real_type> design_cache_type;
 	private: typedef typename base_type::vector_type vector_type;
 	private: typedef typename base_type::matrix_type matrix_type;
 	private: typedef typename traits_type::des_engine_type des_engine_type;
@@ -3054,6 +3219,24 @@ class lqi_application_controller: public detail::lq_application_controller<Trait
 	}
 
 
+	/**
+	 * \brief Set the relative tolerance within which the identified system is
+	 *  considered unchanged and the last LQI gain is reused.
+	 *
+	 * A zero tolerance recomputes the gain whenever the system changes.
+	 */
+	public: void gain_cache_tolerance(real_type tol)
+	{
+		design_cache_.tolerance(tol);
+	}
+
+
+	public: real_type gain_cache_tolerance() const
+	{
+		return design_cache_.tolerance();
+	}
+
+
 	protected: void do_process_sys_init(des_event_type const& evt, des_engine_context_type& ctx)
 	{
 		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( evt );
@@ -3064,11 +3247,19 @@ class lqi_application_controller: public detail::lq_application_controller<Trait
 		base_type::do_process_sys_init(evt, ctx);
 
 		xi_ = vector_type(1,0);
+		design_cache_.reset();
 
 		DCS_DEBUG_TRACE("(" << this << ") END Do Process SYSTEM-INITIALIZATION event (Clock: " << ctx.simulated_time() << ")");
 	}
 
 
+	/// The identification and the LQI design only involve this controller.
+	private: bool do_concurrent_control() const
+	{
+		return true;
+	}
+
+
 	private: vector_type do_optimal_control(vector_type const& x, vector_type const& u, vector_type const& y, matrix_type const& A, matrix_type const& B, matrix_type const& C, matrix_type const& D)
 	{
 		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( u );
@@ -3095,7 +3286,6 @@ class lqi_application_controller: public detail::lq_application_controller<Trait
 		//
 
 		uint_type nx(ublasx::size(x));
-		uint_type nu(ublasx::size(u));
 		uint_type ny(ublasx::size(y));
 		uint_type nz(nx+ny);
 
@@ -3130,11 +3320,27 @@ class lqi_application_controller: public detail::lq_application_controller<Trait
 		vector_type z(nz);
 		ublas::subrange(z, 0, nx) = x;
 		ublas::subrange(z, nx, nz) = xi_;
-::std::cerr << "APP: " << this->application().id() << " - Control Error: " << (r-y) << " - xi=" << xi_ << " - Extended State: " << z << ::std::endl;//XXX
+		DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << this->application().id() << " - Control Error: " << (r-y) << " - xi=" << xi_ << " - Extended State: " << z;
 
 		vector_type opt_u;
 
-		controller_.solve(A, B, C, D, ts);
+		// Redesign only if the identified system has moved away from the one
+		// the current gain has been computed for.
+		if (!design_cache_.matches(A, B, C, D))
+		{
+			design_cache_.reset();
+
+			controller_.solve(A, B, C, D, ts);
+
+			if (!design_cache_.store(A, B, C, D))
+			{
+				DCS_EXCEPTION_THROW( ::std::runtime_error, "Cannot compute equilibrium control input: Rosenbrock's system matrix is not invertible" );
+			}
+		}
+		else
+		{
+			DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << this->application().id() << " - Reusing cached LQI gain";
+		}
 
 //::std::cerr << "[dcs::des::cloud::lqi_controller] z: " << z << ::std::endl;//XXX
 //::std::cerr << "[dcs::des::cloud::lqi_controller] K: " << controller_.gain() << ::std::endl;//XXX
@@ -3142,30 +3348,9 @@ class lqi_application_controller: public detail::lq_application_controller<Trait
 //::std::cerr << "[dcs::des::cloud::lqi_controller] e: " << controller_.eigenvalues() << ::std::endl;//XXX
 		opt_u = ublas::real(controller_.control(z));
 
-		uint_type ncp(nx+nu);
-		uint_type nrp(nx+ny);
-		matrix_type P(nrp, ncp, 0);
-		ublas::subrange(P, 0, nx, 0, nx) = ublas::identity_matrix<real_type>(nx, nx) - A;
-		ublas::subrange(P, 0, nx, nx, ncp) = B;
-		ublas::subrange(P, nx, nrp, 0, nx) = -C;
-		ublas::subrange(P, nx, nrp, nx, ncp) = D;
-		matrix_type Pt(ublas::trans(P));
-		matrix_type PP(ublas::prod(P, Pt));
-		bool inv = ublasx::inv_inplace(PP);
-		if (inv)
-		{
-			PP = ublas::prod(Pt, PP);
-			vector_type yd(nrp,0);
-			ublas::subrange(yd, nx, nrp) = r;
-			vector_type xdud(ublas::prod(PP, yd));
-			::std::cerr << "COMPENSATION: P=" << P << " ==> (xd,ud)=" << xdud << ", opt_u=" << opt_u << ::std::endl;//XXX
-			opt_u = opt_u + ublas::subrange(xdud, nx, ncp);
-			::std::cerr << "COMPENSATION: P=" << P << " ==> (xd,ud)=" << xdud << ", NEW opt_u=" << opt_u << ::std::endl;//XXX
-		}
-		else
-		{
-			DCS_EXCEPTION_THROW( ::std::runtime_error, "Cannot compute equilibrium control input: Rosenbrock's system matrix is not invertible" );
-		}
+		DCS_DES_CLOUD_TRACE(app_controller, debug) << "COMPENSATION: Kr=" << design_cache_.reference_gain() << ", r=" << r << ", opt_u=" << opt_u;
+		opt_u = opt_u + ublas::prod(design_cache_.reference_gain(), r);
+		DCS_DES_CLOUD_TRACE(app_controller, debug) << "COMPENSATION: Kr=" << design_cache_.reference_gain() << ", r=" << r << ", NEW opt_u=" << opt_u;
 
 		return opt_u;
 	}
@@ -3175,6 +3360,8 @@ class lqi_application_controller: public detail::lq_application_controller<Trait
 	private: lq_controller_type controller_;
 	/// The integrated control error.
 	private: vector_type xi_;
+	/// The last LQI design.
+	private: design_cache_type design_cache_;
 }; // lqi_application_controller
 
 
@@ -3301,8 +3488,12 @@ class lqr_application_controller: public detail::lq_application_controller<Trait
 	public: typedef typename base_type::system_identification_strategy_params_pointer system_identification_strategy_params_pointer;
 	public: typedef typename base_type::triggers_type triggers_type;
 	private: typedef ::dcs::control::dlqr_controller<real_type> lq_controller_type;
+	private: typedef detail::lq_design_cache<real_type> design_cache_type;
 	private: typedef typename base_type::vector_type vector_type;
 	private: typedef typename base_type::matrix_type matrix_type;
+	private: typedef typename traits_type::des_engine_type des_engine_type;
+	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::event_type des_event_type;
+	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::engine_context_type des_engine_context_type;
 
 
 	public: lqr_application_controller()
@@ -3356,6 +3547,46 @@ class lqr_application_controller: public detail::lq_application_controller<Trait
 	}
 
 
+	/**
+	 * \brief Set the relative tolerance within which the identified system is
+	 *  considered unchanged and the last LQR gain is reused.
+	 *
+	 * A zero tolerance recomputes the gain whenever the system changes.
+	 */
+	public: void gain_cache_tolerance(real_type tol)
+	{
+		design_cache_.tolerance(tol);
+	}
+
+
+	public: real_type gain_cache_tolerance() const
+	{
+		return design_cache_.tolerance();
+	}
+
+
+	protected: void do_process_sys_init(des_event_type const& evt, des_engine_context_type& ctx)
+	{
+		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( evt );
+		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( ctx );
+
+		DCS_DEBUG_TRACE("(" << this << ") BEGIN Do Process SYSTEM-INITIALIZATION event (Clock: " << ctx.simulated_time() << ")");
+
+		base_type::do_process_sys_init(evt, ctx);
+
+		design_cache_.reset();
+
+		DCS_DEBUG_TRACE("(" << this << ") END Do Process SYSTEM-INITIALIZATION event (Clock: " << ctx.simulated_time() << ")");
+	}
+
+
+	/// The identification and the LQR design only involve this controller.
+	private: bool do_concurrent_control() const
+	{
+		return true;
+	}
+
+
 	private: vector_type do_optimal_control(vector_type const& x, vector_type const& u, vector_type const& y, matrix_type const& A, matrix_type const& B, matrix_type const& C, matrix_type const& D)
 	{
 		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( u );
@@ -3366,52 +3597,6 @@ class lqr_application_controller: public detail::lq_application_controller<Trait
 		namespace ublas = ::boost::numeric::ublas;
 		namespace ublasx = ::boost::numeric::ublasx;
 
-//		// Check: if (A,B) is controllable, then the associated DARE has a
-//		//        positive semidefinite solution.
-//		//        (sufficient but not necessary condition)
-//		if (!::dcs::control::is_controllable(A, B))
-//		{
-//			//throw ::std::runtime_error("System (A,B) is not state-controllable");
-//			::std::clog << "[Warning:lq_app_ctrl] System (A,B) is not state-controllable [with A=" << A << " and B=" << B << "]." << ::std::endl;
-//		}
-		// Check: if (A,B) is stabilizable, then the assoicated DARE has a
-		//        positive semidefinite solution.
-		//        (sufficient and necessary condition)
-		if (!::dcs::control::is_stabilizable(A, B, true))
-		{
-			::std::ostringstream oss;
-			oss << "APP: " << this->application().id() << " - System (A,B) is not stabilizable (the associated DARE cannot have a positive semidefinite solution) [with A=" << A << " and B=" << B << "]";
-			log_warn(base_type::cls_id_, oss.str());
-			throw ::std::runtime_error("System (A,B) is not stabilizable (DARE cannot have a positive semidefinite solution).");
-		}
-//		// Check: if (A,B) controllable and (Q,A) observable, then the
-//		//        associated DARE has a unique and stabilizing solution such
-//		//        that the closed-loop system:
-//		//          x(k+1) = Ax(k) + Bu(k) = (A + BK)x(k)
-//		//        is stable (K is the LQR-optimal state feedback gain).
-//		//        (sufficient but not necessary condition)
-//		if (!::dcs::control::is_observable(A, controller_.Q()))
-//		{
-//			//throw ::std::runtime_error("System (A,Q) is not observable (closed-loop system will not be stable).");
-//			::std::clog << "[Warning:lq_app_ctrl] System (Q,A) is not observable (closed-loop system will not be stable) [with " << A << " and B=" << B << "]." << ::std::endl;
-//		}
-		// Check: if (A,B) stabilizable and (Q,A) detectable, then the
-		//        associated DARE has a unique and stabilizing solution such
-		//        that the closed-loop system:
-		//          x(k+1) = Ax(k) + Bu(k) = (A + BK)x(k)
-		//        is stable (K is the LQR-optimal state feedback gain).
-		//        (sufficient and necessary condition)
-		if (!::dcs::control::is_detectable(A, controller_.Q(), true))
-		{
-			::std::ostringstream oss;
-			oss << "APP: " << this->application().id() << " - System (Q,A) is not detectable (closed-loop system will not be stable) [with " << A << " and Q=" << controller_.Q() << "]";
-			log_warn(base_type::cls_id_, oss.str());
-			throw ::std::runtime_error("System (Q,A) is not detectable (closed-loop system will not be stable).");
-		}
-
-
-		uint_type nx(ublas::num_columns(A));
-		uint_type nu(ublas::num_columns(B));
 		uint_type ny(ublas::num_rows(C));
 
 #if defined(DCS_DES_CLOUD_EXP_LQ_APP_CONTROLLER_USE_OUTPUT_DEVIATION)
@@ -3434,35 +3619,73 @@ class lqr_application_controller: public detail::lq_application_controller<Trait
 
 		vector_type opt_u;
 
-		controller_.solve(A, B);
-		opt_u = ublas::real(controller_.control(x));
+		// Redesign only if the identified system has moved away from the one
+		// the current gain has been computed for.
+		if (!design_cache_.matches(A, B, C, D))
+		{
+			design_cache_.reset();
 
-		uint_type ncp(nx+nu);
-		uint_type nrp(nx+ny);
+//			// Check: if (A,B) is controllable, then the associated DARE has a
+//			//        positive semidefinite solution.
+//			//        (sufficient but not necessary condition)
+//			if (!::dcs::control::is_controllable(A, B))
+//			{
+//				//throw ::std::runtime_error("System (A,B) is not state-controllable");
+//				::std::clog << "[Warning:lq_app_ctrl] System (A,B) is not state-controllable [with A=" << A << " and B=" << B << "]." << ::std::endl;
+//			}
+			// Check: if (A,B) is stabilizable, then the assoicated DARE has a
+			//        positive semidefinite solution.
+			//        (sufficient and necessary condition)
+			if (!::dcs::control::is_stabilizable(A, B, true))
+			{
+				::std::ostringstream oss;
+				oss << "APP: " << this->application().id() << " - System (A,B) is not stabilizable (the associated DARE cannot have a positive semidefinite solution) [with A=" << A << " and B=" << B << "]";
+				log_warn(base_type::cls_id_, oss.str());
+				throw ::std::runtime_error("System (A,B) is not stabilizable (DARE cannot have a positive semidefinite solution).");
+			}
+//			// Check: if (A,B) controllable and (Q,A) observable, then the
+//			//        associated DARE has a unique and stabilizing solution such
+//			//        that the closed-loop system:
+//			//          x(k+1) = Ax(k) + Bu(k) = (A + BK)x(k)
+//			//        is stable (K is the LQR-optimal state feedback gain).
+//			//        (sufficient but not necessary condition)
+//			if (!::dcs::control::is_observable(A, controller_.Q()))
+//			{
+//				//throw ::std::runtime_error("System (A,Q) is not observable (closed-loop system will not be stable).");
+//				::std::clog << "[Warning:lq_app_ctrl] System (Q,A) is not observable (closed-loop system will not be stable) [with " << A << " and B=" << B << "]." << ::std::endl;
+//			}
+			// Check: if (A,B) stabilizable and (Q,A) detectable, then the
+			//        associated DARE has a unique and stabilizing solution such
+			//        that the closed-loop system:
+			//          x(k+1) = Ax(k) + Bu(k) = (A + BK)x(k)
+			//        is stable (K is the LQR-optimal state feedback gain).
+			//        (sufficient and necessary condition)
+			if (!::dcs::control::is_detectable(A, controller_.Q(), true))
+			{
+				::std::ostringstream oss;
+				oss << "APP: " << this->application().id() << " - System (Q,A) is not detectable (closed-loop system will not be stable) [with " << A << " and Q=" << controller_.Q() << "]";
+				log_warn(base_type::cls_id_, oss.str());
+				throw ::std::runtime_error("System (Q,A) is not detectable (closed-loop system will not be stable).");
+			}
 
-		matrix_type P(nrp, ncp, 0);
-		ublas::subrange(P, 0, nx, 0, nx) = ublas::identity_matrix<real_type>(nx, nx) - A;
-		ublas::subrange(P, 0, nx, nx, ncp) = B;
-		ublas::subrange(P, nx, nrp, 0, nx) = -C;
-		ublas::subrange(P, nx, nrp, nx, ncp) = D;
-		matrix_type Pt(ublas::trans(P));
-		matrix_type PP(ublas::prod(P, Pt));
-		bool inv = ublasx::inv_inplace(PP);
-		if (inv)
-		{
-			PP = ublas::prod(Pt, PP);
-			vector_type yd(nrp,0);
-			ublas::subrange(yd, nx, nrp) = r;
-			vector_type xdud(ublas::prod(PP, yd));
-			::std::cerr << "COMPENSATION: P=" << P << " ==> (xd,ud)=" << xdud << ", opt_u=" << opt_u << ::std::endl;//XXX
-			opt_u = opt_u + ublas::subrange(xdud, nx, ncp);
-			::std::cerr << "COMPENSATION: P=" << P << " ==> (xd,ud)=" << xdud << ", NEW opt_u=" << opt_u << ::std::endl;//XXX
+			controller_.solve(A, B);
+
+			if (!design_cache_.store(A, B, C, D))
+			{
+				DCS_EXCEPTION_THROW( ::std::runtime_error, "Cannot compute equilibrium control input: Rosenbrock's system matrix is not invertible" );
+			}
 		}
 		else
 		{
-			DCS_EXCEPTION_THROW( ::std::runtime_error, "Cannot compute equilibrium control input: Rosenbrock's system matrix is not invertible" );
+			DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << this->application().id() << " - Reusing cached LQR gain";
 		}
 
+		opt_u = ublas::real(controller_.control(x));
+
+		DCS_DES_CLOUD_TRACE(app_controller, debug) << "COMPENSATION: Kr=" << design_cache_.reference_gain() << ", r=" << r << ", opt_u=" << opt_u;
+		opt_u = opt_u + ublas::prod(design_cache_.reference_gain(), r);
+		DCS_DES_CLOUD_TRACE(app_controller, debug) << "COMPENSATION: Kr=" << design_cache_.reference_gain() << ", r=" << r << ", NEW opt_u=" << opt_u;
+
 		return opt_u;
 	}
 
@@ -3591,6 +3814,8 @@ class lqr_application_controller: public detail::lq_application_controller<Trait
 
 	/// The LQ (regulator) controller
 	private: lq_controller_type controller_;
+	/// The last LQR design.
+	private: design_cache_type design_cache_;
 }; // lqr_application_controller
 
 
@@ -3660,6 +3885,13 @@ class lqry_application_controller: public detail::lq_application_controller<Trai
 	}
 
 
+	/// The identification and the LQRY design only involve this controller.
+	private: bool do_concurrent_control() const
+	{
+		return true;
+	}
+
+
 	private: vector_type do_optimal_control(vector_type const& x, vector_type const& u, vector_type const& y, matrix_type const& A, matrix_type const& B, matrix_type const& C, matrix_type const& D)
 	{
 		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( u );
@@ -3751,9 +3983,9 @@ class lqry_application_controller: public detail::lq_application_controller<Trai
 			vector_type yd(nrp,0);
 			ublas::subrange(yd, nx, nrp) = r;
 			vector_type xdud(ublas::prod(PP, yd));
-			::std::cerr << "COMPENSATION: P=" << P << " ==> (xd,ud)=" << xdud << ", opt_u=" << opt_u << ::std::endl;//XXX
+			DCS_DES_CLOUD_TRACE(app_controller, debug) << "COMPENSATION: P=" << P << " ==> (xd,ud)=" << xdud << ", opt_u=" << opt_u;
 			opt_u = opt_u + ublas::subrange(xdud, nx, ncp);
-			::std::cerr << "COMPENSATION: P=" << P << " ==> (xd,ud)=" << xdud << ", NEW opt_u=" << opt_u << ::std::endl;//XXX
+			DCS_DES_CLOUD_TRACE(app_controller, debug) << "COMPENSATION: P=" << P << " ==> (xd,ud)=" << xdud << ", NEW opt_u=" << opt_u;
 		}
 		else
 		{
@@ -65,6 +65,7 @@
 #include <dcs/des/cloud/physical_resource_category.hpp>
 #include <dcs/des/cloud/registry.hpp>
 #include <dcs/des/cloud/system_identification_strategy_params.hpp>
+#include <dcs/des/cloud/trace.hpp>
 #include <dcs/des/cloud/utility.hpp>
 #include <dcs/exception.hpp>
 #include <dcs/functional/bind.hpp>
@@ -254,6 +255,7 @@ class lq_application_controller: public base_application_controller<TraitsT>,
 	private: typedef typename base_type::application_type application_type;
 	private: typedef typename application_type::simulation_model_type application_simulation_model_type;
 	private: typedef typename application_simulation_model_type::user_request_type user_request_type;
+	private: typedef typename application_simulation_model_type::user_request_view_type user_request_view_type;
 	private: typedef typename application_simulation_model_type::virtual_machine_type virtual_machine_type;
 	private: typedef ::dcs::shared_ptr<virtual_machine_type> virtual_machine_pointer;
 	private: typedef typename application_type::application_tier_type application_tier_type;
@@ -735,7 +737,7 @@ class lq_application_controller: public base_application_controller<TraitsT>,
 
 		found_departure_ = true;
 
-		user_request_type req = app.simulation_model().request_state(evt);
+		user_request_view_type req(app.simulation_model().request_view(evt));
 
 		real_type app_rt(0);
 
@@ -774,16 +776,9 @@ class lq_application_controller: public base_application_controller<TraitsT>,
 							//      response time.
 
 							// Compute the residence time for this tier
-							::std::vector<real_type> arr_times(req.tier_arrival_times(tier_id));
-							::std::vector<real_type> dep_times(req.tier_departure_times(tier_id));
-							size_type nt(arr_times.size());
-							if (nt > 0)
+							if (req.tier_num_visits(tier_id) > 0)
 							{
-								real_type rt(0);
-								for (size_type t = 0; t < nt; ++t)
-								{
-									rt += dep_times[t]-arr_times[t];
-								}
+								real_type rt(req.tier_residence_time(tier_id));
 								// Apply the EWMA filter to previously observed measurements
 								measure = ewma_smooth_*rt + (1-ewma_smooth_)*measure;
 								app_rt += rt;
@@ -1075,13 +1070,13 @@ DCS_DEBUG_TRACE("p_hat=" << p_hat);//XXX
 DCS_DEBUG_TRACE("Theta_hat=" << ptr_ident_strategy_->Theta_hat());//XXX
 DCS_DEBUG_TRACE("P=" << ptr_ident_strategy_->P());//XXX
 DCS_DEBUG_TRACE("phi=" << ptr_ident_strategy_->phi());//XXX
-::std::cerr << "APP: " << app.id() << " - RLS estimation:" << ::std::endl;//XXX
-::std::cerr << "p=" << p << ::std::endl;//XXX
-::std::cerr << "s=" << s << ::std::endl;//XXX
-::std::cerr << "p_hat=" << p_hat << ::std::endl;//XXX
-::std::cerr << "Theta_hat=" << ptr_ident_strategy_->Theta_hat() << ::std::endl;//XXX
-::std::cerr << "P=" << ptr_ident_strategy_->P() << ::std::endl;//XXX
-::std::cerr << "phi=" << ptr_ident_strategy_->phi() << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - RLS estimation:";
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "p=" << p;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "s=" << s;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "p_hat=" << p_hat;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "Theta_hat=" << ptr_ident_strategy_->Theta_hat();
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "P=" << ptr_ident_strategy_->P();
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "phi=" << ptr_ident_strategy_->phi();
 
 				if (!ublasx::all(ublasx::isfinite(ptr_ident_strategy_->Theta_hat())))
 				{
@@ -1128,14 +1123,14 @@ DCS_DEBUG_TRACE("D=" << D);//XXX
 DCS_DEBUG_TRACE("y= " << y);//XXX
 DCS_DEBUG_TRACE("x= " << x_);//XXX
 DCS_DEBUG_TRACE("u= " << u_);//XXX
-::std::cerr << "APP: " << app.id() << " - Solving LQ with" << ::std::endl;//XXX
-::std::cerr << "A=" << A << ::std::endl;//XXX
-::std::cerr << "B=" << B << ::std::endl;//XXX
-::std::cerr << "C=" << C << ::std::endl;//XXX
-::std::cerr << "D=" << D << ::std::endl;//XXX
-::std::cerr << "y= " << y << ::std::endl;//XXX
-::std::cerr << "x= " << x_ << ::std::endl;//XXX
-::std::cerr << "u= " << u_ << ::std::endl;//XXX
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Solving LQ with";
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "A=" << A;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "B=" << B;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "C=" << C;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "D=" << D;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "y= " << y;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "x= " << x_;
+				DCS_DES_CLOUD_TRACE(app_controller, debug) << "u= " << u_;
 				vector_type opt_u;
 				try
 				{
@@ -1163,9 +1158,9 @@ DCS_DEBUG_TRACE("u= " << u_);//XXX
 				{
 DCS_DEBUG_TRACE("APP: " << app.id() << " - Solved!");//XXX
 DCS_DEBUG_TRACE("APP: " << app.id() << " - Optimal Control u*=> " << opt_u);//XXX
-::std:: cerr << "APP: " << app.id() << " - Optimal Control u*=> " << opt_u << ::std::endl;//XXX
+DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Optimal Control u*=> " << opt_u;
 DCS_DEBUG_TRACE("APP: " << app.id() << " - Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0)));//XXX
-::std::cerr << "APP: " << app.id() << " Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0)) << ::std::endl;//XXX
+DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " Expected application response time: " << (app_perf_model.application_measure(response_time_performance_measure)+(ublas::prod(C, ublas::prod(A,x_)+ublas::prod(B,opt_u))+ublas::prod(D,opt_u))(0));
 
 DCS_DEBUG_TRACE("Applying optimal control");//XXX
 					if (triggers_.predicted_value_sla_ko())
@@ -1211,7 +1206,7 @@ DCS_DEBUG_TRACE("Applying optimal control");//XXX
 							}
 
 //							DCS_DEBUG_TRACE("APP: " << app.id() << " - Assigning new wanted share: VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << " - Category: " << res_category << " - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> Share: " << new_share);
-::std::cerr << "APP: " << app.id() << " - Assigning new wanted share: VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << " - Category: " << res_category << " - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> Share: " << new_share << ::std::endl;//XXX
+							DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Assigning new wanted share: VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << " - Category: " << res_category << " - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> Share: " << new_share;
 
 							new_share = ::dcs::des::cloud::scale_resource_share(
 											// Actual resource capacity and threshold
@@ -1233,8 +1228,8 @@ DCS_DEBUG_TRACE("Applying optimal control");//XXX
 						real_type pred_measure = app_perf_model.application_measure(response_time_performance_measure)
 						//real_type pred_measure = static_cast<real_type>(.5)*app_perf_model.application_measure(response_time_performance_measure)//EXP
 												 + (ublas::prod(C, ublas::prod(A,x_)+ ublas::prod(B,opt_u))+ublas::prod(D,adj_opt_u))(0);
-::std::cerr << "APP: " << app.id() << " - Adjusted Optimal Control u*=> " << adj_opt_u << ::std::endl;//XXX
-::std::cerr << "APP: " << app.id() << " - Expected application response time: " << pred_measure << ::std::endl;//XXX
+						DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Adjusted Optimal Control u*=> " << adj_opt_u;
+						DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - Expected application response time: " << pred_measure;
 
 						::std::vector<performance_measure_category> cats(1);
 						cats[0] = response_time_performance_measure;
@@ -1263,7 +1258,7 @@ DCS_DEBUG_TRACE("Applying optimal control");//XXX
 									);
 
 								DCS_DEBUG_TRACE("APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " - Category: " << res_category << " - Actual Output: " << ewma_tier_s_[tier_id].at(response_time_performance_measure) << " (REF: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share);
-::std::cerr << "APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " Actual Output: " << ewma_tier_s_[tier_id].at(response_time_performance_measure) << " (REF: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share << ::std::endl;//XXX
+								DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " Actual Output: " << ewma_tier_s_[tier_id].at(response_time_performance_measure) << " (REF: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share;
 								ptr_vm->wanted_resource_share(res_category, new_share);
 							}
 						}
@@ -1316,7 +1311,7 @@ DCS_DEBUG_TRACE("Applying optimal control");//XXX
 							}
 
 							DCS_DEBUG_TRACE("APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " - Category: " << res_category << " - Actual Output: " << ewma_tier_s_[tier_id].at(response_time_performance_measure) << " (REF: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share);
-::std::cerr << "APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " Actual Output: " << ewma_tier_s_[tier_id].at(response_time_performance_measure) << " (REF: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share << ::std::endl;//XXX
+							DCS_DES_CLOUD_TRACE(app_controller, debug) << "APP: " << app.id() << " - VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Tier: " << tier_id << ": " << res_category << " Actual Output: " << ewma_tier_s_[tier_id].at(response_time_performance_measure) << " (REF: " << app_perf_model.tier_measure(tier_id, response_time_performance_measure) << ") - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share;
 
 							ptr_vm->wanted_resource_share(res_category, new_share);
 						}
@@ -1365,7 +1360,7 @@ DCS_DEBUG_TRACE("Optimal control applied");//XXX
 		reset_measures();
 
 		DCS_DEBUG_TRACE("APP: " << app.id() << " - Control stats: Count: " << count_ << " - Identification Failure Count: " << ident_fail_count_ << " - Control Failures Count: " << ctrl_fail_count_);
-::std::cerr << "APP: " << app.id() << " - Control stats: Count: " << count_ << " - Identification Failure Count: " << ident_fail_count_ << " - Control Failures Count: " << ctrl_fail_count_ << ::std::endl;
+		DCS_DES_CLOUD_TRACE(app_controller, info) << "APP: " << app.id() << " - Control stats: Count: " << count_ << " - Identification Failure Count: " << ident_fail_count_ << " - Control Failures Count: " << ctrl_fail_count_;
 
 		DCS_DEBUG_TRACE("(" << this << ") END Do Process CONTROL event (Clock: " << ctx.simulated_time() << " - Count: " << count_ << ")");
 	}
@@ -0,0 +1,533 @@
+/**
+ * \file dcs/des/cloud/mser_mean_estimator.hpp
+ *
+ * \brief Mean estimator with automatic truncation of the initial transient by
+ *  means of the MSER rule.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_MSER_MEAN_ESTIMATOR_HPP
+#define DCS_DES_CLOUD_MSER_MEAN_ESTIMATOR_HPP
+
+
+#include <boost/math/distributions/students_t.hpp>
+#include <cmath>
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/des/base_statistic.hpp>
+#include <dcs/des/statistic_categories.hpp>
+#include <dcs/memory.hpp>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace cloud {
+
+/**
+ * \brief Truncation points chosen by a MSER mean estimator over several runs.
+ *
+ * It is shared among all the copies of the same estimator (e.g., the one made
+ * by the DES engine for each replication), so that the truncation point can
+ * be reported along with the estimate.
+ */
+template <typename RealT, typename UIntT>
+struct mser_truncation_summary
+{
+	typedef RealT real_type;
+	typedef UIntT uint_type;
+
+
+	mser_truncation_summary()
+	: num_runs(0),
+	  sum_truncation(0),
+	  has_current(false),
+	  current_truncation(0)
+	{
+	}
+
+
+	/// Return the mean number of discarded observations per run.
+	real_type truncation_point() const
+	{
+		uint_type n(num_runs+(has_current ? 1 : 0));
+
+		if (n == 0)
+		{
+			return 0;
+		}
+
+		return (sum_truncation+(has_current ? current_truncation : 0))/static_cast<real_type>(n);
+	}
+
+
+	/// The number of completed runs.
+	uint_type num_runs;
+	/// The sum of the truncation points of the completed runs.
+	real_type sum_truncation;
+	/// Tell if the current run has a truncation point.
+	bool has_current;
+	/// The truncation point of the current run.
+	uint_type current_truncation;
+};
+
+
+/**
+ * \brief Mean estimator with automatic truncation of the initial transient.
+ *
+ * Observations are grouped into consecutive batches of \c batch_size
+ * observations (5 for the classic MSER-5 rule).
+ * When the estimate is requested, the number \f$d^*\f$ of initial batches to
+ * discard is the one minimizing the Marginal Standard Error
+ * \f[
+ *  \mathrm{MSER}(d) = \frac{1}{(k-d)^2} \sum_{i=d+1}^k (\bar{Y}_i - \bar{\bar{Y}}_{d})^2
+ * \f]
+ * over \f$0 \le d \le k/2\f$, where \f$\bar{Y}_i\f$ is the mean of the
+ * \f$i\f$-th batch and \f$\bar{\bar{Y}}_{d}\f$ is the mean of the last
+ * \f$k-d\f$ batches.
+ * The estimate is then the (weighted) mean of the remaining observations.
+ *
+ * Only the per-batch sums are stored, so memory grows as
+ * \f$n/\mathrm{batch\_size}\f$, and the truncation point is computed in a
+ * single backward pass over them.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename RealT, typename UIntT>
+class mser_mean_estimator: public ::dcs::des::base_statistic<RealT,UIntT>
+{
+	private: typedef ::dcs::des::base_statistic<RealT,UIntT> base_type;
+	public: typedef typename base_type::value_type value_type;
+	public: typedef typename base_type::uint_type uint_type;
+	public: typedef mser_truncation_summary<value_type,uint_type> truncation_summary_type;
+	public: typedef ::dcs::shared_ptr<truncation_summary_type> truncation_summary_pointer;
+	private: typedef ::std::size_t size_type;
+	private: struct batch
+	{
+		value_type sum_wx;
+		value_type sum_wxx;
+		value_type sum_w;
+	};
+	private: typedef ::std::vector<batch> batch_container;
+
+
+	public: static const uint_type default_batch_size = 5;
+
+
+	public: explicit mser_mean_estimator(value_type confidence_level,
+										 uint_type batch_size = default_batch_size,
+										 truncation_summary_pointer const& ptr_summary = truncation_summary_pointer())
+	: conf_level_(confidence_level),
+	  batch_size_(batch_size),
+	  ptr_summary_(ptr_summary),
+	  num_obs_(0),
+	  trunc_batches_(0),
+	  dirty_(false)
+	{
+		// pre: batch_size > 0
+		DCS_ASSERT(
+				batch_size_ > 0,
+				throw ::std::invalid_argument("[dcs::des::cloud::mser_mean_estimator::ctor] Invalid batch size.")
+			);
+
+		clear_batch(cur_);
+		clear_batch(kept_);
+	}
+
+
+	/// Return the number of observations discarded as initial transient.
+	public: uint_type truncation_point() const
+	{
+		update();
+
+		return trunc_batches_*batch_size_;
+	}
+
+
+	/// Return the batch size.
+	public: uint_type batch_size() const
+	{
+		return batch_size_;
+	}
+
+
+	private: static void clear_batch(batch& b)
+	{
+		b.sum_wx = b.sum_wxx = b.sum_w = 0;
+	}
+
+
+	/// Choose the truncation point (if new observations have been collected).
+	private: void update() const
+	{
+		if (!dirty_)
+		{
+			return;
+		}
+
+		const size_type k(batches_.size());
+
+		trunc_batches_ = 0;
+
+		if (k > 1)
+		{
+			value_type s(0);
+			value_type q(0);
+			value_type min_mser(::std::numeric_limits<value_type>::infinity());
+
+			// Backward pass over the batch means: on ties the smallest
+			// truncation point wins
+			for (size_type i = k; i > 0; --i)
+			{
+				const size_type d(i-1);
+				batch const& b(batches_[d]);
+				const value_type y(b.sum_w > 0 ? b.sum_wx/b.sum_w : 0);
+
+				s += y;
+				q += y*y;
+
+				if (2*d > k)
+				{
+					continue;
+				}
+
+				const value_type n(k-d);
+				const value_type mser(::std::max(q-s*s/n, value_type(0))/(n*n));
+				if (mser <= min_mser)
+				{
+					min_mser = mser;
+					trunc_batches_ = d;
+				}
+			}
+		}
+
+		kept_ = cur_;
+		for (size_type i = trunc_batches_; i < k; ++i)
+		{
+			kept_.sum_wx += batches_[i].sum_wx;
+			kept_.sum_wxx += batches_[i].sum_wxx;
+			kept_.sum_w += batches_[i].sum_w;
+		}
+
+		if (ptr_summary_)
+		{
+			ptr_summary_->has_current = true;
+			ptr_summary_->current_truncation = trunc_batches_*batch_size_;
+		}
+
+		dirty_ = false;
+	}
+
+
+	private: uint_type num_kept_observations() const
+	{
+		return num_obs_-trunc_batches_*batch_size_;
+	}
+
+
+	private: void do_collect(value_type obs, value_type weight)
+	{
+		cur_.sum_wx += weight*obs;
+		cur_.sum_wxx += weight*obs*obs;
+		cur_.sum_w += weight;
+		++num_obs_;
+
+		if ((num_obs_ % batch_size_) == 0)
+		{
+			batches_.push_back(cur_);
+			clear_batch(cur_);
+		}
+
+		dirty_ = true;
+	}
+
+
+	private: ::dcs::des::statistic_category do_category() const
+	{
+		return ::dcs::des::mean_statistic;
+	}
+
+
+	private: value_type do_estimate() const
+	{
+		update();
+
+		if (kept_.sum_w <= 0)
+		{
+			return ::std::numeric_limits<value_type>::quiet_NaN();
+		}
+
+		return kept_.sum_wx/kept_.sum_w;
+	}
+
+
+	private: value_type do_variance() const
+	{
+		update();
+
+		const uint_type n(num_kept_observations());
+
+		if (n < 2 || kept_.sum_w <= 0)
+		{
+			return ::std::numeric_limits<value_type>::infinity();
+		}
+
+		const value_type mean(kept_.sum_wx/kept_.sum_w);
+
+		return ::std::max(kept_.sum_wxx/kept_.sum_w-mean*mean, value_type(0))*n/(n-1);
+	}
+
+
+	private: value_type do_standard_deviation() const
+	{
+		return ::std::sqrt(do_variance());
+	}
+
+
+	private: value_type do_half_width() const
+	{
+		update();
+
+		const uint_type n(num_kept_observations());
+
+		if (n < 2)
+		{
+			return ::std::numeric_limits<value_type>::infinity();
+		}
+
+		::boost::math::students_t_distribution<value_type> dist(n-1);
+		value_type t(::boost::math::quantile(::boost::math::complement(dist, (1-conf_level_)/value_type(2))));
+
+		return t*do_standard_deviation()/::std::sqrt(static_cast<value_type>(n));
+	}
+
+
+	private: value_type do_lower() const
+	{
+		return do_estimate()-do_half_width();
+	}
+
+
+	private: value_type do_upper() const
+	{
+		return do_estimate()+do_half_width();
+	}
+
+
+	private: value_type do_relative_precision() const
+	{
+		return do_half_width()/::std::abs(do_estimate());
+	}
+
+
+	private: value_type do_confidence_level() const
+	{
+		return conf_level_;
+	}
+
+
+	private: uint_type do_num_observations() const
+	{
+		return num_obs_;
+	}
+
+
+	private: void do_reset()
+	{
+		// Close the current run
+		if (num_obs_ > 0 && ptr_summary_)
+		{
+			update();
+
+			++ptr_summary_->num_runs;
+			ptr_summary_->sum_truncation += trunc_batches_*batch_size_;
+			ptr_summary_->has_current = false;
+		}
+
+		batches_.clear();
+		clear_batch(cur_);
+		clear_batch(kept_);
+		num_obs_ = 0;
+		trunc_batches_ = 0;
+		dirty_ = false;
+	}
+
+
+	private: ::std::string do_name() const
+	{
+		return "mean";
+	}
+
+
+	/// The level of the confidence interval.
+	private: value_type conf_level_;
+	/// The number of observations in each batch.
+	private: uint_type batch_size_;
+	/// The truncation points chosen so far (possibly shared by copies).
+	private: truncation_summary_pointer ptr_summary_;
+	/// The sums of the complete batches.
+	private: batch_container batches_;
+	/// The sums of the current (incomplete) batch.
+	private: batch cur_;
+	/// The number of collected observations.
+	private: uint_type num_obs_;
+	/// The number of discarded batches.
+	private: mutable size_type trunc_batches_;
+	/// The sums of the observations kept after truncation.
+	private: mutable batch kept_;
+	/// Tell if the truncation point must be recomputed.
+	private: mutable bool dirty_;
+}; // mser_mean_estimator
+
+
+/**
+ * \brief Output statistic which also reports the truncation point chosen by
+ *  a MSER mean estimator.
+ *
+ * It forwards everything to the wrapped output statistic (e.g., the one
+ * built by the DES engine around a \c mser_mean_estimator) and exposes the
+ * truncation points recorded in the shared summary.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename RealT, typename UIntT>
+class mser_truncated_statistic: public ::dcs::des::base_statistic<RealT,UIntT>
+{
+	private: typedef ::dcs::des::base_statistic<RealT,UIntT> base_type;
+	public: typedef typename base_type::value_type value_type;
+	public: typedef typename base_type::uint_type uint_type;
+	public: typedef ::dcs::shared_ptr<base_type> statistic_pointer;
+	public: typedef mser_truncation_summary<value_type,uint_type> truncation_summary_type;
+	public: typedef ::dcs::shared_ptr<truncation_summary_type> truncation_summary_pointer;
+
+
+	public: mser_truncated_statistic(statistic_pointer const& ptr_stat, truncation_summary_pointer const& ptr_summary)
+	: ptr_stat_(ptr_stat),
+	  ptr_summary_(ptr_summary)
+	{
+		// pre: ptr_stat is a valid pointer
+		DCS_ASSERT(
+				ptr_stat_,
+				throw ::std::invalid_argument("[dcs::des::cloud::mser_truncated_statistic::ctor] Invalid statistic.")
+			);
+		// pre: ptr_summary is a valid pointer
+		DCS_ASSERT(
+				ptr_summary_,
+				throw ::std::invalid_argument("[dcs::des::cloud::mser_truncated_statistic::ctor] Invalid truncation summary.")
+			);
+	}
+
+
+	/// Return the mean number of observations discarded per run.
+	public: value_type truncation_point() const
+	{
+		return ptr_summary_->truncation_point();
+	}
+
+
+	private: void do_collect(value_type obs, value_type weight)
+	{
+		(*ptr_stat_)(obs, weight);
+	}
+
+
+	private: ::dcs::des::statistic_category do_category() const
+	{
+		return ptr_stat_->category();
+	}
+
+
+	private: value_type do_estimate() const
+	{
+		return ptr_stat_->estimate();
+	}
+
+
+	private: value_type do_variance() const
+	{
+		return ptr_stat_->variance();
+	}
+
+
+	private: value_type do_standard_deviation() const
+	{
+		return ptr_stat_->standard_deviation();
+	}
+
+
+	private: value_type do_half_width() const
+	{
+		return ptr_stat_->half_width();
+	}
+
+
+	private: value_type do_lower() const
+	{
+		return ptr_stat_->lower();
+	}
+
+
+	private: value_type do_upper() const
+	{
+		return ptr_stat_->upper();
+	}
+
+
+	private: value_type do_relative_precision() const
+	{
+		return ptr_stat_->relative_precision();
+	}
+
+
+	private: value_type do_confidence_level() const
+	{
+		return ptr_stat_->confidence_level();
+	}
+
+
+	private: uint_type do_num_observations() const
+	{
+		return ptr_stat_->num_observations();
+	}
+
+
+	private: void do_reset()
+	{
+		ptr_stat_->reset();
+	}
+
+
+	private: ::std::string do_name() const
+	{
+		return ptr_stat_->name();
+	}
+
+
+	/// The wrapped output statistic.
+	private: statistic_pointer ptr_stat_;
+	/// The truncation points chosen by the underlying estimator.
+	private: truncation_summary_pointer ptr_summary_;
+}; // mser_truncated_statistic
+
+}}} // Namespace dcs::des::cloud
+
+
+#endif // DCS_DES_CLOUD_MSER_MEAN_ESTIMATOR_HPP
@@ -26,7 +26,9 @@
 #define DCS_DES_CLOUD_OPTIMAL_MIGRATION_CONTROLLER_HPP
 
 
+#include <boost/thread/thread.hpp>
 #include <ctime>//XXX
+#include <dcs/assert.hpp>
 #include <dcs/debug.hpp>
 #include <dcs/des/base_statistic.hpp>
 #include <dcs/des/engine_traits.hpp>
@@ -40,12 +42,17 @@
 #include <dcs/des/cloud/logging.hpp>
 #include <dcs/des/cloud/physical_resource_category.hpp>
 #include <dcs/des/cloud/power_status.hpp>
+#include <dcs/des/cloud/registry.hpp>
+#include <dcs/des/cloud/resource_vector.hpp>
 #include <dcs/exception.hpp>
+#include <dcs/functional/bind.hpp>
 #include <dcs/macro.hpp>
 #include <dcs/memory.hpp>
+#include <exception>
 #include <limits>
 #include <map>
 #include <stdexcept>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -56,6 +63,7 @@ template <typename TraitsT>
 class optimal_migration_controller: public base_migration_controller<TraitsT>
 {
 	private: typedef base_migration_controller<TraitsT> base_type;
+	private: typedef optimal_migration_controller<TraitsT> self_type;
 	public: typedef TraitsT traits_type;
 	public: typedef typename traits_type::real_type real_type;
 	public: typedef typename traits_type::uint_type uint_type;
@@ -64,6 +72,8 @@ class optimal_migration_controller: public base_migration_controller<TraitsT>
 	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::event_type des_event_type;
 	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::engine_context_type des_engine_context_type;
 	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::event_source_type des_event_source_type;
+	private: typedef ::dcs::shared_ptr<des_event_source_type> des_event_source_pointer;
+	private: typedef registry<traits_type> registry_type;
 	private: typedef typename base_type::data_center_type data_center_type;
 	private: typedef typename data_center_type::virtual_machines_placement_type virtual_machines_placement_type;
 	private: typedef typename data_center_type::physical_machine_type physical_machine_type;
@@ -83,13 +93,16 @@ class optimal_migration_controller: public base_migration_controller<TraitsT>
 	private: typedef typename traits_type::physical_machine_identifier_type physical_machine_identifier_type;
 	private: typedef typename traits_type::virtual_machine_identifier_type virtual_machine_identifier_type;
 	private: typedef ::std::map<virtual_machine_identifier_type,real_type> virtual_machine_utilization_map;
+	private: typedef ::dcs::shared_ptr< ::boost::thread > thread_pointer;
 
 
 	private: static const ::dcs::des::statistic_category utilization_statistic_category = ::dcs::des::mean_statistic;
+	private: static const ::std::string decision_event_source_name;
 	public: static const real_type default_power_cost_weight;
 	public: static const real_type default_migration_cost_weight;
 	public: static const real_type default_sla_cost_weight;
 	public: static const real_type default_ewma_smoothing_factor;
+	public: static const real_type default_decision_delay;
 
 
 	public: optimal_migration_controller()
@@ -106,9 +119,14 @@ class optimal_migration_controller: public base_migration_controller<TraitsT>
 	  ptr_cost_(new statistic_impl_type()),
 	  ptr_num_migr_(new statistic_impl_type()),
 	  ptr_migr_rate_(new statistic_impl_type()),
-	  ptr_solver_()
+	  ptr_solver_(),
+	  async_(false),
+	  decision_delay_(default_decision_delay),
+	  pending_(false),
+	  pending_num_vms_(0),
+	  ptr_decision_evt_src_(new des_event_source_type(decision_event_source_name))
 	{
-//		init();
+		init();
 	}
 
 
@@ -132,9 +150,14 @@ class optimal_migration_controller: public base_migration_controller<TraitsT>
 	  ptr_cost_(new statistic_impl_type()),
 	  ptr_num_migr_(new statistic_impl_type()),
 	  ptr_migr_rate_(new statistic_impl_type()),
-	  ptr_solver_(detail::make_vm_placement_optimal_solver(solver_params))
+	  ptr_solver_(detail::make_vm_placement_optimal_solver(solver_params)),
+	  async_(false),
+	  decision_delay_(default_decision_delay),
+	  pending_(false),
+	  pending_num_vms_(0),
+	  ptr_decision_evt_src_(new des_event_source_type(decision_event_source_name))
 	{
-//		init();
+		init();
 	}
 
 
@@ -154,9 +177,55 @@ class optimal_migration_controller: public base_migration_controller<TraitsT>
 	}
 
 
-//	public: ~optimal_migration_controller()
-//	{
-//	}
+	public: ~optimal_migration_controller()
+	{
+		finit();
+	}
+
+
+	/**
+	 * \brief Tell if the optimization problem is to be solved asynchronously.
+	 *
+	 * When asynchronous, the problem is solved outside the DES thread while
+	 * the simulation goes on, and the resulting placement is applied later
+	 * (see \c decision_delay).
+	 */
+	public: void async_solver(bool value)
+	{
+		async_ = value;
+	}
+
+
+	public: bool async_solver() const
+	{
+		return async_;
+	}
+
+
+	/**
+	 * \brief Set the simulated time taken to make a placement decision.
+	 *
+	 * Only used when the problem is solved asynchronously.
+	 * With a zero delay, the placement is applied at the next control event.
+	 * Otherwise, it is applied after the given time since the control event,
+	 * and no new problem is solved until then.
+	 */
+	public: void decision_delay(real_type value)
+	{
+		// pre: value >= 0
+		DCS_ASSERT(
+			value >= 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::optimal_migration_controller::decision_delay] Invalid decision delay.")
+		);
+
+		decision_delay_ = value;
+	}
+
+
+	public: real_type decision_delay() const
+	{
+		return decision_delay_;
+	}
 
 
 	//@{ Interface Member Functions
@@ -195,6 +264,9 @@ class optimal_migration_controller: public base_migration_controller<TraitsT>
 			   = uint_type(0);
 		vm_util_map_.clear();
 
+		// Discard the decision still pending from a previous replication (if any)
+		discard_pending_decision();
+
 		DCS_DEBUG_TRACE("(" << this << ") END Do Process SYSTEM-INITIALIZATION event (Clock: " << ctx.simulated_time() << ")");
 	}
 
@@ -206,6 +278,9 @@ class optimal_migration_controller: public base_migration_controller<TraitsT>
 
 		DCS_DEBUG_TRACE("(" << this << ") BEGIN Do Process SYSTEM-FINALIZATION event (Clock: " << ctx.simulated_time() << ")");
 
+		// The simulation is over: a decision still pending is never applied
+		discard_pending_decision();
+
 		(*ptr_num_migr_)(migr_count_);
 		// For migration rate, use the weighted harmonic mean (see the "Workload Book" by Feitelson)
 		(*ptr_migr_rate_)(static_cast<real_type>(migr_rate_num_)/static_cast<real_type>(migr_rate_den_));
@@ -226,13 +301,12 @@ class optimal_migration_controller: public base_migration_controller<TraitsT>
 ::std::string st(::std::asctime(::std::localtime(&t)));
 ::std::cerr << "[optimal_migration_controller] BEGIN Do Process CONTROL event (Clock: " << ctx.simulated_time() << " - Count: " << count_ << " - Fail-Count: " << fail_count_ << " - #Migrations: " << migr_count_ << " - Real-Clock: " << st.substr(0, st.size()-1) <<  " (" << static_cast< unsigned long >(t) << " secs since the Epoch" << "))" << ::std::endl;//XXX
 }//XXX
-		typedef typename optimal_solver_type::problem_result_type optimal_solver_result_type;
 		typedef typename application_tier_type::resource_share_container ref_share_container;
 		//typedef typename optimal_solver_type::resource_share_container share_container;
 #ifdef DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
 		typedef typename base_type::vm_share_observer::share_container share_container;
 #else // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
-		typedef ::std::map<physical_resource_category,real_type> share_container;
+		typedef resource_vector<real_type> share_container;
 #endif // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
 		typedef ::std::vector<physical_machine_pointer> physical_machine_container;
 		typedef typename physical_machine_container::const_iterator physical_machine_iterator;
@@ -251,12 +325,18 @@ class optimal_migration_controller: public base_migration_controller<TraitsT>
 
 		++count_;
 
+		// The decision made since the last control event is ready now
+		if (pending_ && decision_delay_ == 0)
+		{
+			apply_pending_decision();
+		}
+
 		data_center_type& dc(this->controlled_data_center());
 		uint_type num_vms(0);
 		::std::map<typename traits_type::virtual_machine_identifier_type, share_container> wanted_share_map;
 
 		// Update VMs utilization stats
-		virtual_machine_container vms(dc.active_virtual_machines());
+		virtual_machine_container const& vms(dc.active_virtual_machines());
 		virtual_machine_iterator vm_end_it(vms.end());
 		for (virtual_machine_iterator vm_it = vms.begin(); vm_it != vm_end_it; ++vm_it)
 		{
@@ -391,116 +471,37 @@ class optimal_migration_controller: public base_migration_controller<TraitsT>
 //			vms.clear();
 //#endif // DCS_DES_CLOUD_EXP_MIGR_CONTROLLER_MONITOR_VMS
 
-			ptr_solver_->solve(dc, wp_, wm_, ws_, vm_util_map_.begin(), vm_util_map_.end(), wanted_share_map.begin(), wanted_share_map.end());
-
-			// Check solution and act accordingly
+			if (!async_)
+			{
+				ptr_solver_->solve(dc, wp_, wm_, ws_, vm_util_map_.begin(), vm_util_map_.end(), wanted_share_map.begin(), wanted_share_map.end());
 
-			if (ptr_solver_->result().solved())
+				apply_solution(num_vms);
+			}
+			else if (pending_)
+			{
+				// Still waiting for the previous decision
+				log_warn(DCS_DES_CLOUD_LOGGING_AT, "Placement decision still pending. Skip optimization.");
+			}
+			else
 			{
-				typedef typename optimal_solver_result_type::resource_share_container opt_share_container;
-				typedef typename optimal_solver_result_type::physical_virtual_machine_map opt_physical_virtual_machine_map;
-				typedef typename opt_physical_virtual_machine_map::const_iterator opt_physical_virtual_machine_iterator;
+				// Read the problem data now, and solve it while the simulation goes on
 
-				(*ptr_cost_)(ptr_solver_->result().cost());
+				ptr_solver_->prepare(dc, wp_, wm_, ws_, vm_util_map_.begin(), vm_util_map_.end(), wanted_share_map.begin(), wanted_share_map.end());
 
-				virtual_machines_placement_type deployment;
+				solver_error_.clear();
+				ptr_solver_thread_ = ::dcs::make_shared< ::boost::thread >(::dcs::functional::bind(&self_type::run_solver, this));
+				pending_ = true;
+				pending_num_vms_ = num_vms;
 
-				opt_physical_virtual_machine_map pm_vm_map(ptr_solver_->result().placement());
-				opt_physical_virtual_machine_iterator pm_vm_end_it(pm_vm_map.end());
-				for (opt_physical_virtual_machine_iterator pm_vm_it = pm_vm_map.begin(); pm_vm_it != pm_vm_end_it; ++pm_vm_it)
+				if (decision_delay_ > 0)
 				{
-					physical_machine_pointer ptr_pm(dc.physical_machine_ptr(pm_vm_it->first.first));
-					virtual_machine_pointer ptr_vm(dc.virtual_machine_ptr(pm_vm_it->first.second));
-					opt_share_container const& shares(pm_vm_it->second);
-
-					// check: paranoid check
-					DCS_DEBUG_ASSERT( ptr_pm );
-					// check: paranoid check
-					DCS_DEBUG_ASSERT( ptr_vm );
-
-					deployment.place(*ptr_vm,
-									 *ptr_pm,
-									 shares.begin(),
-									 shares.end());
-				}
-
-				uint_type num_migrs(0);
-
-				num_migrs = this->migrate(deployment);
+					registry_type& reg(registry_type::instance());
 
-				migr_count_ += num_migrs;
-				// For migration rate, use the weighted harmonic mean (see the "Workload Book" by Feitelson)
-				migr_rate_den_ += num_vms;
-				migr_rate_num_ += num_migrs;
-
-//			physical_machine_id_map inactive_pms;
-//
-//			// Populate the inactive PMs container with all powered-on machines
-//			{
-//				physical_machine_container active_pms(dc.physical_machines(powered_on_power_status));
-//				physical_machine_iterator pm_end_it(active_pms.end());
-//				for (physical_machine_iterator pm_it = active_pms.begin(); pm_it != pm_end_it; ++pm_it)
-//				{
-//					physical_machine_pointer ptr_pm(*pm_it);
-//
-//					inactive_pms[ptr_pm->id()] = ptr_pm;
-//				}
-//			}
-//
-//			// Migrate VMs
-//			{
-////				dc.displace_active_virtual_machines(false);
-//
-//				physical_virtual_machine_map pm_vm_map(ptr_solver_->result().placement());
-////[XXX]
-//::std::cerr << "CHECK SOLVER PLACEMENT" << ::std::endl;//XXX
-//for (typename physical_virtual_machine_map::const_iterator it = ptr_solver_->result().placement().begin(); it != ptr_solver_->result().placement().end(); ++it)//XXX
-//{//XXX
-//::std::cerr << "VM ID: " << (it->first.second) << " placed on PM ID: " << (it->first.first) << " with SHARE: " << ((it->second)[0].second) << ::std::endl;//XXX
-//}//XXX
-////[/XXX]
-//				physical_virtual_machine_iterator pm_vm_end_it(pm_vm_map.end());
-//				for (physical_virtual_machine_iterator pm_vm_it = pm_vm_map.begin(); pm_vm_it != pm_vm_end_it; ++pm_vm_it)
-//				{
-//					physical_machine_pointer ptr_pm(dc.physical_machine_ptr(pm_vm_it->first.first));
-//					virtual_machine_pointer ptr_vm(dc.virtual_machine_ptr(pm_vm_it->first.second));
-//					resource_share_container shares(pm_vm_it->second);
-//
-//					// check: paranoid check
-//					DCS_DEBUG_ASSERT( ptr_pm );
-//					// check: paranoid check
-//					DCS_DEBUG_ASSERT( ptr_vm );
-//
-////::std::cerr << "Going to migrate VM (" << pm_vm_it->first.second << "): " << *ptr_vm << " into PM (" << pm_vm_it->first.first << "): " << *ptr_pm << ::std::endl; //XXX
-//					if (ptr_vm->vmm().hosting_machine().id() != ptr_pm->id())
-//					{
-//						++migr_count_;
-//					}
-//
-//					dc.migrate_virtual_machine(ptr_vm, ptr_pm, shares.begin(), shares.end());
-//
-//					if (inactive_pms.count(ptr_pm->id()) > 0)
-//					{
-//						inactive_pms.erase(ptr_pm->id());
-//					}
-//				}
-//			}
-//
-//			// Turn off unused PMs
-//			{
-//				physical_machine_id_iterator pm_id_end_it(inactive_pms.end());
-//				for (physical_machine_id_iterator pm_id_it = inactive_pms.begin(); pm_id_it != pm_id_end_it; ++pm_id_it)
-//				{
-//					physical_machine_pointer ptr_pm(pm_id_it->second);
-//
-//					ptr_pm->power_off();
-//				}
-//			}
-			}
-			else
-			{
-				log_warn(DCS_DES_CLOUD_LOGGING_AT, "Failed to solve optimization problem. Skip migration.");
-				++fail_count_;
+					reg.des_engine().schedule_event(
+						ptr_decision_evt_src_,
+						reg.des_engine().simulated_time() + decision_delay_
+					);
+				}
 			}
 		}
 		else
@@ -542,9 +543,207 @@ class optimal_migration_controller: public base_migration_controller<TraitsT>
 		return *ptr_migr_rate_;
 	}
 
+
+	protected: void do_wait_background_work()
+	{
+		// The decision stays pending and is applied as usual
+		wait_solver();
+	}
+
 	//@} Interface Member Functions
 
 
+	private: void init()
+	{
+		ptr_decision_evt_src_->connect(
+			::dcs::functional::bind(
+				&self_type::process_decision,
+				this,
+				::dcs::functional::placeholders::_1,
+				::dcs::functional::placeholders::_2
+			)
+		);
+	}
+
+
+	private: void finit()
+	{
+		discard_pending_decision();
+
+		ptr_decision_evt_src_->disconnect(
+			::dcs::functional::bind(
+				&self_type::process_decision,
+				this,
+				::dcs::functional::placeholders::_1,
+				::dcs::functional::placeholders::_2
+			)
+		);
+	}
+
+
+	private: void process_decision(des_event_type const& evt, des_engine_context_type& ctx)
+	{
+		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( evt );
+		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( ctx );
+
+		DCS_DEBUG_TRACE("(" << this << ") BEGIN Do Process DECISION event (Clock: " << ctx.simulated_time() << ")");
+
+		if (pending_)
+		{
+			apply_pending_decision();
+		}
+
+		DCS_DEBUG_TRACE("(" << this << ") END Do Process DECISION event (Clock: " << ctx.simulated_time() << ")");
+	}
+
+
+	/// Solve the prepared problem (this is run outside the DES thread).
+	private: void run_solver()
+	{
+		try
+		{
+			ptr_solver_->run();
+		}
+		catch (::std::exception const& e)
+		{
+			solver_error_ = e.what();
+		}
+		catch (...)
+		{
+			solver_error_ = "Unknown error";
+		}
+	}
+
+
+	private: void wait_solver()
+	{
+		if (ptr_solver_thread_)
+		{
+			ptr_solver_thread_->join();
+			ptr_solver_thread_.reset();
+		}
+	}
+
+
+	private: void discard_pending_decision()
+	{
+		wait_solver();
+		pending_ = false;
+	}
+
+
+	private: void apply_pending_decision()
+	{
+		wait_solver();
+		pending_ = false;
+
+		if (!solver_error_.empty())
+		{
+			log_warn(DCS_DES_CLOUD_LOGGING_AT, "Failed to solve optimization problem (" + solver_error_ + "). Skip migration.");
+			++fail_count_;
+			return;
+		}
+
+		if (ptr_solver_->result().solved() && !up_to_date_solution())
+		{
+			log_warn(DCS_DES_CLOUD_LOGGING_AT, "The set of running VMs changed while solving the optimization problem. Skip migration.");
+			++fail_count_;
+			return;
+		}
+
+		apply_solution(pending_num_vms_);
+	}
+
+
+	/// Tell if the last solution still places exactly the running VMs.
+	private: bool up_to_date_solution() const
+	{
+		typedef typename optimal_solver_type::problem_result_type optimal_solver_result_type;
+		typedef typename optimal_solver_result_type::physical_virtual_machine_map opt_physical_virtual_machine_map;
+		typedef typename opt_physical_virtual_machine_map::const_iterator opt_physical_virtual_machine_iterator;
+		typedef ::std::vector<virtual_machine_pointer> virtual_machine_container;
+		typedef typename virtual_machine_container::const_iterator virtual_machine_iterator;
+
+		data_center_type const& dc(this->controlled_data_center());
+
+		opt_physical_virtual_machine_map const& pm_vm_map(ptr_solver_->result().placement());
+		opt_physical_virtual_machine_iterator pm_vm_end_it(pm_vm_map.end());
+		for (opt_physical_virtual_machine_iterator pm_vm_it = pm_vm_map.begin(); pm_vm_it != pm_vm_end_it; ++pm_vm_it)
+		{
+			if (dc.virtual_machine_ptr(pm_vm_it->first.second)->power_state() != powered_on_power_status)
+			{
+				return false;
+			}
+		}
+
+		::std::size_t num_vms(0);
+		virtual_machine_container const& vms(dc.active_virtual_machines());
+		virtual_machine_iterator vm_end_it(vms.end());
+		for (virtual_machine_iterator vm_it = vms.begin(); vm_it != vm_end_it; ++vm_it)
+		{
+			if ((*vm_it)->power_state() == powered_on_power_status)
+			{
+				++num_vms;
+			}
+		}
+
+		return num_vms == pm_vm_map.size();
+	}
+
+
+	/// Migrate VMs according to the last solution of the optimization problem.
+	private: void apply_solution(uint_type num_vms)
+	{
+		typedef typename optimal_solver_type::problem_result_type optimal_solver_result_type;
+
+		data_center_type& dc(this->controlled_data_center());
+
+		if (ptr_solver_->result().solved())
+		{
+			typedef typename optimal_solver_result_type::resource_share_container opt_share_container;
+			typedef typename optimal_solver_result_type::physical_virtual_machine_map opt_physical_virtual_machine_map;
+			typedef typename opt_physical_virtual_machine_map::const_iterator opt_physical_virtual_machine_iterator;
+
+			(*ptr_cost_)(ptr_solver_->result().cost());
+
+			virtual_machines_placement_type deployment;
+
+			opt_physical_virtual_machine_map pm_vm_map(ptr_solver_->result().placement());
+			opt_physical_virtual_machine_iterator pm_vm_end_it(pm_vm_map.end());
+			for (opt_physical_virtual_machine_iterator pm_vm_it = pm_vm_map.begin(); pm_vm_it != pm_vm_end_it; ++pm_vm_it)
+			{
+				physical_machine_pointer ptr_pm(dc.physical_machine_ptr(pm_vm_it->first.first));
+				virtual_machine_pointer ptr_vm(dc.virtual_machine_ptr(pm_vm_it->first.second));
+				opt_share_container const& shares(pm_vm_it->second);
+
+				// check: paranoid check
+				DCS_DEBUG_ASSERT( ptr_pm );
+				// check: paranoid check
+				DCS_DEBUG_ASSERT( ptr_vm );
+
+				deployment.place(*ptr_vm,
+								 *ptr_pm,
+								 shares.begin(),
+								 shares.end());
+			}
+
+			uint_type num_migrs(0);
+
+			num_migrs = this->migrate(deployment);
+
+			migr_count_ += num_migrs;
+			// For migration rate, use the weighted harmonic mean (see the "Workload Book" by Feitelson)
+			migr_rate_den_ += num_vms;
+			migr_rate_num_ += num_migrs;
+		}
+		else
+		{
+			log_warn(DCS_DES_CLOUD_LOGGING_AT, "Failed to solve optimization problem. Skip migration.");
+			++fail_count_;
+		}
+	}
+
+
 
 	private: real_type wp_;
 	private: real_type wm_;
@@ -560,6 +759,13 @@ class optimal_migration_controller: public base_migration_controller<TraitsT>
 	private: statistic_pointer ptr_migr_rate_;
 	private: optimal_solver_pointer ptr_solver_;
 	private: virtual_machine_utilization_map vm_util_map_;
+	private: bool async_; ///< Solve the optimization problem outside the DES thread.
+	private: real_type decision_delay_; ///< Simulated time to make a placement decision (when async).
+	private: bool pending_; ///< Tell if a placement decision has been started but not applied yet.
+	private: uint_type pending_num_vms_; ///< Number of running VMs when the pending decision was started.
+	private: thread_pointer ptr_solver_thread_;
+	private: ::std::string solver_error_;
+	private: des_event_source_pointer ptr_decision_evt_src_;
 }; // optimal_migration_controller
 
 template <typename TraitsT>
@@ -574,6 +780,12 @@ const typename optimal_migration_controller<TraitsT>::real_type optimal_migratio
 template <typename TraitsT>
 const typename optimal_migration_controller<TraitsT>::real_type optimal_migration_controller<TraitsT>::default_ewma_smoothing_factor(0.90);
 
+template <typename TraitsT>
+const typename optimal_migration_controller<TraitsT>::real_type optimal_migration_controller<TraitsT>::default_decision_delay(0);
+
+template <typename TraitsT>
+const ::std::string optimal_migration_controller<TraitsT>::decision_event_source_name("Optimal Migration Decision");
+
 }}} // Namespace dcs::des::cloud
 
 
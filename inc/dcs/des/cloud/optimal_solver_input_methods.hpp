@@ -40,6 +40,7 @@ enum optimal_solver_input_methods
 	matlab_optimal_solver_input_method, ///< MATLAB
 	matlabbinary_optimal_solver_input_method, ///< MATLAB_BINARY (http://plato.asu.edu/ftp/usrguide.pdf)
 	mps_optimal_solver_input_method, ///< MPS (http://en.wikipedia.org/wiki/MPS_(format))
+	native_optimal_solver_input_method, ///< Native (the problem is solved in-process)
 	netflo_optimal_solver_input_method, ///< NETFLO (http://www.mcs.anl.gov/otc/Guide/SoftwareGuide/Blurbs/netflo.html)
 	qps_optimal_solver_input_method, ///< QPS (http://plato.asu.edu/QPS.pdf)
 	relax4_optimal_solver_input_method, ///< RELAX4 (http://www.mcs.anl.gov/otc/Guide/OptWeb/continuous/constrained/network/relax4-format.html)
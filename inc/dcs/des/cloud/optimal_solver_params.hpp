@@ -26,10 +26,15 @@
 #define DCS_DES_CLOUD_SYSTEM_OPTIMAL_SOLVER_PARAMS_HPP
 
 
+#include <cstddef>
+#include <dcs/assert.hpp>
 #include <dcs/des/cloud/optimal_solver_categories.hpp>
 #include <dcs/des/cloud/optimal_solver_ids.hpp>
 #include <dcs/des/cloud/optimal_solver_input_methods.hpp>
 #include <dcs/des/cloud/optimal_solver_proxies.hpp>
+#include <limits>
+#include <stdexcept>
+#include <string>
 
 
 namespace dcs { namespace des { namespace cloud {
@@ -38,6 +43,7 @@ template <typename TraitsT>
 class base_optimal_solver_params
 {
 	public: typedef TraitsT traits_type;
+	public: typedef typename traits_type::real_type real_type;
 
 
 	public: base_optimal_solver_params(optimal_solver_categories category,
@@ -47,7 +53,11 @@ class base_optimal_solver_params
 	: category_(category),
 	  method_(method),
 	  solver_(solver),
-	  proxy_(proxy)
+	  proxy_(proxy),
+	  time_limit_(::std::numeric_limits<real_type>::infinity()),
+	  num_threads_(1),
+	  cache_(false),
+	  cache_tolerance_(0)
 	{
 	}
 
@@ -76,10 +86,98 @@ class base_optimal_solver_params
 	}
 
 
+	/// Set the max (wall-clock) time, in seconds, the solver can spend on a problem.
+	public: void time_limit(real_type value)
+	{
+		// pre: value > 0
+		DCS_ASSERT(
+			value > 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::base_optimal_solver_params::time_limit] Invalid time limit.")
+		);
+
+		time_limit_ = value;
+	}
+
+
+	public: real_type time_limit() const
+	{
+		return time_limit_;
+	}
+
+
+	/// Set the max number of threads the solver can use (for in-process solvers).
+	public: void num_threads(::std::size_t value)
+	{
+		// pre: value > 0
+		DCS_ASSERT(
+			value > 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::base_optimal_solver_params::num_threads] Invalid number of threads.")
+		);
+
+		num_threads_ = value;
+	}
+
+
+	public: ::std::size_t num_threads() const
+	{
+		return num_threads_;
+	}
+
+
+	/// Enable or disable the caching of the results of solved problems.
+	public: void cache(bool value)
+	{
+		cache_ = value;
+	}
+
+
+	public: bool cache() const
+	{
+		return cache_;
+	}
+
+
+	/// Set the directory where cached results are stored (none means in-memory only).
+	public: void cache_path(::std::string const& value)
+	{
+		cache_path_ = value;
+	}
+
+
+	public: ::std::string const& cache_path() const
+	{
+		return cache_path_;
+	}
+
+
+	/// Set the max difference of VM utilizations for a cached result to be reused.
+	public: void cache_tolerance(real_type value)
+	{
+		// pre: value >= 0
+		DCS_ASSERT(
+			value >= 0,
+			throw ::std::invalid_argument("[dcs::des::cloud::base_optimal_solver_params::cache_tolerance] Invalid tolerance.")
+		);
+
+		cache_tolerance_ = value;
+	}
+
+
+	public: real_type cache_tolerance() const
+	{
+		return cache_tolerance_;
+	}
+
+
 	private: optimal_solver_categories category_;
 	private: optimal_solver_input_methods method_;
 	private: optimal_solver_ids solver_;
 	private: optimal_solver_proxies proxy_;
+	private: real_type time_limit_;
+	private: ::std::size_t num_threads_;
+	private: bool cache_;
+	private: ::std::string cache_path_;
+	private: real_type cache_tolerance_;
 };
 
 template <typename TraitsT>
@@ -38,6 +38,9 @@ enum physical_resource_category
 	//network_down_resource_category,
 };
 
+/// The number of physical resource categories.
+enum { num_physical_resource_categories = storage_resource_category+1 };
+
 }}} // Namespace dcs::des::cloud
 
 
@@ -0,0 +1,144 @@
+/**
+ * \file dcs/des/cloud/portfolio_initial_placement_strategy.hpp
+ *
+ * \brief Initial VM placement based on a portfolio of concurrently run
+ *  strategies.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_PORTFOLIO_INITIAL_PLACEMENT_STRATEGY_HPP
+#define DCS_DES_CLOUD_PORTFOLIO_INITIAL_PLACEMENT_STRATEGY_HPP
+
+
+#include <cstddef>
+#include <dcs/assert.hpp>
+#include <dcs/debug.hpp>
+#include <dcs/des/cloud/base_initial_placement_strategy.hpp>
+#include <dcs/des/cloud/data_center.hpp>
+#include <dcs/des/cloud/detail/placement_portfolio.hpp>
+#include <dcs/des/cloud/virtual_machines_placement.hpp>
+#include <dcs/memory.hpp>
+#include <stdexcept>
+#include <vector>
+
+
+namespace dcs { namespace des { namespace cloud {
+
+/**
+ * \brief Initial VM placement choosing the best placement among the ones
+ *  computed concurrently by a set of strategies.
+ *
+ * Each strategy is run on its own thread against the same (read-only) data
+ * center; the placement which leaves the fewest VMs unplaced and, among them,
+ * has the lowest cost (see \c detail::placement_cost_model) is returned.
+ */
+template <typename TraitsT>
+class portfolio_initial_placement_strategy: public base_initial_placement_strategy<TraitsT>
+{
+	private: typedef base_initial_placement_strategy<TraitsT> base_type;
+	public: typedef TraitsT traits_type;
+	public: typedef typename traits_type::real_type real_type;
+	public: typedef data_center<traits_type> data_center_type;
+	public: typedef base_initial_placement_strategy<traits_type> strategy_type;
+	public: typedef ::dcs::shared_ptr<strategy_type> strategy_pointer;
+	public: typedef detail::placement_cost_model<traits_type> cost_model_type;
+	private: typedef detail::placement_portfolio<traits_type> portfolio_type;
+	private: typedef ::std::vector<strategy_pointer> strategy_container;
+	/// Computes the placement of one strategy of the portfolio.
+	private: struct task
+	{
+		task(strategy_pointer const& ptr_strategy_, data_center_type const& dc_)
+		: ptr_strategy(ptr_strategy_),
+		  ptr_dc(&dc_)
+		{
+		}
+
+		virtual_machines_placement<traits_type> operator()() const
+		{
+			return ptr_strategy->placement(*ptr_dc);
+		}
+
+		strategy_pointer ptr_strategy;
+		data_center_type const* ptr_dc;
+	};
+
+
+	public: explicit portfolio_initial_placement_strategy(cost_model_type const& cost_model = cost_model_type(),
+														  real_type time_budget = portfolio_type::default_time_budget,
+														  real_type ref_penalty = base_type::default_reference_share_penalty)
+	: base_type(ref_penalty),
+	  portfolio_(cost_model, time_budget)
+	{
+	}
+
+
+	/// Add a strategy to the portfolio.
+	public: void add_strategy(strategy_pointer const& ptr_strategy)
+	{
+		// pre: ptr_strategy is a valid pointer
+		DCS_ASSERT(
+			ptr_strategy,
+			throw ::std::invalid_argument("[dcs::des::cloud::portfolio_initial_placement_strategy::add_strategy] Invalid strategy pointer.")
+		);
+
+		strategies_.push_back(ptr_strategy);
+	}
+
+
+	public: ::std::size_t num_strategies() const
+	{
+		return strategies_.size();
+	}
+
+
+	private: virtual_machines_placement<traits_type> do_placement(data_center_type const& dc)
+	{
+		// pre: at least one strategy
+		DCS_ASSERT(
+			!strategies_.empty(),
+			throw ::std::logic_error("[dcs::des::cloud::portfolio_initial_placement_strategy::do_placement] Empty portfolio.")
+		);
+
+DCS_DEBUG_TRACE("BEGIN Initial Placement");//XXX
+		::std::vector<task> tasks;
+		for (::std::size_t i = 0; i < strategies_.size(); ++i)
+		{
+			tasks.push_back(task(strategies_[i], dc));
+		}
+
+		virtual_machines_placement<traits_type> deployment;
+		deployment = portfolio_.run(tasks,
+									dc,
+									dc.active_virtual_machines().begin(),
+									dc.active_virtual_machines().end());
+
+DCS_DEBUG_TRACE("END Initial Placement ==> " << deployment);///XXX
+		return deployment;
+	}
+
+
+	private: portfolio_type portfolio_;
+	private: strategy_container strategies_;
+}; // portfolio_initial_placement_strategy
+
+}}} // Namespace dcs::des::cloud
+
+
+#endif // DCS_DES_CLOUD_PORTFOLIO_INITIAL_PLACEMENT_STRATEGY_HPP
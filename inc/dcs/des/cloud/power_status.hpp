@@ -38,6 +38,9 @@ enum power_status
 	suspended_power_status
 };
 
+/// The number of power statuses.
+enum { num_power_statuses = suspended_power_status+1 };
+
 
 template <
 	typename CharT,
@@ -30,6 +30,7 @@
 #include <dcs/debug.hpp>
 #include <dcs/des/engine_traits.hpp>
 #include <dcs/des/cloud/base_physical_machine_controller.hpp>
+#include <dcs/des/cloud/resource_vector.hpp>
 #include <dcs/macro.hpp>
 #include <map>
 #ifdef DCS_DES_CLOUD_EXP_OUTPUT_VM_SHARES
@@ -139,9 +140,9 @@ class proportional_physical_machine_controller: public base_physical_machine_con
 		typedef typename vm_container::const_iterator vm_iterator;
 		typedef typename vm_type::resource_share_container share_container;
 		typedef typename share_container::const_iterator share_iterator;
-		typedef ::std::map<physical_resource_category,real_type> share_map_container;
+		typedef resource_vector<real_type> share_map_container;
 
-		vm_container actual_vms(this->machine().vmm().virtual_machines(powered_on_power_status));
+		vm_container const& actual_vms(this->machine().vmm().virtual_machines(powered_on_power_status));
 		share_map_container share_sums;
 		short step = 1;
 
@@ -93,6 +93,13 @@ class qn_application_controller: public base_application_controller<TraitsT>
 
 	//@{ Inteface Member Functions
 
+	/// The QN model of the application is solved on its own.
+	private: bool do_concurrent_control() const
+	{
+		return true;
+	}
+
+
 	private: void do_process_control(des_event_type const& evt, des_engine_context_type& ctx)
 	{
 		DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( evt );
@@ -313,7 +320,7 @@ DCS_DEBUG_TRACE("New Share: " << new_share);//XXX
 					new_share = ::std::max(new_share, default_min_share_);
 
 DCS_DEBUG_TRACE("Assigning new wanted share: VM: " << ptr_vm->name() << " (" << ptr_vm->id() << ") - Category: " << res_category << " - Actual Share: " << ptr_vm->resource_share(res_category) << " ==> New Share: " << new_share);//XXX
-					ptr_vm->wanted_resource_share(res_category, new_share);
+					this->wanted_resource_share(ptr_vm, res_category, new_share);
 				}
 			}
 		}
@@ -27,6 +27,7 @@
 #define DCS_DES_CLOUD_QN_APPLICATION_SIMULATION_MODEL_HPP
 
 
+#include <algorithm>
 #include <dcs/debug.hpp>
 #include <dcs/des/engine_traits.hpp>
 #include <dcs/des/base_statistic.hpp>
@@ -41,12 +42,16 @@
 #include <dcs/des/cloud/performance_measure_category.hpp>
 #include <dcs/des/cloud/physical_resource_category.hpp>
 #include <dcs/des/cloud/registry.hpp>
+#include <dcs/des/cloud/trace.hpp>
 #include <dcs/des/cloud/user_request.hpp>
+#include <dcs/des/cloud/user_request_view.hpp>
 #include <dcs/des/cloud/utility.hpp>
 #include <dcs/exception.hpp>
 #include <dcs/functional/bind.hpp>
 #include <dcs/macro.hpp>
 #include <dcs/memory.hpp>
+#include <cstddef>
+#include <limits>
 #include <stdexcept>
 #include <vector>
 
@@ -248,6 +253,9 @@ class qn_application_simulation_model: public base_application_simulation_model<
 	private: typedef ::std::map<uint_type,node_identifier_type> tier_mapping_container;
 	private: typedef ::std::map<node_identifier_type,uint_type> node_mapping_container;
 	private: typedef typename base_type::user_request_type user_request_type;
+	private: typedef typename base_type::user_request_view_type user_request_view_type;
+	private: typedef typename user_request_view_type::state_pointer request_state_pointer;
+	private: typedef typename user_request_view_type::utilization_profile_type request_utilization_profile_type;
 	private: typedef registry<traits_type> registry_type;
 	private: typedef typename traits_type::des_engine_type des_engine_type;
 	private: typedef typename ::dcs::des::engine_traits<des_engine_type>::engine_context_type des_engine_context_type;
@@ -574,37 +582,38 @@ class qn_application_simulation_model: public base_application_simulation_model<
 
 	private: ::std::vector<user_request_type> do_tier_in_service_requests(uint_type tier_id) const
 	{
-		typedef typename qn_model_type::node_type node_type;
-		typedef ::dcs::des::model::qn::service_station_node<qn_model_traits_type> service_node_type;
 		typedef ::std::vector<customer_pointer> customer_container;
 		typedef typename customer_container::const_iterator customer_iterator;
 
-		node_type const& node = ptr_model_->get_node(node_from_tier(tier_id));
+		::std::vector<user_request_type> requests;
 
-		// pre: tier must be a service-station node.
-		DCS_ASSERT(
-				node.category() == ::dcs::des::model::qn::service_station_node_category,
-				throw ::std::runtime_error("[dcs::des::cloud::qn_application_simulation_model::do_tier_in_service_requests] Expected a service station node. Got another kind of node.")
-			);
+		customer_container customers(tier_active_customers(tier_id));
+		customer_iterator customer_end_it(customers.end());
+		for (customer_iterator it = customers.begin(); it != customer_end_it; ++it)
+		{
+			requests.push_back(make_request(*it));
+		}
 
-		service_node_type const* ptr_svc_node(dynamic_cast<service_node_type const*>(&node));
+		return requests;
+	}
 
-		// double-check: tier must be a service-station node.
-		DCS_ASSERT(
-				ptr_svc_node,
-				throw ::std::runtime_error("[dcs::des::cloud::qn_application_simulation_model::do_tier_in_service_requests] Unable to get a service station node.")
-			);
 
-		::std::vector<user_request_type> requests;
+	private: ::std::vector<user_request_view_type> do_tier_in_service_request_views(uint_type tier_id) const
+	{
+		typedef ::std::vector<customer_pointer> customer_container;
+		typedef typename customer_container::const_iterator customer_iterator;
+
+		customer_container customers(tier_active_customers(tier_id));
 
-		customer_container customers(ptr_svc_node->active_customers());
+		::std::vector<user_request_view_type> views;
+		views.reserve(customers.size());
 		customer_iterator customer_end_it(customers.end());
 		for (customer_iterator it = customers.begin(); it != customer_end_it; ++it)
 		{
-			requests.push_back(make_request(*it));
+			views.push_back(user_request_view_type(*this, *it));
 		}
 
-		return requests;
+		return views;
 	}
 
 
@@ -798,6 +807,113 @@ class qn_application_simulation_model: public base_application_simulation_model<
 	}
 
 
+	private: user_request_view_type do_request_view(des_event_type const& evt) const
+	{
+		return user_request_view_type(*this, evt.template unfolded_state<customer_pointer>());
+	}
+
+
+	private: uint_type do_request_id(request_state_pointer const& ptr_state) const
+	{
+		return request_customer(ptr_state).id();
+	}
+
+
+	private: uint_type do_request_current_tier(request_state_pointer const& ptr_state) const
+	{
+		customer_type& customer(request_customer(ptr_state));
+
+		if (node_mapped(customer.current_node()))
+		{
+			return tier_from_node(customer.current_node());
+		}
+
+		return ::std::numeric_limits<uint_type>::max();
+	}
+
+
+	private: real_type do_request_arrival_time(request_state_pointer const& ptr_state) const
+	{
+		return request_customer(ptr_state).arrival_time();
+	}
+
+
+	private: real_type do_request_departure_time(request_state_pointer const& ptr_state) const
+	{
+		return request_customer(ptr_state).departure_time();
+	}
+
+
+	private: ::std::size_t do_request_tier_num_visits(request_state_pointer const& ptr_state, uint_type tier_id) const
+	{
+		if (!tier_vm_active(tier_id))
+		{
+			return 0;
+		}
+
+		return request_customer(ptr_state).node_arrival_times(node_from_tier(tier_id)).size();
+	}
+
+
+	private: real_type do_request_tier_arrival_time(request_state_pointer const& ptr_state, uint_type tier_id, ::std::size_t visit) const
+	{
+		return request_customer(ptr_state).node_arrival_times(node_from_tier(tier_id)).at(visit);
+	}
+
+
+	private: real_type do_request_tier_departure_time(request_state_pointer const& ptr_state, uint_type tier_id, ::std::size_t visit) const
+	{
+		return request_customer(ptr_state).node_departure_times(node_from_tier(tier_id)).at(visit);
+	}
+
+
+	private: real_type do_request_tier_residence_time(request_state_pointer const& ptr_state, uint_type tier_id) const
+	{
+		typedef ::std::vector<real_type> time_container;
+
+		if (!tier_vm_active(tier_id))
+		{
+			return 0;
+		}
+
+		customer_type& customer(request_customer(ptr_state));
+		node_identifier_type node_id(node_from_tier(tier_id));
+		time_container const& arr_times(customer.node_arrival_times(node_id));
+		time_container const& dep_times(customer.node_departure_times(node_id));
+		::std::size_t n(::std::min(arr_times.size(), dep_times.size()));
+
+		real_type rt(0);
+		for (::std::size_t i = 0; i < n; ++i)
+		{
+			rt += dep_times[i]-arr_times[i];
+		}
+
+		return rt;
+	}
+
+
+	private: request_utilization_profile_type do_request_tier_last_utilization_profile(request_state_pointer const& ptr_state, uint_type tier_id, physical_resource_category category) const
+	{
+		typedef typename customer_type::utilization_profile_type customer_utilization_profile_type;
+		typedef ::std::vector<customer_utilization_profile_type> customer_utilization_profile_container;
+
+		//FIXME: CPU resource category is hard-coded (see make_request)
+		if (category != cpu_resource_category || !tier_vm_active(tier_id))
+		{
+			return request_utilization_profile_type();
+		}
+
+		customer_utilization_profile_container const& profiles(request_customer(ptr_state).node_utilization_profiles(node_from_tier(tier_id)));
+
+		if (profiles.empty())
+		{
+			return request_utilization_profile_type();
+		}
+
+		return make_request_utilization_profile(tier_id, category, profiles.back());
+	}
+
+
 	private: void do_resource_share(uint_type tier_id, physical_resource_category category, real_type share)
 	{
 //FIXME
@@ -955,7 +1071,7 @@ DCS_DEBUG_TRACE("New capacity multiplier: " << ptr_svc_node->capacity_multiplier
 		typedef typename category_container::const_iterator category_iterator;
 		typedef ::std::vector<real_type> measure_container;
 
-		user_request_type req = make_request(evt);
+		user_request_view_type req(this->request_view(evt));
 
 		category_container categories(this->application().sla_cost_model().slo_categories());
 
@@ -996,7 +1112,7 @@ DCS_DEBUG_TRACE("New capacity multiplier: " << ptr_svc_node->capacity_multiplier
 		if (!this->application().sla_cost_model().satisfied(categories.begin(), categories.end(), measures.begin()))
 		{
 			DCS_DEBUG_TRACE("Found SLA violation for measures: " << measures[0]);
-::std::cerr << "APP " << this->application().id() << " -- SLA violation: " << measures[0] << " vs " << this->application().sla_cost_model().slo_value(response_time_performance_measure) << " (Clock: " << ctx.simulated_time() << ")" << ::std::endl;//XXX
+			DCS_DES_CLOUD_TRACE(app_simulation, info) << "APP " << this->application().id() << " -- SLA violation: " << measures[0] << " vs " << this->application().sla_cost_model().slo_value(response_time_performance_measure) << " (Clock: " << ctx.simulated_time() << ")";
 
 			++num_sla_viols_;
 		}
@@ -1016,7 +1132,7 @@ DCS_DEBUG_TRACE("New capacity multiplier: " << ptr_svc_node->capacity_multiplier
 		typedef typename category_container::const_iterator category_iterator;
 		typedef ::std::vector<real_type> measure_container;
 
-		user_request_type req = make_request(evt);
+		user_request_view_type req(this->request_view(evt));
 
 		// check: make sure this request is at this tier
 		if (tid != req.current_tier())
@@ -1024,6 +1140,8 @@ DCS_DEBUG_TRACE("New capacity multiplier: " << ptr_svc_node->capacity_multiplier
 			return;
 		}
 
+		::std::size_t last_visit(req.tier_num_visits(tid)-1);
+
 		category_container categories(this->application().sla_cost_model().slo_categories());
 
 		measure_container measures;
@@ -1040,7 +1158,7 @@ DCS_DEBUG_TRACE("New capacity multiplier: " << ptr_svc_node->capacity_multiplier
 					throw ::std::runtime_error("[dcs::des::cloud::qn_application_simulation_model::process_request_departure] Queue length as SLO category has not been implemented yet.");//FIXME
 				case response_time_performance_measure:
 					{
-						real_type rt = req.tier_departure_times(req.current_tier()).back()-req.tier_arrival_times(req.current_tier()).back();
+						real_type rt = req.tier_departure_time(tid, last_visit)-req.tier_arrival_time(tid, last_visit);
 						measures.push_back(rt);
 					}
 					break;
@@ -1054,7 +1172,7 @@ DCS_DEBUG_TRACE("New capacity multiplier: " << ptr_svc_node->capacity_multiplier
 			}
 
 			detail::dump_tier_measure<traits_type>(this->application().id(),
-												   req.current_tier(),
+												   tid,
 												   category,
 												   measures.back(),
 												   this->application().performance_model().tier_measure(req.current_tier(), category));
@@ -1088,8 +1206,6 @@ DCS_DEBUG_TRACE("New capacity multiplier: " << ptr_svc_node->capacity_multiplier
 		typedef ::std::vector<real_type> time_container;
 		typedef typename time_container::const_iterator time_iterator;
 		typedef typename customer_type::utilization_profile_type customer_utilization_profile_type;
-		typedef resource_utilization_profile<traits_type> request_utilization_profile_type;
-		typedef typename customer_utilization_profile_type::const_iterator customer_utilization_profile_iterator;
 
 		// check: safety check
 		DCS_DEBUG_ASSERT( ptr_customer );
@@ -1110,13 +1226,7 @@ DCS_DEBUG_TRACE("New capacity multiplier: " << ptr_svc_node->capacity_multiplier
 		{
 			uint_type tier_id(it->first);
 			node_identifier_type node_id(it->second);
-			virtual_machine_pointer ptr_vm(this->tier_virtual_machine(tier_id));
-
-			// check: paranoid-check
-			DCS_DEBUG_ASSERT( ptr_vm );
-
-			// It is possible that the VM for this tier has already been displaced or it is not powered-on
-			if (!ptr_vm->deployed() || ptr_vm->power_state() != powered_on_power_status)
+			if (!tier_vm_active(tier_id))
 			{
 				continue;
 			}
@@ -1142,29 +1252,89 @@ DCS_DEBUG_TRACE("New capacity multiplier: " << ptr_svc_node->capacity_multiplier
 			::std::size_t np(profiles.size());
 			for (::std::size_t i = 0; i < np; ++i)
 			{
-				customer_utilization_profile_type const& customer_profile(profiles[i]);
 				physical_resource_category category(cpu_resource_category); //FIXME: CPU resource category is hard-coded
 
-				request_utilization_profile_type request_profile;
-				customer_utilization_profile_iterator profile_end_it(customer_profile.end());
-				for (customer_utilization_profile_iterator it = customer_profile.begin(); it != profile_end_it; ++it)
-				{
-					typename customer_utilization_profile_iterator::value_type const& item(*it);
-					real_type util;
-					util = ::dcs::des::cloud::scale_resource_utilization(
-							this->application().reference_resource(category).capacity(),
-							this->tier_virtual_machine(tier_id)->vmm().hosting_machine().resource(category)->capacity(),
-							item.utilization()
-						);
-					request_profile(item.begin_time(), item.end_time(), util);
-				}
-				req.tier_utilization_profile(tier_id, category, request_profile);
+				req.tier_utilization_profile(tier_id, category, make_request_utilization_profile(tier_id, category, profiles[i]));
 			}
 		}
 
 		return req;
 	}
 
+
+	/// Scales a customer utilization profile to the machine hosting the given tier.
+	private: template <typename CustomerProfileT>
+		request_utilization_profile_type make_request_utilization_profile(uint_type tier_id, physical_resource_category category, CustomerProfileT const& customer_profile) const
+	{
+		typedef typename CustomerProfileT::const_iterator customer_utilization_profile_iterator;
+
+		real_type ref_capacity(this->application().reference_resource(category).capacity());
+		real_type host_capacity(this->tier_virtual_machine(tier_id)->vmm().hosting_machine().resource(category)->capacity());
+
+		request_utilization_profile_type request_profile;
+		customer_utilization_profile_iterator profile_end_it(customer_profile.end());
+		for (customer_utilization_profile_iterator it = customer_profile.begin(); it != profile_end_it; ++it)
+		{
+			typename customer_utilization_profile_iterator::value_type const& item(*it);
+			real_type util;
+			util = ::dcs::des::cloud::scale_resource_utilization(
+					ref_capacity,
+					host_capacity,
+					item.utilization()
+				);
+			request_profile(item.begin_time(), item.end_time(), util);
+		}
+
+		return request_profile;
+	}
+
+
+	/// Tells if the VM of the given tier is deployed and powered on.
+	private: bool tier_vm_active(uint_type tier_id) const
+	{
+		virtual_machine_pointer ptr_vm(this->tier_virtual_machine(tier_id));
+
+		// check: paranoid-check
+		DCS_DEBUG_ASSERT( ptr_vm );
+
+		// It is possible that the VM for this tier has already been displaced or it is not powered-on
+		return ptr_vm->deployed() && ptr_vm->power_state() == powered_on_power_status;
+	}
+
+
+	private: ::std::vector<customer_pointer> tier_active_customers(uint_type tier_id) const
+	{
+		typedef typename qn_model_type::node_type node_type;
+		typedef ::dcs::des::model::qn::service_station_node<qn_model_traits_type> service_node_type;
+
+		node_type const& node = ptr_model_->get_node(node_from_tier(tier_id));
+
+		// pre: tier must be a service-station node.
+		DCS_ASSERT(
+				node.category() == ::dcs::des::model::qn::service_station_node_category,
+				throw ::std::runtime_error("[dcs::des::cloud::qn_application_simulation_model::tier_active_customers] Expected a service station node. Got another kind of node.")
+			);
+
+		service_node_type const* ptr_svc_node(dynamic_cast<service_node_type const*>(&node));
+
+		// double-check: tier must be a service-station node.
+		DCS_ASSERT(
+				ptr_svc_node,
+				throw ::std::runtime_error("[dcs::des::cloud::qn_application_simulation_model::tier_active_customers] Unable to get a service station node.")
+			);
+
+		return ptr_svc_node->active_customers();
+	}
+
+
+	private: static customer_type& request_customer(request_state_pointer const& ptr_state)
+	{
+		// check: safety check
+		DCS_DEBUG_ASSERT( ptr_state );
+
+		return *static_cast<customer_type*>(ptr_state.get());
+	}
+
 	//@} Class members
 
 
@@ -1,7 +1,7 @@
 /**
  * \file dcs/des/cloud/registry.hpp
  *
- * \brief Global registry class.
+ * \brief Simulation context (registry) class.
  *
  * Copyright (C) 2009-2011  Distributed Computing System (DCS) Group, Computer
  * Science Department - University of Piemonte Orientale, Alessandria (Italy).
@@ -26,116 +26,36 @@
 #define DCS_DES_CLOUD_REGISTRY_HPP
 
 
-#define DCS_DES_CLOUD_REGISTRY_USE_ABRAHAMS_SINGLETON
-//#undef DCS_DES_CLOUD_REGISTRY_USE_ABRAHAMS_SINGLETON
-
-
-#if defined(DCS_DES_CLOUD_REGISTRY_USE_ABRAHAMS_SINGLETON)
-
-# include <boost/serialization/singleton.hpp>
-
-#else // DCS_DES_CLOUD_REGISTRY_USE_ABRAHAMS_SINGLETON
-
-
-# include <boost/scoped_ptr.hpp>
-# include <boost/thread/once.hpp>
-# include <boost/utility.hpp>
-# include <dcs/type_traits/add_const.hpp>
-# include <dcs/type_traits/add_reference.hpp>
-
-
-#endif // DCS_DES_CLOUD_REGISTRY_USE_ABRAHAMS_SINGLETON
-
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/once.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/utility.hpp>
+#include <dcs/debug.hpp>
 #include <dcs/des/cloud/config/configuration.hpp>
+#include <dcs/des/cloud/control_tick_scheduler.hpp>
 #include <dcs/des/cloud/identifier_generator.hpp>
 #include <dcs/memory.hpp>
 
 
 namespace dcs { namespace des { namespace cloud {
 
-#if !defined(DCS_DES_CLOUD_REGISTRY_USE_ABRAHAMS_SINGLETON)
-
-namespace detail { namespace /*<unnamed>*/ {
-
 /**
- * \brief Thread safe lazy singleton template class.
- *
- * This class is a thread-safe lazy singleton template class, which can be used
- * during static initialization or anytime after.
+ * \brief The simulation context.
  *
- * Original code found at http://www.boostcookbook.com/Recipe:/1235044
+ * A registry holds the state shared by all the components of a single
+ * simulation, that is the DES engine, the uniform random number generator, the
+ * configuration, the identifier generators and the scheduler of control ticks.
  *
- * \note
- *  - If T's constructor throws, instance() will return a null reference.
- *  - If your singleton class manages resources, you may provide a public
- *    destructor, and it will be called when the instance of your singleton
- *    class is out of scoped (see scoped_ptr docs).
- *  .
- *
- * \author Port4l, http://www.boostcookbook.com/User:/Port4l
- * \author Marco Guazzone (marco.guazzone@gmail.com)
+ * Several registries can live in the same process, so that independent
+ * simulations can be run side-by-side (e.g., one per thread).
+ * Components not given an explicit registry use the one returned by
+ * \c instance(), which is the registry bound to the calling thread (see
+ * \c bind() and \c scoped_registry) or, when no registry has been bound, a
+ * process-wide default registry.
  */
-template <typename T>
-class singleton: ::boost::noncopyable
-{
-	public: static T& instance()
-	{
-//		::boost::call_once(init, flag_);
-		::boost::call_once(flag_, init);
-		return *ptr_t_;
-	}
-
-
-	public: static T const& const_instance()
-	{
-//		::boost::call_once(init, flag_);
-		::boost::call_once(flag_, init);
-		return *ptr_t_;
-	}
-
-
-	protected: singleton() {}
-
-
-	protected: virtual ~singleton() { }
-
-
-	private: static void init() // never throws
-	{
-		DCS_DEBUG_TRACE("Singleton initialization");//XXX
-
-		ptr_t_.reset(new T());
-	}
-
-
-	private: static ::boost::once_flag flag_;
-	private: static ::boost::scoped_ptr<T> ptr_t_;
-};
-
-template <typename T>
-::boost::once_flag singleton<T>::flag_ = BOOST_ONCE_INIT;
-
-template <typename T>
-::boost::scoped_ptr<T> singleton<T>::ptr_t_(0);
-
-}} // Namespace detail::<unnamed>
-
-#endif // DCS_DES_CLOUD_REGISTRY_USE_ABRAHAMS_SINGLETON
-
-
-#if defined(DCS_DES_CLOUD_REGISTRY_USE_ABRAHAMS_SINGLETON)
-
 template <typename TraitsT>
-class registry: public ::boost::serialization::singleton< registry<TraitsT> >
+class registry: ::boost::noncopyable
 {
-	private: typedef ::boost::serialization::singleton< registry<TraitsT> > base_type;
-#else // DCS_DES_CLOUD_REGISTRY_USE_ABRAHAMS_SINGLETON
-
-template <typename TraitsT>
-class registry: public detail::singleton< registry<TraitsT> >
-{
-	friend class detail::singleton< registry<TraitsT> >;
-#endif // DCS_DES_CLOUD_REGISTRY_USE_ABRAHAMS_SINGLETON
 	public: typedef TraitsT traits_type;
 	public: typedef typename traits_type::des_engine_type des_engine_type;
 	public: typedef ::dcs::shared_ptr<des_engine_type> des_engine_pointer;
@@ -149,23 +69,53 @@ class registry: public detail::singleton< registry<TraitsT> >
 	public: typedef identifier_generator<application_identifier_type> application_id_generator_type;
 	public: typedef identifier_generator<physical_machine_identifier_type> physical_machine_id_generator_type;
 	public: typedef identifier_generator<virtual_machine_identifier_type> virtual_machine_id_generator_type;
+	public: typedef ::dcs::des::cloud::control_tick_scheduler<traits_type> control_tick_scheduler_type;
 
 
+	/// Return the registry bound to the calling thread or, if none, the default one.
 	public: static registry& instance()
 	{
-		return base_type::get_mutable_instance();
+		registry* ptr_reg(ptr_cur_reg_.get());
+
+		if (ptr_reg)
+		{
+			return *ptr_reg;
+		}
+
+		::boost::call_once(default_flag_, &registry::init_default);
+
+		return *ptr_default_reg_;
 	}
 
 
 	public: static registry const& const_instance()
 	{
-		return base_type::get_const_instance();
+		return instance();
+	}
+
+
+	/**
+	 * \brief Bind the given registry to the calling thread.
+	 *
+	 * \param ptr_reg The registry to bind; a null pointer restores the default
+	 *  registry.
+	 * \return The registry previously bound to the calling thread (possibly
+	 *  null).
+	 */
+	public: static registry* bind(registry* ptr_reg)
+	{
+		registry* ptr_old_reg(ptr_cur_reg_.release());
+
+		ptr_cur_reg_.reset(ptr_reg);
+
+		return ptr_old_reg;
 	}
 
 
 	public: void des_engine(des_engine_pointer const& ptr_engine)
 	{
 		ptr_des_eng_ = ptr_engine;
+		ctrl_tick_sched_.des_engine(ptr_engine);
 	}
 
 
@@ -307,8 +257,20 @@ class registry: public detail::singleton< registry<TraitsT> >
 	}
 
 
+	public: control_tick_scheduler_type& control_tick_scheduler()
+	{
+		return ctrl_tick_sched_;
+	}
+
+
+	public: control_tick_scheduler_type const& control_tick_scheduler() const
+	{
+		return ctrl_tick_sched_;
+	}
+
+
 	/// Default constructor
-	protected: registry()
+	public: registry()
 	: app_id_gen_(0),
 	  pm_id_gen_(0),
 	  vm_id_gen_(0)
@@ -316,12 +278,66 @@ class registry: public detail::singleton< registry<TraitsT> >
 	}
 
 
+	private: static void init_default() // never throws
+	{
+		DCS_DEBUG_TRACE("Default registry initialization");//XXX
+
+		ptr_default_reg_.reset(new registry());
+	}
+
+
+	/// The thread-specific pointer must not delete bound registries.
+	private: static void no_cleanup(registry*)
+	{
+	}
+
+
+	private: static ::boost::once_flag default_flag_;
+	private: static ::boost::scoped_ptr<registry> ptr_default_reg_;
+	private: static ::boost::thread_specific_ptr<registry> ptr_cur_reg_;
 	private: des_engine_pointer ptr_des_eng_;
 	private: uniform_random_generator_pointer ptr_rng_;
 	private: configuration_pointer ptr_conf_;
 	private: application_id_generator_type app_id_gen_;
 	private: physical_machine_id_generator_type pm_id_gen_;
 	private: virtual_machine_id_generator_type vm_id_gen_;
+	private: control_tick_scheduler_type ctrl_tick_sched_;
+};
+
+template <typename TraitsT>
+::boost::once_flag registry<TraitsT>::default_flag_ = BOOST_ONCE_INIT;
+
+template <typename TraitsT>
+::boost::scoped_ptr< registry<TraitsT> > registry<TraitsT>::ptr_default_reg_(0);
+
+template <typename TraitsT>
+::boost::thread_specific_ptr< registry<TraitsT> > registry<TraitsT>::ptr_cur_reg_(&registry<TraitsT>::no_cleanup);
+
+
+/**
+ * \brief Bind a registry to the calling thread for the lifetime of this object.
+ *
+ * The previously bound registry is restored on destruction.
+ */
+template <typename TraitsT>
+class scoped_registry: ::boost::noncopyable
+{
+	public: typedef registry<TraitsT> registry_type;
+
+
+	public: explicit scoped_registry(registry_type& reg)
+	: ptr_old_reg_(registry_type::bind(&reg))
+	{
+	}
+
+
+	public: ~scoped_registry()
+	{
+		registry_type::bind(ptr_old_reg_);
+	}
+
+
+	private: registry_type* ptr_old_reg_;
 };
 
 }}} // Namespace dcs::des::cloud
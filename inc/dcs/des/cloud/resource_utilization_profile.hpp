@@ -218,12 +218,27 @@ class resource_utilization_profile
 	}
 
 
+	/// The measure of the profile domain (i.e., the cardinality of the underlying interval map).
 	public: size_type size() const
 	{
 		return profile_.size();
 	}
 
 
+	/// The number of segments of this profile.
+	public: size_type num_segments() const
+	{
+		return profile_.iterative_size();
+	}
+
+
+	/// Removes the given time interval from this profile.
+	public: void erase(time_interval_type const& interval)
+	{
+		profile_.erase(interval);
+	}
+
+
 	public: real_type area() const
 	{
 		real_type a(0);
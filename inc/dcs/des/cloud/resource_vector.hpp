@@ -0,0 +1,371 @@
+/**
+ * \file dcs/des/cloud/resource_vector.hpp
+ *
+ * \brief Dense per-resource-category vector of values.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_RESOURCE_VECTOR_HPP
+#define DCS_DES_CLOUD_RESOURCE_VECTOR_HPP
+
+
+#include <cstddef>
+#include <dcs/des/cloud/physical_resource_category.hpp>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+
+namespace dcs { namespace des { namespace cloud {
+
+/**
+ * \brief Dense per-resource-category vector of values (e.g., shares or
+ *  utilizations).
+ *
+ * It is a drop-in replacement for
+ * <code>std::map<physical_resource_category,RealT></code>: values are stored
+ * in a fixed-size array indexed by category, along with a mask of the
+ * categories which have been set, and iteration visits the set categories
+ * in increasing order as <code>(category, value)</code> pairs.
+ * Hence, it needs no dynamic allocation and unset categories read as zero,
+ * so that the element-wise operations are plain loops over the array.
+ *
+ * \tparam RealT The type of the values.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename RealT>
+class resource_vector
+{
+	public: typedef RealT real_type;
+	public: typedef physical_resource_category key_type;
+	public: typedef real_type mapped_type;
+	public: typedef ::std::pair<physical_resource_category,real_type> value_type;
+	public: typedef ::std::size_t size_type;
+	private: typedef unsigned int mask_type;
+
+
+	/// Iterator over the set categories, as <code>(category, value)</code> pairs.
+	public: class const_iterator
+	{
+		public: typedef ::std::forward_iterator_tag iterator_category;
+		public: typedef typename resource_vector::value_type value_type;
+		public: typedef ::std::ptrdiff_t difference_type;
+		public: typedef value_type const* pointer;
+		public: typedef value_type const& reference;
+
+
+		public: const_iterator()
+		: ptr_vec_(0),
+		  pos_(num_physical_resource_categories)
+		{
+		}
+
+
+		public: const_iterator(resource_vector const* ptr_vec, size_type pos)
+		: ptr_vec_(ptr_vec),
+		  pos_(pos)
+		{
+			seek();
+		}
+
+
+		public: reference operator*() const
+		{
+			return cur_;
+		}
+
+
+		public: pointer operator->() const
+		{
+			return &cur_;
+		}
+
+
+		public: const_iterator& operator++()
+		{
+			++pos_;
+			seek();
+
+			return *this;
+		}
+
+
+		public: const_iterator operator++(int)
+		{
+			const_iterator tmp(*this);
+
+			++*this;
+
+			return tmp;
+		}
+
+
+		public: bool operator==(const_iterator const& rhs) const
+		{
+			return pos_ == rhs.pos_;
+		}
+
+
+		public: bool operator!=(const_iterator const& rhs) const
+		{
+			return pos_ != rhs.pos_;
+		}
+
+
+		/// Move to the first set category from the current position on.
+		private: void seek()
+		{
+			while (pos_ < num_physical_resource_categories && !ptr_vec_->test(pos_))
+			{
+				++pos_;
+			}
+			if (pos_ < num_physical_resource_categories)
+			{
+				cur_.first = static_cast<physical_resource_category>(pos_);
+				cur_.second = ptr_vec_->values_[pos_];
+			}
+		}
+
+
+		private: resource_vector const* ptr_vec_;
+		private: size_type pos_;
+		private: value_type cur_;
+	}; // const_iterator
+
+	/// Elements can only be modified through operator[].
+	public: typedef const_iterator iterator;
+
+	friend class const_iterator;
+
+
+	public: resource_vector()
+	: mask_(0)
+	{
+		zero();
+	}
+
+
+	/// Build from a range of <code>(category, value)</code> pairs.
+	public: template <typename ForwardIterT>
+		resource_vector(ForwardIterT first, ForwardIterT last)
+	: mask_(0)
+	{
+		zero();
+
+		for (; first != last; ++first)
+		{
+			(*this)[first->first] = first->second;
+		}
+	}
+
+
+	/// Return the value of the given category, setting it (to zero) if unset.
+	public: real_type& operator[](physical_resource_category category)
+	{
+		mask_ |= bit(category);
+
+		return values_[category];
+	}
+
+
+	/// Return the value of the given category (zero if unset).
+	public: real_type operator()(physical_resource_category category) const
+	{
+		return values_[category];
+	}
+
+
+	public: real_type const& at(physical_resource_category category) const
+	{
+		if (!test(category))
+		{
+			throw ::std::out_of_range("[dcs::des::cloud::resource_vector::at] Unset resource category.");
+		}
+
+		return values_[category];
+	}
+
+
+	public: real_type& at(physical_resource_category category)
+	{
+		if (!test(category))
+		{
+			throw ::std::out_of_range("[dcs::des::cloud::resource_vector::at] Unset resource category.");
+		}
+
+		return values_[category];
+	}
+
+
+	public: size_type count(physical_resource_category category) const
+	{
+		return test(category) ? 1 : 0;
+	}
+
+
+	public: const_iterator find(physical_resource_category category) const
+	{
+		return test(category) ? const_iterator(this, category) : end();
+	}
+
+
+	public: ::std::pair<iterator,bool> insert(value_type const& x)
+	{
+		bool inserted(!test(x.first));
+
+		if (inserted)
+		{
+			(*this)[x.first] = x.second;
+		}
+
+		return ::std::make_pair(const_iterator(this, x.first), inserted);
+	}
+
+
+	public: size_type erase(physical_resource_category category)
+	{
+		size_type n(count(category));
+
+		mask_ &= ~bit(category);
+		values_[category] = 0;
+
+		return n;
+	}
+
+
+	public: void clear()
+	{
+		mask_ = 0;
+		zero();
+	}
+
+
+	public: bool empty() const
+	{
+		return mask_ == 0;
+	}
+
+
+	public: size_type size() const
+	{
+		size_type n(0);
+		for (size_type i = 0; i < num_physical_resource_categories; ++i)
+		{
+			n += test(i) ? 1 : 0;
+		}
+
+		return n;
+	}
+
+
+	public: const_iterator begin() const
+	{
+		return const_iterator(this, 0);
+	}
+
+
+	public: const_iterator end() const
+	{
+		return const_iterator(this, num_physical_resource_categories);
+	}
+
+
+	/// Element-wise sum; categories set in \a rhs become set.
+	public: resource_vector& operator+=(resource_vector const& rhs)
+	{
+		for (size_type i = 0; i < num_physical_resource_categories; ++i)
+		{
+			values_[i] += rhs.values_[i];
+		}
+		mask_ |= rhs.mask_;
+
+		return *this;
+	}
+
+
+	/// Element-wise difference; categories set in \a rhs become set.
+	public: resource_vector& operator-=(resource_vector const& rhs)
+	{
+		for (size_type i = 0; i < num_physical_resource_categories; ++i)
+		{
+			values_[i] -= rhs.values_[i];
+		}
+		mask_ |= rhs.mask_;
+
+		return *this;
+	}
+
+
+	public: bool operator==(resource_vector const& rhs) const
+	{
+		if (mask_ != rhs.mask_)
+		{
+			return false;
+		}
+		for (size_type i = 0; i < num_physical_resource_categories; ++i)
+		{
+			if (values_[i] != rhs.values_[i])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+
+	public: bool operator!=(resource_vector const& rhs) const
+	{
+		return !(*this == rhs);
+	}
+
+
+	private: static mask_type bit(size_type i)
+	{
+		return mask_type(1) << i;
+	}
+
+
+	private: bool test(size_type i) const
+	{
+		return (mask_ & bit(i)) != 0;
+	}
+
+
+	private: void zero()
+	{
+		for (size_type i = 0; i < num_physical_resource_categories; ++i)
+		{
+			values_[i] = 0;
+		}
+	}
+
+
+	/// The value of each category (zero if unset).
+	private: real_type values_[num_physical_resource_categories];
+	/// The set categories (one bit per category).
+	private: mask_type mask_;
+}; // resource_vector
+
+}}} // Namespace dcs::des::cloud
+
+
+#endif // DCS_DES_CLOUD_RESOURCE_VECTOR_HPP
@@ -0,0 +1,602 @@
+/**
+ * \file dcs/des/cloud/trace.hpp
+ *
+ * \brief Structured trace channels with compile-time and run-time levels.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_TRACE_HPP
+#define DCS_DES_CLOUD_TRACE_HPP
+
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/utility.hpp>
+#include <cstddef>
+#include <dcs/memory.hpp>
+#include <fstream>
+#include <ios>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+
+/**
+ * Compile-time trace levels.
+ *
+ * Every channel has a maximum level fixed at compile time; trace statements
+ * above it are removed by the compiler, so that their arguments are never
+ * evaluated.
+ * The default maximum level is given by \c DCS_DES_CLOUD_CONFIG_TRACE_LEVEL
+ * (none in release builds, debug otherwise) and can be overridden per channel
+ * (e.g., \c -DDCS_DES_CLOUD_CONFIG_APP_CONTROLLER_TRACE_LEVEL=3).
+ * Values are: 0=none, 1=error, 2=warn, 3=info, 4=debug.
+ */
+#ifndef DCS_DES_CLOUD_CONFIG_TRACE_LEVEL
+# ifdef NDEBUG
+#  define DCS_DES_CLOUD_CONFIG_TRACE_LEVEL 0
+# else // NDEBUG
+#  define DCS_DES_CLOUD_CONFIG_TRACE_LEVEL 4
+# endif // NDEBUG
+#endif // DCS_DES_CLOUD_CONFIG_TRACE_LEVEL
+
+#ifndef DCS_DES_CLOUD_CONFIG_APP_CONTROLLER_TRACE_LEVEL
+# define DCS_DES_CLOUD_CONFIG_APP_CONTROLLER_TRACE_LEVEL DCS_DES_CLOUD_CONFIG_TRACE_LEVEL
+#endif // DCS_DES_CLOUD_CONFIG_APP_CONTROLLER_TRACE_LEVEL
+
+#ifndef DCS_DES_CLOUD_CONFIG_APP_SIMULATION_TRACE_LEVEL
+# define DCS_DES_CLOUD_CONFIG_APP_SIMULATION_TRACE_LEVEL DCS_DES_CLOUD_CONFIG_TRACE_LEVEL
+#endif // DCS_DES_CLOUD_CONFIG_APP_SIMULATION_TRACE_LEVEL
+
+#ifndef DCS_DES_CLOUD_CONFIG_PM_SIMULATION_TRACE_LEVEL
+# define DCS_DES_CLOUD_CONFIG_PM_SIMULATION_TRACE_LEVEL DCS_DES_CLOUD_CONFIG_TRACE_LEVEL
+#endif // DCS_DES_CLOUD_CONFIG_PM_SIMULATION_TRACE_LEVEL
+
+
+/**
+ * \brief Trace a record on the given channel at the given level.
+ *
+ * Usage:
+ * \code
+ * DCS_DES_CLOUD_TRACE(app_controller, info) << "APP " << app.id() << " - OBSERVATION: " << rt;
+ * \endcode
+ *
+ * The streamed expression is evaluated only if the channel is enabled for the
+ * given level both at compile time and at run time.
+ */
+#define DCS_DES_CLOUD_TRACE(channel,level) \
+	if (!(::dcs::des::cloud::trace_channel_traits< ::dcs::des::cloud::channel##_trace_channel >::max_level >= ::dcs::des::cloud::level##_trace_level \
+		  && ::dcs::des::cloud::tracer::instance().enabled(::dcs::des::cloud::channel##_trace_channel, ::dcs::des::cloud::level##_trace_level))) \
+	{ \
+	} \
+	else \
+		::dcs::des::cloud::trace_record(::dcs::des::cloud::channel##_trace_channel, ::dcs::des::cloud::level##_trace_level).stream()
+
+
+namespace dcs { namespace des { namespace cloud {
+
+enum trace_level
+{
+	none_trace_level = 0,
+	error_trace_level = 1,
+	warn_trace_level = 2,
+	info_trace_level = 3,
+	debug_trace_level = 4
+};
+
+
+enum trace_channel
+{
+	app_controller_trace_channel = 0, ///< Application controllers
+	app_simulation_trace_channel, ///< Application simulation models
+	pm_simulation_trace_channel, ///< Physical machine simulation models
+	num_trace_channels
+};
+
+
+template <int ChannelV>
+struct trace_channel_traits;
+
+template <>
+struct trace_channel_traits<app_controller_trace_channel>
+{
+	static const int max_level = DCS_DES_CLOUD_CONFIG_APP_CONTROLLER_TRACE_LEVEL;
+};
+
+template <>
+struct trace_channel_traits<app_simulation_trace_channel>
+{
+	static const int max_level = DCS_DES_CLOUD_CONFIG_APP_SIMULATION_TRACE_LEVEL;
+};
+
+template <>
+struct trace_channel_traits<pm_simulation_trace_channel>
+{
+	static const int max_level = DCS_DES_CLOUD_CONFIG_PM_SIMULATION_TRACE_LEVEL;
+};
+
+
+inline
+char const* to_string(trace_channel channel)
+{
+	switch (channel)
+	{
+		case app_controller_trace_channel:
+			return "app_controller";
+		case app_simulation_trace_channel:
+			return "app_simulation";
+		case pm_simulation_trace_channel:
+			return "pm_simulation";
+		default:
+			break;
+	}
+
+	throw ::std::invalid_argument("[dcs::des::cloud::to_string] Unknown trace channel.");
+}
+
+
+inline
+char const* to_string(trace_level level)
+{
+	switch (level)
+	{
+		case none_trace_level:
+			return "none";
+		case error_trace_level:
+			return "error";
+		case warn_trace_level:
+			return "warn";
+		case info_trace_level:
+			return "info";
+		case debug_trace_level:
+			return "debug";
+	}
+
+	throw ::std::invalid_argument("[dcs::des::cloud::to_string] Unknown trace level.");
+}
+
+
+/**
+ * \brief Base class for trace sinks.
+ *
+ * Sinks are called with the tracer lock held, hence they need no
+ * synchronization on their own.
+ */
+class base_trace_sink
+{
+	public: virtual ~base_trace_sink()
+	{
+	}
+
+
+	public: void write(trace_channel channel, trace_level level, char const* data, ::std::size_t n)
+	{
+		do_write(channel, level, data, n);
+	}
+
+
+	public: void flush()
+	{
+		do_flush();
+	}
+
+
+	private: virtual void do_write(trace_channel channel, trace_level level, char const* data, ::std::size_t n) = 0;
+
+	private: virtual void do_flush() = 0;
+};
+
+
+namespace detail {
+
+/// Output stream either owned (a file) or borrowed (e.g., \c std::clog), with a write buffer in front of it.
+class trace_sink_buffer: ::boost::noncopyable
+{
+	public: static const ::std::size_t default_capacity = 64*1024;
+
+
+	public: explicit trace_sink_buffer(::std::ostream& os, ::std::size_t capacity)
+	: ptr_os_(&os),
+	  capacity_(capacity)
+	{
+		buf_.reserve(capacity_);
+	}
+
+
+	public: trace_sink_buffer(::std::string const& fname, bool binary, ::std::size_t capacity)
+	: ptr_ofs_(new ::std::ofstream(fname.c_str(), binary ? (::std::ios_base::out | ::std::ios_base::binary) : ::std::ios_base::out)),
+	  ptr_os_(ptr_ofs_.get()),
+	  capacity_(capacity)
+	{
+		if (!ptr_ofs_->good())
+		{
+			throw ::std::runtime_error("[dcs::des::cloud::detail::trace_sink_buffer] Unable to open trace file '" + fname + "'.");
+		}
+
+		buf_.reserve(capacity_);
+	}
+
+
+	public: ~trace_sink_buffer()
+	{
+		flush();
+	}
+
+
+	public: void append(char const* data, ::std::size_t n)
+	{
+		if (buf_.size()+n > capacity_)
+		{
+			drain();
+		}
+		buf_.append(data, n);
+	}
+
+
+	public: void flush()
+	{
+		drain();
+		ptr_os_->flush();
+	}
+
+
+	private: void drain()
+	{
+		if (!buf_.empty())
+		{
+			ptr_os_->write(buf_.data(), buf_.size());
+			buf_.clear();
+		}
+	}
+
+
+	private: ::boost::scoped_ptr< ::std::ofstream > ptr_ofs_;
+	private: ::std::ostream* ptr_os_;
+	private: ::std::size_t capacity_;
+	private: ::std::string buf_;
+};
+
+} // Namespace detail
+
+
+/**
+ * \brief Trace sink writing one human-readable line per record.
+ *
+ * Lines have the form <tt>[channel:level] message</tt>.
+ */
+class text_trace_sink: public base_trace_sink
+{
+	public: explicit text_trace_sink(::std::ostream& os, ::std::size_t capacity = detail::trace_sink_buffer::default_capacity)
+	: buf_(os, capacity)
+	{
+	}
+
+
+	public: explicit text_trace_sink(::std::string const& fname, ::std::size_t capacity = detail::trace_sink_buffer::default_capacity)
+	: buf_(fname, false, capacity)
+	{
+	}
+
+
+	private: void do_write(trace_channel channel, trace_level level, char const* data, ::std::size_t n)
+	{
+		::std::string hdr("[");
+		hdr += to_string(channel);
+		hdr += ":";
+		hdr += to_string(level);
+		hdr += "] ";
+
+		buf_.append(hdr.data(), hdr.size());
+		buf_.append(data, n);
+		buf_.append("\n", 1);
+	}
+
+
+	private: void do_flush()
+	{
+		buf_.flush();
+	}
+
+
+	private: detail::trace_sink_buffer buf_;
+};
+
+
+/**
+ * \brief Trace sink writing binary records.
+ *
+ * The stream starts with the 8-byte magic string \c "DCSTRC01" and is followed
+ * by a sequence of records, each made of:
+ * - the channel (1 byte),
+ * - the level (1 byte),
+ * - the length \e n of the payload (4 bytes, little-endian),
+ * - the payload (\e n bytes, not NUL-terminated).
+ * .
+ */
+class binary_trace_sink: public base_trace_sink
+{
+	public: explicit binary_trace_sink(::std::ostream& os, ::std::size_t capacity = detail::trace_sink_buffer::default_capacity)
+	: buf_(os, capacity)
+	{
+		write_magic();
+	}
+
+
+	public: explicit binary_trace_sink(::std::string const& fname, ::std::size_t capacity = detail::trace_sink_buffer::default_capacity)
+	: buf_(fname, true, capacity)
+	{
+		write_magic();
+	}
+
+
+	private: void write_magic()
+	{
+		buf_.append("DCSTRC01", 8);
+	}
+
+
+	private: void do_write(trace_channel channel, trace_level level, char const* data, ::std::size_t n)
+	{
+		char hdr[6];
+
+		hdr[0] = static_cast<char>(channel);
+		hdr[1] = static_cast<char>(level);
+		for (::std::size_t i = 0; i < 4; ++i)
+		{
+			hdr[2+i] = static_cast<char>((n >> (8*i)) & 0xFF);
+		}
+
+		buf_.append(hdr, sizeof(hdr));
+		buf_.append(data, n);
+	}
+
+
+	private: void do_flush()
+	{
+		buf_.flush();
+	}
+
+
+	private: detail::trace_sink_buffer buf_;
+};
+
+
+/**
+ * \brief Process-wide dispatcher of trace records.
+ *
+ * Holds the run-time level of each channel (all disabled by default) and the
+ * sink records are written to (a buffered text sink on \c std::clog by
+ * default).
+ * Records coming from concurrent simulations are serialized.
+ */
+class tracer: ::boost::noncopyable
+{
+	public: typedef ::dcs::shared_ptr<base_trace_sink> sink_pointer;
+
+
+	public: static tracer& instance()
+	{
+		static tracer t;
+
+		return t;
+	}
+
+
+	public: ~tracer()
+	{
+		flush();
+	}
+
+
+	public: bool enabled(trace_channel channel, trace_level level) const
+	{
+		return level <= levels_[channel];
+	}
+
+
+	public: void level(trace_channel channel, trace_level level)
+	{
+		levels_[channel] = level;
+	}
+
+
+	public: trace_level level(trace_channel channel) const
+	{
+		return levels_[channel];
+	}
+
+
+	/// Set the run-time level of all channels.
+	public: void level(trace_level level)
+	{
+		for (::std::size_t i = 0; i < num_trace_channels; ++i)
+		{
+			levels_[i] = level;
+		}
+	}
+
+
+	/// Parse a run-time level specification of the form \c "channel=level[,...]", where \c channel may be \c "all".
+	public: void configure(::std::string const& spec)
+	{
+		::std::istringstream iss(spec);
+		::std::string item;
+
+		while (::std::getline(iss, item, ','))
+		{
+			::std::string::size_type pos(item.find('='));
+
+			if (pos == ::std::string::npos)
+			{
+				throw ::std::invalid_argument("[dcs::des::cloud::tracer::configure] Malformed trace specification '" + item + "'.");
+			}
+
+			::std::string ch_name(item.substr(0, pos));
+			trace_level lvl(parse_level(item.substr(pos+1)));
+
+			if (ch_name == "all")
+			{
+				level(lvl);
+			}
+			else
+			{
+				level(parse_channel(ch_name), lvl);
+			}
+		}
+	}
+
+
+	/// Set the precision used to format floating-point values.
+	public: void precision(::std::streamsize prec)
+	{
+		precision_ = prec;
+	}
+
+
+	public: ::std::streamsize precision() const
+	{
+		return precision_;
+	}
+
+
+	public: void sink(sink_pointer const& ptr_sink)
+	{
+		::boost::lock_guard< ::boost::mutex > lock(mutex_);
+
+		if (ptr_sink_)
+		{
+			ptr_sink_->flush();
+		}
+		ptr_sink_ = ptr_sink;
+	}
+
+
+	public: void write(trace_channel channel, trace_level level, ::std::string const& msg)
+	{
+		::boost::lock_guard< ::boost::mutex > lock(mutex_);
+
+		if (ptr_sink_)
+		{
+			ptr_sink_->write(channel, level, msg.data(), msg.size());
+		}
+	}
+
+
+	public: void flush()
+	{
+		::boost::lock_guard< ::boost::mutex > lock(mutex_);
+
+		if (ptr_sink_)
+		{
+			ptr_sink_->flush();
+		}
+	}
+
+
+	private: tracer()
+	: ptr_sink_(new text_trace_sink(::std::clog)),
+	  precision_(::std::clog.precision())
+	{
+		level(none_trace_level);
+	}
+
+
+	private: static trace_channel parse_channel(::std::string const& name)
+	{
+		for (::std::size_t i = 0; i < num_trace_channels; ++i)
+		{
+			if (name == to_string(static_cast<trace_channel>(i)))
+			{
+				return static_cast<trace_channel>(i);
+			}
+		}
+
+		throw ::std::invalid_argument("[dcs::des::cloud::tracer::parse_channel] Unknown trace channel '" + name + "'.");
+	}
+
+
+	private: static trace_level parse_level(::std::string const& name)
+	{
+		for (int i = none_trace_level; i <= debug_trace_level; ++i)
+		{
+			if (name == to_string(static_cast<trace_level>(i)))
+			{
+				return static_cast<trace_level>(i);
+			}
+		}
+
+		throw ::std::invalid_argument("[dcs::des::cloud::tracer::parse_level] Unknown trace level '" + name + "'.");
+	}
+
+
+	private: trace_level levels_[num_trace_channels];
+	private: sink_pointer ptr_sink_;
+	private: ::std::streamsize precision_;
+	private: ::boost::mutex mutex_;
+};
+
+
+/**
+ * \brief A single trace record.
+ *
+ * The record is formatted in memory and handed to the tracer when destroyed
+ * (i.e., at the end of the full expression of a \c DCS_DES_CLOUD_TRACE
+ * statement).
+ */
+class trace_record: ::boost::noncopyable
+{
+	public: trace_record(trace_channel channel, trace_level level)
+	: channel_(channel),
+	  level_(level)
+	{
+		oss_.precision(tracer::instance().precision());
+	}
+
+
+	public: ~trace_record()
+	{
+		try
+		{
+			tracer::instance().write(channel_, level_, oss_.str());
+		}
+		catch (...)
+		{
+			// Tracing must never break the simulation
+		}
+	}
+
+
+	public: ::std::ostream& stream()
+	{
+		return oss_;
+	}
+
+
+	private: trace_channel channel_;
+	private: trace_level level_;
+	private: ::std::ostringstream oss_;
+};
+
+}}} // Namespace dcs::des::cloud
+
+
+#endif // DCS_DES_CLOUD_TRACE_HPP
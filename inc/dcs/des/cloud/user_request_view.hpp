@@ -0,0 +1,180 @@
+/**
+ * \file dcs/des/cloud/user_request_view.hpp
+ *
+ * \brief Read-only view over the state of a user request.
+ *
+ * Copyright (C) 2009-2011  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#ifndef DCS_DES_CLOUD_USER_REQUEST_VIEW_HPP
+#define DCS_DES_CLOUD_USER_REQUEST_VIEW_HPP
+
+
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/des/cloud/physical_resource_category.hpp>
+#include <dcs/des/cloud/resource_utilization_profile.hpp>
+#include <dcs/memory.hpp>
+#include <iosfwd>
+
+
+namespace dcs { namespace des { namespace cloud {
+
+template <typename TraitsT>
+class base_application_simulation_model;
+
+
+/**
+ * \brief Read-only view over the state of a user request.
+ *
+ * Unlike \c user_request, which copies per-tier arrival/departure times and
+ * utilization profiles when it is built, a view only keeps a reference to the
+ * application simulation model and to the model-specific request state (e.g.,
+ * the queueing network customer).
+ * Every accessor is resolved lazily by the owning model, so that event
+ * handlers only pay for what they actually read.
+ *
+ * A view must not outlive the application simulation model it comes from.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+template <typename TraitsT>
+class user_request_view
+{
+	public: typedef TraitsT traits_type;
+	public: typedef typename traits_type::real_type real_type;
+	public: typedef typename traits_type::uint_type uint_type;
+	public: typedef uint_type identifier_type;
+	public: typedef resource_utilization_profile<traits_type> utilization_profile_type;
+	public: typedef base_application_simulation_model<traits_type> application_simulation_model_type;
+	public: typedef ::dcs::shared_ptr<void> state_pointer;
+
+
+	public: user_request_view()
+	: ptr_model_(0)
+	{
+	}
+
+
+	public: user_request_view(application_simulation_model_type const& model, state_pointer const& ptr_state)
+	: ptr_model_(&model),
+	  ptr_state_(ptr_state)
+	{
+	}
+
+
+	public: identifier_type id() const
+	{
+		return model().request_id(ptr_state_);
+	}
+
+
+	public: uint_type current_tier() const
+	{
+		return model().request_current_tier(ptr_state_);
+	}
+
+
+	public: real_type arrival_time() const
+	{
+		return model().request_arrival_time(ptr_state_);
+	}
+
+
+	public: real_type departure_time() const
+	{
+		return model().request_departure_time(ptr_state_);
+	}
+
+
+	/// Number of times this request has entered the given tier.
+	public: ::std::size_t tier_num_visits(uint_type tier_id) const
+	{
+		return model().request_tier_num_visits(ptr_state_, tier_id);
+	}
+
+
+	public: real_type tier_arrival_time(uint_type tier_id, ::std::size_t visit) const
+	{
+		return model().request_tier_arrival_time(ptr_state_, tier_id, visit);
+	}
+
+
+	/// \pre The given visit must be completed.
+	public: real_type tier_departure_time(uint_type tier_id, ::std::size_t visit) const
+	{
+		return model().request_tier_departure_time(ptr_state_, tier_id, visit);
+	}
+
+
+	/// Sum of the residence times of all the completed visits to the given tier.
+	public: real_type tier_residence_time(uint_type tier_id) const
+	{
+		return model().request_tier_residence_time(ptr_state_, tier_id);
+	}
+
+
+	/// Utilization profile of the most recent visit to the given tier (empty if none).
+	public: utilization_profile_type tier_last_utilization_profile(uint_type tier_id, physical_resource_category category) const
+	{
+		return model().request_tier_last_utilization_profile(ptr_state_, tier_id, category);
+	}
+
+
+	public: state_pointer const& state() const
+	{
+		return ptr_state_;
+	}
+
+
+	private: application_simulation_model_type const& model() const
+	{
+		// pre: view must be bound to a model
+		DCS_DEBUG_ASSERT( ptr_model_ );
+
+		return *ptr_model_;
+	}
+
+
+	/// The application simulation model owning the request.
+	private: application_simulation_model_type const* ptr_model_;
+	/// The model-specific request state.
+	private: state_pointer ptr_state_;
+};
+
+
+template <
+    typename CharT,
+    typename CharTraitsT,
+    typename TraitsT
+>
+::std::basic_ostream<CharT,CharTraitsT>& operator<<(::std::basic_ostream<CharT,CharTraitsT>& os, user_request_view<TraitsT> const& req)
+{
+    return os << "<"
+			  <<   "ID: " << req.id()
+			  << ", Tier: " << req.current_tier()
+			  << ", Arrival Time: " << req.arrival_time()
+			  << ", Departure Time: " << req.departure_time()
+			  << ">";
+}
+
+}}} // Namespace dcs::des::cloud
+
+
+#endif // DCS_DES_CLOUD_USER_REQUEST_VIEW_HPP
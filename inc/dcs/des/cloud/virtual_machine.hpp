@@ -43,6 +43,7 @@
 #include <dcs/des/cloud/physical_resource_view.hpp>
 #include <dcs/des/cloud/power_status.hpp>
 #include <dcs/des/cloud/registry.hpp>
+#include <dcs/des/cloud/resource_vector.hpp>
 #include <dcs/des/cloud/utility.hpp>
 #include <dcs/des/cloud/virtual_machine_monitor.hpp>
 #include <dcs/exception.hpp>
@@ -90,7 +91,7 @@ class virtual_machine
 	public: typedef typename traits_type::real_type real_type;
 	public: typedef typename traits_type::uint_type uint_type;
 	public: typedef typename traits_type::virtual_machine_identifier_type identifier_type;
-	private: typedef ::std::map<physical_resource_category,real_type> resource_share_impl_container;
+	private: typedef resource_vector<real_type> resource_share_impl_container;
 	private: typedef ::std::pair<physical_resource_category, real_type> resource_share_type;
 	public: typedef ::std::vector<resource_share_type> resource_share_container;
 	public: typedef application_tier<traits_type> application_tier_type;
@@ -465,12 +466,18 @@ class virtual_machine
 			update_wanted_share_stats(wanted_res_shares_.begin(), wanted_res_shares_.end());
 			update_share_stats(res_shares_.begin(), res_shares_.end());
 		}
+
+		notify_power_status(old_status);
 	}
 
 
 	public: void power_off()
 	{
+		power_status old_status(power_status_);
+
 		power_status_ = powered_off_power_status;
+
+		notify_power_status(old_status);
 	}
 
 
@@ -482,7 +489,11 @@ class virtual_machine
 			::std::logic_error("[dcs::des::cloud::virtual_machine::suspend] Cannot suspend a non-running virtual machine.")
 		);
 
+		power_status old_status(power_status_);
+
 		power_status_ = suspended_power_status;
+
+		notify_power_status(old_status);
 	}
 
 
@@ -494,8 +505,12 @@ class virtual_machine
 			::std::logic_error("[dcs::des::cloud::virtual_machine::resume] Cannot resume a non-suspended virtual machine.")
 		);
 
+		power_status old_status(power_status_);
+
 		power_status_ = powered_on_power_status;
 
+		notify_power_status(old_status);
+
 		update_wanted_share_stats(wanted_res_shares_.begin(), wanted_res_shares_.end());
 		update_share_stats(res_shares_.begin(), res_shares_.end());
 	}
@@ -576,6 +591,16 @@ class virtual_machine
 	}
 
 
+	/// Let the hosting VMM (if any) update its per-power-status lists.
+	private: void notify_power_status(power_status old_status)
+	{
+		if (ptr_vmm_ && old_status != power_status_)
+		{
+			ptr_vmm_->power_status_changed(*this, old_status);
+		}
+	}
+
+
 	private: void create_share_stats(physical_resource_category category)
 	{
 		typedef ::dcs::des::cloud::registry<traits_type> registry_type;
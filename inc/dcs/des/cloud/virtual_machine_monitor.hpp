@@ -35,6 +35,7 @@
 #include <dcs/macro.hpp>
 #include <dcs/memory.hpp>
 //#include <map>
+#include <cstddef>
 #include <stdexcept>
 #include <map>
 #include <vector>
@@ -67,7 +68,8 @@ class virtual_machine_monitor//: public base_virtual_machine_monitor<TraitsT>
 
 
 	public: virtual_machine_monitor()
-	: ptr_pm_(0)
+	: status_vms_(num_power_statuses),
+	  ptr_pm_(0)
 //		: vms_counter_(0)
 	{
 	}
@@ -127,7 +129,13 @@ class virtual_machine_monitor//: public base_virtual_machine_monitor<TraitsT>
 		);
 
 		ptr_vm->vmm(this);
+		if (vms_.count(ptr_vm->id()) > 0)
+		{
+			erase_vm(ptr_vm->id());
+		}
 		vms_[ptr_vm->id()] = ptr_vm;
+		insert_vm(vm_list_, ptr_vm);
+		insert_vm(status_vms_[ptr_vm->power_state()], ptr_vm);
 	}
 
 
@@ -148,46 +156,42 @@ class virtual_machine_monitor//: public base_virtual_machine_monitor<TraitsT>
 		}
 
 		ptr_vm->vmm(0);
-		vms_.erase(ptr_vm->id());
+		erase_vm(ptr_vm->id());
 	}
 
 
-	public: virtual_machine_container virtual_machines() const
+	/// Return the hosted VMs, ordered by identifier.
+	public: virtual_machine_container const& virtual_machines() const
 	{
-		typedef typename virtual_machine_impl_container::const_iterator iterator;
-
-		virtual_machine_container vms;
-
-		iterator end_it = vms_.end();
-		for (iterator it = vms_.begin(); it != end_it; ++it)
-		{
-			virtual_machine_pointer ptr_vm(it->second);
-
-			vms.push_back(ptr_vm);
-		}
-
-		return vms;
+		return vm_list_;
 	}
 
 
-	public: virtual_machine_container virtual_machines(power_status status) const
+	/**
+	 * \brief Return the hosted VMs in the given power status, ordered by
+	 *  identifier.
+	 *
+	 * The returned list is kept up-to-date on every power transition, so it
+	 * must be copied if VMs are powered on/off while iterating over it.
+	 */
+	public: virtual_machine_container const& virtual_machines(power_status status) const
 	{
-		typedef typename virtual_machine_impl_container::const_iterator iterator;
+		return status_vms_[status];
+	}
 
-		virtual_machine_container vms;
 
-		iterator end_it = vms_.end();
-		for (iterator it = vms_.begin(); it != end_it; ++it)
+	/// Move a hosted VM to the list of its new power status.
+	public: void power_status_changed(virtual_machine_type const& vm, power_status old_status)
+	{
+		if (vms_.count(vm.id()) == 0 || vm.power_state() == old_status)
 		{
-			virtual_machine_pointer ptr_vm(it->second);
-
-			if (ptr_vm->power_state() == status)
-			{
-				vms.push_back(ptr_vm);
-			}
+			return;
 		}
 
-		return vms;
+		virtual_machine_pointer ptr_vm(vms_.at(vm.id()));
+
+		remove_vm(status_vms_[old_status], vm.id());
+		insert_vm(status_vms_[vm.power_state()], ptr_vm);
 	}
 
 
@@ -332,8 +336,51 @@ class virtual_machine_monitor//: public base_virtual_machine_monitor<TraitsT>
 	}
 
 
+	/// Insert a VM in the given list, keeping it ordered by identifier.
+	private: static void insert_vm(virtual_machine_container& vms, virtual_machine_pointer const& ptr_vm)
+	{
+		typename virtual_machine_container::iterator it(vms.begin());
+		while (it != vms.end() && (*it)->id() < ptr_vm->id())
+		{
+			++it;
+		}
+		vms.insert(it, ptr_vm);
+	}
+
+
+	/// Remove the VM with the given identifier from the given list (if any).
+	private: static void remove_vm(virtual_machine_container& vms, virtual_machine_identifier_type id)
+	{
+		typename virtual_machine_container::iterator end_it(vms.end());
+		for (typename virtual_machine_container::iterator it = vms.begin(); it != end_it; ++it)
+		{
+			if ((*it)->id() == id)
+			{
+				vms.erase(it);
+				break;
+			}
+		}
+	}
+
+
+	/// Remove the VM with the given identifier from all the lists.
+	private: void erase_vm(virtual_machine_identifier_type id)
+	{
+		vms_.erase(id);
+		remove_vm(vm_list_, id);
+		for (::std::size_t i = 0; i < status_vms_.size(); ++i)
+		{
+			remove_vm(status_vms_[i], id);
+		}
+	}
+
+
 //	private: uint_type vms_counter_;
 	private: virtual_machine_impl_container vms_;
+	/// The hosted VMs, ordered by identifier
+	private: virtual_machine_container vm_list_;
+	/// The hosted VMs in each power status, ordered by identifier
+	private: ::std::vector<virtual_machine_container> status_vms_;
 	//private: uint_type_name_container vm_id_names_;
 	/// The performance overhead associated to virtualization
 	private: physical_machine_pointer ptr_pm_;
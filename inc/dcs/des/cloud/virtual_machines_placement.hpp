@@ -29,6 +29,7 @@
 #include <cstddef>
 #include <dcs/math/traits/float.hpp>
 #include <dcs/des/cloud/physical_resource_category.hpp>
+#include <dcs/des/cloud/resource_vector.hpp>
 #include <dcs/des/cloud/utility.hpp>
 #include <iostream>
 #include <map>
@@ -64,7 +65,7 @@ class virtual_machines_placement
 	private: typedef typename traits_type::virtual_machine_identifier_type physical_machine_identifier_type;
 	private: typedef typename traits_type::virtual_machine_identifier_type virtual_machine_identifier_type;
 	private: typedef ::std::pair<virtual_machine_identifier_type,physical_machine_identifier_type> vm_pm_pair_type;
-	private: typedef ::std::map<physical_resource_category,real_type> share_container;
+	private: typedef resource_vector<real_type> share_container;
 	private: typedef ::std::map<vm_pm_pair_type,share_container> placement_container;
 	//private: typedef ::std::vector<physical_machine_identifier_type> by_vm_index_container;
 	private: typedef ::std::map<virtual_machine_identifier_type,physical_machine_identifier_type> by_vm_index_container;
@@ -76,7 +77,9 @@ class virtual_machines_placement
 	public: typedef typename placement_container::const_iterator const_iterator;
 	public: typedef typename share_container::iterator share_iterator;
 	public: typedef typename share_container::const_iterator share_const_iterator;
-	public: typedef ::std::map<physical_resource_category, real_type> resource_utilization_map;
+	public: typedef resource_vector<real_type> resource_utilization_map;
+	private: typedef ::std::map<physical_machine_identifier_type,share_container> by_pm_share_container;
+	private: typedef ::std::map<physical_machine_identifier_type,resource_utilization_map> by_pm_utilization_container;
 
 
 	public: template <typename ForwardShareIterT, typename ForwardUtilIterT>
@@ -88,118 +91,10 @@ class virtual_machines_placement
 					   ForwardUtilIterT last_util,
 					   data_center_type const& dc)
 	{
-		typedef typename data_center_type::virtual_machine_pointer virtual_machine_pointer;
-		typedef typename share_container::const_iterator share_iterator;
-		typedef typename by_pm_index_subcontainer::const_iterator pm_vm_iterator;
-
-		physical_machine_identifier_type pm_id(pm.id());
-		virtual_machine_identifier_type vm_id(vm.id());
-
-//		share_container wanted_shares(first_share, last_share);
 		share_container free_shares;
-		share_container wanted_shares;
 		resource_utilization_map free_utils;
-		resource_utilization_map wanted_utils;
 
-		// Initialize wanted and free shares containers and make some
-		// preliminary check.
-		while (first_share != last_share)
-		{
-			physical_resource_category category(first_share->first);
-			//real_type max_share(pm.resource(category)->utilization_threshold());
-			real_type max_share(1);//FIXME: usare ref_penalty config parameter oppure prevedere un share_threshold per ogni risorsa fisica
-			real_type wanted_share(first_share->second);
-			if (::dcs::math::float_traits<real_type>::definitely_greater(wanted_share, max_share))
-			{
-				return false;
-			}
-			wanted_shares[category] = wanted_share;
-			free_shares[category] = max_share;
-//			if (!wanted_utils.empty())
-//			{
-//				free_utils[category] = pm.resource(category)->utilization_threshold();
-//			}
-			++first_share;
-		}
-
-		// Initialize wanted and free utilizations containers and make some
-		// preliminary check.
-		while (first_util != last_util)
-		{
-			physical_resource_category category(first_util->first);
-			real_type max_util(pm.resource(category)->utilization_threshold());
-			real_type wanted_util(first_util->second);
-			if (::dcs::math::float_traits<real_type>::definitely_greater(wanted_util, max_util))
-			{
-				return false;
-			}
-			wanted_utils[category] = wanted_util;
-			free_utils[category] = max_util;
-			++first_util;
-		}
-
-		if (by_pm_idx_.count(pm_id) > 0)
-		{
-			pm_vm_iterator pm_vm_end_it(by_pm_idx_.at(pm_id).end());
-			for (pm_vm_iterator pm_vm_it = by_pm_idx_.at(pm_id).begin(); pm_vm_it != pm_vm_end_it; ++pm_vm_it)
-			{
-				// Iterate over each VM deployed on this machine (but the one we
-				// currently want to place)
-
-				if (*pm_vm_it != vm_id)
-				{
-					vm_pm_pair_type key(make_vm_pm_pair(*pm_vm_it, pm_id));
-
-					share_iterator share_end_it(placements_.at(key).end());
-					for (share_iterator share_it = placements_.at(key).begin(); share_it != share_end_it; ++share_it)
-					{
-						physical_resource_category category(share_it->first);
-
-						free_shares[category] -= share_it->second;
-
-						if (
-								(
-									wanted_shares.count(category) > 0
-									&&
-									::dcs::math::float_traits<real_type>::definitely_less(free_shares.at(category), wanted_shares.at(category))
-								)
-								||
-								free_shares[category] <= 0)
-						{
-							return false;
-						}
-
-						if (!wanted_utils.empty())
-						{
-							virtual_machine_pointer ptr_vm(dc.virtual_machine_ptr(*pm_vm_it));
-
-							// check: paranoid check
-							DCS_DEBUG_ASSERT( ptr_vm );
-
-							free_utils[category] -= scale_resource_utilization(ptr_vm->guest_system().application().reference_resource(category).capacity(),
-																			   ptr_vm->guest_system().resource_share(category),
-																			   pm.resource(category)->capacity(),
-																			   share_it->second,
-																			   ptr_vm->guest_system().application().performance_model().tier_measure(ptr_vm->guest_system().id(), ::dcs::des::cloud::utilization_performance_measure),
-																			   pm.resource(category)->utilization_threshold());
-							if (
-									(
-										wanted_utils.count(category) > 0
-										&&
-										::dcs::math::float_traits<real_type>::definitely_less(free_utils.at(category), wanted_utils.at(category))
-									)
-									||
-									free_utils[category] <= 0)
-							{
-								return false;
-							}
-						}
-					}
-				}
-			}
-		}
-
-		return true;
+		return residual_capacity(vm, pm, first_share, last_share, first_util, last_util, dc, free_shares, free_utils);
 	}
 
 
@@ -220,6 +115,21 @@ class virtual_machines_placement
 	}
 
 
+	/// Returns the share of the given resource not yet assigned to any VM placed on the given PM.
+	public: real_type residual_share(physical_machine_identifier_type pm_id, physical_resource_category category) const
+	{
+		//FIXME: usare ref_penalty config parameter oppure prevedere un share_threshold per ogni risorsa fisica
+		real_type max_share(1);
+
+		if (pm_shares_.count(pm_id) == 0 || pm_shares_.at(pm_id).count(category) == 0)
+		{
+			return max_share;
+		}
+
+		return max_share-pm_shares_.at(pm_id).at(category);
+	}
+
+
 	public: template <typename ForwardShareIterT, typename ForwardUtilIterT>
 		bool try_place(virtual_machine_type& vm,
 					   physical_machine_type& pm,
@@ -253,6 +163,7 @@ class virtual_machines_placement
 //		}
 		by_vm_idx_[vm_id] = pm_id;
 		by_pm_idx_[pm_id].insert(vm_id);
+		update_pm_resources(pm_id);
 
 		return true;
 	}
@@ -366,6 +277,7 @@ class virtual_machines_placement
 		placements_.erase(make_vm_pm_pair(vm_id, pm_id));
 		by_vm_idx_.erase(vm_id);
 		by_pm_idx_[pm_id].erase(vm_id);
+		update_pm_resources(pm_id);
 	}
 
 
@@ -400,6 +312,8 @@ class virtual_machines_placement
 		placements_.clear();
 		by_vm_idx_.clear();
 		by_pm_idx_.clear();
+		pm_shares_.clear();
+		pm_utils_.clear();
 	}
 
 
@@ -421,6 +335,18 @@ class virtual_machines_placement
 	}
 
 
+	/// Returns the number of VMs placed on the given PM.
+	public: size_type vm_size(physical_machine_identifier_type pm_id) const
+	{
+		if (by_pm_idx_.count(pm_id) == 0)
+		{
+			return 0;
+		}
+
+		return by_pm_idx_.at(pm_id).size();
+	}
+
+
 	public: bool empty() const
 	{
 		return placements_.empty();
@@ -599,6 +525,242 @@ class virtual_machines_placement
 //[/XXX]
 
 
+	/**
+	 * \brief Checks if a VM is placeable on a PM and computes the PM free
+	 *  shares and utilizations as seen by that VM.
+	 *
+	 * Resources used by the VMs already on the PM come from the per-PM
+	 * aggregates, so that the check costs O(#resources) instead of
+	 * O(#VMs on the PM).
+	 * The aggregates are only recomputed if the VM is itself placed on the
+	 * PM (since its own contribution must be excluded).
+	 */
+	private: template <typename ForwardShareIterT, typename ForwardUtilIterT>
+		bool residual_capacity(virtual_machine_type const& vm,
+							   physical_machine_type const& pm,
+							   ForwardShareIterT first_share,
+							   ForwardShareIterT last_share,
+							   ForwardUtilIterT first_util,
+							   ForwardUtilIterT last_util,
+							   data_center_type const& dc,
+							   share_container& free_shares,
+							   resource_utilization_map& free_utils)
+	{
+		typedef typename share_container::const_iterator share_iterator;
+		typedef typename resource_utilization_map::const_iterator utilization_iterator;
+
+		physical_machine_identifier_type pm_id(pm.id());
+		virtual_machine_identifier_type vm_id(vm.id());
+
+		share_container wanted_shares;
+		resource_utilization_map wanted_utils;
+
+		// Initialize wanted and free shares containers and make some
+		// preliminary check.
+		while (first_share != last_share)
+		{
+			physical_resource_category category(first_share->first);
+			//real_type max_share(pm.resource(category)->utilization_threshold());
+			real_type max_share(1);//FIXME: usare ref_penalty config parameter oppure prevedere un share_threshold per ogni risorsa fisica
+			real_type wanted_share(first_share->second);
+			if (::dcs::math::float_traits<real_type>::definitely_greater(wanted_share, max_share))
+			{
+				return false;
+			}
+			wanted_shares[category] = wanted_share;
+			free_shares[category] = max_share;
+			++first_share;
+		}
+
+		// Initialize wanted and free utilizations containers and make some
+		// preliminary check.
+		while (first_util != last_util)
+		{
+			physical_resource_category category(first_util->first);
+			real_type max_util(pm.resource(category)->utilization_threshold());
+			real_type wanted_util(first_util->second);
+			if (::dcs::math::float_traits<real_type>::definitely_greater(wanted_util, max_util))
+			{
+				return false;
+			}
+			wanted_utils[category] = wanted_util;
+			free_utils[category] = max_util;
+			++first_util;
+		}
+
+		if (by_pm_idx_.count(pm_id) == 0 || by_pm_idx_.at(pm_id).empty())
+		{
+			return true;
+		}
+
+		bool self_placed(placed(vm_id, pm_id));
+
+		// Check shares
+
+		share_container used_shares;
+		if (self_placed)
+		{
+			used_shares = sum_pm_shares(pm_id, &vm_id);
+		}
+		else if (pm_shares_.count(pm_id) > 0)
+		{
+			used_shares = pm_shares_.at(pm_id);
+		}
+		share_iterator share_end_it(used_shares.end());
+		for (share_iterator share_it = used_shares.begin(); share_it != share_end_it; ++share_it)
+		{
+			physical_resource_category category(share_it->first);
+
+			// NOTE: a resource used on the PM but not wanted by the VM
+			//       yields a non-positive free share.
+			free_shares[category] -= share_it->second;
+
+			if (
+					(
+						wanted_shares.count(category) > 0
+						&&
+						::dcs::math::float_traits<real_type>::definitely_less(free_shares.at(category), wanted_shares.at(category))
+					)
+					||
+					free_shares[category] <= 0)
+			{
+				return false;
+			}
+		}
+
+		// Check utilizations
+
+		if (!wanted_utils.empty())
+		{
+			resource_utilization_map used_utils;
+			if (self_placed)
+			{
+				used_utils = sum_pm_utilizations(pm, &vm_id, dc);
+			}
+			else
+			{
+				if (pm_utils_.count(pm_id) == 0)
+				{
+					pm_utils_[pm_id] = sum_pm_utilizations(pm, 0, dc);
+				}
+				used_utils = pm_utils_.at(pm_id);
+			}
+			utilization_iterator util_end_it(used_utils.end());
+			for (utilization_iterator util_it = used_utils.begin(); util_it != util_end_it; ++util_it)
+			{
+				physical_resource_category category(util_it->first);
+
+				free_utils[category] -= util_it->second;
+
+				if (
+						(
+							wanted_utils.count(category) > 0
+							&&
+							::dcs::math::float_traits<real_type>::definitely_less(free_utils.at(category), wanted_utils.at(category))
+						)
+						||
+						free_utils[category] <= 0)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+
+	/// Sums the shares assigned to the VMs placed on the given PM (but the excluded one, if any).
+	private: share_container sum_pm_shares(physical_machine_identifier_type pm_id, virtual_machine_identifier_type const* ptr_excluded_vm_id) const
+	{
+		typedef typename by_pm_index_subcontainer::const_iterator pm_vm_iterator;
+
+		share_container used_shares;
+
+		if (by_pm_idx_.count(pm_id) == 0)
+		{
+			return used_shares;
+		}
+
+		pm_vm_iterator pm_vm_end_it(by_pm_idx_.at(pm_id).end());
+		for (pm_vm_iterator pm_vm_it = by_pm_idx_.at(pm_id).begin(); pm_vm_it != pm_vm_end_it; ++pm_vm_it)
+		{
+			if (ptr_excluded_vm_id && *pm_vm_it == *ptr_excluded_vm_id)
+			{
+				continue;
+			}
+
+			used_shares += placements_.at(make_vm_pm_pair(*pm_vm_it, pm_id));
+		}
+
+		return used_shares;
+	}
+
+
+	/// Sums the utilizations, scaled to the given PM, of the VMs placed on it (but the excluded one, if any).
+	private: resource_utilization_map sum_pm_utilizations(physical_machine_type const& pm, virtual_machine_identifier_type const* ptr_excluded_vm_id, data_center_type const& dc) const
+	{
+		typedef typename data_center_type::virtual_machine_pointer virtual_machine_pointer;
+		typedef typename by_pm_index_subcontainer::const_iterator pm_vm_iterator;
+		typedef typename share_container::const_iterator share_iterator;
+
+		physical_machine_identifier_type pm_id(pm.id());
+		resource_utilization_map used_utils;
+
+		if (by_pm_idx_.count(pm_id) == 0)
+		{
+			return used_utils;
+		}
+
+		pm_vm_iterator pm_vm_end_it(by_pm_idx_.at(pm_id).end());
+		for (pm_vm_iterator pm_vm_it = by_pm_idx_.at(pm_id).begin(); pm_vm_it != pm_vm_end_it; ++pm_vm_it)
+		{
+			if (ptr_excluded_vm_id && *pm_vm_it == *ptr_excluded_vm_id)
+			{
+				continue;
+			}
+
+			virtual_machine_pointer ptr_vm(dc.virtual_machine_ptr(*pm_vm_it));
+
+			// check: paranoid check
+			DCS_DEBUG_ASSERT( ptr_vm );
+
+			share_container const& shares(placements_.at(make_vm_pm_pair(*pm_vm_it, pm_id)));
+			share_iterator share_end_it(shares.end());
+			for (share_iterator share_it = shares.begin(); share_it != share_end_it; ++share_it)
+			{
+				physical_resource_category category(share_it->first);
+
+				used_utils[category] += scale_resource_utilization(ptr_vm->guest_system().application().reference_resource(category).capacity(),
+																   ptr_vm->guest_system().resource_share(category),
+																   pm.resource(category)->capacity(),
+																   share_it->second,
+																   ptr_vm->guest_system().application().performance_model().tier_measure(ptr_vm->guest_system().id(), ::dcs::des::cloud::utilization_performance_measure),
+																   pm.resource(category)->utilization_threshold());
+			}
+		}
+
+		return used_utils;
+	}
+
+
+	/// Refreshes the per-PM resource aggregates after a placement change on the given PM.
+	private: void update_pm_resources(physical_machine_identifier_type pm_id)
+	{
+		if (by_pm_idx_.count(pm_id) > 0 && !by_pm_idx_.at(pm_id).empty())
+		{
+			pm_shares_[pm_id] = sum_pm_shares(pm_id, 0);
+		}
+		else
+		{
+			pm_shares_.erase(pm_id);
+		}
+
+		// Utilizations need the data center to be computed: recompute lazily.
+		pm_utils_.erase(pm_id);
+	}
+
+
 	private: template <typename ForwardShareIterT>
 		bool placement_need_update(virtual_machine_type& vm,
 								   physical_machine_type& pm,
@@ -640,6 +802,10 @@ class virtual_machines_placement
 	private: placement_container placements_;
 	private: by_vm_index_container by_vm_idx_;
 	private: by_pm_index_container by_pm_idx_;
+	/// Per-PM sum of the shares of the placed VMs.
+	private: by_pm_share_container pm_shares_;
+	/// Per-PM sum of the (scaled) utilizations of the placed VMs; lazily computed.
+	private: by_pm_utilization_container pm_utils_;
 };
 
 
@@ -22,13 +22,21 @@
  * \author Marco Guazzone (marco.guazzone@gmail.com)
  */
 
+#include <algorithm>
+#include <boost/variant.hpp>
+#include <cerrno>
+#include <cmath>
 #include <cstddef>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <dcs/assert.hpp>
 #include <dcs/des/engine.hpp>
 #include <dcs/des/engine_traits.hpp>
+#include <dcs/des/mean_estimator.hpp>
 #include <dcs/des/cloud/config/configuration.hpp>
+#include <dcs/des/cloud/config/operation/make_application_controller.hpp>
 #include <dcs/des/cloud/config/operation/make_data_center.hpp>
 #include <dcs/des/cloud/config/operation/make_data_center_manager.hpp>
 #include <dcs/des/cloud/config/operation/make_des_engine.hpp>
@@ -38,12 +46,15 @@
 #include <dcs/des/cloud/config/yaml.hpp>
 #include <dcs/des/cloud/data_center.hpp>
 #include <dcs/des/cloud/data_center_manager.hpp>
+#include <dcs/des/cloud/detail/system_utility.hpp>
 #include <dcs/des/cloud/physical_resource_category.hpp>
 #include <dcs/des/cloud/performance_measure_category.hpp>
 #include <dcs/des/cloud/registry.hpp>
+#include <dcs/des/cloud/trace.hpp>
 #include <dcs/des/cloud/virtual_machine.hpp>
 #include <dcs/des/cloud/traits.hpp>
 #include <dcs/des/cloud/logging/base_logger.hpp>
+#include <dcs/des/cloud/mser_mean_estimator.hpp>
 #include <dcs/functional/bind.hpp>
 #include <dcs/macro.hpp>
 //#include <dcs/math/random/any_generator.hpp>
@@ -57,9 +68,15 @@
 #endif // DCS_DEBUG
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <vector>
 #include <yaml-cpp/yaml.h>
 
@@ -102,12 +119,15 @@ typedef dcs::des::cloud::traits<
 		> traits_type;
 typedef dcs::des::cloud::registry<traits_type> registry_type;
 typedef ::dcs::math::random::minstd_rand1 random_seeder_type;
+typedef dcs::des::cloud::config::configuration<real_type,uint_type> configuration_type;
+typedef dcs::shared_ptr<configuration_type> configuration_pointer;
 
 
 namespace detail { namespace /*<unnamed>*/ {
 
 typedef ::dcs::des::engine_traits<des_engine_type>::event_type des_event_type;
 typedef ::dcs::des::engine_traits<des_engine_type>::engine_context_type des_engine_context_type;
+typedef ::dcs::des::engine_traits<des_engine_type>::event_source_type des_event_source_type;
 
 
 inline
@@ -118,7 +138,21 @@ void usage()
 				<< "Options:" << ::std::endl
 				<< "  --partial-stats" << ::std::endl
 				<< "  --conf <configuration-file>" << ::std::endl
-				<< "  --out-data-file <output-data-file>" << ::std::endl;
+				<< "  --jobs <max-num-concurrent-replications>" << ::std::endl
+				<< "  --control-threads <max-num-threads-per-control-tick>" << ::std::endl
+				<< "    (with more than one thread, control steps see the VM shares at the" << ::std::endl
+				<< "     beginning of the tick, so results differ from single-threaded runs" << ::std::endl
+				<< "     when applications share physical machines)" << ::std::endl
+				<< "  --out-data-file <output-data-file>" << ::std::endl
+				<< "  --fork-at <simulated-time>" << ::std::endl
+				<< "  --fork-variants <configuration-file>[,<configuration-file>...]" << ::std::endl
+				<< "    (at the given time, fork one process per variant, which goes on" << ::std::endl
+				<< "     with the application controllers of its configuration file)" << ::std::endl
+				<< "  --trace <channel>=<level>[,<channel>=<level>...]" << ::std::endl
+				<< "    (channels: all, app_controller, app_simulation, pm_simulation;" << ::std::endl
+				<< "     levels: none, error, warn, info, debug)" << ::std::endl
+				<< "  --trace-file <trace-file>" << ::std::endl
+				<< "  --trace-binary" << ::std::endl;
 }
 
 
@@ -329,6 +363,12 @@ class simulated_system
 	public: typedef ::dcs::shared_ptr<data_center_manager_type> data_center_manager_pointer;
 
 
+	public: simulated_system()
+	: batch_means_(false)
+	{
+	}
+
+
 	public: void data_center(data_center_pointer const& ptr_dc)
 	{
 		ptr_dc_ = ptr_dc;
@@ -365,8 +405,27 @@ class simulated_system
 	}
 
 
+	/**
+	 * \brief Tells if output statistics are estimated by batch means.
+	 *
+	 * Machine and data center statistics are observed once per run, so they
+	 * are not supported in batch-means mode.
+	 */
+	public: void batch_means(bool value)
+	{
+		batch_means_ = value;
+	}
+
+
+	public: bool batch_means() const
+	{
+		return batch_means_;
+	}
+
+
 	private: data_center_pointer ptr_dc_;
 	private: data_center_manager_pointer ptr_dc_mngr_;
+	private: bool batch_means_;
 }; // simulated_system
 
 
@@ -385,6 +444,8 @@ void report_stats(::std::basic_ostream<CharT,CharTraitsT>& os, simulated_system<
 	data_center_type const& dc(sys.data_center());
 
 	::std::string indent("  ");
+	// Machine and data center statistics are observed once per run
+	::std::string unsupported_stat("not supported in batch-means mode");
 
 //	// VM Placement
 //	{
@@ -619,6 +680,21 @@ void report_stats(::std::basic_ostream<CharT,CharTraitsT>& os, simulated_system<
 
 			os << indent
 			   << "Physical Machine: '" << ptr_mach->name() << "' (ID: " << ptr_mach->id() << ")" << ::std::endl;
+
+			if (sys.batch_means())
+			{
+				os << indent << indent
+				   << "Uptime: " << unsupported_stat << ::std::endl;
+				os << indent << indent
+				   << "Consumed Energy: " << unsupported_stat << ::std::endl;
+				os << indent << indent
+				   << "Utilization: " << unsupported_stat << ::std::endl;
+				os << indent << indent
+				   << "Share: " << unsupported_stat << ::std::endl;
+
+				continue;
+			}
+
 			os << indent << indent
 			   << "Uptime: " << ptr_mach->simulation_model().uptime() << ::std::endl;
 			os << indent << indent
@@ -635,12 +711,57 @@ void report_stats(::std::basic_ostream<CharT,CharTraitsT>& os, simulated_system<
 	// Data Center statistics
 	{
 		os << ::std::endl << "-- Data Center --" << ::std::endl;
-		os << indent
-		   << "Consumed Energy: " << tot_energy << ::std::endl;
-		os << indent
-		   << "# VM Migrations: " << sys.data_center_manager().migration_controller().num_migrations() << ::std::endl;
-		os << indent
-		   << "VM Migration Ratio: " << sys.data_center_manager().migration_controller().migration_rate() << ::std::endl;
+		if (sys.batch_means())
+		{
+			os << indent
+			   << "Consumed Energy: " << unsupported_stat << ::std::endl;
+			os << indent
+			   << "# VM Migrations: " << unsupported_stat << ::std::endl;
+			os << indent
+			   << "VM Migration Ratio: " << unsupported_stat << ::std::endl;
+		}
+		else
+		{
+			os << indent
+			   << "Consumed Energy: " << tot_energy << ::std::endl;
+			os << indent
+			   << "# VM Migrations: " << sys.data_center_manager().migration_controller().num_migrations() << ::std::endl;
+			os << indent
+			   << "VM Migration Ratio: " << sys.data_center_manager().migration_controller().migration_rate() << ::std::endl;
+		}
+	}
+}
+
+
+/// Report a statistic observed once per run, which is not supported in batch-means mode.
+template <typename StatisticT>
+void yaml_report_run_statistic(::YAML::Emitter& yaml, StatisticT const& stat, bool batch_means)
+{
+	yaml << ::YAML::BeginMap;
+	yaml << ::YAML::Key << "type" << ::YAML::Value << stat.name();
+	if (batch_means)
+	{
+		yaml << ::YAML::Key << "supported" << ::YAML::Value << false;
+	}
+	else
+	{
+		yaml << ::YAML::Key << "estimate" << ::YAML::Value << stat.estimate();
+		yaml << ::YAML::Key << "stddev" << ::YAML::Value << stat.standard_deviation();
+	}
+	yaml << ::YAML::EndMap;
+}
+
+
+/// Report the truncation point of the given statistic, if it discards the initial transient.
+template <typename StatisticT>
+void yaml_report_truncation(::YAML::Emitter& yaml, StatisticT const& stat)
+{
+	typedef ::dcs::des::cloud::mser_truncated_statistic<typename StatisticT::value_type,typename StatisticT::uint_type> truncated_statistic_type;
+
+	truncated_statistic_type const* ptr_trunc_stat(dynamic_cast<truncated_statistic_type const*>(&stat));
+	if (ptr_trunc_stat)
+	{
+		yaml << ::YAML::Key << "truncation-point" << ::YAML::Value << ptr_trunc_stat->truncation_point();
 	}
 }
 
@@ -829,6 +950,7 @@ void yaml_report_stats(::std::basic_ostream<CharT,CharTraitsT>& os, simulated_sy
 						yaml << ::YAML::Key << "type" << ::YAML::Value << ptr_stat->name();
 						yaml << ::YAML::Key << "estimate" << ::YAML::Value << ptr_stat->estimate();
 						yaml << ::YAML::Key << "stddev" << ::YAML::Value << ptr_stat->standard_deviation();
+						yaml_report_truncation(yaml, *ptr_stat);
 						yaml << ::YAML::EndMap;
 					}
 
@@ -890,6 +1012,7 @@ void yaml_report_stats(::std::basic_ostream<CharT,CharTraitsT>& os, simulated_sy
 							yaml << ::YAML::Key << "type" << ::YAML::Value << ptr_tier_stat->name();
 							yaml << ::YAML::Key << "estimate" << ::YAML::Value << ptr_tier_stat->estimate();
 							yaml << ::YAML::Key << "stddev" << ::YAML::Value << ptr_tier_stat->standard_deviation();
+							yaml_report_truncation(yaml, *ptr_tier_stat);
 							yaml << ::YAML::EndMap;
 						}
 
@@ -933,29 +1056,13 @@ void yaml_report_stats(::std::basic_ostream<CharT,CharTraitsT>& os, simulated_sy
 			yaml << ::YAML::Key << "name" << ::YAML::Value << ptr_mach->name();
 
 			yaml << ::YAML::Key << "uptime" << ::YAML::Value;
-			yaml << ::YAML::BeginMap;
-			yaml << ::YAML::Key << "type" << ::YAML::Value << ptr_mach->simulation_model().uptime().name();
-			yaml << ::YAML::Key << "estimate" << ::YAML::Value << ptr_mach->simulation_model().uptime().estimate();
-			yaml << ::YAML::Key << "stddev" << ::YAML::Value << ptr_mach->simulation_model().uptime().standard_deviation();
-			yaml << ::YAML::EndMap;
+			yaml_report_run_statistic(yaml, ptr_mach->simulation_model().uptime(), sys.batch_means());
 			yaml << ::YAML::Key << "consumed-energy" << ::YAML::Value;
-			yaml << ::YAML::BeginMap;
-			yaml << ::YAML::Key << "type" << ::YAML::Value << ptr_mach->simulation_model().consumed_energy().name();
-			yaml << ::YAML::Key << "estimate" << ::YAML::Value << ptr_mach->simulation_model().consumed_energy().estimate();
-			yaml << ::YAML::Key << "stddev" << ::YAML::Value << ptr_mach->simulation_model().consumed_energy().standard_deviation();
-			yaml << ::YAML::EndMap;
+			yaml_report_run_statistic(yaml, ptr_mach->simulation_model().consumed_energy(), sys.batch_means());
 			yaml << ::YAML::Key << "utilization" << ::YAML::Value;
-			yaml << ::YAML::BeginMap;
-			yaml << ::YAML::Key << "type" << ::YAML::Value << ptr_mach->simulation_model().utilization().name();
-			yaml << ::YAML::Key << "estimate" << ::YAML::Value << ptr_mach->simulation_model().utilization().estimate();
-			yaml << ::YAML::Key << "stddev" << ::YAML::Value << ptr_mach->simulation_model().utilization().standard_deviation();
-			yaml << ::YAML::EndMap;
+			yaml_report_run_statistic(yaml, ptr_mach->simulation_model().utilization(), sys.batch_means());
 			yaml << ::YAML::Key << "share" << ::YAML::Value;
-			yaml << ::YAML::BeginMap;
-			yaml << ::YAML::Key << "type" << ::YAML::Value << ptr_mach->simulation_model().share().name();
-			yaml << ::YAML::Key << "estimate" << ::YAML::Value << ptr_mach->simulation_model().share().estimate();
-			yaml << ::YAML::Key << "stddev" << ::YAML::Value << ptr_mach->simulation_model().share().standard_deviation();
-			yaml << ::YAML::EndMap;
+			yaml_report_run_statistic(yaml, ptr_mach->simulation_model().share(), sys.batch_means());
 
 			yaml << ::YAML::EndMap; // physical-machine
 
@@ -973,21 +1080,20 @@ void yaml_report_stats(::std::basic_ostream<CharT,CharTraitsT>& os, simulated_sy
 		yaml << ::YAML::Key << "consumed-energy" << ::YAML::Value;
 		yaml << ::YAML::BeginMap;
 		yaml << ::YAML::Key << "type" << ::YAML::Value << "mean";
-		yaml << ::YAML::Key << "estimate" << ::YAML::Value << tot_energy;
-		yaml << ::YAML::Key << "stddev" << ::YAML::Value << 0;
+		if (sys.batch_means())
+		{
+			yaml << ::YAML::Key << "supported" << ::YAML::Value << false;
+		}
+		else
+		{
+			yaml << ::YAML::Key << "estimate" << ::YAML::Value << tot_energy;
+			yaml << ::YAML::Key << "stddev" << ::YAML::Value << 0;
+		}
 		yaml << ::YAML::EndMap;
 		yaml << ::YAML::Key << "num-vm-migrations" << ::YAML::Value;
-		yaml << ::YAML::BeginMap;
-		yaml << ::YAML::Key << "type" << ::YAML::Value << sys.data_center_manager().migration_controller().num_migrations().name();
-		yaml << ::YAML::Key << "estimate" << ::YAML::Value << sys.data_center_manager().migration_controller().num_migrations().estimate();
-		yaml << ::YAML::Key << "stddev" << ::YAML::Value << sys.data_center_manager().migration_controller().num_migrations().standard_deviation();
-		yaml << ::YAML::EndMap;
+		yaml_report_run_statistic(yaml, sys.data_center_manager().migration_controller().num_migrations(), sys.batch_means());
 		yaml << ::YAML::Key << "vm-migration-rate" << ::YAML::Value;
-		yaml << ::YAML::BeginMap;
-		yaml << ::YAML::Key << "type" << ::YAML::Value << sys.data_center_manager().migration_controller().migration_rate().name();
-		yaml << ::YAML::Key << "estimate" << ::YAML::Value << sys.data_center_manager().migration_controller().migration_rate().estimate();
-		yaml << ::YAML::Key << "stddev" << ::YAML::Value << sys.data_center_manager().migration_controller().migration_rate().standard_deviation();
-		yaml << ::YAML::EndMap;
+		yaml_report_run_statistic(yaml, sys.data_center_manager().migration_controller().migration_rate(), sys.batch_means());
 
 		yaml << ::YAML::EndMap;
 	}
@@ -1045,154 +1151,180 @@ void process_sys_finit_sim_event(des_event_type const& evt, des_engine_context_t
 }
 
 
-#ifdef DCS_DEBUG
-void stack_tracer()
+/**
+ * \brief State of the fan-out of a simulation into several variants.
+ *
+ * The simulation is run up to the fork time with the original configuration;
+ * then a child process is forked for each variant, which goes on from the
+ * (copy-on-write) state of its parent after replacing the application
+ * controllers with the ones of the variant configuration.
+ * The parent goes on with the original controllers.
+ */
+struct fork_context
 {
-#if __GNUC__
-	void *trace_elems[20];
-	int trace_elem_count(backtrace(trace_elems, 20));
-	char **stack_syms(backtrace_symbols(trace_elems, trace_elem_count));
-	for (int i = 0; i < trace_elem_count; ++i)
+	fork_context()
+	: time(0),
+	  variant(0),
+	  done(false)
 	{
-		::std::cerr << stack_syms[i] << ::std::endl;
 	}
-	::free(stack_syms);
 
-	::std::exit(1);
-#endif // __GNUC__
-}
-#endif // DCS_DEBUG
 
-}} // Namespace detail::<unnamed>
+	/// The simulated time at which the simulation is forked.
+	real_type time;
+	/// The configuration file of each variant.
+	::std::vector< ::std::string > variant_fnames;
+	/// The configuration of each variant.
+	::std::vector<configuration_pointer> ptr_variant_confs;
+	/// The variant run by this process (0 for the original configuration).
+	::std::size_t variant;
+	/// Tell if the fork has taken place.
+	bool done;
+	/// The forked processes (only in the parent).
+	::std::vector< ::pid_t > children;
+	/// The forked data center.
+	::dcs::shared_ptr< ::dcs::des::cloud::data_center<traits_type> > ptr_dc;
+	/// The manager of the forked data center.
+	::dcs::shared_ptr< ::dcs::des::cloud::data_center_manager<traits_type> > ptr_dc_mngr;
+	/// The source of the fork event.
+	::dcs::shared_ptr<des_event_source_type> ptr_evt_src;
+};
 
 
-int main(int argc, char* argv[])
+void process_sys_init_fork_event(des_event_type const& evt, des_engine_context_type& ctx, fork_context* ptr_fork)
 {
-//	typedef double real_type;
-//	typedef unsigned long uint_type;
-//	typedef long int_type;
-//	typedef dcs::des::engine<real_type> des_engine_type;
-////	typedef dcs::math::random::base_generator<real_type> random_generator_type;
-//	typedef dcs::math::random::base_generator<uint_type> random_generator_type;
-//	typedef dcs::des::cloud::traits<
-//				des_engine_type,
-//				random_generator_type,
-//				real_type,
-//				uint_type,
-//				int_type
-//			> traits_type;
-//	typedef dcs::des::cloud::registry<traits_type> registry_type;
-	typedef dcs::des::cloud::config::configuration<real_type,uint_type> configuration_type;
-	typedef dcs::shared_ptr<configuration_type> configuration_pointer;
-	typedef dcs::shared_ptr<des_engine_type> des_engine_pointer;
-	typedef dcs::shared_ptr<random_generator_type> random_generator_pointer;
-	//typedef dcs::des::cloud::data_center<traits_type> data_center_type;
-	typedef dcs::shared_ptr< dcs::des::cloud::data_center<traits_type> > data_center_pointer;
-	typedef dcs::shared_ptr< dcs::des::cloud::data_center_manager<traits_type> > data_center_manager_pointer;
-
-
-#ifdef DCS_DEBUG
-	::std::set_terminate(detail::stack_tracer);
-#endif // DCS_DEBUG
-
-	prog_name = argv[0];
+	DCS_MACRO_SUPPRESS_UNUSED_VARIABLE_WARNING( evt );
 
-	if (argc < 2)
+	// Fork only once (i.e., in the first replication)
+	if (!ptr_fork->done)
 	{
-		detail::usage();
-		return -1;
+		registry_type::instance().des_engine().schedule_event(
+				ptr_fork->ptr_evt_src,
+				::std::max(ptr_fork->time, ctx.simulated_time())
+			);
 	}
+}
 
 
-	std::cout << "--- DCS DES Cloud start at " << detail::strtime() << "." << std::endl;
-	std::cout << "--------------------------------------------------------------------------------" << std::endl;
-
-
-	// Parse command line arguments
+/// Replace the application controllers with the ones of the given configuration.
+void install_variant(des_event_type const& evt, des_engine_context_type& ctx, ::dcs::des::cloud::data_center<traits_type>& dc, configuration_type const& conf)
+{
+	typedef ::dcs::des::cloud::data_center<traits_type> data_center_type;
+	typedef data_center_type::application_pointer application_pointer;
+	typedef data_center_type::application_controller_pointer application_controller_pointer;
+	typedef ::std::vector<application_pointer> application_container;
+	typedef application_container::const_iterator application_iterator;
+	typedef configuration_type::data_center_config_type::application_config_container application_config_container;
+	typedef application_config_container::const_iterator application_config_iterator;
+
+	application_config_container const& app_confs(conf.data_center().applications());
+	application_config_iterator app_conf_end_it(app_confs.end());
+
+	application_container apps(dc.applications());
+	application_iterator app_end_it(apps.end());
+	for (application_iterator app_it = apps.begin(); app_it != app_end_it; ++app_it)
+	{
+		application_pointer ptr_app(*app_it);
+
+		// Application instances are named after their configuration
+		// (see data_center_manager)
+		::std::string const& name(ptr_app->name());
+		application_config_iterator app_conf_it(app_confs.begin());
+		while (app_conf_it != app_conf_end_it
+			   && name != app_conf_it->name
+			   && name.compare(0, app_conf_it->name.size()+2, app_conf_it->name + " (") != 0)
+		{
+			++app_conf_it;
+		}
+		if (app_conf_it == app_conf_end_it)
+		{
+			throw ::std::runtime_error("Application '" + name + "' not found in the variant configuration.");
+		}
 
-	std::string conf_fname; // (argv[1]);
-	bool partial_stats(false);
-	std::string outdata_fname;
-	bool output_info(false);
-	bool output_help(false);
+		application_controller_pointer ptr_app_ctrl;
+		ptr_app_ctrl = ::dcs::des::cloud::config::make_application_controller<traits_type>(app_conf_it->controller, ptr_app);
+		dc.application_controller(ptr_app->id(), ptr_app_ctrl);
+		ptr_app_ctrl->take_over(evt, ctx);
+	}
+}
 
-	output_help = detail::get_option(argv, argv+argc, "--help");
-	output_info = detail::get_option(argv, argv+argc, "--info");
 
-	if (output_help)
-	{
-		detail::usage();
-		return 0;
-	}
-	if (output_info)
+void process_fork_sim_event(des_event_type const& evt, des_engine_context_type& ctx, fork_context* ptr_fork)
+{
+	ptr_fork->done = true;
+
+	// Only the forking thread survives in the children: make sure no other
+	// thread is working on the state they inherit (e.g., an asynchronous
+	// solver of the migration controller).
+	// Workers of the system identification proxies need no care here, since
+	// each child starts its own ones at their first request.
+	ptr_fork->ptr_dc_mngr->migration_controller().wait_background_work();
+
+	// Avoid to duplicate buffered output in child processes
+	::dcs::des::cloud::tracer::instance().flush();
+	::std::cout.flush();
+	::std::cerr.flush();
+
+	::std::size_t num_variants(ptr_fork->ptr_variant_confs.size());
+	for (::std::size_t i = 0; i < num_variants; ++i)
 	{
-		detail::info();
-		return 0;
-	}
+		::pid_t pid(::fork());
 
-	try
-	{
-		partial_stats = detail::get_option(argv, argv+argc, "--partial-stats");
-		conf_fname = detail::get_option<std::string>(argv, argv+argc, "--conf");
-		outdata_fname = detail::get_option<std::string>(argv, argv+argc, "--out-data-file", "");
-	}
-	catch (std::exception const& e)
-	{
-		std::cerr << "[Error] Error while parsing command-line options: " << e.what() << std::endl;
-		detail::usage();
-		std::abort();
-	}
+		if (pid == -1)
+		{
+			::std::ostringstream oss;
+			oss << "Unable to fork variant '" << ptr_fork->variant_fnames[i] << "': " << ::std::strerror(errno);
 
-	std::cout << "CLI OPTIONS:" << std::endl;
-	std::cout << " - Partial Statistics: " << std::boolalpha << partial_stats << std::endl;
-	std::cout << " - Configuration File: " << conf_fname << std::endl;
-	std::cout << " - Output Data File: " << outdata_fname << std::endl;
-	std::cout << "--------------------------------------------------------------------------------" << std::endl;
+			// Don't leave orphan variants behind
+			::std::size_t num_children(ptr_fork->children.size());
+			for (::std::size_t j = 0; j < num_children; ++j)
+			{
+				::kill(ptr_fork->children[j], SIGKILL);
+				while (::waitpid(ptr_fork->children[j], 0, 0) == -1 && errno == EINTR)
+				{
+					;
+				}
+			}
+			ptr_fork->children.clear();
 
-	// Read configuration
+			throw ::std::runtime_error(oss.str());
+		}
 
-	configuration_category conf_cat = yaml_configuration;
+		if (pid == 0)
+		{
+			// Child process: go on with the controllers of the variant
 
-	configuration_pointer ptr_conf;
+			ptr_fork->variant = i+1;
+			ptr_fork->children.clear();
 
-	try
-	{
-		switch (conf_cat)
-		{
-			case yaml_configuration:
+			install_variant(evt, ctx, *(ptr_fork->ptr_dc), *(ptr_fork->ptr_variant_confs[i]));
 
-				ptr_conf = dcs::make_shared<configuration_type>(
-							dcs::des::cloud::config::read_file(
-								conf_fname,
-								::dcs::des::cloud::config::yaml_reader<real_type,uint_type>()
-							)
-						);
-				break;
-			default:
-				throw ::std::runtime_error("Unknown configuration category.");
+			return;
 		}
+
+		ptr_fork->children.push_back(pid);
 	}
-	catch (::std::exception const& e)
-	{
-		::std::clog << "[Error] Unable to read configuration: " << e.what() << ::std::endl;
-		return -2;
-	}
+}
 
-	DCS_DEBUG_TRACE("Configuration: " << *ptr_conf); //XXX
 
-	// Print configuration (for ease later info retrieval)
-	::std::cout << "CONFIGURATION:" << ::std::endl
-				<< *ptr_conf << ::std::endl
-				<< "--------------------------------------------------------------------------------" << ::std::endl
-				<< ::std::endl;
+/// Run the simulation described by the given configuration and report its statistics.
+void run_simulation(configuration_pointer const& ptr_conf, random_seeder_type const& seeder, bool partial_stats, ::std::ostream* ptr_os, ::std::string const& outdata_fname, fork_context* ptr_fork = 0)
+{
+	typedef dcs::shared_ptr<des_engine_type> des_engine_pointer;
+	typedef dcs::shared_ptr<random_generator_type> random_generator_pointer;
+	typedef dcs::shared_ptr< dcs::des::cloud::data_center<traits_type> > data_center_pointer;
+	typedef dcs::shared_ptr< dcs::des::cloud::data_center_manager<traits_type> > data_center_manager_pointer;
 
-	// Build the registry
+	// Build the simulation context and bind it to this thread for the whole run
 
-	registry_type& reg(registry_type::instance());
+	dcs::shared_ptr<registry_type> ptr_reg(new registry_type());
+	dcs::des::cloud::scoped_registry<traits_type> reg_scope(*ptr_reg);
+	registry_type& reg(*ptr_reg);
 	reg.configuration(ptr_conf);
 	des_engine_pointer ptr_des_eng;
 	ptr_des_eng = dcs::des::cloud::config::make_des_engine(*ptr_conf);
 	reg.des_engine(ptr_des_eng);
+	reg.control_tick_scheduler().num_threads(::std::max(ptr_conf->simulation().control_parallelism, uint_type(1)));
 	random_generator_pointer ptr_rng;
 	ptr_rng = dcs::des::cloud::config::make_random_number_generator(*ptr_conf);//OK
 //	ptr_rng = dcs::make_shared<dcs::math::random::mt19937>(5489UL);//XXX
@@ -1200,14 +1332,12 @@ int main(int argc, char* argv[])
 
 //	detail::test_rng(ptr_rng);//XXX
 
-	random_seeder_type seeder(ptr_conf->rng().seed);
-
-	detail::simulated_system<traits_type> sys;
+	simulated_system<traits_type> sys;
 
 	// Register some DES event hooks
 	ptr_des_eng->system_initialization_event_source().connect(
 			::dcs::functional::bind(
-				&detail::process_sys_init_sim_event,
+				&process_sys_init_sim_event,
 				::dcs::functional::placeholders::_1,
 				::dcs::functional::placeholders::_2,
 				seeder
@@ -1217,7 +1347,7 @@ int main(int argc, char* argv[])
 	{
 		ptr_des_eng->system_finalization_event_source().connect(
 				::dcs::functional::bind(
-					&detail::process_sys_finit_sim_event<traits_type>,
+					&process_sys_finit_sim_event<traits_type>,
 					::dcs::functional::placeholders::_1,
 					::dcs::functional::placeholders::_2,
 					&sys
@@ -1239,14 +1369,36 @@ int main(int argc, char* argv[])
 	// Build the Data Center
 	data_center_pointer ptr_dc;
 	data_center_manager_pointer ptr_dc_mngr;
-	ptr_dc = dcs::des::cloud::config::make_data_center<traits_type>(*ptr_conf, ptr_rng, ptr_des_eng);
+	ptr_dc = dcs::des::cloud::config::make_data_center<traits_type>(*ptr_conf, ptr_reg);
 	ptr_dc_mngr = dcs::des::cloud::config::make_data_center_manager<traits_type>(*ptr_conf, ptr_dc);
 
 	sys.data_center(ptr_dc);
 	sys.data_center_manager(ptr_dc_mngr);
+	sys.batch_means(ptr_conf->simulation().output_analysis.category == dcs::des::cloud::config::batch_means_output_analysis);
 
-	std::cerr.precision(16);
-	std::cout.precision(16);
+	// Prepare the fan-out into variants
+	if (ptr_fork)
+	{
+		ptr_fork->ptr_dc = ptr_dc;
+		ptr_fork->ptr_dc_mngr = ptr_dc_mngr;
+		ptr_fork->ptr_evt_src = ::dcs::make_shared<des_event_source_type>("Fork Simulation");
+		ptr_fork->ptr_evt_src->connect(
+				::dcs::functional::bind(
+					&process_fork_sim_event,
+					::dcs::functional::placeholders::_1,
+					::dcs::functional::placeholders::_2,
+					ptr_fork
+				)
+			);
+		ptr_des_eng->system_initialization_event_source().connect(
+				::dcs::functional::bind(
+					&process_sys_init_fork_event,
+					::dcs::functional::placeholders::_1,
+					::dcs::functional::placeholders::_2,
+					ptr_fork
+				)
+			);
+	}
 
 	// Run the simulation
 	ptr_des_eng->run();
@@ -1254,20 +1406,1006 @@ int main(int argc, char* argv[])
 	// Detach the simulation observer
 	ptr_sim_log->detach(*ptr_des_eng);
 
-	// Report statistics
-	std::cout << "STATISTICS:" << std::endl;
-	detail::report_stats(std::cout, sys);
-	std::cout << "--------------------------------------------------------------------------------" << std::endl;
+	// Wait for the variants, so that reports do not overlap
+	bool failed(false);
+	if (ptr_fork)
+	{
+		::std::size_t num_children(ptr_fork->children.size());
+		for (::std::size_t i = 0; i < num_children; ++i)
+		{
+			int status(0);
+			if (::waitpid(ptr_fork->children[i], &status, 0) == -1
+				|| !WIFEXITED(status)
+				|| WEXITSTATUS(status) != EXIT_SUCCESS)
+			{
+				::std::cerr << "[Error] Variant '" << ptr_fork->variant_fnames[i] << "' failed." << ::std::endl;
+				failed = true;
+			}
+		}
+	}
 
+	::std::string variant_fname;
+	::std::string variant_outdata_fname(outdata_fname);
+	if (ptr_fork && ptr_fork->variant > 0)
+	{
+		variant_fname = ptr_fork->variant_fnames[ptr_fork->variant-1];
 
-	std::cout << "--- DCS DES Cloud stop at " << detail::strtime() << "." << std::endl;
+		::std::ostringstream oss;
+		oss << outdata_fname << ".variant-" << ptr_fork->variant;
+		variant_outdata_fname = oss.str();
+	}
+
+	// Report statistics
+	if (ptr_os)
+	{
+		// Write the whole report at once, since variants run concurrently
+		::std::ostringstream oss;
+		oss.precision(ptr_os->precision());
+		if (variant_fname.empty())
+		{
+			oss << "STATISTICS:" << ::std::endl;
+		}
+		else
+		{
+			oss << "STATISTICS (variant: " << variant_fname << "):" << ::std::endl;
+		}
+		report_stats(oss, sys);
+		oss << "--------------------------------------------------------------------------------" << ::std::endl;
+		*ptr_os << oss.str() << ::std::flush;
+	}
 
 	if (!outdata_fname.empty())
 	{
-		::std::ofstream ofs(outdata_fname.c_str());
+		::std::ofstream ofs(variant_outdata_fname.c_str());
 
-		detail::yaml_report_stats(ofs, sys);
+		yaml_report_stats(ofs, sys);
 
 		ofs.close();
 	}
+
+	if (ptr_fork && ptr_fork->variant > 0)
+	{
+		// The variant is over
+		::dcs::des::cloud::tracer::instance().flush();
+		::std::cout.flush();
+		::std::cerr.flush();
+		::_exit(EXIT_SUCCESS);
+	}
+
+	if (failed)
+	{
+		throw ::std::runtime_error("One or more variants failed.");
+	}
+}
+
+
+/// Return the number of independent replications requested by the given configuration.
+uint_type num_replications(configuration_type const& conf)
+{
+	typedef dcs::des::cloud::config::independent_replications_output_analysis_config<real_type,uint_type> output_analysis_config_type;
+
+	switch (conf.simulation().output_analysis.category)
+	{
+		case dcs::des::cloud::config::independent_replications_output_analysis:
+			{
+				output_analysis_config_type const& analysis = ::boost::get<output_analysis_config_type>(conf.simulation().output_analysis.category_conf);
+
+				switch (analysis.num_replications_category)
+				{
+					case dcs::des::cloud::config::constant_num_replications_detector:
+						return ::boost::get<output_analysis_config_type::constant_num_replications_detector_type>(analysis.num_replications_category_conf).num_replications;
+					case dcs::des::cloud::config::banks2005_num_replications_detector:
+						// The sequential stopping rule cannot be evaluated across
+						// concurrent replications, so only the mandatory ones are run.
+						return ::boost::get<output_analysis_config_type::banks2005_num_replications_detector_type>(analysis.num_replications_category_conf).min_num_replications;
+				}
+			}
+			break;
+	}
+
+	throw ::std::runtime_error("Unable to run concurrent replications for this output analysis category.");
+}
+
+
+/// Return a copy of the given configuration which describes exactly one replication.
+configuration_type make_replication_configuration(configuration_type const& conf)
+{
+	typedef dcs::des::cloud::config::simulation_config<real_type,uint_type> simulation_config_type;
+	typedef dcs::des::cloud::config::independent_replications_output_analysis_config<real_type,uint_type> output_analysis_config_type;
+	typedef output_analysis_config_type::constant_num_replications_detector_type num_replications_detector_config_type;
+
+	simulation_config_type sim(conf.simulation());
+	output_analysis_config_type analysis(::boost::get<output_analysis_config_type>(sim.output_analysis.category_conf));
+	num_replications_detector_config_type num_reps_detector;
+	num_reps_detector.num_replications = 1;
+	analysis.num_replications_category = dcs::des::cloud::config::constant_num_replications_detector;
+	analysis.num_replications_category_conf = num_reps_detector;
+	sim.output_analysis.category_conf = analysis;
+	sim.output_analysis.parallelism = 1;
+
+	configuration_type rep_conf(conf);
+	rep_conf.simulation(sim);
+
+	return rep_conf;
+}
+
+
+/// Per-replication YAML nodes describing the same entity.
+typedef ::std::vector< ::YAML::Node const* > yaml_node_container;
+
+/// Estimator of a statistic across replications.
+typedef ::dcs::des::mean_estimator<real_type,uint_type> replication_statistic_type;
+
+
+/// Return the value with the given key of each of the given YAML maps.
+yaml_node_container yaml_children(yaml_node_container const& nodes, ::std::string const& key)
+{
+	yaml_node_container children;
+
+	yaml_node_container::const_iterator node_end_it(nodes.end());
+	for (yaml_node_container::const_iterator node_it = nodes.begin(); node_it != node_end_it; ++node_it)
+	{
+		children.push_back(&((**node_it)[key]));
+	}
+
+	return children;
+}
+
+
+/// Return the i-th element of each of the given YAML sequences.
+yaml_node_container yaml_children(yaml_node_container const& nodes, ::std::size_t i)
+{
+	yaml_node_container children;
+
+	yaml_node_container::const_iterator node_end_it(nodes.end());
+	for (yaml_node_container::const_iterator node_it = nodes.begin(); node_it != node_end_it; ++node_it)
+	{
+		children.push_back(&((**node_it)[i]));
+	}
+
+	return children;
+}
+
+
+/// Return the number of elements shared by all the given YAML sequences.
+::std::size_t yaml_common_size(yaml_node_container const& nodes)
+{
+	::std::size_t n(nodes.front()->size());
+
+	yaml_node_container::const_iterator node_end_it(nodes.end());
+	for (yaml_node_container::const_iterator node_it = nodes.begin(); node_it != node_end_it; ++node_it)
+	{
+		n = ::std::min(n, (*node_it)->size());
+	}
+
+	return n;
+}
+
+
+/// Collect the per-replication estimates of a statistic (as written by \c yaml_report_stats).
+void merge_replication_statistic(yaml_node_container const& nodes, replication_statistic_type& stat)
+{
+	yaml_node_container::const_iterator node_end_it(nodes.end());
+	for (yaml_node_container::const_iterator node_it = nodes.begin(); node_it != node_end_it; ++node_it)
+	{
+		real_type x;
+		(**node_it)["estimate"] >> x;
+		stat(x);
+	}
+}
+
+
+/// Report every statistic of the given per-replication YAML sequences with the given label.
+template <typename CharT, typename CharTraitsT>
+void report_merged_statistics(::std::basic_ostream<CharT,CharTraitsT>& os, ::std::string const& indent, yaml_node_container const& nodes, real_type confidence_level)
+{
+	::std::size_t n(yaml_common_size(nodes));
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		yaml_node_container stat_nodes(yaml_children(nodes, i));
+
+		::std::string type;
+		(*stat_nodes.front())["type"] >> type;
+
+		replication_statistic_type stat(confidence_level);
+		merge_replication_statistic(stat_nodes, stat);
+
+		os << indent << type << ": " << stat << ::std::endl;
+	}
+}
+
+
+/**
+ * \brief Report the statistics of several replications in the layout of
+ *  \c report_stats.
+ *
+ * \a nodes are the per-replication reports written by \c yaml_report_stats.
+ */
+template <typename CharT, typename CharTraitsT>
+void report_merged_stats(::std::basic_ostream<CharT,CharTraitsT>& os, yaml_node_container const& nodes, real_type confidence_level)
+{
+	typedef ::dcs::des::cloud::performance_measure_category statistic_category_type;
+	typedef ::std::vector<statistic_category_type> statistic_category_container;
+	typedef statistic_category_container::const_iterator statistic_category_iterator;
+
+	::std::string indent("  ");
+
+	// Virtual Machines
+	{
+		os << ::std::endl << "-- Virtual Machines --" << ::std::endl;
+
+		yaml_node_container vm_nodes(yaml_children(nodes, "virtual-machines"));
+		::std::size_t num_vms(yaml_common_size(vm_nodes));
+		for (::std::size_t v = 0; v < num_vms; ++v)
+		{
+			yaml_node_container vm(yaml_children(vm_nodes, v));
+			::std::string name;
+			::std::string id;
+			(*vm.front())["name"] >> name;
+			(*vm.front())["id"] >> id;
+
+			os << indent
+			   << "Virtual Machine: '" << name << "' (ID: " << id << ")" << ::std::endl;
+
+			const char* share_keys[] = {"wanted-shares", "assigned-shares"};
+			const char* share_labels[] = {"Wanted Resource Shares: ", "Assigned Resource Shares: "};
+			for (::std::size_t k = 0; k < 2; ++k)
+			{
+				os << indent << indent
+				   << share_labels[k] << ::std::endl;
+
+				yaml_node_container share_nodes(yaml_children(vm, share_keys[k]));
+				::std::size_t num_shares(yaml_common_size(share_nodes));
+				for (::std::size_t s = 0; s < num_shares; ++s)
+				{
+					yaml_node_container share(yaml_children(share_nodes, s));
+					::std::string category;
+					(*share.front())["resource-category"] >> category;
+
+					os << indent << indent << indent
+					   << "Resource: " << category << ::std::endl;
+
+					report_merged_statistics(os, indent+indent+indent+indent, yaml_children(share, "stats"), confidence_level);
+				}
+			}
+		}
+	}
+
+	// Application statistics
+	{
+		os << ::std::endl << "-- Applications --" << ::std::endl;
+
+		statistic_category_container stat_categories(::dcs::des::cloud::performance_measure_categories());
+		statistic_category_iterator stat_cat_end_it(stat_categories.end());
+
+		yaml_node_container app_nodes(yaml_children(nodes, "applications"));
+		::std::size_t num_apps(yaml_common_size(app_nodes));
+		for (::std::size_t a = 0; a < num_apps; ++a)
+		{
+			yaml_node_container app(yaml_children(app_nodes, a));
+			::std::string name;
+			::std::string id;
+			(*app.front())["name"] >> name;
+			(*app.front())["id"] >> id;
+
+			os << indent
+			   << "Application: '" << name << "' (ID: " << id << ")" << ::std::endl;
+			os << indent << indent
+			   << "Overall: " << ::std::endl;
+
+			yaml_node_container overall(yaml_children(app, "overall"));
+			{
+				replication_statistic_type num_arrs(confidence_level);
+				replication_statistic_type num_deps(confidence_level);
+				replication_statistic_type num_sla_viols(confidence_level);
+				merge_replication_statistic(yaml_children(overall, "num-arrivals"), num_arrs);
+				merge_replication_statistic(yaml_children(overall, "num-departures"), num_deps);
+				merge_replication_statistic(yaml_children(overall, "num-sla-violations"), num_sla_viols);
+
+				os << indent << indent << indent
+				   << "# Arrivals: " << num_arrs << ::std::endl;
+				os << indent << indent << indent
+				   << "# Departures: " << num_deps << ::std::endl;
+				os << indent << indent << indent
+				   << "# SLA violations: " << num_sla_viols << ::std::endl;
+			}
+
+			for (statistic_category_iterator stat_cat_it = stat_categories.begin(); stat_cat_it != stat_cat_end_it; ++stat_cat_it)
+			{
+				statistic_category_type stat_category(*stat_cat_it);
+
+				if (::dcs::des::cloud::for_application(stat_category))
+				{
+					os << indent << indent << indent
+					   << to_string(stat_category) << ": " << ::std::endl;
+
+					report_merged_statistics(os, indent+indent+indent+indent, yaml_children(overall, to_yaml_id(stat_category)), confidence_level);
+				}
+			}
+
+			// Tier statistics
+			yaml_node_container tier_nodes(yaml_children(app, "tiers"));
+			::std::size_t num_tiers(yaml_common_size(tier_nodes));
+			for (::std::size_t t = 0; t < num_tiers; ++t)
+			{
+				yaml_node_container tier(yaml_children(tier_nodes, t));
+				::std::string tier_name;
+				(*tier.front())["name"] >> tier_name;
+
+				os << indent << indent
+				   << "Tier '" << tier_name << "': " << ::std::endl;
+
+				replication_statistic_type num_arrs(confidence_level);
+				replication_statistic_type num_deps(confidence_level);
+				merge_replication_statistic(yaml_children(tier, "num-arrivals"), num_arrs);
+				merge_replication_statistic(yaml_children(tier, "num-departures"), num_deps);
+
+				os << indent << indent << indent
+				   << "# Arrivals: " << num_arrs << ::std::endl;
+				os << indent << indent << indent
+				   << "# Departures: " << num_deps << ::std::endl;
+
+				for (statistic_category_iterator stat_cat_it = stat_categories.begin(); stat_cat_it != stat_cat_end_it; ++stat_cat_it)
+				{
+					statistic_category_type stat_category(*stat_cat_it);
+
+					if (::dcs::des::cloud::for_application_tier(stat_category))
+					{
+						os << indent << indent << indent
+						   << to_string(stat_category) << ": " << ::std::endl;
+
+						report_merged_statistics(os, indent+indent+indent+indent, yaml_children(tier, to_yaml_id(stat_category)), confidence_level);
+					}
+				}
+			}
+		}
+	}
+
+	real_type tot_energy(0);
+
+	// Machine statistics
+	{
+		os << ::std::endl << "-- Physical Machines --" << ::std::endl;
+
+		yaml_node_container pm_nodes(yaml_children(nodes, "physical-machines"));
+		::std::size_t num_pms(yaml_common_size(pm_nodes));
+		for (::std::size_t p = 0; p < num_pms; ++p)
+		{
+			yaml_node_container pm(yaml_children(pm_nodes, p));
+			::std::string name;
+			::std::string id;
+			(*pm.front())["name"] >> name;
+			(*pm.front())["id"] >> id;
+
+			replication_statistic_type uptime(confidence_level);
+			replication_statistic_type energy(confidence_level);
+			replication_statistic_type util(confidence_level);
+			replication_statistic_type share(confidence_level);
+			merge_replication_statistic(yaml_children(pm, "uptime"), uptime);
+			merge_replication_statistic(yaml_children(pm, "consumed-energy"), energy);
+			merge_replication_statistic(yaml_children(pm, "utilization"), util);
+			merge_replication_statistic(yaml_children(pm, "share"), share);
+
+			os << indent
+			   << "Physical Machine: '" << name << "' (ID: " << id << ")" << ::std::endl;
+			os << indent << indent
+			   << "Uptime: " << uptime << ::std::endl;
+			os << indent << indent
+			   << "Consumed Energy: " << energy << ::std::endl;
+			os << indent << indent
+			   << "Utilization: " << util << ::std::endl;
+			os << indent << indent
+			   << "Share: " << share << ::std::endl;
+
+			tot_energy += energy.estimate();
+		}
+	}
+
+	// Data Center statistics
+	{
+		yaml_node_container dc(yaml_children(nodes, "data-center"));
+
+		replication_statistic_type num_migrs(confidence_level);
+		replication_statistic_type migr_rate(confidence_level);
+		merge_replication_statistic(yaml_children(dc, "num-vm-migrations"), num_migrs);
+		merge_replication_statistic(yaml_children(dc, "vm-migration-rate"), migr_rate);
+
+		os << ::std::endl << "-- Data Center --" << ::std::endl;
+		os << indent
+		   << "Consumed Energy: " << tot_energy << ::std::endl;
+		os << indent
+		   << "# VM Migrations: " << num_migrs << ::std::endl;
+		os << indent
+		   << "VM Migration Ratio: " << migr_rate << ::std::endl;
+	}
+}
+
+
+/**
+ * \brief Merge the YAML reports of several replications into a single report.
+ *
+ * The reports are expected to share the same layout (as produced by
+ * \c yaml_report_stats), which is kept by the merged report.
+ * Every statistic (i.e., every map with an \c estimate key) is replaced by the
+ * mean and the standard deviation of the per-replication estimates.
+ */
+void yaml_merge_replication_stats(::YAML::Emitter& yaml, yaml_node_container const& nodes, real_type confidence_level)
+{
+	::YAML::Node const& node(*nodes.front());
+
+	switch (node.Type())
+	{
+		case ::YAML::NodeType::Map:
+			if (node.FindValue("estimate"))
+			{
+				::std::string type;
+				node["type"] >> type;
+
+				replication_statistic_type stat(confidence_level);
+				merge_replication_statistic(nodes, stat);
+
+				yaml << ::YAML::BeginMap;
+				yaml << ::YAML::Key << "type" << ::YAML::Value << type;
+				yaml << ::YAML::Key << "estimate" << ::YAML::Value << stat.estimate();
+				yaml << ::YAML::Key << "stddev" << ::YAML::Value << stat.standard_deviation();
+				if (node.FindValue("truncation-point"))
+				{
+					real_type trunc(0);
+					yaml_node_container::const_iterator node_end_it(nodes.end());
+					for (yaml_node_container::const_iterator node_it = nodes.begin(); node_it != node_end_it; ++node_it)
+					{
+						real_type x;
+						(**node_it)["truncation-point"] >> x;
+						trunc += x;
+					}
+					yaml << ::YAML::Key << "truncation-point" << ::YAML::Value << (trunc/nodes.size());
+				}
+				yaml << ::YAML::EndMap;
+			}
+			else
+			{
+				yaml << ::YAML::BeginMap;
+				for (::YAML::Iterator it = node.begin(); it != node.end(); ++it)
+				{
+					::std::string key;
+					it.first() >> key;
+
+					yaml << ::YAML::Key << key << ::YAML::Value;
+					yaml_merge_replication_stats(yaml, yaml_children(nodes, key), confidence_level);
+				}
+				yaml << ::YAML::EndMap;
+			}
+			break;
+		case ::YAML::NodeType::Sequence:
+			{
+				::std::size_t n(yaml_common_size(nodes));
+
+				yaml << ::YAML::BeginSeq;
+				for (::std::size_t i = 0; i < n; ++i)
+				{
+					yaml_merge_replication_stats(yaml, yaml_children(nodes, i), confidence_level);
+				}
+				yaml << ::YAML::EndSeq;
+			}
+			break;
+		case ::YAML::NodeType::Scalar:
+			{
+				::std::string value;
+				node >> value;
+				yaml << value;
+			}
+			break;
+		default:
+			yaml << ::YAML::Null;
+			break;
+	}
+}
+
+
+/// Wait for the termination of one of the running replications.
+void wait_replication(::std::map< ::pid_t, uint_type >& running, bool& failed)
+{
+	int status(0);
+	::pid_t pid(::waitpid(-1, &status, 0));
+
+	if (pid == -1)
+	{
+		if (errno == EINTR)
+		{
+			return;
+		}
+
+		::std::ostringstream oss;
+		oss << "Unable to wait for a replication: " << ::std::strerror(errno);
+		throw ::std::runtime_error(oss.str());
+	}
+
+	if (running.count(pid) == 0)
+	{
+		return;
+	}
+
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+	{
+		::std::cerr << "[Error] Replication #" << running[pid] << " (PID: " << pid << ") terminated abnormally." << ::std::endl;
+		failed = true;
+	}
+
+	running.erase(pid);
+}
+
+
+/// Terminate and reap the running replications.
+void kill_replications(::std::map< ::pid_t, uint_type >& running)
+{
+	typedef ::std::map< ::pid_t, uint_type >::const_iterator iterator;
+
+	iterator end_it(running.end());
+	for (iterator it = running.begin(); it != end_it; ++it)
+	{
+		::kill(it->first, SIGKILL);
+	}
+	for (iterator it = running.begin(); it != end_it; ++it)
+	{
+		while (::waitpid(it->first, 0, 0) == -1 && errno == EINTR)
+		{
+			;
+		}
+	}
+	running.clear();
+}
+
+
+/// Remove the given temporary files.
+void remove_files(::std::vector< ::std::string > const& fnames)
+{
+	::std::size_t n(fnames.size());
+	for (::std::size_t i = 0; i < n; ++i)
+	{
+		if (!fnames[i].empty())
+		{
+			::std::remove(fnames[i].c_str());
+		}
+	}
+}
+
+
+/**
+ * \brief Run the independent replications concurrently.
+ *
+ * Each replication is run in its own child process (thus with its own
+ * registry, DES engine, random number generator and data center) by using the
+ * same seed it would receive in a sequential run.
+ * At most \a num_jobs replications are run at the same time.
+ * Per-replication reports are then merged into a single confidence-interval
+ * report, laid out as the ones of \c report_stats and \c yaml_report_stats.
+ */
+void run_parallel_replications(configuration_pointer const& ptr_conf, random_seeder_type const& seeder, uint_type num_jobs, ::std::ostream& os, ::std::string const& outdata_fname)
+{
+	uint_type num_reps(num_replications(*ptr_conf));
+
+	if (num_reps < 2)
+	{
+		// No confidence interval can be computed across a single replication,
+		// so just run it as usual.
+		run_simulation(ptr_conf, seeder, false, &os, outdata_fname);
+		return;
+	}
+
+	configuration_pointer ptr_rep_conf(dcs::make_shared<configuration_type>(make_replication_configuration(*ptr_conf)));
+
+	::std::vector< ::std::string > rep_fnames(num_reps);
+	::std::map< ::pid_t, uint_type > running;
+	bool failed(false);
+
+	// Avoid to duplicate buffered output in child processes
+	::std::cout.flush();
+	::std::cerr.flush();
+
+	try
+	{
+		for (uint_type r = 0; r < num_reps && !failed; ++r)
+		{
+			while (running.size() >= num_jobs)
+			{
+				wait_replication(running, failed);
+			}
+
+			rep_fnames[r] = ::dcs::des::cloud::detail::make_tmp_file("/tmp/des_cloud_sim-rep-");
+
+			// Don't let buffered trace records be duplicated in the child
+			::dcs::des::cloud::tracer::instance().flush();
+
+			::pid_t pid(::fork());
+
+			if (pid == -1)
+			{
+				::std::ostringstream oss;
+				oss << "Unable to start replication #" << r << ": " << ::std::strerror(errno);
+				throw ::std::runtime_error(oss.str());
+			}
+
+			if (pid == 0)
+			{
+				// Child process
+
+				int ret(EXIT_SUCCESS);
+
+				try
+				{
+					// Skip the seeds used by the previous replications
+					random_seeder_type rep_seeder(seeder);
+					for (uint_type i = 0; i < r; ++i)
+					{
+						rep_seeder();
+					}
+
+					run_simulation(ptr_rep_conf, rep_seeder, false, 0, rep_fnames[r]);
+				}
+				catch (::std::exception const& e)
+				{
+					::std::cerr << "[Error] Replication #" << r << ": " << e.what() << ::std::endl;
+					ret = EXIT_FAILURE;
+				}
+
+				::dcs::des::cloud::tracer::instance().flush();
+				::std::cout.flush();
+				::std::cerr.flush();
+				::_exit(ret);
+			}
+
+			running[pid] = r;
+		}
+		while (!running.empty())
+		{
+			wait_replication(running, failed);
+		}
+	}
+	catch (...)
+	{
+		// Don't leave orphan replications behind
+		kill_replications(running);
+		remove_files(rep_fnames);
+		throw;
+	}
+
+	if (failed)
+	{
+		remove_files(rep_fnames);
+		throw ::std::runtime_error("One or more replications failed.");
+	}
+
+	// Merge per-replication reports
+
+	::std::vector< dcs::shared_ptr< ::YAML::Node > > docs;
+	yaml_node_container ptr_docs;
+	for (uint_type r = 0; r < num_reps; ++r)
+	{
+		::std::ifstream ifs(rep_fnames[r].c_str());
+		::YAML::Parser parser(ifs);
+		dcs::shared_ptr< ::YAML::Node > ptr_doc(new ::YAML::Node());
+		if (!parser.GetNextDocument(*ptr_doc))
+		{
+			remove_files(rep_fnames);
+
+			::std::ostringstream oss;
+			oss << "Unable to read the statistics of replication #" << r << ".";
+			throw ::std::runtime_error(oss.str());
+		}
+		ifs.close();
+
+		docs.push_back(ptr_doc);
+		ptr_docs.push_back(ptr_doc.get());
+	}
+	remove_files(rep_fnames);
+
+	real_type confidence_level(ptr_conf->simulation().output_analysis.confidence_level);
+
+	// Write the whole report at once, as run_simulation does
+	::std::ostringstream oss;
+	oss.precision(os.precision());
+	oss << "STATISTICS:" << ::std::endl;
+	report_merged_stats(oss, ptr_docs, confidence_level);
+	oss << "--------------------------------------------------------------------------------" << ::std::endl;
+	os << oss.str() << ::std::flush;
+
+	if (!outdata_fname.empty())
+	{
+		::YAML::Emitter yaml;
+		yaml_merge_replication_stats(yaml, ptr_docs, confidence_level);
+
+		::std::ofstream ofs(outdata_fname.c_str());
+
+		ofs << yaml.c_str() << ::std::endl;
+
+		ofs.close();
+	}
+}
+
+
+#ifdef DCS_DEBUG
+void stack_tracer()
+{
+#if __GNUC__
+	void *trace_elems[20];
+	int trace_elem_count(backtrace(trace_elems, 20));
+	char **stack_syms(backtrace_symbols(trace_elems, trace_elem_count));
+	for (int i = 0; i < trace_elem_count; ++i)
+	{
+		::std::cerr << stack_syms[i] << ::std::endl;
+	}
+	::free(stack_syms);
+
+	::std::exit(1);
+#endif // __GNUC__
+}
+#endif // DCS_DEBUG
+
+}} // Namespace detail::<unnamed>
+
+
+int main(int argc, char* argv[])
+{
+//	typedef double real_type;
+//	typedef unsigned long uint_type;
+//	typedef long int_type;
+//	typedef dcs::des::engine<real_type> des_engine_type;
+////	typedef dcs::math::random::base_generator<real_type> random_generator_type;
+//	typedef dcs::math::random::base_generator<uint_type> random_generator_type;
+//	typedef dcs::des::cloud::traits<
+//				des_engine_type,
+//				random_generator_type,
+//				real_type,
+//				uint_type,
+//				int_type
+//			> traits_type;
+//	typedef dcs::des::cloud::registry<traits_type> registry_type;
+	//typedef dcs::des::cloud::data_center<traits_type> data_center_type;
+
+
+#ifdef DCS_DEBUG
+	::std::set_terminate(detail::stack_tracer);
+#endif // DCS_DEBUG
+
+	prog_name = argv[0];
+
+	if (argc < 2)
+	{
+		detail::usage();
+		return -1;
+	}
+
+
+	std::cout << "--- DCS DES Cloud start at " << detail::strtime() << "." << std::endl;
+	std::cout << "--------------------------------------------------------------------------------" << std::endl;
+
+
+	// Parse command line arguments
+
+	std::string conf_fname; // (argv[1]);
+	bool partial_stats(false);
+	std::string outdata_fname;
+	uint_type num_jobs(0);
+	uint_type num_control_threads(0);
+	std::string trace_spec;
+	std::string trace_fname;
+	bool trace_binary(false);
+	bool output_info(false);
+	bool output_help(false);
+	real_type fork_time(-1);
+	std::string fork_variants;
+
+	output_help = detail::get_option(argv, argv+argc, "--help");
+	output_info = detail::get_option(argv, argv+argc, "--info");
+
+	if (output_help)
+	{
+		detail::usage();
+		return 0;
+	}
+	if (output_info)
+	{
+		detail::info();
+		return 0;
+	}
+
+	try
+	{
+		partial_stats = detail::get_option(argv, argv+argc, "--partial-stats");
+		conf_fname = detail::get_option<std::string>(argv, argv+argc, "--conf");
+		outdata_fname = detail::get_option<std::string>(argv, argv+argc, "--out-data-file", "");
+		num_jobs = detail::get_option<uint_type>(argv, argv+argc, "--jobs", num_jobs);
+		num_control_threads = detail::get_option<uint_type>(argv, argv+argc, "--control-threads", num_control_threads);
+		trace_spec = detail::get_option<std::string>(argv, argv+argc, "--trace", "");
+		trace_fname = detail::get_option<std::string>(argv, argv+argc, "--trace-file", "");
+		trace_binary = detail::get_option(argv, argv+argc, "--trace-binary");
+		fork_time = detail::get_option<real_type>(argv, argv+argc, "--fork-at", fork_time);
+		fork_variants = detail::get_option<std::string>(argv, argv+argc, "--fork-variants", "");
+	}
+	catch (std::exception const& e)
+	{
+		std::cerr << "[Error] Error while parsing command-line options: " << e.what() << std::endl;
+		detail::usage();
+		std::abort();
+	}
+
+	std::cout << "CLI OPTIONS:" << std::endl;
+	std::cout << " - Partial Statistics: " << std::boolalpha << partial_stats << std::endl;
+	std::cout << " - Configuration File: " << conf_fname << std::endl;
+	std::cout << " - Output Data File: " << outdata_fname << std::endl;
+	std::cout << " - Concurrent Replications: " << num_jobs << std::endl;
+	std::cout << " - Control Threads: " << num_control_threads << std::endl;
+	std::cout << " - Trace Levels: " << trace_spec << std::endl;
+	std::cout << " - Trace File: " << trace_fname << " (" << (trace_binary ? "binary" : "text") << ")" << std::endl;
+	std::cout << " - Fork Time: " << fork_time << std::endl;
+	std::cout << " - Fork Variants: " << fork_variants << std::endl;
+	std::cout << "--------------------------------------------------------------------------------" << std::endl;
+
+	// Set-up tracing
+
+	try
+	{
+		::dcs::des::cloud::tracer& tracer(::dcs::des::cloud::tracer::instance());
+
+		tracer.configure(trace_spec);
+		if (trace_binary)
+		{
+			if (trace_fname.empty())
+			{
+				throw ::std::invalid_argument("Binary traces need a trace file.");
+			}
+			tracer.sink(::dcs::make_shared< ::dcs::des::cloud::binary_trace_sink >(trace_fname));
+		}
+		else if (!trace_fname.empty())
+		{
+			tracer.sink(::dcs::make_shared< ::dcs::des::cloud::text_trace_sink >(trace_fname));
+		}
+		tracer.precision(16);
+	}
+	catch (::std::exception const& e)
+	{
+		::std::clog << "[Error] Unable to set-up tracing: " << e.what() << ::std::endl;
+		return -2;
+	}
+
+	// Read configuration
+
+	configuration_category conf_cat = yaml_configuration;
+
+	configuration_pointer ptr_conf;
+
+	try
+	{
+		switch (conf_cat)
+		{
+			case yaml_configuration:
+
+				ptr_conf = dcs::make_shared<configuration_type>(
+							dcs::des::cloud::config::read_file(
+								conf_fname,
+								::dcs::des::cloud::config::yaml_reader<real_type,uint_type>()
+							)
+						);
+				break;
+			default:
+				throw ::std::runtime_error("Unknown configuration category.");
+		}
+	}
+	catch (::std::exception const& e)
+	{
+		::std::clog << "[Error] Unable to read configuration: " << e.what() << ::std::endl;
+		return -2;
+	}
+
+	// Read the configuration of each variant
+
+	detail::fork_context fork_ctx;
+
+	if (!fork_variants.empty())
+	{
+		try
+		{
+			if (fork_time < 0)
+			{
+				throw ::std::invalid_argument("Variants need a fork time.");
+			}
+
+			// The controllers installed at the fork would be lost at the next replication
+			bool single_run(false);
+			switch (ptr_conf->simulation().output_analysis.category)
+			{
+				case dcs::des::cloud::config::independent_replications_output_analysis:
+					single_run = detail::num_replications(*ptr_conf) == 1;
+					break;
+				case dcs::des::cloud::config::batch_means_output_analysis:
+					single_run = true;
+					break;
+				default:
+					break;
+			}
+			if (!single_run)
+			{
+				throw ::std::invalid_argument("Variants need a single simulation run (i.e., batch means or exactly one replication).");
+			}
+
+			fork_ctx.time = fork_time;
+
+			std::string::size_type pos(0);
+			while (pos <= fork_variants.size())
+			{
+				std::string::size_type next_pos(fork_variants.find(',', pos));
+				if (next_pos == std::string::npos)
+				{
+					next_pos = fork_variants.size();
+				}
+
+				std::string variant_fname(fork_variants.substr(pos, next_pos-pos));
+				if (!variant_fname.empty())
+				{
+					fork_ctx.variant_fnames.push_back(variant_fname);
+					fork_ctx.ptr_variant_confs.push_back(
+							dcs::make_shared<configuration_type>(
+								dcs::des::cloud::config::read_file(
+									variant_fname,
+									::dcs::des::cloud::config::yaml_reader<real_type,uint_type>()
+								)
+							)
+						);
+				}
+
+				pos = next_pos+1;
+			}
+		}
+		catch (::std::exception const& e)
+		{
+			::std::clog << "[Error] Unable to read variant configuration: " << e.what() << ::std::endl;
+			return -2;
+		}
+	}
+
+	// The command-line option takes precedence over the configuration file
+	if (num_control_threads > 0)
+	{
+		dcs::des::cloud::config::simulation_config<real_type,uint_type> sim(ptr_conf->simulation());
+		sim.control_parallelism = num_control_threads;
+		ptr_conf->simulation(sim);
+	}
+
+	DCS_DEBUG_TRACE("Configuration: " << *ptr_conf); //XXX
+
+	// Print configuration (for ease later info retrieval)
+	::std::cout << "CONFIGURATION:" << ::std::endl
+				<< *ptr_conf << ::std::endl
+				<< "--------------------------------------------------------------------------------" << ::std::endl
+				<< ::std::endl;
+
+	// The command-line option takes precedence over the configuration file
+	if (num_jobs == 0)
+	{
+		num_jobs = ptr_conf->simulation().output_analysis.parallelism;
+	}
+
+	random_seeder_type seeder(ptr_conf->rng().seed);
+
+	std::cerr.precision(16);
+	std::cout.precision(16);
+
+	// Batch means analyze a single long run, which cannot be split among jobs
+	if (!fork_ctx.ptr_variant_confs.empty())
+	{
+		// Variants share the simulation up to the fork time
+		detail::run_simulation(ptr_conf, seeder, partial_stats, &std::cout, outdata_fname, &fork_ctx);
+	}
+	else if (num_jobs > 1 && ptr_conf->simulation().output_analysis.category == dcs::des::cloud::config::independent_replications_output_analysis)
+	{
+		detail::run_parallel_replications(ptr_conf, seeder, num_jobs, std::cout, outdata_fname);
+	}
+	else
+	{
+		detail::run_simulation(ptr_conf, seeder, partial_stats, &std::cout, outdata_fname);
+	}
+
+	::dcs::des::cloud::tracer::instance().flush();
+
+	std::cout << "--- DCS DES Cloud stop at " << detail::strtime() << "." << std::endl;
 }
@@ -0,0 +1,181 @@
+/**
+ * \file src/des_cloud_sysid_worker.cpp
+ *
+ * \brief Native system identification worker.
+ *
+ * Long-lived co-process serving the requests of the MATLAB-based system
+ * identification proxies (see
+ * \c dcs/des/cloud/detail/sysid_worker/protocol.hpp) by means of the native
+ * RLS implementation, so that simulations can be run without MATLAB.
+ * Select it by setting the \c DCS_DES_CLOUD_SYSID_WORKER environment variable
+ * to the path of this program.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/vector_proxy.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <dcs/des/cloud/detail/sysid_worker/client.hpp>
+#include <dcs/des/cloud/detail/sysid_worker/protocol.hpp>
+#include <dcs/sysid/algorithm/rls.hpp>
+#include <exception>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+
+namespace sysid_worker = ::dcs::des::cloud::detail::sysid_worker;
+
+
+namespace detail { namespace /*<unnamed>*/ {
+
+typedef sysid_worker::value_type real_type;
+typedef ::std::size_t size_type;
+typedef ::boost::numeric::ublas::vector<real_type> vector_type;
+typedef ::boost::numeric::ublas::matrix<real_type> matrix_type;
+
+
+inline
+size_type to_size(real_type x)
+{
+	if (x < 0)
+	{
+		throw ::std::invalid_argument("[detail::to_size] Negative order.");
+	}
+
+	return static_cast<size_type>(x);
+}
+
+
+/// Serve a \c rarx request: <tt>(z, nn, ff[, th, P, phi])</tt>.
+sysid_worker::message rarx(sysid_worker::message const& req)
+{
+	namespace ublas = ::boost::numeric::ublas;
+
+	if (req.args.size() != 3 && req.args.size() != 6)
+	{
+		throw ::std::invalid_argument("[detail::rarx] Wrong number of arguments.");
+	}
+
+	vector_type z;
+	sysid_worker::copy_matrix(req.args[0], z);
+	vector_type nn;
+	sysid_worker::copy_matrix(req.args[1], nn);
+	real_type ff(0);
+	sysid_worker::copy_matrix(req.args[2], ff);
+
+	const size_type nz(z.size());
+	if (nz < 2)
+	{
+		throw ::std::invalid_argument("[detail::rarx] Data must have at least one output and one input.");
+	}
+	const size_type nu(nz-1);
+	if (nn.size() != 1+2*nu)
+	{
+		throw ::std::invalid_argument("[detail::rarx] Orders and data sizes do not match.");
+	}
+
+	// All the inputs share the same order and delay (see the proxy)
+	const size_type na(to_size(nn(0)));
+	const size_type nb(to_size(nn(1)));
+	const size_type d(to_size(nn(1+nu)));
+
+	vector_type th;
+	matrix_type P;
+	vector_type phi;
+	if (req.args.size() == 6)
+	{
+		sysid_worker::copy_matrix(req.args[3], th);
+		sysid_worker::copy_matrix(req.args[4], P);
+		sysid_worker::copy_matrix(req.args[5], phi);
+	}
+	else
+	{
+		::dcs::sysid::rls_arx_miso_init(na, nb, d, nu, th, P, phi);
+	}
+
+	vector_type u(ublas::subrange(z, 1, nz));
+	real_type yh(::dcs::sysid::rls_ff_arx_miso(z(0), u, ff, na, nb, d, th, P, phi));
+
+	sysid_worker::message rep(sysid_worker::rarx_opcode);
+	rep.args.push_back(sysid_worker::make_matrix(th));
+	rep.args.push_back(sysid_worker::make_matrix(yh));
+	rep.args.push_back(sysid_worker::make_matrix(P));
+	rep.args.push_back(sysid_worker::make_matrix(phi));
+
+	return rep;
+}
+
+}} // Namespace detail::<unnamed>
+
+
+int main()
+{
+	int rep_fd(sysid_worker::client::reply_fd);
+
+	// Allow to run the worker by hand (replies on standard output)
+	if (::fcntl(rep_fd, F_GETFD) == -1)
+	{
+		rep_fd = STDOUT_FILENO;
+	}
+
+	try
+	{
+		sysid_worker::message req;
+
+		while (sysid_worker::read_message(STDIN_FILENO, req) && req.op != sysid_worker::quit_opcode)
+		{
+			sysid_worker::message rep;
+
+			try
+			{
+				switch (req.op)
+				{
+					case sysid_worker::rarx_opcode:
+						rep = detail::rarx(req);
+						break;
+					case sysid_worker::rpem_opcode:
+						rep = sysid_worker::make_error_message("rpem is not supported by the native worker; use the MATLAB worker.");
+						break;
+					default:
+						rep = sysid_worker::make_error_message("Unknown operation code.");
+						break;
+				}
+			}
+			catch (::std::exception const& e)
+			{
+				rep = sysid_worker::make_error_message(e.what());
+			}
+
+			sysid_worker::write_message(rep_fd, rep);
+		}
+	}
+	catch (::std::exception const& e)
+	{
+		::std::clog << "[Error] " << e.what() << ::std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+%% DCS_DES_CLOUD_SYSID_WORKER  System identification worker for dcs::des::cloud.
+%%
+%% Long-lived co-process serving the rarx/rpem requests of the MATLAB-based
+%% system identification proxies, in place of starting a new MATLAB instance
+%% at every estimation step.
+%% Requests are read from the standard input and replies are written on file
+%% descriptor 3; see dcs/des/cloud/detail/sysid_worker/protocol.hpp for the
+%% wire format.
+%%
+%% This file must be on the MATLAB (or Octave) path; the simulator starts it
+%% with "matlab -nodisplay -nojvm -r dcs_des_cloud_sysid_worker" unless the
+%% DCS_DES_CLOUD_SYSID_WORKER environment variable says otherwise.
+%%
+%% Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+%% Science Department - University of Piemonte Orientale, Alessandria (Italy).
+%%
+%% This program is free software: you can redistribute it and/or modify
+%% it under the terms of the GNU General Public License as published
+%% by the Free Software Foundation, either version 3 of the License, or
+%% (at your option) any later version.
+%%
+%% This program is distributed in the hope that it will be useful,
+%% but WITHOUT ANY WARRANTY; without even the implied warranty of
+%% MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+%% GNU General Public License for more details.
+%%
+%% You should have received a copy of the GNU General Public License
+%% along with this program.  If not, see <http://www.gnu.org/licenses/>.
+%%
+%% Author: Marco Guazzone (marco.guazzone@gmail.com)
+
+function dcs_des_cloud_sysid_worker()
+	MAGIC = uint32(hex2dec('57534344'));
+	QUIT_OP = 0;
+	RARX_OP = 1;
+	RPEM_OP = 2;
+	ERROR_OP = 255;
+
+	fin = fopen('/dev/stdin', 'r');
+	fout = fopen('/dev/fd/3', 'w');
+	if fin < 0 || fout < 0
+		exit(1);
+	end
+
+	while true
+		[hdr, cnt] = fread(fin, 3, 'uint32=>uint32');
+		if cnt < 3
+			break;
+		end
+		if hdr(1) ~= MAGIC
+			exit(1);
+		end
+		op = double(hdr(2));
+		args = cell(1, double(hdr(3)));
+		for i = 1:numel(args)
+			dims = double(fread(fin, 2, 'uint32'));
+			args{i} = reshape(fread(fin, dims(1)*dims(2), 'double'), dims(1), dims(2));
+		end
+
+		if op == QUIT_OP
+			break;
+		end
+
+		try
+			switch op
+				case RARX_OP
+					if numel(args) > 3
+						[th, yh, P, phi] = rarx(args{1}, args{2}, 'ff', args{3}, args{4}, args{5}, args{6});
+					else
+						[th, yh, P, phi] = rarx(args{1}, args{2}, 'ff', args{3});
+					end
+					rep = {th(:), yh, P, phi(:)};
+				case RPEM_OP
+					if numel(args) > 3
+						[th, yh, P, phi, psi] = rpem(args{1}, args{2}, 'ff', args{3}, args{4}, args{5}, args{6}, args{7});
+					else
+						[th, yh, P, phi, psi] = rpem(args{1}, args{2}, 'ff', args{3});
+					end
+					rep = {th(:), yh, P, phi(:), psi(:)};
+				otherwise
+					error('Unknown operation code %d.', op);
+			end
+		catch err
+			op = ERROR_OP;
+			rep = {double(err.message)};
+		end
+
+		write_message(fout, MAGIC, op, rep);
+	end
+
+	fclose(fout);
+	fclose(fin);
+	exit(0);
+end
+
+
+function write_message(fid, magic, op, args)
+	fwrite(fid, [magic, op, numel(args)], 'uint32');
+	for i = 1:numel(args)
+		fwrite(fid, size(args{i}), 'uint32');
+		fwrite(fid, args{i}, 'double');
+	end
+	% Replies must reach the simulator right away
+	if exist('OCTAVE_VERSION', 'builtin')
+		fflush(fid);
+	else
+		fseek(fid, 0, 'cof');
+	end
+end
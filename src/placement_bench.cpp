@@ -0,0 +1,172 @@
+/**
+ * \file src/placement_bench.cpp
+ *
+ * \brief Microbenchmark of the VM placement feasibility check.
+ *
+ * Times the \c placeable check of a VM against a set of PMs which already
+ * host some VMs, both for a VM not yet placed (served by the per-PM share
+ * aggregates) and for a VM already placed on the PM (which has to exclude its
+ * own contribution), so that changes to the per-check cost of the share
+ * containers can be measured in isolation from the simulation.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <ctime>
+#include <dcs/des/cloud/config/configuration.hpp>
+#include <dcs/des/cloud/data_center.hpp>
+#include <dcs/des/cloud/physical_machine.hpp>
+#include <dcs/des/cloud/physical_resource_category.hpp>
+#include <dcs/des/cloud/registry.hpp>
+#include <dcs/des/cloud/traits.hpp>
+#include <dcs/des/cloud/virtual_machine.hpp>
+#include <dcs/des/cloud/virtual_machines_placement.hpp>
+#include <dcs/des/engine.hpp>
+#include <dcs/des/replications/engine.hpp>
+#include <dcs/math/random.hpp>
+#include <dcs/memory.hpp>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+
+namespace detail { namespace /*<unnamed>*/ {
+
+typedef double real_type;
+typedef unsigned long uint_type;
+typedef long int_type;
+typedef ::std::size_t size_type;
+typedef ::dcs::des::engine<real_type> des_engine_type;
+typedef ::dcs::math::random::base_generator<uint_type> random_generator_type;
+typedef ::dcs::des::cloud::traits<
+			des_engine_type,
+			random_generator_type,
+			::dcs::des::cloud::config::configuration<real_type,uint_type>,
+			real_type,
+			uint_type,
+			int_type
+		> traits_type;
+typedef ::dcs::des::cloud::registry<traits_type> registry_type;
+typedef ::dcs::des::replications::engine<real_type,uint_type> des_engine_impl_type;
+typedef ::dcs::des::cloud::data_center<traits_type> data_center_type;
+typedef ::dcs::des::cloud::physical_machine<traits_type> physical_machine_type;
+typedef ::dcs::shared_ptr<physical_machine_type> physical_machine_pointer;
+typedef ::dcs::des::cloud::virtual_machine<traits_type> virtual_machine_type;
+typedef ::dcs::shared_ptr<virtual_machine_type> virtual_machine_pointer;
+typedef ::dcs::des::cloud::virtual_machines_placement<traits_type> placement_type;
+typedef ::std::pair< ::dcs::des::cloud::physical_resource_category,real_type> share_type;
+typedef ::std::vector<share_type> share_container;
+
+
+inline
+double elapsed_ns(::std::clock_t start, ::std::clock_t stop, uint_type n)
+{
+	return (static_cast<double>(stop-start)/CLOCKS_PER_SEC)*1.0e+9/n;
+}
+
+}} // Namespace detail::<unnamed>
+
+
+int main(int argc, char* argv[])
+{
+	const detail::size_type num_pms(64);
+	const detail::size_type num_vms_per_pm(8);
+
+	detail::uint_type n(10000);
+	if (argc > 1)
+	{
+		n = ::std::strtoul(argv[1], 0, 10);
+	}
+	if (n == 0)
+	{
+		::std::clog << "Usage: " << argv[0] << " [<num-rounds>]" << ::std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// PMs create their simulation model through the registry
+	detail::registry_type reg;
+	::dcs::des::cloud::scoped_registry<detail::traits_type> reg_scope(reg);
+	reg.des_engine(::dcs::make_shared<detail::des_engine_impl_type>(detail::real_type(1), detail::uint_type(1)));
+
+	detail::data_center_type dc;
+	detail::placement_type placement;
+
+	// Every PM hosts some VMs, each one using the same CPU and memory share
+	detail::share_container shares;
+	shares.push_back(detail::share_type(::dcs::des::cloud::cpu_resource_category, 0.1));
+	shares.push_back(detail::share_type(::dcs::des::cloud::memory_resource_category, 0.05));
+	detail::share_container no_utils;
+
+	::std::vector<detail::physical_machine_pointer> pms;
+	::std::vector<detail::virtual_machine_pointer> vms;
+	for (detail::size_type i = 0; i < num_pms; ++i)
+	{
+		detail::physical_machine_pointer ptr_pm(new detail::physical_machine_type());
+		ptr_pm->id(static_cast<long>(i));
+		pms.push_back(ptr_pm);
+
+		for (detail::size_type j = 0; j < num_vms_per_pm; ++j)
+		{
+			detail::virtual_machine_pointer ptr_vm(new detail::virtual_machine_type());
+			ptr_vm->id(static_cast<long>(vms.size()));
+			vms.push_back(ptr_vm);
+
+			placement.place(*ptr_vm, *ptr_pm, shares.begin(), shares.end(), no_utils.begin(), no_utils.end(), dc);
+		}
+	}
+
+	// A VM not yet placed anywhere
+	detail::virtual_machine_type vm;
+	vm.id(static_cast<long>(vms.size()));
+
+	detail::uint_type num_ok(0);
+
+	::std::clock_t start(::std::clock());
+	for (detail::uint_type k = 0; k < n; ++k)
+	{
+		for (detail::size_type i = 0; i < num_pms; ++i)
+		{
+			if (placement.placeable(vm, *pms[i], shares.begin(), shares.end(), no_utils.begin(), no_utils.end(), dc))
+			{
+				++num_ok;
+			}
+		}
+	}
+	::std::clock_t stop(::std::clock());
+	::std::cout << "placeable() of an unplaced VM: " << detail::elapsed_ns(start, stop, n*num_pms) << " ns/check" << ::std::endl;
+
+	start = ::std::clock();
+	for (detail::uint_type k = 0; k < n; ++k)
+	{
+		for (detail::size_type i = 0; i < num_pms; ++i)
+		{
+			if (placement.placeable(*vms[i*num_vms_per_pm], *pms[i], shares.begin(), shares.end(), no_utils.begin(), no_utils.end(), dc))
+			{
+				++num_ok;
+			}
+		}
+	}
+	stop = ::std::clock();
+	::std::cout << "placeable() of a placed VM: " << detail::elapsed_ns(start, stop, n*num_pms) << " ns/check" << ::std::endl;
+
+	// Each PM has room for one more VM, and for its own ones
+	return num_ok == 2*n*num_pms ? EXIT_SUCCESS : EXIT_FAILURE;
+}
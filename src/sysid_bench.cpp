@@ -0,0 +1,159 @@
+/**
+ * \file src/sysid_bench.cpp
+ *
+ * \brief Microbenchmark of the recursive system identification strategies.
+ *
+ * Times the estimation step and the extraction of the A_k and B_k matrices
+ * of the RLS-based identification strategies on a synthetic ARX system, so
+ * that changes to their per-sample cost can be measured in isolation from the
+ * simulation.
+ *
+ * Copyright (C) 2009-2012  Distributed Computing System (DCS) Group, Computer
+ * Science Department - University of Piemonte Orientale, Alessandria (Italy).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * \author Marco Guazzone (marco.guazzone@gmail.com)
+ */
+
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <ctime>
+#include <dcs/des/cloud/detail/system_identification_strategies.hpp>
+#include <iostream>
+#include <string>
+
+
+namespace detail { namespace /*<unnamed>*/ {
+
+struct traits
+{
+	typedef double real_type;
+	typedef unsigned long uint_type;
+};
+
+typedef traits::real_type real_type;
+typedef traits::uint_type uint_type;
+typedef ::std::size_t size_type;
+typedef ::dcs::des::cloud::detail::rls_ff_miso_proxy<traits> rls_proxy_type;
+typedef rls_proxy_type::vector_type vector_type;
+typedef rls_proxy_type::matrix_type matrix_type;
+
+
+inline
+real_type uniform01()
+{
+	return static_cast<real_type>(::std::rand())/RAND_MAX;
+}
+
+
+inline
+double elapsed_ns(::std::clock_t start, ::std::clock_t stop, uint_type n)
+{
+	return (static_cast<double>(stop-start)/CLOCKS_PER_SEC)*1.0e+9/n;
+}
+
+}} // Namespace detail::<unnamed>
+
+
+int main(int argc, char* argv[])
+{
+	const detail::size_type na(2);
+	const detail::size_type nb(2);
+	const detail::size_type d(1);
+	const detail::size_type ny(2);
+	const detail::size_type nu(2);
+	const detail::real_type ff(0.98);
+
+	detail::uint_type n(100000);
+	if (argc > 1)
+	{
+		n = ::std::strtoul(argv[1], 0, 10);
+	}
+	if (n == 0)
+	{
+		::std::clog << "Usage: " << argv[0] << " [<num-steps>]" << ::std::endl;
+		return EXIT_FAILURE;
+	}
+
+	::std::srand(5489);
+
+	detail::rls_proxy_type rls(na, nb, d, ny, nu, ff);
+	rls.max_covariance_heuristic(true);
+	rls.max_covariance_heuristic_max_value(1.0e+10);
+	rls.condition_number_covariance_heuristic(true);
+	rls.condition_number_covariance_heuristic_max_value(2);
+	rls.init();
+
+	// A stable first-order system with a small additive noise
+	detail::vector_type y(ny, 0);
+	detail::vector_type u(nu, 0);
+
+	::std::clock_t start(::std::clock());
+	for (detail::uint_type k = 0; k < n; ++k)
+	{
+		for (detail::size_type j = 0; j < nu; ++j)
+		{
+			u(j) = detail::uniform01();
+		}
+		for (detail::size_type i = 0; i < ny; ++i)
+		{
+			y(i) = 0.5*y(i)+0.3*u(i % nu)+0.01*(detail::uniform01()-0.5);
+		}
+		rls.estimate(y, u);
+	}
+	::std::clock_t stop(::std::clock());
+	::std::cout << "estimate(): " << detail::elapsed_ns(start, stop, n) << " ns/step" << ::std::endl;
+
+	detail::real_type chk(0);
+
+	start = ::std::clock();
+	for (detail::uint_type k = 0; k < n; ++k)
+	{
+		for (detail::size_type i = 1; i <= na; ++i)
+		{
+			chk += rls.A(i)(0,0);
+		}
+		for (detail::size_type i = 1; i <= nb; ++i)
+		{
+			chk += rls.B(i)(0,0);
+		}
+	}
+	stop = ::std::clock();
+	::std::cout << "A(k)/B(k) by value: " << detail::elapsed_ns(start, stop, n) << " ns/step" << ::std::endl;
+
+	detail::matrix_type X;
+
+	start = ::std::clock();
+	for (detail::uint_type k = 0; k < n; ++k)
+	{
+		for (detail::size_type i = 1; i <= na; ++i)
+		{
+			rls.A(i, X);
+			chk -= X(0,0);
+		}
+		for (detail::size_type i = 1; i <= nb; ++i)
+		{
+			rls.B(i, X);
+			chk -= X(0,0);
+		}
+	}
+	stop = ::std::clock();
+	::std::cout << "A(k)/B(k) in place: " << detail::elapsed_ns(start, stop, n) << " ns/step" << ::std::endl;
+
+	// Both extractions must agree
+	return chk == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
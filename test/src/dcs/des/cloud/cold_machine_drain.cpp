@@ -0,0 +1,309 @@
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/des/cloud/data_center.hpp>
+#include <dcs/des/cloud/detail/cold_machine_drain.hpp>
+#include <dcs/des/cloud/detail/physical_machine_fit_index.hpp>
+#include <dcs/des/cloud/dummy_physical_machine_controller.hpp>
+#include <dcs/des/cloud/physical_resource.hpp>
+#include <dcs/des/cloud/physical_resource_category.hpp>
+#include <dcs/des/cloud/registry.hpp>
+#include <dcs/des/cloud/resource_vector.hpp>
+#include <dcs/des/cloud/traits.hpp>
+#include <dcs/des/cloud/virtual_machines_placement.hpp>
+#include <dcs/des/replications/engine.hpp>
+#include <dcs/math/random/mersenne_twister.hpp>
+#include <dcs/memory.hpp>
+#include <dcs/test.hpp>
+#include <map>
+#include <set>
+#include <vector>
+
+
+typedef double real_type;
+typedef unsigned long uint_type;
+typedef long int_type;
+typedef dcs::des::replications::engine<real_type,uint_type> des_engine_type;
+typedef dcs::math::random::mt19937 random_generator_type;
+typedef dcs::des::cloud::traits<
+			des_engine_type,
+			random_generator_type,
+			real_type,
+			uint_type,
+			int_type
+		> traits_type;
+typedef dcs::des::cloud::registry<traits_type> registry_type;
+typedef dcs::shared_ptr<des_engine_type> des_engine_pointer;
+typedef dcs::shared_ptr<random_generator_type> random_generator_pointer;
+typedef dcs::des::cloud::data_center<traits_type> data_center_type;
+typedef data_center_type::physical_machine_type physical_machine_type;
+typedef data_center_type::physical_machine_pointer physical_machine_pointer;
+typedef data_center_type::physical_machine_controller_pointer physical_machine_controller_pointer;
+typedef data_center_type::virtual_machine_type virtual_machine_type;
+typedef data_center_type::virtual_machine_pointer virtual_machine_pointer;
+typedef data_center_type::virtual_machines_placement_type virtual_machines_placement_type;
+typedef physical_machine_type::resource_type physical_resource_type;
+typedef physical_machine_type::resource_pointer physical_resource_pointer;
+typedef dcs::des::cloud::dummy_physical_machine_controller<traits_type> physical_machine_controller_type;
+typedef dcs::des::cloud::detail::physical_machine_fit_index<traits_type> physical_machine_index_type;
+typedef traits_type::physical_machine_identifier_type physical_machine_identifier_type;
+typedef traits_type::virtual_machine_identifier_type virtual_machine_identifier_type;
+typedef dcs::des::cloud::resource_vector<real_type> resource_share_map;
+typedef std::vector<virtual_machine_pointer> vm_container;
+typedef std::set<physical_machine_identifier_type> physical_machine_identifier_set;
+typedef std::map<virtual_machine_identifier_type,physical_machine_identifier_type> vm_pm_map;
+
+
+const real_type min_replication_len(5.3);
+const real_type min_num_replications(1);
+const uint_type seed(5489);
+const real_type pm_capacity(1000);
+
+
+namespace detail { namespace /*<unnamed>*/ {
+
+/// Places every VM with a fixed CPU share, as the migration controller does with the observed shares.
+struct fixed_share_placer
+{
+	fixed_share_placer(data_center_type const& dc_)
+	: ptr_dc(&dc_)
+	{
+	}
+
+	void share(virtual_machine_pointer const& ptr_vm, real_type value)
+	{
+		shares[ptr_vm->id()] = value;
+	}
+
+	real_type wanted_capacity(virtual_machine_pointer const& ptr_vm) const
+	{
+		return shares.at(ptr_vm->id())*pm_capacity;
+	}
+
+	bool try_place(virtual_machine_pointer const& ptr_vm, physical_machine_pointer const& ptr_pm, virtual_machines_placement_type& deployment) const
+	{
+		resource_share_map vm_shares;
+		vm_shares[dcs::des::cloud::cpu_resource_category] = shares.at(ptr_vm->id());
+		resource_share_map vm_utils;
+
+		return deployment.try_place(*ptr_vm,
+									*ptr_pm,
+									vm_shares.begin(),
+									vm_shares.end(),
+									vm_utils.begin(),
+									vm_utils.end(),
+									*ptr_dc);
+	}
+
+	data_center_type const* ptr_dc;
+	std::map<virtual_machine_identifier_type,real_type> shares;
+};
+
+
+void setup_registry()
+{
+	registry_type& reg = registry_type::instance();
+
+	des_engine_pointer ptr_eng = dcs::make_shared<des_engine_type>(min_replication_len, min_num_replications);
+	reg.des_engine(ptr_eng);
+	random_generator_pointer ptr_rng = dcs::make_shared<random_generator_type>(seed);
+	reg.uniform_random_generator(ptr_rng);
+}
+
+
+physical_machine_pointer add_physical_machine(data_center_type& dc, bool power_on)
+{
+	physical_machine_pointer ptr_pm = dcs::make_shared<physical_machine_type>();
+	physical_resource_pointer ptr_cpu = dcs::make_shared<physical_resource_type>("CPU", dcs::des::cloud::cpu_resource_category, pm_capacity, real_type(1));
+	ptr_pm->add_resource(ptr_cpu);
+
+	physical_machine_controller_pointer ptr_ctrl = dcs::make_shared<physical_machine_controller_type>(ptr_pm);
+	dc.add_physical_machine(ptr_pm, ptr_ctrl);
+
+	if (power_on)
+	{
+		ptr_pm->power_on();
+	}
+
+	return ptr_pm;
+}
+
+
+virtual_machine_pointer place_virtual_machine(virtual_machine_identifier_type vm_id,
+											  physical_machine_pointer const& ptr_pm,
+											  real_type share,
+											  fixed_share_placer& placer,
+											  virtual_machines_placement_type& deployment)
+{
+	virtual_machine_pointer ptr_vm = dcs::make_shared<virtual_machine_type>();
+	ptr_vm->id(vm_id);
+
+	placer.share(ptr_vm, share);
+	placer.try_place(ptr_vm, ptr_pm, deployment);
+
+	return ptr_vm;
+}
+
+
+vm_pm_map hosts(vm_container const& vms, virtual_machines_placement_type const& deployment)
+{
+	vm_pm_map map;
+	for (std::size_t i = 0; i < vms.size(); ++i)
+	{
+		map[vms[i]->id()] = deployment.pm_id(deployment.find(*(vms[i])));
+	}
+
+	return map;
+}
+
+
+std::size_t num_migrations(vm_pm_map const& before, vm_pm_map const& after)
+{
+	std::size_t n(0);
+	for (vm_pm_map::const_iterator it = before.begin(); it != before.end(); ++it)
+	{
+		if (after.at(it->first) != it->second)
+		{
+			++n;
+		}
+	}
+
+	return n;
+}
+
+}} // Namespace detail::<unnamed>
+
+
+DCS_TEST_DEF( test_powered_off_target )
+{
+	DCS_DEBUG_TRACE("Test Case: Powered-off Target");
+
+	detail::setup_registry();
+
+	data_center_type dc;
+	physical_machine_pointer ptr_cold_pm = detail::add_physical_machine(dc, true);
+	detail::add_physical_machine(dc, false);
+
+	virtual_machines_placement_type deployment;
+	detail::fixed_share_placer placer(dc);
+	vm_container vms;
+	vms.push_back(detail::place_virtual_machine(0, ptr_cold_pm, 0.2, placer, deployment));
+
+	physical_machine_index_type pm_index(dc, deployment, false);
+	physical_machine_identifier_set excluded_pms;
+	vm_pm_map before(detail::hosts(vms, deployment));
+
+	bool drained = dcs::des::cloud::detail::drain_physical_machine(ptr_cold_pm->id(), vms, dc, deployment, pm_index, excluded_pms, placer);
+
+	// Powering on a machine to empty a cold one saves nothing
+	DCS_TEST_CHECK( !drained );
+	DCS_TEST_CHECK( detail::num_migrations(before, detail::hosts(vms, deployment)) == 0 );
+	DCS_TEST_CHECK_CLOSE( deployment.residual_share(ptr_cold_pm->id(), dcs::des::cloud::cpu_resource_category), 0.8, 1.0e-5 );
+	DCS_TEST_CHECK( excluded_pms.empty() );
+}
+
+
+DCS_TEST_DEF( test_idle_target )
+{
+	DCS_DEBUG_TRACE("Test Case: Idle Target");
+
+	detail::setup_registry();
+
+	data_center_type dc;
+	physical_machine_pointer ptr_cold_pm = detail::add_physical_machine(dc, true);
+	detail::add_physical_machine(dc, true);
+
+	virtual_machines_placement_type deployment;
+	detail::fixed_share_placer placer(dc);
+	vm_container vms;
+	vms.push_back(detail::place_virtual_machine(0, ptr_cold_pm, 0.2, placer, deployment));
+
+	physical_machine_index_type pm_index(dc, deployment, false);
+	physical_machine_identifier_set excluded_pms;
+	vm_pm_map before(detail::hosts(vms, deployment));
+
+	bool drained = dcs::des::cloud::detail::drain_physical_machine(ptr_cold_pm->id(), vms, dc, deployment, pm_index, excluded_pms, placer);
+
+	// The other machine is on but hosts nothing: it would turn cold in turn
+	DCS_TEST_CHECK( !drained );
+	DCS_TEST_CHECK( detail::num_migrations(before, detail::hosts(vms, deployment)) == 0 );
+	DCS_TEST_CHECK( excluded_pms.empty() );
+}
+
+
+DCS_TEST_DEF( test_partial_fit )
+{
+	DCS_DEBUG_TRACE("Test Case: Partial Fit");
+
+	detail::setup_registry();
+
+	data_center_type dc;
+	physical_machine_pointer ptr_cold_pm = detail::add_physical_machine(dc, true);
+	physical_machine_pointer ptr_pm = detail::add_physical_machine(dc, true);
+
+	virtual_machines_placement_type deployment;
+	detail::fixed_share_placer placer(dc);
+	vm_container vms;
+	vms.push_back(detail::place_virtual_machine(0, ptr_cold_pm, 0.6, placer, deployment));
+	vms.push_back(detail::place_virtual_machine(1, ptr_cold_pm, 0.2, placer, deployment));
+	vm_container other_vms;
+	other_vms.push_back(detail::place_virtual_machine(2, ptr_pm, 0.3, placer, deployment));
+
+	physical_machine_index_type pm_index(dc, deployment, false);
+	physical_machine_identifier_set excluded_pms;
+	vm_pm_map before(detail::hosts(vms, deployment));
+
+	bool drained = dcs::des::cloud::detail::drain_physical_machine(ptr_cold_pm->id(), vms, dc, deployment, pm_index, excluded_pms, placer);
+
+	// The first VM fits, the second does not: the first one must come back
+	DCS_TEST_CHECK( !drained );
+	DCS_TEST_CHECK( detail::num_migrations(before, detail::hosts(vms, deployment)) == 0 );
+	DCS_TEST_CHECK_CLOSE( deployment.residual_share(ptr_cold_pm->id(), dcs::des::cloud::cpu_resource_category), 0.2, 1.0e-5 );
+	DCS_TEST_CHECK_CLOSE( deployment.residual_share(ptr_pm->id(), dcs::des::cloud::cpu_resource_category), 0.7, 1.0e-5 );
+	DCS_TEST_CHECK( excluded_pms.empty() );
+}
+
+
+DCS_TEST_DEF( test_drain )
+{
+	DCS_DEBUG_TRACE("Test Case: Drain");
+
+	detail::setup_registry();
+
+	data_center_type dc;
+	physical_machine_pointer ptr_cold_pm = detail::add_physical_machine(dc, true);
+	physical_machine_pointer ptr_pm = detail::add_physical_machine(dc, true);
+
+	virtual_machines_placement_type deployment;
+	detail::fixed_share_placer placer(dc);
+	vm_container vms;
+	vms.push_back(detail::place_virtual_machine(0, ptr_cold_pm, 0.2, placer, deployment));
+	vm_container other_vms;
+	other_vms.push_back(detail::place_virtual_machine(1, ptr_pm, 0.3, placer, deployment));
+
+	physical_machine_index_type pm_index(dc, deployment, false);
+	physical_machine_identifier_set excluded_pms;
+	vm_pm_map before(detail::hosts(vms, deployment));
+
+	bool drained = dcs::des::cloud::detail::drain_physical_machine(ptr_cold_pm->id(), vms, dc, deployment, pm_index, excluded_pms, placer);
+
+	DCS_TEST_CHECK( drained );
+	DCS_TEST_CHECK( detail::num_migrations(before, detail::hosts(vms, deployment)) == 1 );
+	DCS_TEST_CHECK( deployment.vm_size(ptr_cold_pm->id()) == 0 );
+	DCS_TEST_CHECK( deployment.pm_id(deployment.find(*(vms[0]))) == ptr_pm->id() );
+	DCS_TEST_CHECK( excluded_pms.count(ptr_cold_pm->id()) == 1 );
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE( "Cold Machine Drain" );
+
+	DCS_TEST_BEGIN();
+
+	DCS_TEST_DO( test_powered_off_target );
+	DCS_TEST_DO( test_idle_target );
+	DCS_TEST_DO( test_partial_fit );
+	DCS_TEST_DO( test_drain );
+
+	DCS_TEST_END();
+}
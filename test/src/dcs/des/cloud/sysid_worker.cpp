@@ -0,0 +1,222 @@
+#include <boost/numeric/ublas/io.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/des/cloud/detail/sysid_worker/client.hpp>
+#include <dcs/des/cloud/detail/sysid_worker/protocol.hpp>
+#include <dcs/sysid/algorithm/rls.hpp>
+#include <dcs/test.hpp>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+
+namespace sysid_worker = ::dcs::des::cloud::detail::sysid_worker;
+
+
+static const double tol = 1.0e-10;
+
+
+/// The native worker, unless overridden by the DCS_DES_CLOUD_SYSID_WORKER environment variable.
+static ::std::vector< ::std::string > native_worker_command()
+{
+	return sysid_worker::worker_command(::std::vector< ::std::string >(1, "./build/debug/des_cloud_sysid_worker"));
+}
+
+
+DCS_TEST_DEF( test_round_trip )
+{
+	DCS_DEBUG_TRACE("Test Case: Request Round Trip");
+
+	typedef ::boost::numeric::ublas::vector<double> vector_type;
+	typedef ::boost::numeric::ublas::matrix<double> matrix_type;
+
+	vector_type z(3);
+	z(0) = 0.5; z(1) = -1.25; z(2) = 3;
+	matrix_type P(2, 2);
+	P(0,0) = 1; P(0,1) = 2;
+	P(1,0) = 3; P(1,1) = 4;
+
+	sysid_worker::message req(sysid_worker::rarx_opcode);
+	req.args.push_back(sysid_worker::make_matrix(z, false));
+	req.args.push_back(sysid_worker::make_matrix(P));
+	req.args.push_back(sysid_worker::make_matrix(0.98));
+
+	int fds[2];
+	DCS_TEST_CHECK( ::pipe(fds) == 0 );
+	sysid_worker::write_message(fds[1], req);
+	::close(fds[1]);
+
+	sysid_worker::message rep;
+	DCS_TEST_CHECK( sysid_worker::read_message(fds[0], rep) );
+	DCS_TEST_CHECK( rep.op == sysid_worker::rarx_opcode );
+	DCS_TEST_CHECK( rep.args.size() == 3 );
+	DCS_TEST_CHECK( rep.args[0].size1() == 1 && rep.args[0].size2() == 3 );
+
+	vector_type zz;
+	sysid_worker::copy_matrix(rep.args[0], zz);
+	DCS_TEST_CHECK_VECTOR_CLOSE( zz, z, 3, tol );
+	matrix_type PP;
+	sysid_worker::copy_matrix(rep.args[1], PP);
+	DCS_TEST_CHECK_MATRIX_CLOSE( PP, P, 2, 2, tol );
+	double ff(0);
+	sysid_worker::copy_matrix(rep.args[2], ff);
+	DCS_TEST_CHECK_CLOSE( ff, 0.98, tol );
+
+	// End-of-file
+	DCS_TEST_CHECK( !sysid_worker::read_message(fds[0], rep) );
+	::close(fds[0]);
+}
+
+
+DCS_TEST_DEF( test_error )
+{
+	DCS_DEBUG_TRACE("Test Case: Error Reply");
+
+	const ::std::string what("rpem is not supported");
+
+	int fds[2];
+	DCS_TEST_CHECK( ::pipe(fds) == 0 );
+	sysid_worker::write_message(fds[1], sysid_worker::make_error_message(what));
+	::close(fds[1]);
+
+	sysid_worker::message rep;
+	DCS_TEST_CHECK( sysid_worker::read_message(fds[0], rep) );
+	::close(fds[0]);
+	DCS_TEST_CHECK( rep.op == sysid_worker::error_opcode );
+	DCS_TEST_CHECK( sysid_worker::error_text(rep) == what );
+}
+
+
+DCS_TEST_DEF( test_native_worker_rarx )
+{
+	DCS_DEBUG_TRACE("Test Case: Native Worker RARX Steps");
+
+	typedef ::boost::numeric::ublas::vector<double> vector_type;
+	typedef ::boost::numeric::ublas::matrix<double> matrix_type;
+
+	const ::std::size_t na(2);
+	const ::std::size_t nb(1);
+	const ::std::size_t nk(1);
+	const ::std::size_t nu(1);
+	const double ff(0.98);
+
+	vector_type nn(1+2*nu);
+	nn(0) = na; nn(1) = nb; nn(2) = nk;
+
+	// Expected state, computed in-process with the same RLS implementation
+	vector_type th;
+	matrix_type P;
+	vector_type phi;
+	::dcs::sysid::rls_arx_miso_init(na, nb, nk, nu, th, P, phi);
+
+	const double ys[] = {0.8, 1.3, 0.9};
+	const double us[] = {0.5, 0.7, 0.4};
+
+	sysid_worker::client worker(native_worker_command());
+
+	vector_type rep_th;
+	matrix_type rep_P;
+	vector_type rep_phi;
+	for (::std::size_t k = 0; k < 3; ++k)
+	{
+		vector_type z(1+nu);
+		z(0) = ys[k];
+		z(1) = us[k];
+
+		sysid_worker::message req(sysid_worker::rarx_opcode);
+		req.args.push_back(sysid_worker::make_matrix(z, false));
+		req.args.push_back(sysid_worker::make_matrix(nn, false));
+		req.args.push_back(sysid_worker::make_matrix(ff));
+		if (k > 0)
+		{
+			// Go on from the state returned by the previous step
+			req.args.push_back(sysid_worker::make_matrix(rep_th));
+			req.args.push_back(sysid_worker::make_matrix(rep_P));
+			req.args.push_back(sysid_worker::make_matrix(rep_phi));
+		}
+
+		vector_type u(nu);
+		u(0) = us[k];
+		double yh(::dcs::sysid::rls_ff_arx_miso(ys[k], u, ff, na, nb, nk, th, P, phi));
+
+		sysid_worker::message rep(worker.call(req));
+
+		DCS_TEST_CHECK( rep.op == sysid_worker::rarx_opcode );
+		DCS_TEST_CHECK( rep.args.size() == 4 );
+
+		sysid_worker::copy_matrix(rep.args[0], rep_th);
+		DCS_TEST_CHECK( rep_th.size() == th.size() );
+		DCS_TEST_CHECK_VECTOR_CLOSE( rep_th, th, th.size(), tol );
+		double rep_yh(0);
+		sysid_worker::copy_matrix(rep.args[1], rep_yh);
+		DCS_TEST_CHECK_CLOSE( rep_yh, yh, tol );
+		sysid_worker::copy_matrix(rep.args[2], rep_P);
+		DCS_TEST_CHECK( rep_P.size1() == P.size1() && rep_P.size2() == P.size2() );
+		DCS_TEST_CHECK_MATRIX_CLOSE( rep_P, P, P.size1(), P.size2(), tol );
+		sysid_worker::copy_matrix(rep.args[3], rep_phi);
+		DCS_TEST_CHECK( rep_phi.size() == phi.size() );
+		DCS_TEST_CHECK_VECTOR_CLOSE( rep_phi, phi, phi.size(), tol );
+	}
+
+	worker.shutdown();
+}
+
+
+DCS_TEST_DEF( test_native_worker_rpem )
+{
+	DCS_DEBUG_TRACE("Test Case: Native Worker RPEM Error Reply");
+
+	typedef ::boost::numeric::ublas::vector<double> vector_type;
+
+	vector_type z(2);
+	z(0) = 0.8; z(1) = 0.5;
+	vector_type nn(5);
+	nn(0) = 1; nn(1) = 1; nn(2) = 1; nn(3) = 1; nn(4) = 1;
+
+	sysid_worker::message req(sysid_worker::rpem_opcode);
+	req.args.push_back(sysid_worker::make_matrix(z, false));
+	req.args.push_back(sysid_worker::make_matrix(nn, false));
+	req.args.push_back(sysid_worker::make_matrix(0.98));
+
+	sysid_worker::client worker(native_worker_command());
+
+	bool failed(false);
+	try
+	{
+		worker.call(req);
+	}
+	catch (::std::runtime_error const& e)
+	{
+		failed = ::std::string(e.what()).find("rpem is not supported") != ::std::string::npos;
+	}
+	DCS_TEST_CHECK( failed );
+
+	// The worker must survive a failed request
+	vector_type nn_arx(3);
+	nn_arx(0) = 1; nn_arx(1) = 1; nn_arx(2) = 1;
+	sysid_worker::message arx_req(sysid_worker::rarx_opcode);
+	arx_req.args.push_back(sysid_worker::make_matrix(z, false));
+	arx_req.args.push_back(sysid_worker::make_matrix(nn_arx, false));
+	arx_req.args.push_back(sysid_worker::make_matrix(0.98));
+	DCS_TEST_CHECK( worker.call(arx_req).op == sysid_worker::rarx_opcode );
+
+	worker.shutdown();
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE( "System Identification Worker Protocol" );
+
+	DCS_TEST_BEGIN();
+
+	DCS_TEST_DO( test_round_trip );
+	DCS_TEST_DO( test_error );
+	DCS_TEST_DO( test_native_worker_rarx );
+	DCS_TEST_DO( test_native_worker_rpem );
+
+	DCS_TEST_END();
+}
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/des/cloud/detail/utilization_profile_integrator.hpp>
+#include <dcs/des/cloud/resource_utilization_profile.hpp>
+#include <dcs/test.hpp>
+
+
+struct traits_type
+{
+	typedef double real_type;
+};
+
+typedef traits_type::real_type real_type;
+typedef ::dcs::des::cloud::resource_utilization_profile<traits_type> profile_type;
+typedef ::dcs::des::cloud::detail::utilization_profile_integrator<traits_type> integrator_type;
+
+
+static const real_type tol = 1.0e-9;
+static const ::std::size_t min_flush_size = 16;
+static const ::std::size_t num_steps = 5000;
+
+
+namespace detail { namespace /*<unnamed>*/ {
+
+/// Busy power of the Fan et al. 2007 model, above an idle power of 86.7 W.
+struct fan2007_busy_power
+{
+	real_type operator()(real_type u) const
+	{
+		return 119.1*(2*u-::std::pow(u, 1.4));
+	}
+};
+
+
+/// Single-pass integration of the whole profile, as done before incremental flushing.
+void integrate(profile_type const& profile, real_type& energy, real_type& busy_time)
+{
+	fan2007_busy_power power;
+
+	energy = busy_time
+		   = 0;
+	for (profile_type::const_iterator it = profile.begin(); it != profile.end(); ++it)
+	{
+		energy += power(it->second)*::boost::icl::length(it->first);
+		busy_time += ::boost::icl::length(it->first);
+	}
+}
+
+
+/// Adds the utilization of the k-th step: a base level and a request overlapping the previous steps.
+void add_step(profile_type& profile, ::std::size_t k)
+{
+	real_type t(k);
+
+	profile(t, t+1, 0.1*(1+k%7));
+	if (k >= 2)
+	{
+		profile(t-2, t+1, 0.05);
+	}
+}
+
+}} // Namespace detail::<unnamed>
+
+
+DCS_TEST_DEF( test_bounded_window )
+{
+	DCS_DEBUG_TRACE("Test Case: Bounded Window");
+
+	profile_type profile;
+	profile_type full_profile;
+	integrator_type integrator(min_flush_size);
+
+	::std::size_t num_flushes(0);
+	::std::size_t max_segments(0);
+	for (::std::size_t k = 0; k < num_steps; ++k)
+	{
+		detail::add_step(profile, k);
+		detail::add_step(full_profile, k);
+
+		max_segments = ::std::max(max_segments, profile.num_segments());
+
+		if (integrator.flush_due(profile))
+		{
+			// Utilization can still be added from the earliest in-service arrival
+			integrator.flush(profile, real_type(k)-1.5, detail::fan2007_busy_power());
+			++num_flushes;
+		}
+	}
+
+	// The profile is kept bounded...
+	DCS_TEST_CHECK( max_segments <= min_flush_size );
+	DCS_TEST_CHECK( profile.num_segments() < min_flush_size );
+	// ... and flushes are spread over several steps
+	DCS_TEST_CHECK( num_flushes > 0 );
+	DCS_TEST_CHECK( num_flushes <= 2*num_steps/min_flush_size );
+
+	real_type energy(0);
+	real_type busy_time(0);
+	integrator.integrate(profile, detail::fan2007_busy_power(), energy, busy_time);
+
+	real_type ref_energy(0);
+	real_type ref_busy_time(0);
+	detail::integrate(full_profile, ref_energy, ref_busy_time);
+
+	DCS_TEST_CHECK_REL_CLOSE( energy, ref_energy, tol );
+	DCS_TEST_CHECK_REL_CLOSE( busy_time, ref_busy_time, tol );
+	DCS_TEST_CHECK_REL_CLOSE( busy_time, real_type(num_steps), tol );
+}
+
+
+DCS_TEST_DEF( test_unbounded_window )
+{
+	DCS_DEBUG_TRACE("Test Case: Unbounded Window");
+
+	profile_type profile;
+	profile_type full_profile;
+	integrator_type integrator(min_flush_size);
+
+	::std::size_t num_flushes(0);
+	for (::std::size_t k = 0; k < num_steps; ++k)
+	{
+		detail::add_step(profile, k);
+		detail::add_step(full_profile, k);
+
+		if (integrator.flush_due(profile))
+		{
+			// A request in service since the beginning: nothing settles
+			integrator.flush(profile, 0, detail::fan2007_busy_power());
+			++num_flushes;
+		}
+	}
+
+	// The threshold doubles at every flush, so flushes are logarithmic in the profile size
+	DCS_TEST_CHECK( num_flushes > 0 );
+	DCS_TEST_CHECK( num_flushes <= static_cast< ::std::size_t >(::std::ceil(::std::log(real_type(num_steps)/min_flush_size)/::std::log(2.0)))+1 );
+	DCS_TEST_CHECK( integrator.flush_size() > profile.num_segments() );
+	DCS_TEST_CHECK( profile.num_segments() == full_profile.num_segments() );
+
+	real_type energy(0);
+	real_type busy_time(0);
+	integrator.integrate(profile, detail::fan2007_busy_power(), energy, busy_time);
+
+	real_type ref_energy(0);
+	real_type ref_busy_time(0);
+	detail::integrate(full_profile, ref_energy, ref_busy_time);
+
+	DCS_TEST_CHECK_REL_CLOSE( energy, ref_energy, tol );
+	DCS_TEST_CHECK_REL_CLOSE( busy_time, ref_busy_time, tol );
+}
+
+
+DCS_TEST_DEF( test_reset )
+{
+	DCS_DEBUG_TRACE("Test Case: Reset");
+
+	profile_type profile;
+	integrator_type integrator(min_flush_size);
+
+	for (::std::size_t k = 0; k < 4*min_flush_size; ++k)
+	{
+		detail::add_step(profile, k);
+	}
+	integrator.flush(profile, real_type(4*min_flush_size), detail::fan2007_busy_power());
+
+	DCS_TEST_CHECK( profile.num_segments() == 0 );
+	DCS_TEST_CHECK( integrator.busy_time() > 0 );
+
+	integrator.reset();
+
+	DCS_TEST_CHECK( integrator.busy_energy() == 0 );
+	DCS_TEST_CHECK( integrator.busy_time() == 0 );
+	DCS_TEST_CHECK( integrator.flush_size() == min_flush_size );
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE( "Utilization Profile Integrator" );
+
+	DCS_TEST_BEGIN();
+
+	DCS_TEST_DO( test_bounded_window );
+	DCS_TEST_DO( test_unbounded_window );
+	DCS_TEST_DO( test_reset );
+
+	DCS_TEST_END();
+}
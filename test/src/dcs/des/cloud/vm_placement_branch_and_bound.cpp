@@ -0,0 +1,382 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <dcs/debug.hpp>
+#include <dcs/des/cloud/detail/native/vm_placement_branch_and_bound.hpp>
+#include <dcs/des/cloud/detail/native/vm_placement_problem.hpp>
+#include <dcs/test.hpp>
+#include <limits>
+#include <vector>
+
+
+struct traits_type
+{
+	typedef double real_type;
+	typedef unsigned long physical_machine_identifier_type;
+	typedef unsigned long virtual_machine_identifier_type;
+};
+
+typedef traits_type::real_type real_type;
+typedef ::dcs::des::cloud::detail::native::vm_placement_problem<traits_type> problem_type;
+typedef ::dcs::des::cloud::detail::native::vm_placement_branch_and_bound<traits_type> branch_and_bound_type;
+typedef problem_type::index_vector_type index_vector_type;
+typedef problem_type::real_vector_type real_vector_type;
+
+
+static const real_type tol = 1.0e-7;
+static const real_type eps = 1.0e-5;
+static const real_type feas_tol = 1.0e-9;
+static const ::std::size_t num_instances = 25;
+
+
+namespace detail { namespace /*<unnamed>*/ {
+
+/// Deterministic pseudo-random numbers in [0,1), so that instances are reproducible.
+class lcg
+{
+	public: explicit lcg(unsigned long seed)
+	: x_(seed)
+	{
+	}
+
+	public: real_type operator()()
+	{
+		x_ = (1103515245UL*x_+12345UL) % 2147483648UL;
+		return static_cast<real_type>(x_)/2147483648.0;
+	}
+
+	public: real_type operator()(real_type lo, real_type hi)
+	{
+		return lo+(hi-lo)*(*this)();
+	}
+
+	private: unsigned long x_;
+};
+
+
+/**
+ * Make a problem with \a ni machines and \a nj VMs.
+ *
+ * Machines come in two sizes and VMs are initially spread over the machines,
+ * so that moving a VM away costs one migration; identical machines exercise
+ * symmetry breaking.
+ */
+problem_type make_problem(lcg& rng, ::std::size_t ni, ::std::size_t nj, real_type ws)
+{
+	problem_type problem;
+
+	for (::std::size_t i = 0; i < ni; ++i)
+	{
+		// Fan et al. 2007 power model: P(u) = P_idle + (P_busy-P_idle)*(2u-u^r)
+		real_type p_idle((i % 2) ? 86.7 : 120.0);
+		real_type p_delta((i % 2) ? 119.1 : 180.0);
+		real_type umax(0.8);
+
+		problem.pm_ids.push_back(i);
+		problem.c0.push_back(p_idle);
+		problem.c1.push_back(2*p_delta);
+		problem.c2.push_back(-p_delta);
+		problem.r.push_back(1.4);
+		problem.smax.push_back(1);
+		problem.c.push_back(((i % 2) ? 1.0 : 2.0)*umax);
+		problem.umax.push_back(umax);
+	}
+	for (::std::size_t j = 0; j < nj; ++j)
+	{
+		problem.vm_ids.push_back(j);
+		problem.cr.push_back(rng(0.6, 1.0)*0.8);
+		problem.ur.push_back(rng(0.1, 0.6));
+		problem.srmin.push_back(0.2);
+	}
+	problem.mc = problem_type::real_matrix_type(ni, nj, 1);
+	for (::std::size_t j = 0; j < nj; ++j)
+	{
+		problem.mc(j % ni, j) = 0;
+	}
+	problem.wp = 1;
+	problem.wm = rng(0, 1) < 0.5 ? 0 : 1;
+	problem.ws = ws;
+
+	return problem;
+}
+
+
+/// Optimal share cost of machine \a i hosting \a vms, by bisection on the multiplier of the capacity constraint.
+real_type share_cost(problem_type const& problem, ::std::size_t i, index_vector_type const& vms)
+{
+	::std::size_t n(vms.size());
+	real_vector_type a(n);
+	for (::std::size_t h = 0; h < n; ++h)
+	{
+		a[h] = problem.c[i]/problem.cr[vms[h]];
+	}
+
+	real_type lo(0);
+	real_type hi(1.0e+6);
+	for (::std::size_t iter = 0; iter < 200; ++iter)
+	{
+		real_type mid((lo+hi)/2);
+		real_type sum(0);
+		for (::std::size_t h = 0; h < n; ++h)
+		{
+			sum += ::std::min(::std::max(1/a[h]-mid/(2*a[h]*a[h]), problem.srmin[vms[h]]/a[h]), real_type(1));
+		}
+		if (sum > problem.smax[i])
+		{
+			lo = mid;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	real_type cost(0);
+	for (::std::size_t h = 0; h < n; ++h)
+	{
+		real_type s(::std::min(::std::max(1/a[h]-hi/(2*a[h]*a[h]), problem.srmin[vms[h]]/a[h]), real_type(1)));
+		cost += (a[h]*s-1)*(a[h]*s-1);
+	}
+
+	return cost;
+}
+
+
+/// Cost of the given placement, or infinity if it is not feasible.
+real_type placement_cost(problem_type const& problem, index_vector_type const& hosts)
+{
+	::std::size_t ni(problem.pm_ids.size());
+	::std::size_t nj(problem.vm_ids.size());
+
+	// Same normalization of the objective terms as the AMPL model
+	real_type max_power(0);
+	real_type max_mc(0);
+	for (::std::size_t i = 0; i < ni; ++i)
+	{
+		max_power = ::std::max(max_power, problem.c0[i]+problem.c1[i]+problem.c2[i]);
+		for (::std::size_t j = 0; j < nj; ++j)
+		{
+			max_mc = ::std::max(max_mc, problem.mc(i,j));
+		}
+	}
+	real_type wwp(problem.wp/(ni*max_power));
+	real_type wwm((problem.wm > 0 && max_mc > 0) ? problem.wm/(nj*max_mc) : 0);
+	real_type wws(problem.ws/nj);
+
+	::std::vector<index_vector_type> pm_vms(ni);
+	real_type cost(0);
+	for (::std::size_t j = 0; j < nj; ++j)
+	{
+		pm_vms[hosts[j]].push_back(j);
+		cost += wwm*problem.mc(hosts[j],j);
+	}
+	for (::std::size_t i = 0; i < ni; ++i)
+	{
+		if (pm_vms[i].empty())
+		{
+			continue;
+		}
+
+		real_type u(0);
+		real_type min_share(0);
+		for (::std::size_t h = 0; h < pm_vms[i].size(); ++h)
+		{
+			::std::size_t j(pm_vms[i][h]);
+			real_type a(problem.c[i]/problem.cr[j]);
+			u += problem.ur[j]/a;
+			min_share += problem.srmin[j]/a;
+			if (problem.srmin[j]/a > 1)
+			{
+				return ::std::numeric_limits<real_type>::infinity();
+			}
+		}
+		if (u > (problem.umax[i]+feas_tol) || min_share > (problem.smax[i]+feas_tol))
+		{
+			return ::std::numeric_limits<real_type>::infinity();
+		}
+
+		cost += wwp*(problem.c0[i]+problem.c1[i]*u+problem.c2[i]*::std::pow(eps+u, problem.r[i]));
+		cost += wws*share_cost(problem, i, pm_vms[i]);
+	}
+
+	return cost;
+}
+
+
+/// Enumerate every placement; return the optimal cost and whether the optimum is unique.
+real_type brute_force(problem_type const& problem, index_vector_type& best_hosts, bool& unique)
+{
+	::std::size_t ni(problem.pm_ids.size());
+	::std::size_t nj(problem.vm_ids.size());
+
+	real_type best_cost(::std::numeric_limits<real_type>::infinity());
+	real_type second_cost(::std::numeric_limits<real_type>::infinity());
+	index_vector_type hosts(nj, 0);
+	while (true)
+	{
+		real_type cost(placement_cost(problem, hosts));
+		if (cost < best_cost)
+		{
+			second_cost = best_cost;
+			best_cost = cost;
+			best_hosts = hosts;
+		}
+		else if (cost < second_cost)
+		{
+			second_cost = cost;
+		}
+
+		// Next placement, in lexicographic order
+		::std::size_t k(0);
+		while (k < nj && ++hosts[k] == ni)
+		{
+			hosts[k] = 0;
+			++k;
+		}
+		if (k == nj)
+		{
+			break;
+		}
+	}
+
+	unique = (second_cost-best_cost) > tol*::std::max(real_type(1), best_cost);
+
+	return best_cost;
+}
+
+
+void check_optimal(problem_type const& problem, ::std::size_t num_threads)
+{
+	index_vector_type bf_hosts;
+	bool unique(false);
+	real_type bf_cost(brute_force(problem, bf_hosts, unique));
+	bool bf_found(bf_cost < ::std::numeric_limits<real_type>::infinity());
+
+	branch_and_bound_type bnb(problem, ::std::numeric_limits<real_type>::infinity(), num_threads);
+
+	DCS_TEST_CHECK( bnb.solve() == bf_found );
+	if (!bf_found)
+	{
+		return;
+	}
+
+	DCS_TEST_CHECK( bnb.hosts().size() == problem.vm_ids.size() );
+	DCS_TEST_CHECK_REL_CLOSE( bnb.cost(), bf_cost, tol );
+	DCS_TEST_CHECK_REL_CLOSE( placement_cost(problem, bnb.hosts()), bf_cost, tol );
+	if (unique)
+	{
+		DCS_TEST_CHECK( bnb.hosts() == bf_hosts );
+	}
+}
+
+}} // Namespace detail::<unnamed>
+
+
+DCS_TEST_DEF( test_power_and_migrations_one_thread )
+{
+	DCS_DEBUG_TRACE("Test Case: Power and Migration Costs - 1 Thread");
+
+	detail::lcg rng(5489);
+	for (::std::size_t n = 0; n < num_instances; ++n)
+	{
+		detail::check_optimal(detail::make_problem(rng, 3+n%2, 5, 0), 1);
+	}
+}
+
+
+DCS_TEST_DEF( test_power_and_migrations_many_threads )
+{
+	DCS_DEBUG_TRACE("Test Case: Power and Migration Costs - 4 Threads");
+
+	detail::lcg rng(5489);
+	for (::std::size_t n = 0; n < num_instances; ++n)
+	{
+		detail::check_optimal(detail::make_problem(rng, 3+n%2, 5, 0), 4);
+	}
+}
+
+
+DCS_TEST_DEF( test_all_costs_one_thread )
+{
+	DCS_DEBUG_TRACE("Test Case: Power, Migration and SLA Costs - 1 Thread");
+
+	detail::lcg rng(1234);
+	for (::std::size_t n = 0; n < num_instances; ++n)
+	{
+		detail::check_optimal(detail::make_problem(rng, 3+n%2, 5, 1), 1);
+	}
+}
+
+
+DCS_TEST_DEF( test_all_costs_many_threads )
+{
+	DCS_DEBUG_TRACE("Test Case: Power, Migration and SLA Costs - 4 Threads");
+
+	detail::lcg rng(1234);
+	for (::std::size_t n = 0; n < num_instances; ++n)
+	{
+		detail::check_optimal(detail::make_problem(rng, 3+n%2, 5, 1), 4);
+	}
+}
+
+
+DCS_TEST_DEF( test_time_limit )
+{
+	DCS_DEBUG_TRACE("Test Case: Time Limit");
+
+	detail::lcg rng(42);
+	problem_type problem(detail::make_problem(rng, 4, 6, 1));
+
+	index_vector_type bf_hosts;
+	bool unique(false);
+	real_type bf_cost(detail::brute_force(problem, bf_hosts, unique));
+	DCS_TEST_CHECK( bf_cost < ::std::numeric_limits<real_type>::infinity() );
+
+	// Give a feasible (non-optimal) placement to start from: the one-VM-per-machine-class round robin
+	index_vector_type guess;
+	real_type guess_cost(::std::numeric_limits<real_type>::infinity());
+	for (::std::size_t first = 0; first < problem.pm_ids.size() && guess_cost == ::std::numeric_limits<real_type>::infinity(); ++first)
+	{
+		guess.assign(problem.vm_ids.size(), 0);
+		for (::std::size_t j = 0; j < guess.size(); ++j)
+		{
+			guess[j] = (first+j) % problem.pm_ids.size();
+		}
+		guess_cost = detail::placement_cost(problem, guess);
+	}
+	DCS_TEST_CHECK( guess_cost < ::std::numeric_limits<real_type>::infinity() );
+	problem.init_guesses.push_back(guess);
+
+	for (::std::size_t num_threads = 1; num_threads <= 4; num_threads += 3)
+	{
+		// No time at all: the search stops at its first check, keeping the best placement so far
+		branch_and_bound_type bnb(problem, 0, num_threads);
+
+		DCS_TEST_CHECK( bnb.solve() );
+		DCS_TEST_CHECK( bnb.cost() <= guess_cost+tol );
+		DCS_TEST_CHECK( bnb.cost() >= bf_cost-tol );
+		DCS_TEST_CHECK_REL_CLOSE( detail::placement_cost(problem, bnb.hosts()), bnb.cost(), tol );
+
+		// With enough time, the optimum is found
+		branch_and_bound_type bnb_inf(problem, ::std::numeric_limits<real_type>::infinity(), num_threads);
+
+		DCS_TEST_CHECK( bnb_inf.solve() );
+		DCS_TEST_CHECK_REL_CLOSE( bnb_inf.cost(), bf_cost, tol );
+	}
+}
+
+
+int main()
+{
+	DCS_TEST_SUITE( "VM Placement Branch-and-Bound Solver" );
+
+	DCS_TEST_BEGIN();
+
+	DCS_TEST_DO( test_power_and_migrations_one_thread );
+	DCS_TEST_DO( test_power_and_migrations_many_threads );
+	DCS_TEST_DO( test_all_costs_one_thread );
+	DCS_TEST_DO( test_all_costs_many_threads );
+	DCS_TEST_DO( test_time_limit );
+
+	DCS_TEST_END();
+}